@@ -0,0 +1,261 @@
+/**
+ * arena.c
+ * Implementation of the arenas and of the accounting of the memory of the compiler
+ * @author Jose Pablo Ortiz Lack
+ */
+#include "arena.h"
+#include "diagnostics.h"
+#include "session.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdatomic.h>
+
+_Thread_local Arena *currentArena = NULL;
+
+size_t memoryLimit = 0;
+
+_Thread_local int memoryLimitExceeded = 0;
+
+const char *allocationCategoryNames[ALLOCATION_CATEGORIES] = { "nodes" , "symbols" , "strings" , "runtime" };
+
+//the memory of every thread is accounted together, the limit applies to the process
+static atomic_size_t currentBytes[ALLOCATION_CATEGORIES];
+static atomic_size_t peakBytes[ALLOCATION_CATEGORIES];
+static atomic_size_t currentTotalBytes;
+static atomic_size_t peakTotalBytes;
+
+//bytes allocated by the current thread and not accounted yet, so the nodes do not pay for atomic operations one by one
+static _Thread_local size_t pendingBytes[ALLOCATION_CATEGORIES];
+static _Thread_local size_t pendingTotal;
+
+/**
+ * @brief terminates the program when there is not enough memory
+ */
+static void *assertAllocated( void *memory ) {
+
+    if ( memory == NULL ) {
+
+        printf( "Error: Memory allocation failed. Program will be terminated\n" );
+        exit(1);
+
+    }
+
+    return memory;
+}
+
+/**
+ * @brief raises a peak to a number of bytes if they are more
+ */
+static void raisePeak( atomic_size_t *peak , size_t bytes ) {
+
+    size_t previous = atomic_load( peak );
+
+    while ( previous < bytes && !atomic_compare_exchange_weak( peak , &previous , bytes ) ) {
+
+        //previous was reloaded by the failed exchange
+
+    }
+}
+
+/**
+ * @brief adds bytes to the memory in use of a category
+ * @return 1 if the memory in use is within the limit, 0 otherwise
+ */
+static int chargeMemory( AllocationCategory category , size_t bytes ) {
+
+    size_t total = atomic_fetch_add( &currentTotalBytes , bytes ) + bytes;
+
+    raisePeak( &peakBytes[category] , atomic_fetch_add( &currentBytes[category] , bytes ) + bytes );
+    raisePeak( &peakTotalBytes , total );
+
+    return memoryLimit == 0 || total <= memoryLimit;
+}
+
+/**
+ * @brief accounts the bytes allocated by the current thread that were not accounted yet
+ * @return 1 if the memory in use is within the limit, 0 otherwise
+ */
+static int chargePendingMemory() {
+
+    int withinLimit = 1;
+    int category;
+
+    for ( category = 0 ; category < ALLOCATION_CATEGORIES ; category++ ) {
+
+        if ( pendingBytes[category] > 0 ) {
+
+            withinLimit &= chargeMemory( category , pendingBytes[category] );
+
+            pendingBytes[category] = 0;
+
+        }
+    }
+
+    pendingTotal = 0;
+
+    return withinLimit;
+}
+
+/**
+ * @brief removes bytes from the memory in use of a category
+ */
+static void dischargeMemory( AllocationCategory category , size_t bytes ) {
+
+    atomic_fetch_sub( &currentBytes[category] , bytes );
+    atomic_fetch_sub( &currentTotalBytes , bytes );
+
+}
+
+/**
+ * @brief allocates memory from an arena, adding a block if the current one has no room
+ */
+static void *allocateArena( Arena *arena , size_t size , size_t alignment ) {
+
+    ArenaBlock *block = arena->blocks;
+    uintptr_t start;
+
+    if ( block != NULL ) {
+
+        start = ( (uintptr_t) ( block + 1 ) + block->used + alignment - 1 ) & ~(uintptr_t) ( alignment - 1 );
+
+        if ( start + size <= (uintptr_t) ( block + 1 ) + block->size ) {
+
+            block->used = start + size - (uintptr_t) ( block + 1 );
+            arena->bytes += size;
+
+            return (void *) start;
+
+        }
+    }
+
+    //the block is large enough for the allocation even if its memory starts at the worst alignment
+    block = assertAllocated( malloc( sizeof( ArenaBlock ) + ( size + alignment > ARENA_BLOCK_SIZE ? size + alignment : ARENA_BLOCK_SIZE ) ) );
+
+    block->size   = size + alignment > ARENA_BLOCK_SIZE ? size + alignment : ARENA_BLOCK_SIZE;
+    block->next   = arena->blocks;
+    arena->blocks = block;
+
+    start = ( (uintptr_t) ( block + 1 ) + alignment - 1 ) & ~(uintptr_t) ( alignment - 1 );
+
+    block->used   = start + size - (uintptr_t) ( block + 1 );
+    arena->bytes += size;
+
+    return (void *) start;
+}
+
+void *allocateCompilerMemory( size_t size , size_t alignment , AllocationCategory category ) {
+
+    void *memory;
+
+    pendingBytes[category] += size;
+    pendingTotal           += size;
+
+    //the allocation is still made, the compilation stops at the next token
+    if ( ( pendingTotal >= ACCOUNTING_STEP || ( memoryLimit != 0 && atomic_load_explicit( &currentTotalBytes , memory_order_relaxed ) + pendingTotal > memoryLimit ) ) &&
+         !chargePendingMemory() && !memoryLimitExceeded ) {
+
+        memoryLimitExceeded = 1;
+
+        reportError( "Memory limit of %zu bytes exceeded" , memoryLimit );
+
+    }
+
+    if ( currentArena != NULL ) {
+
+        currentArena->categoryBytes[category] += size;
+
+        return memset( allocateArena( currentArena , size , alignment ) , 0 , size );
+
+    }
+
+    if ( alignment <= sizeof( void * ) ) {
+
+        return assertAllocated( calloc( 1 , size > 0 ? size : 1 ) );
+
+    }
+
+    if ( posix_memalign( &memory , alignment , size > 0 ? size : 1 ) != 0 ) {
+
+        assertAllocated( NULL );
+
+    }
+
+    return memset( memory , 0 , size );
+}
+
+char *copyCompilerString( const char *text , size_t length ) {
+
+    char *copy = allocateCompilerMemory( length + 1 , 1 , aSTRINGS );
+
+    memcpy( copy , text , length );
+
+    return copy;
+}
+
+void releaseArena( Arena *arena ) {
+
+    int category;
+
+    //the bytes of the arena may not be accounted yet
+    chargePendingMemory();
+
+    for ( category = 0 ; category < ALLOCATION_CATEGORIES ; category++ ) {
+
+        dischargeMemory( category , arena->categoryBytes[category] );
+
+        arena->categoryBytes[category] = 0;
+
+    }
+
+    while ( arena->blocks != NULL ) {
+
+        ArenaBlock *next = arena->blocks->next;
+
+        free( arena->blocks );
+
+        arena->blocks = next;
+
+    }
+
+    arena->bytes = 0;
+
+}
+
+void accountRuntimeMemory( size_t bytes ) {
+
+    if ( !chargeMemory( aRUNTIME , bytes ) ) {
+
+        runtimeError( "Error: Memory limit of %zu bytes exceeded. Program will be terminated\n" , memoryLimit );
+
+    }
+}
+
+void releaseRuntimeMemory( size_t bytes ) {
+
+    dischargeMemory( aRUNTIME , bytes );
+
+}
+
+void getMemoryUsage( MemoryUsage *usage ) {
+
+    int category;
+
+    //the bytes of the current thread not accounted yet are added without accounting them, so a signal handler may call it
+    for ( category = 0 ; category < ALLOCATION_CATEGORIES ; category++ ) {
+
+        usage->current[category] = atomic_load( &currentBytes[category] ) + pendingBytes[category];
+        usage->peak[category]    = atomic_load( &peakBytes[category] );
+        usage->peak[category]    = usage->current[category] > usage->peak[category] ? usage->current[category] : usage->peak[category];
+
+    }
+
+    usage->currentTotal = atomic_load( &currentTotalBytes ) + pendingTotal;
+    usage->peakTotal    = atomic_load( &peakTotalBytes );
+    usage->peakTotal    = usage->currentTotal > usage->peakTotal ? usage->currentTotal : usage->peakTotal;
+
+}
+
+//end arena.c
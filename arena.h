@@ -0,0 +1,142 @@
+/**
+ * arena.h
+ * Definition of the arenas, blocks of memory from which the nodes, symbols and identifiers of one program are allocated
+ * and released at once, and of the accounting of the memory of the compiler by category
+ * @author Jose Pablo Ortiz Lack
+ */
+#ifndef __ARENA_H__
+#define __ARENA_H__
+
+#include <stddef.h>
+
+/**
+ * @brief bytes of a block of an arena, a larger allocation gets a block of its own
+ */
+#define ARENA_BLOCK_SIZE 65536
+
+/**
+ * @brief bytes a thread allocates before they are accounted, unless they would go over the memory limit
+ */
+#define ACCOUNTING_STEP 16384
+
+/**
+ * @brief what the memory of the compiler is used for
+ */
+typedef enum tagAllocationCategory {
+
+    aNODES, //nodes of the trees and the plans of their loops
+    aSYMBOLS, //symbols and the local lists of the procedures
+    aSTRINGS, //identifiers
+    aRUNTIME //elements of the arrays and buffers of the execution
+
+} AllocationCategory;
+
+/**
+ * @brief number of allocation categories
+ */
+#define ALLOCATION_CATEGORIES ( aRUNTIME + 1 )
+
+/**
+ * @brief names of the allocation categories, in AllocationCategory order
+ */
+extern const char *allocationCategoryNames[ALLOCATION_CATEGORIES];
+
+/**
+ * @brief bytes of the compiler in use and the most ever in use, by category and in total
+ */
+typedef struct tagMemoryUsage {
+
+    size_t current[ALLOCATION_CATEGORIES]; //bytes in use
+    size_t peak[ALLOCATION_CATEGORIES]; //most bytes in use at once
+
+    size_t currentTotal; //bytes in use of every category
+    size_t peakTotal; //most bytes in use at once of every category
+
+} MemoryUsage;
+
+/**
+ * @brief a block of an arena, followed by its memory
+ */
+typedef struct tagArenaBlock {
+
+    struct tagArenaBlock *next; //block allocated before this one
+
+    size_t used; //bytes of the block already allocated
+    size_t size; //bytes of the block
+
+} ArenaBlock;
+
+/**
+ * @brief the memory of one program
+ */
+typedef struct tagArena {
+
+    ArenaBlock *blocks; //blocks of the arena, the most recent one first
+    size_t bytes; //bytes allocated from the arena
+    size_t categoryBytes[ALLOCATION_CATEGORIES]; //bytes allocated from the arena by category
+
+} Arena;
+
+/**
+ * @brief arena of the program being compiled by the current thread, NULL to allocate from the heap
+ */
+extern _Thread_local Arena *currentArena;
+
+/**
+ * @brief most bytes the compiler may use at once, every category and thread together, 0 for no limit
+ */
+extern size_t memoryLimit;
+
+/**
+ * @brief set when the memory of the program being compiled by the current thread went over the limit. An error is reported once,
+ * the scanners end the input at the next token and the program is not executed. Cleared by every compilation that starts
+ */
+extern _Thread_local int memoryLimitExceeded;
+
+/**
+ * @brief allocates zeroed memory for the program being compiled, from the arena of the current thread if it has one.
+ * Memory allocated from the heap is never released
+ * @param size bytes to allocate
+ * @param alignment alignment of the memory, a power of 2
+ * @param category what the memory is used for
+ * @return the memory. The program is terminated if there is not enough memory
+ */
+void *allocateCompilerMemory( size_t size , size_t alignment , AllocationCategory category );
+
+/**
+ * @brief copies a string into memory of the program being compiled, accounted as aSTRINGS
+ * @param text characters to copy
+ * @param length number of characters
+ * @return the null terminated copy
+ */
+char *copyCompilerString( const char *text , size_t length );
+
+/**
+ * @brief releases every block of an arena, leaving it empty, and its bytes from the memory in use
+ * @param arena arena to be released
+ */
+void releaseArena( Arena *arena );
+
+/**
+ * @brief accounts a buffer allocated by the execution as aRUNTIME memory. Going over the limit is a run-time error, see runtimeError
+ * of session.h
+ * @param bytes bytes of the buffer
+ */
+void accountRuntimeMemory( size_t bytes );
+
+/**
+ * @brief removes a buffer released by the execution from the aRUNTIME memory in use
+ * @param bytes bytes of the buffer, as accounted
+ */
+void releaseRuntimeMemory( size_t bytes );
+
+/**
+ * @brief obtains the memory in use and the most ever in use by every thread. The bytes other threads allocated since they last
+ * accounted theirs, less than ACCOUNTING_STEP per thread, are not included
+ * @param usage where the bytes are written
+ */
+void getMemoryUsage( MemoryUsage *usage );
+
+#endif //__ARENA_H__
+
+//end arena.h
@@ -0,0 +1,1330 @@
+/**
+ * batch.c
+ * Implementation of the batch execution
+ *
+ * The records are executed BATCH_LANES at a time. Every value of the batch is a vector with one lane per record, so a walk of the
+ * tree computes an operation for every record and the kernels that compute it are vectorized. Statements are executed under a
+ * mask of the lanes that reach them: an if statement narrows the mask to the lanes whose condition is true, and the lanes of a
+ * loop whose condition became false stay inactive until every lane left the loop. A lane whose record ends with an error is
+ * removed from every mask
+ * @author Jose Pablo Ortiz Lack
+ */
+#include "batch.h"
+#include "symbolTable.h"
+#include "syntaxTree.h"
+#include "arena.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <math.h>
+
+/**
+ * @brief kernels are cloned for AVX-512, AVX2 and the SSE2 baseline, the clone is selected at load time through CPUID
+ */
+#if defined( __GNUC__ ) && defined( __x86_64__ ) && !defined( __clang__ )
+#define BATCH_KERNEL __attribute__(( target_clones( "avx512f" , "avx2" , "default" ) ))
+#else
+#define BATCH_KERNEL
+#endif
+
+/**
+ * @brief 1 if a lane is in a mask and its record has not ended with an error
+ */
+#define ACTIVE_LANE( mask , lane ) ( ( mask )[lane] & batch->alive[lane] )
+
+/**
+ * @brief integer and long for loops have no bounds to verify
+ */
+#define ALWAYS_FINITE( value ) 1
+
+/**
+ * @brief the state of the records being executed
+ */
+typedef struct tagBatch {
+
+    Symbol **symbolTable; //the symbolTable of the compiler
+
+    void **values; //lanes of every symbol, indexed by slot. Element i of an array is stored at lanes i * BATCH_LANES to i * BATCH_LANES + BATCH_LANES - 1
+
+    unsigned char alive[BATCH_LANES]; //1 for the lanes whose record is executed, 0 for the unused lanes and the records that ended with an error
+    const char *input[BATCH_LANES]; //next character of the record of every lane
+
+    FILE *outputs[BATCH_LANES]; //output of the record of every lane
+    char *outputTexts[BATCH_LANES]; //text written to the outputs
+    size_t outputLengths[BATCH_LANES]; //length of the text written to the outputs
+
+    int failed; //records that ended with an error
+
+} Batch;
+
+/**
+ * @brief ends the record of a lane with an error written to its output. The other lanes continue
+ */
+static void terminateLane( Batch *batch , int lane , const char *format , ... ) {
+
+    va_list arguments;
+
+    va_start( arguments , format );
+    vfprintf( batch->outputs[lane] , format , arguments );
+    va_end( arguments );
+
+    batch->alive[lane] = 0;
+    batch->failed++;
+
+}
+
+/**
+ * @brief removes from a mask the lanes whose record ended
+ * @param active mask of the lanes that remain, it may be the same mask
+ * @param mask mask to be narrowed
+ * @param alive lanes whose record is executed
+ * @return 1 if any lane remains in the mask
+ */
+BATCH_KERNEL
+static int narrowMask( unsigned char *active , const unsigned char *mask , const unsigned char *alive ) {
+
+    unsigned char any = 0;
+    int lane;
+
+    for ( lane = 0 ; lane < BATCH_LANES ; lane++ ) {
+
+        active[lane] = mask[lane] & alive[lane];
+        any         |= active[lane];
+
+    }
+
+    return any;
+
+}
+
+/**
+ * @brief defines the kernels of the arithmetic of a type. Integer and long lanes are computed as unsigned values, so they wrap
+ * around like the scalar operations
+ */
+#define ARITHMETIC_KERNELS( suffix , type , wrapType )                                                                   \
+                                                                                                                         \
+    BATCH_KERNEL                                                                                                         \
+    static void add##suffix( type *result , const type *right ) {                                                        \
+                                                                                                                         \
+        int lane;                                                                                                        \
+                                                                                                                         \
+        for ( lane = 0 ; lane < BATCH_LANES ; lane++ ) {                                                                 \
+                                                                                                                         \
+            result[lane] = (type) ( (wrapType) result[lane] + (wrapType) right[lane] );                                  \
+                                                                                                                         \
+        }                                                                                                                \
+    }                                                                                                                    \
+                                                                                                                         \
+    BATCH_KERNEL                                                                                                         \
+    static void subtract##suffix( type *result , const type *right ) {                                                   \
+                                                                                                                         \
+        int lane;                                                                                                        \
+                                                                                                                         \
+        for ( lane = 0 ; lane < BATCH_LANES ; lane++ ) {                                                                 \
+                                                                                                                         \
+            result[lane] = (type) ( (wrapType) result[lane] - (wrapType) right[lane] );                                  \
+                                                                                                                         \
+        }                                                                                                                \
+    }                                                                                                                    \
+                                                                                                                         \
+    BATCH_KERNEL                                                                                                         \
+    static void multiply##suffix( type *result , const type *right ) {                                                   \
+                                                                                                                         \
+        int lane;                                                                                                        \
+                                                                                                                         \
+        for ( lane = 0 ; lane < BATCH_LANES ; lane++ ) {                                                                 \
+                                                                                                                         \
+            result[lane] = (type) ( (wrapType) result[lane] * (wrapType) right[lane] );                                  \
+                                                                                                                         \
+        }                                                                                                                \
+    }                                                                                                                    \
+                                                                                                                         \
+    BATCH_KERNEL                                                                                                         \
+    static void gather##suffix( type *result , const type *elements , const int *index ) {                               \
+                                                                                                                         \
+        int lane;                                                                                                        \
+                                                                                                                         \
+        for ( lane = 0 ; lane < BATCH_LANES ; lane++ ) {                                                                 \
+                                                                                                                         \
+            result[lane] = elements[(long) index[lane] * BATCH_LANES + lane];                                            \
+                                                                                                                         \
+        }                                                                                                                \
+    }                                                                                                                    \
+                                                                                                                         \
+    BATCH_KERNEL                                                                                                         \
+    static void store##suffix( type *values , const type *value , const unsigned char *mask ) {                          \
+                                                                                                                         \
+        int lane;                                                                                                        \
+                                                                                                                         \
+        for ( lane = 0 ; lane < BATCH_LANES ; lane++ ) {                                                                 \
+                                                                                                                         \
+            values[lane] = mask[lane] ? value[lane] : values[lane];                                                      \
+                                                                                                                         \
+        }                                                                                                                \
+    }                                                                                                                    \
+                                                                                                                         \
+    BATCH_KERNEL                                                                                                         \
+    static void compare##suffix( unsigned char *outcome , const type *left , const type *right ,                         \
+                                 ExpresionType expresionType , const unsigned char *mask ) {                             \
+                                                                                                                         \
+        int lane;                                                                                                        \
+                                                                                                                         \
+        for ( lane = 0 ; lane < BATCH_LANES ; lane++ ) {                                                                 \
+                                                                                                                         \
+            outcome[lane] = mask[lane] & ( expresionType == eGREATER_THAN ? left[lane] > right[lane] :                   \
+                                         ( expresionType == eLESS_THAN ? left[lane] < right[lane] : left[lane] == right[lane] ) ); \
+                                                                                                                         \
+        }                                                                                                                \
+    }
+
+/**
+ * @brief defines the checked arithmetic of an integer type: the operations that trap overflows and the division, which ends the
+ * records that divide by 0
+ */
+#define INTEGER_KERNELS( suffix , type , wrapType )                                                                      \
+                                                                                                                         \
+    ARITHMETIC_KERNELS( suffix , type , wrapType )                                                                       \
+                                                                                                                         \
+    static void trap##suffix( type *result , const type *right , OperationType operationType ,                           \
+                              const unsigned char *mask , Batch *batch ) {                                               \
+                                                                                                                         \
+        int lane;                                                                                                        \
+                                                                                                                         \
+        for ( lane = 0 ; lane < BATCH_LANES ; lane++ ) {                                                                 \
+                                                                                                                         \
+            int overflow = operationType == oSUM ? __builtin_add_overflow( result[lane] , right[lane] , &result[lane] ) : \
+                           operationType == oSUB ? __builtin_sub_overflow( result[lane] , right[lane] , &result[lane] ) : \
+                                                   __builtin_mul_overflow( result[lane] , right[lane] , &result[lane] );  \
+                                                                                                                         \
+            if ( overflow && ACTIVE_LANE( mask , lane ) ) {                                                              \
+                                                                                                                         \
+                terminateLane( batch , lane , "Error: Integer overflow. Program will be terminated.\n" );                \
+                                                                                                                         \
+            }                                                                                                            \
+        }                                                                                                                \
+    }                                                                                                                    \
+                                                                                                                         \
+    static void divide##suffix( type *result , const type *right , const unsigned char *mask , Batch *batch ) {          \
+                                                                                                                         \
+        int lane;                                                                                                        \
+                                                                                                                         \
+        for ( lane = 0 ; lane < BATCH_LANES ; lane++ ) {                                                                 \
+                                                                                                                         \
+            if ( !ACTIVE_LANE( mask , lane ) ) {                                                                         \
+                                                                                                                         \
+                result[lane] = 0;                                                                                        \
+                                                                                                                         \
+            } else if ( right[lane] == 0 ) {                                                                             \
+                                                                                                                         \
+                terminateLane( batch , lane , "Error: Division by zero. Program will be terminated.\n" );                \
+                                                                                                                         \
+            } else if ( right[lane] == -1 ) { /*the smallest value divided by -1 overflows*/                             \
+                                                                                                                         \
+                if ( __builtin_sub_overflow( 0 , result[lane] , &result[lane] ) && overflowTrapEnabled ) {               \
+                                                                                                                         \
+                    terminateLane( batch , lane , "Error: Integer overflow. Program will be terminated.\n" );            \
+                                                                                                                         \
+                }                                                                                                        \
+                                                                                                                         \
+            } else {                                                                                                     \
+                                                                                                                         \
+                result[lane] /= right[lane];                                                                             \
+                                                                                                                         \
+            }                                                                                                            \
+        }                                                                                                                \
+    }
+
+/**
+ * @brief defines the arithmetic of a floating point type
+ */
+#define REAL_KERNELS( suffix , type )                                                                                    \
+                                                                                                                         \
+    ARITHMETIC_KERNELS( suffix , type , type )                                                                           \
+                                                                                                                         \
+    BATCH_KERNEL                                                                                                         \
+    static void divide##suffix( type *result , const type *right ) {                                                     \
+                                                                                                                         \
+        int lane;                                                                                                        \
+                                                                                                                         \
+        for ( lane = 0 ; lane < BATCH_LANES ; lane++ ) {                                                                 \
+                                                                                                                         \
+            result[lane] /= right[lane];                                                                                 \
+                                                                                                                         \
+        }                                                                                                                \
+    }
+
+INTEGER_KERNELS( Integers , int , unsigned int )
+INTEGER_KERNELS( Longs , long long , unsigned long long )
+REAL_KERNELS( Floats , float )
+REAL_KERNELS( Doubles , double )
+
+/**
+ * @brief obtains the lanes of a symbol
+ */
+static void *symbolLanes( Batch *batch , char *identifier ) {
+
+    return batch->values[findSymbol( batch->symbolTable , identifier )->slot];
+
+}
+
+static void evaluateBatchInteger( Node *operation , int *result , const unsigned char *mask , Batch *batch );
+
+/**
+ * @brief computes the index of an array element node for every lane. The lanes whose index is out of the bounds of the array end
+ * with the error of the bounds check, even if bounds checking is not enabled, since the lanes share the memory of the array
+ * @param node array element or array assignment node
+ * @param index index of every lane, 0 for the lanes that are not active
+ * @param mask lanes that evaluate the node
+ * @param batch the records being executed
+ */
+static void resolveBatchIndex( Node *node , int *index , const unsigned char *mask , Batch *batch ) {
+
+    int length = findSymbol( batch->symbolTable , node->value.idValue )->length;
+    int lane;
+
+    evaluateBatchInteger( node->indexExpr , index , mask , batch );
+
+    for ( lane = 0 ; lane < BATCH_LANES ; lane++ ) {
+
+        if ( !ACTIVE_LANE( mask , lane ) ) {
+
+            index[lane] = 0;
+
+        } else if ( index[lane] < 0 || index[lane] >= length ) {
+
+            terminateLane( batch , lane , "Error: Index %d out of bounds for array %s. Program will be terminated.\n" , index[lane] , node->value.idValue );
+
+            index[lane] = 0;
+
+        }
+    }
+}
+
+/**
+ * @brief calculates an integer operation for every lane. The lanes that are not in the mask get a value, but raise no error
+ * @param operation operation to be calculated
+ * @param result value of every lane
+ * @param mask lanes whose value is used
+ * @param batch the records being executed
+ */
+static void evaluateBatchInteger( Node *operation , int *result , const unsigned char *mask , Batch *batch ) {
+
+    int right[BATCH_LANES];
+    int lane;
+
+    //binary operations evaluate their left operand first, so the errors of a lane are raised in the order of the scalar path
+    switch ( operation->operationType ) {
+
+        case oINTEGER:
+
+            for ( lane = 0 ; lane < BATCH_LANES ; lane++ ) {
+
+                result[lane] = operation->value.iValue;
+
+            }
+
+        break;
+
+        case oID:
+
+            memcpy( result , symbolLanes( batch , operation->value.idValue ) , sizeof( right ) );
+
+        break;
+
+        case oINDEX:
+
+            resolveBatchIndex( operation , right , mask , batch );
+            gatherIntegers( result , symbolLanes( batch , operation->value.idValue ) , right );
+
+        break;
+
+        case oSUM:
+        case oSUB:
+        case oMULT:
+
+            evaluateBatchInteger( operation->leftOperand , result , mask , batch );
+            evaluateBatchInteger( operation->rightOperand , right , mask , batch );
+
+            if ( overflowTrapEnabled ) {
+
+                trapIntegers( result , right , operation->operationType , mask , batch );
+
+            } else if ( operation->operationType == oSUM ) {
+
+                addIntegers( result , right );
+
+            } else if ( operation->operationType == oSUB ) {
+
+                subtractIntegers( result , right );
+
+            } else {
+
+                multiplyIntegers( result , right );
+
+            }
+
+        break;
+
+        case oDIV:
+
+            evaluateBatchInteger( operation->leftOperand , result , mask , batch );
+            evaluateBatchInteger( operation->rightOperand , right , mask , batch );
+
+            divideIntegers( result , right , mask , batch );
+
+        break;
+
+        case oKEEP: //the lanes compute the operation again instead of keeping its value
+        case oREUSE:
+
+            evaluateBatchInteger( operation->leftOperand , result , mask , batch );
+
+        break;
+
+        default:
+            // should not be here
+        break;
+
+    }
+}
+
+/**
+ * @brief calculates a long operation for every lane. The lanes that are not in the mask get a value, but raise no error
+ * @param operation operation to be calculated
+ * @param result value of every lane
+ * @param mask lanes whose value is used
+ * @param batch the records being executed
+ */
+static void evaluateBatchLong( Node *operation , long long *result , const unsigned char *mask , Batch *batch ) {
+
+    long long right[BATCH_LANES];
+    int lane;
+
+    switch ( operation->operationType ) {
+
+        case oLONG:
+
+            for ( lane = 0 ; lane < BATCH_LANES ; lane++ ) {
+
+                result[lane] = operation->value.lValue;
+
+            }
+
+        break;
+
+        case oID:
+
+            memcpy( result , symbolLanes( batch , operation->value.idValue ) , sizeof( right ) );
+
+        break;
+
+        case oINDEX: {
+
+            int index[BATCH_LANES];
+
+            resolveBatchIndex( operation , index , mask , batch );
+            gatherLongs( result , symbolLanes( batch , operation->value.idValue ) , index );
+
+        }
+        break;
+
+        case oSUM:
+        case oSUB:
+        case oMULT:
+
+            evaluateBatchLong( operation->leftOperand , result , mask , batch );
+            evaluateBatchLong( operation->rightOperand , right , mask , batch );
+
+            if ( overflowTrapEnabled ) {
+
+                trapLongs( result , right , operation->operationType , mask , batch );
+
+            } else if ( operation->operationType == oSUM ) {
+
+                addLongs( result , right );
+
+            } else if ( operation->operationType == oSUB ) {
+
+                subtractLongs( result , right );
+
+            } else {
+
+                multiplyLongs( result , right );
+
+            }
+
+        break;
+
+        case oDIV:
+
+            evaluateBatchLong( operation->leftOperand , result , mask , batch );
+            evaluateBatchLong( operation->rightOperand , right , mask , batch );
+
+            divideLongs( result , right , mask , batch );
+
+        break;
+
+        case oKEEP:
+        case oREUSE:
+
+            evaluateBatchLong( operation->leftOperand , result , mask , batch );
+
+        break;
+
+        default:
+            // should not be here
+        break;
+
+    }
+}
+
+/**
+ * @brief calculates a float operation for every lane
+ * @param operation operation to be calculated
+ * @param result value of every lane
+ * @param mask lanes whose value is used
+ * @param batch the records being executed
+ */
+static void evaluateBatchFloat( Node *operation , float *result , const unsigned char *mask , Batch *batch ) {
+
+    float right[BATCH_LANES];
+    int lane;
+
+    switch ( operation->operationType ) {
+
+        case oFLOAT:
+
+            for ( lane = 0 ; lane < BATCH_LANES ; lane++ ) {
+
+                result[lane] = operation->value.fValue;
+
+            }
+
+        break;
+
+        case oID:
+
+            memcpy( result , symbolLanes( batch , operation->value.idValue ) , sizeof( right ) );
+
+        break;
+
+        case oINDEX: {
+
+            int index[BATCH_LANES];
+
+            resolveBatchIndex( operation , index , mask , batch );
+            gatherFloats( result , symbolLanes( batch , operation->value.idValue ) , index );
+
+        }
+        break;
+
+        case oSUM:
+        case oSUB:
+        case oMULT:
+        case oDIV:
+
+            evaluateBatchFloat( operation->leftOperand , result , mask , batch );
+            evaluateBatchFloat( operation->rightOperand , right , mask , batch );
+
+            switch ( operation->operationType ) {
+
+                case oSUM: addFloats( result , right ); break;
+                case oSUB: subtractFloats( result , right ); break;
+                case oMULT: multiplyFloats( result , right ); break;
+                default: divideFloats( result , right ); break;
+
+            }
+
+        break;
+
+        case oKEEP:
+        case oREUSE:
+
+            evaluateBatchFloat( operation->leftOperand , result , mask , batch );
+
+        break;
+
+        default:
+            // should not be here
+        break;
+
+    }
+}
+
+/**
+ * @brief calculates a double operation for every lane
+ * @param operation operation to be calculated
+ * @param result value of every lane
+ * @param mask lanes whose value is used
+ * @param batch the records being executed
+ */
+static void evaluateBatchDouble( Node *operation , double *result , const unsigned char *mask , Batch *batch ) {
+
+    double right[BATCH_LANES];
+    int lane;
+
+    switch ( operation->operationType ) {
+
+        case oDOUBLE:
+
+            for ( lane = 0 ; lane < BATCH_LANES ; lane++ ) {
+
+                result[lane] = operation->value.dValue;
+
+            }
+
+        break;
+
+        case oID:
+
+            memcpy( result , symbolLanes( batch , operation->value.idValue ) , sizeof( right ) );
+
+        break;
+
+        case oINDEX: {
+
+            int index[BATCH_LANES];
+
+            resolveBatchIndex( operation , index , mask , batch );
+            gatherDoubles( result , symbolLanes( batch , operation->value.idValue ) , index );
+
+        }
+        break;
+
+        case oSUM:
+        case oSUB:
+        case oMULT:
+        case oDIV:
+
+            evaluateBatchDouble( operation->leftOperand , result , mask , batch );
+            evaluateBatchDouble( operation->rightOperand , right , mask , batch );
+
+            switch ( operation->operationType ) {
+
+                case oSUM: addDoubles( result , right ); break;
+                case oSUB: subtractDoubles( result , right ); break;
+                case oMULT: multiplyDoubles( result , right ); break;
+                default: divideDoubles( result , right ); break;
+
+            }
+
+        break;
+
+        case oKEEP:
+        case oREUSE:
+
+            evaluateBatchDouble( operation->leftOperand , result , mask , batch );
+
+        break;
+
+        default:
+            // should not be here
+        break;
+
+    }
+}
+
+/**
+ * @brief evaluates a condition for every lane
+ * @param expresion expresion to be evaluated
+ * @param outcome 1 for the lanes of the mask whose condition is true, it may be the same mask
+ * @param mask lanes that evaluate the condition
+ * @param batch the records being executed
+ */
+static void evaluateBatchCondition( Node *expresion , unsigned char *outcome , const unsigned char *mask , Batch *batch ) {
+
+    //the left side is evaluated before the right side, as in the operations
+    switch ( expresion->symbolType ) {
+
+        case sINTEGER: {
+
+            int left[BATCH_LANES];
+            int right[BATCH_LANES];
+
+            evaluateBatchInteger( expresion->leftOperand , left , mask , batch );
+            evaluateBatchInteger( expresion->rightOperand , right , mask , batch );
+
+            compareIntegers( outcome , left , right , expresion->expresionType , mask );
+        }
+        break;
+
+        case sFLOAT: {
+
+            float left[BATCH_LANES];
+            float right[BATCH_LANES];
+
+            evaluateBatchFloat( expresion->leftOperand , left , mask , batch );
+            evaluateBatchFloat( expresion->rightOperand , right , mask , batch );
+
+            compareFloats( outcome , left , right , expresion->expresionType , mask );
+        }
+        break;
+
+        case sLONG: {
+
+            long long left[BATCH_LANES];
+            long long right[BATCH_LANES];
+
+            evaluateBatchLong( expresion->leftOperand , left , mask , batch );
+            evaluateBatchLong( expresion->rightOperand , right , mask , batch );
+
+            compareLongs( outcome , left , right , expresion->expresionType , mask );
+        }
+        break;
+
+        case sDOUBLE: {
+
+            double left[BATCH_LANES];
+            double right[BATCH_LANES];
+
+            evaluateBatchDouble( expresion->leftOperand , left , mask , batch );
+            evaluateBatchDouble( expresion->rightOperand , right , mask , batch );
+
+            compareDoubles( outcome , left , right , expresion->expresionType , mask );
+        }
+        break;
+
+    }
+}
+
+/**
+ * @brief assigns the value of every active lane to a symbol, to one of its elements if an index is given, or to every element if
+ * the symbol is an array and no index is given
+ */
+#define ASSIGN_LANES( suffix , type , values , value , index , length , mask )                                           \
+    {                                                                                                                    \
+        int lane;                                                                                                        \
+        int element;                                                                                                     \
+                                                                                                                         \
+        if ( ( index ) != NULL ) {                                                                                       \
+                                                                                                                         \
+            for ( lane = 0 ; lane < BATCH_LANES ; lane++ ) {                                                             \
+                                                                                                                         \
+                if ( ACTIVE_LANE( mask , lane ) ) {                                                                      \
+                                                                                                                         \
+                    ( (type *) ( values ) )[(long) ( index )[lane] * BATCH_LANES + lane] = ( value )[lane];              \
+                                                                                                                         \
+                }                                                                                                        \
+            }                                                                                                            \
+                                                                                                                         \
+        } else {                                                                                                         \
+                                                                                                                         \
+            for ( element = 0 ; element < ( ( length ) > 0 ? ( length ) : 1 ) ; element++ ) {                            \
+                                                                                                                         \
+                store##suffix( (type *) ( values ) + (long) element * BATCH_LANES , value , mask );                      \
+                                                                                                                         \
+            }                                                                                                            \
+        }                                                                                                                \
+    }
+
+/**
+ * @brief executes an assignment for the lanes of a mask. The index of an element is evaluated before the value assigned
+ */
+static void resolveBatchAssignment( Node *tree , const unsigned char *mask , Batch *batch ) {
+
+    Symbol *symbol = findSymbol( batch->symbolTable , tree->value.idValue );
+    void *values = batch->values[symbol->slot];
+    int indexes[BATCH_LANES];
+    int *index = NULL;
+
+    if ( tree->indexExpr != NULL ) {
+
+        index = indexes;
+
+        resolveBatchIndex( tree , index , mask , batch );
+
+    }
+
+    switch ( tree->symbolType ) {
+
+        case sINTEGER: {
+
+            int value[BATCH_LANES];
+
+            evaluateBatchInteger( tree->expr , value , mask , batch );
+
+            ASSIGN_LANES( Integers , int , values , value , index , symbol->length , mask );
+        }
+        break;
+
+        case sFLOAT: {
+
+            float value[BATCH_LANES];
+
+            evaluateBatchFloat( tree->expr , value , mask , batch );
+
+            ASSIGN_LANES( Floats , float , values , value , index , symbol->length , mask );
+        }
+        break;
+
+        case sLONG: {
+
+            long long value[BATCH_LANES];
+
+            evaluateBatchLong( tree->expr , value , mask , batch );
+
+            ASSIGN_LANES( Longs , long long , values , value , index , symbol->length , mask );
+        }
+        break;
+
+        case sDOUBLE: {
+
+            double value[BATCH_LANES];
+
+            evaluateBatchDouble( tree->expr , value , mask , batch );
+
+            ASSIGN_LANES( Doubles , double , values , value , index , symbol->length , mask );
+        }
+        break;
+
+    }
+}
+
+static void resolveBatchTree( Node *tree , const unsigned char *mask , Batch *batch );
+
+/**
+ * @brief defines the execution of a for loop of a type for the lanes of a mask. Every lane keeps its own iterator, and a lane
+ * leaves the loop when its iterator passes its until value. The loop ends when every lane left it
+ */
+#define BATCH_FOR_LOOP( name , type , wrapType , evaluate , suffix , finite )                                            \
+                                                                                                                         \
+    static void name( Node *tree , const unsigned char *mask , Batch *batch ) {                                          \
+                                                                                                                         \
+        type iterator[BATCH_LANES];                                                                                      \
+        type step[BATCH_LANES];                                                                                          \
+        type until[BATCH_LANES];                                                                                         \
+        type *values = symbolLanes( batch , tree->value.idValue );                                                       \
+        unsigned char running[BATCH_LANES];                                                                              \
+        int lane;                                                                                                        \
+                                                                                                                         \
+        evaluate( tree->expr , iterator , mask , batch );                                                                \
+        evaluate( tree->stepExpr , step , mask , batch );                                                                \
+        evaluate( tree->untilExpr , until , mask , batch );                                                              \
+                                                                                                                         \
+        store##suffix( values , iterator , mask );                                                                       \
+                                                                                                                         \
+        for ( lane = 0 ; lane < BATCH_LANES ; lane++ ) {                                                                 \
+                                                                                                                         \
+            if ( !ACTIVE_LANE( mask , lane ) ) {                                                                         \
+                                                                                                                         \
+                continue;                                                                                                \
+                                                                                                                         \
+            }                                                                                                            \
+                                                                                                                         \
+            if ( !( finite( iterator[lane] ) && finite( step[lane] ) && finite( until[lane] ) ) ) {                      \
+                                                                                                                         \
+                terminateLane( batch , lane , "Error: For loop bounds must be finite. Program will be terminated.\n" );  \
+                                                                                                                         \
+            } else if ( step[lane] == 0 ) {                                                                              \
+                                                                                                                         \
+                terminateLane( batch , lane , "Error: Step cannot be 0.0 . Program will be terminated.\n" );             \
+                                                                                                                         \
+            }                                                                                                            \
+        }                                                                                                                \
+                                                                                                                         \
+        memcpy( running , mask , sizeof( running ) );                                                                    \
+                                                                                                                         \
+        while ( narrowMask( running , running , batch->alive ) ) {                                                       \
+                                                                                                                         \
+            unsigned char any = 0;                                                                                       \
+                                                                                                                         \
+            for ( lane = 0 ; lane < BATCH_LANES ; lane++ ) {                                                             \
+                                                                                                                         \
+                running[lane] &= step[lane] < 0 ? iterator[lane] >= until[lane] : iterator[lane] <= until[lane];         \
+                any           |= running[lane];                                                                          \
+                                                                                                                         \
+            }                                                                                                            \
+                                                                                                                         \
+            if ( !any ) {                                                                                                \
+                                                                                                                         \
+                break;                                                                                                   \
+                                                                                                                         \
+            }                                                                                                            \
+                                                                                                                         \
+            store##suffix( values , iterator , running );                                                                \
+                                                                                                                         \
+            resolveBatchTree( tree->doOptStmts , running , batch );                                                      \
+                                                                                                                         \
+            for ( lane = 0 ; lane < BATCH_LANES ; lane++ ) {                                                             \
+                                                                                                                         \
+                iterator[lane] = running[lane] ? (type) ( (wrapType) iterator[lane] + (wrapType) step[lane] ) : iterator[lane]; \
+                                                                                                                         \
+            }                                                                                                            \
+        }                                                                                                                \
+                                                                                                                         \
+        /*same adjustment as the scalar path: the iterator keeps the last value that met the condition*/                \
+        for ( lane = 0 ; lane < BATCH_LANES ; lane++ ) {                                                                 \
+                                                                                                                         \
+            if ( ACTIVE_LANE( mask , lane ) ) {                                                                          \
+                                                                                                                         \
+                values[lane] = (type) ( (wrapType) iterator[lane] - (wrapType) step[lane] );                             \
+                                                                                                                         \
+            }                                                                                                            \
+        }                                                                                                                \
+    }
+
+BATCH_FOR_LOOP( resolveBatchIntegerFor , int , unsigned int , evaluateBatchInteger , Integers , ALWAYS_FINITE )
+BATCH_FOR_LOOP( resolveBatchLongFor , long long , unsigned long long , evaluateBatchLong , Longs , ALWAYS_FINITE )
+BATCH_FOR_LOOP( resolveBatchFloatFor , float , float , evaluateBatchFloat , Floats , isfinite )
+BATCH_FOR_LOOP( resolveBatchDoubleFor , double , double , evaluateBatchDouble , Doubles , isfinite )
+
+/**
+ * @brief executes a read statement for the lanes of a mask, taking the next value of the record of every lane
+ */
+static void resolveBatchRead( Node *tree , const unsigned char *mask , Batch *batch ) {
+
+    Symbol *symbol = findSymbol( batch->symbolTable , tree->value.idValue );
+    int elements = symbol->length > 0 ? symbol->length : 1; //reading an array updates every element
+    int lane;
+
+    for ( lane = 0 ; lane < BATCH_LANES ; lane++ ) {
+
+        char *end;
+        int element;
+
+        if ( !ACTIVE_LANE( mask , lane ) ) {
+
+            continue;
+
+        }
+
+        fprintf( batch->outputs[lane] , "read value for %s: " , tree->value.idValue );
+
+        //a value that cannot be converted is not consumed, and 0 is assigned
+        for ( element = 0 ; element < elements ; element++ ) {
+
+            long offset = (long) element * BATCH_LANES + lane;
+
+            switch ( symbol->type ) {
+
+                case sINTEGER: ( (int *) batch->values[symbol->slot] )[offset] = (int) strtol( batch->input[lane] , &end , 10 ); break;
+                case sFLOAT: ( (float *) batch->values[symbol->slot] )[offset] = strtof( batch->input[lane] , &end ); break;
+                case sLONG: ( (long long *) batch->values[symbol->slot] )[offset] = strtoll( batch->input[lane] , &end , 10 ); break;
+                case sDOUBLE: ( (double *) batch->values[symbol->slot] )[offset] = strtod( batch->input[lane] , &end ); break;
+
+            }
+        }
+
+        batch->input[lane] = end;
+
+        fprintf( batch->outputs[lane] , "\n" );
+
+    }
+}
+
+/**
+ * @brief executes a print statement for the lanes of a mask
+ */
+static void resolveBatchPrint( Node *tree , const unsigned char *mask , Batch *batch ) {
+
+    int lane;
+
+    switch ( tree->expr->symbolType ) {
+
+        case sINTEGER: {
+
+            int value[BATCH_LANES];
+
+            evaluateBatchInteger( tree->expr , value , mask , batch );
+
+            for ( lane = 0 ; lane < BATCH_LANES ; lane++ ) {
+
+                if ( ACTIVE_LANE( mask , lane ) ) {
+
+                    fprintf( batch->outputs[lane] , "%d\n" , value[lane] );
+
+                }
+            }
+        }
+        break;
+
+        case sFLOAT: {
+
+            float value[BATCH_LANES];
+
+            evaluateBatchFloat( tree->expr , value , mask , batch );
+
+            for ( lane = 0 ; lane < BATCH_LANES ; lane++ ) {
+
+                if ( ACTIVE_LANE( mask , lane ) ) {
+
+                    fprintf( batch->outputs[lane] , "%f\n" , value[lane] );
+
+                }
+            }
+        }
+        break;
+
+        case sLONG: {
+
+            long long value[BATCH_LANES];
+
+            evaluateBatchLong( tree->expr , value , mask , batch );
+
+            for ( lane = 0 ; lane < BATCH_LANES ; lane++ ) {
+
+                if ( ACTIVE_LANE( mask , lane ) ) {
+
+                    fprintf( batch->outputs[lane] , "%lld\n" , value[lane] );
+
+                }
+            }
+        }
+        break;
+
+        case sDOUBLE: {
+
+            double value[BATCH_LANES];
+
+            evaluateBatchDouble( tree->expr , value , mask , batch );
+
+            for ( lane = 0 ; lane < BATCH_LANES ; lane++ ) {
+
+                if ( ACTIVE_LANE( mask , lane ) ) {
+
+                    fprintf( batch->outputs[lane] , "%f\n" , value[lane] );
+
+                }
+            }
+        }
+        break;
+
+    }
+}
+
+/**
+ * @brief obtains the size of a value of a type
+ */
+static size_t valueSize( SymbolType type ) {
+
+    return type == sLONG || type == sDOUBLE ? 8 : 4;
+
+}
+
+/**
+ * @brief executes a call for the lanes of a mask. The frame of the call gives the locals of the procedure lanes of their own, so
+ * the lanes of the locals of the call that made a recursive call are kept. The arguments are evaluated before the frame is entered
+ */
+static void resolveBatchCall( Node *tree , const unsigned char *mask , Batch *batch ) {
+
+    Node *procedure = tree->procedure;
+    Node *argument  = tree->arguments;
+    void *frame[procedure->localCount > 0 ? procedure->localCount : 1];
+    int index;
+
+    for ( index = 0 ; index < procedure->localCount ; index++ ) {
+
+        Symbol *local = procedure->locals[index];
+        size_t size   = BATCH_LANES * valueSize( local->type );
+
+        accountRuntimeMemory( size );
+
+        if ( ( frame[index] = aligned_alloc( SYMBOL_ARRAY_ALIGNMENT , size ) ) == NULL ) {
+
+            printf( "Error: Memory allocation failed. Program will be terminated\n" );
+            exit(1);
+
+        }
+
+        memset( frame[index] , 0 , size );
+
+        if ( index < procedure->parameterCount ) {
+
+            switch ( local->type ) {
+
+                case sINTEGER: evaluateBatchInteger( argument->expr , frame[index] , mask , batch ); break;
+                case sFLOAT: evaluateBatchFloat( argument->expr , frame[index] , mask , batch ); break;
+                case sLONG: evaluateBatchLong( argument->expr , frame[index] , mask , batch ); break;
+                case sDOUBLE: evaluateBatchDouble( argument->expr , frame[index] , mask , batch ); break;
+
+            }
+
+            argument = argument->nextArgument;
+
+        }
+    }
+
+    //the frame and the lanes of the caller are swapped on the way in and on the way out
+    for ( index = 0 ; index < procedure->localCount ; index++ ) {
+
+        void *caller = batch->values[procedure->locals[index]->slot];
+
+        batch->values[procedure->locals[index]->slot] = frame[index];
+        frame[index]                                  = caller;
+
+    }
+
+    resolveBatchTree( procedure->body , mask , batch );
+
+    for ( index = 0 ; index < procedure->localCount ; index++ ) {
+
+        releaseRuntimeMemory( BATCH_LANES * valueSize( procedure->locals[index]->type ) );
+        free( batch->values[procedure->locals[index]->slot] );
+
+        batch->values[procedure->locals[index]->slot] = frame[index];
+
+    }
+}
+
+/**
+ * @brief executes a statement other than a semicolon for the lanes of a mask
+ */
+static void resolveBatchStatement( Node *tree , const unsigned char *mask , Batch *batch ) {
+
+    unsigned char active[BATCH_LANES];
+
+    if ( !narrowMask( active , mask , batch->alive ) ) { //no lane reaches the statement
+
+        return;
+
+    }
+
+    switch ( tree->type ) {
+
+        case nASSIGNMENT:
+
+            resolveBatchAssignment( tree , active , batch );
+
+        break;
+
+        case nIF:
+
+            evaluateBatchCondition( tree->expresion , active , active , batch );
+            resolveBatchTree( tree->thenOptStmts , active , batch );
+
+        break;
+
+        case nWHILE: //the lanes whose condition is false stay inactive until every lane left the loop
+
+            for ( ;; ) {
+
+                evaluateBatchCondition( tree->expresion , active , active , batch );
+
+                if ( !narrowMask( active , active , batch->alive ) ) {
+
+                    break;
+
+                }
+
+                resolveBatchTree( tree->doOptStmts , active , batch );
+
+            }
+
+        break;
+
+        case nFOR:
+
+            switch ( tree->symbolType ) {
+
+                case sINTEGER: resolveBatchIntegerFor( tree , active , batch ); break;
+                case sFLOAT: resolveBatchFloatFor( tree , active , batch ); break;
+                case sLONG: resolveBatchLongFor( tree , active , batch ); break;
+                case sDOUBLE: resolveBatchDoubleFor( tree , active , batch ); break;
+
+            }
+
+        break;
+
+        case nREAD:
+
+            resolveBatchRead( tree , active , batch );
+
+        break;
+
+        case nPRINT:
+
+            resolveBatchPrint( tree , active , batch );
+
+        break;
+
+        case nCALL:
+
+            resolveBatchCall( tree , active , batch );
+
+        break;
+
+        default: //no statements
+        break;
+
+    }
+}
+
+/**
+ * @brief executes the statements of a tree for the lanes of a mask. Sequences are walked without a mask of their own, so long
+ * programs do not need one mask per statement on the stack
+ */
+static void resolveBatchTree( Node *tree , const unsigned char *mask , Batch *batch ) {
+
+    for ( ; tree != NULL && tree->type == nSEMICOLON ; tree = tree->rightStatement ) {
+
+        resolveBatchTree( tree->leftStatement , mask , batch );
+
+    }
+
+    if ( tree != NULL ) {
+
+        resolveBatchStatement( tree , mask , batch );
+
+    }
+}
+
+/**
+ * @brief reads a file into memory, followed by a null character
+ * @return the contents, NULL if the file cannot be read
+ */
+static char *readRecords( const char *fileName , size_t *length ) {
+
+    FILE *file = fopen( fileName , "rb" );
+    char *text = NULL;
+    size_t capacity = 0;
+    size_t count;
+
+    if ( file == NULL ) {
+
+        return NULL;
+
+    }
+
+    *length = 0;
+
+    do {
+
+        if ( *length + 1 >= capacity ) {
+
+            capacity = capacity == 0 ? 65536 : 2 * capacity;
+            text     = realloc( text , capacity );
+
+            if ( text == NULL ) {
+
+                printf( "Error: Memory allocation failed. Program will be terminated\n" );
+                exit(1);
+
+            }
+        }
+
+        count    = fread( text + *length , 1 , capacity - *length - 1 , file );
+        *length += count;
+
+    } while ( count > 0 );
+
+    fclose( file );
+
+    text[*length] = '\0';
+
+    return text;
+
+}
+
+int resolveBatch( Node *tree , Symbol **symbolTable , const char *fileName , FILE *output ) {
+
+    Batch batch;
+    unsigned char mask[BATCH_LANES];
+    size_t length;
+    char *records = readRecords( fileName , &length );
+    char *record;
+    int slotCount = getSlotCount( symbolTable );
+    int recordIndex = 0;
+    Symbol *symbol;
+    int lane;
+
+    if ( records == NULL ) {
+
+        return -1;
+
+    }
+
+    memset( &batch , 0 , sizeof( Batch ) );
+
+    batch.symbolTable = symbolTable;
+    batch.values      = calloc( slotCount > 0 ? slotCount : 1 , sizeof( void * ) );
+
+    if ( batch.values == NULL ) {
+
+        printf( "Error: Memory allocation failed. Program will be terminated\n" );
+        exit(1);
+
+    }
+
+    for ( symbol = *symbolTable ; symbol != NULL ; symbol = symbol->next ) {
+
+        size_t size = ( symbol->length > 0 ? symbol->length : 1 ) * BATCH_LANES * valueSize( symbol->type );
+
+        accountRuntimeMemory( size );
+
+        if ( ( batch.values[symbol->slot] = aligned_alloc( SYMBOL_ARRAY_ALIGNMENT , size ) ) == NULL ) {
+
+            printf( "Error: Memory allocation failed. Program will be terminated\n" );
+            exit(1);
+
+        }
+    }
+
+    //every line is a record, a last line without characters is not
+    for ( record = records ; record < records + length ; ) {
+
+        for ( lane = 0 ; lane < BATCH_LANES && record < records + length ; lane++ ) {
+
+            char *end = strchr( record , '\n' );
+
+            if ( end != NULL ) {
+
+                *end = '\0';
+
+            }
+
+            batch.input[lane]   = record;
+            batch.alive[lane]   = 1;
+            batch.outputs[lane] = open_memstream( &batch.outputTexts[lane] , &batch.outputLengths[lane] );
+
+            record = end != NULL ? end + 1 : records + length;
+
+        }
+
+        for ( ; lane < BATCH_LANES ; lane++ ) {
+
+            batch.alive[lane]   = 0;
+            batch.outputs[lane] = NULL;
+
+        }
+
+        //every record starts with the symbols set to 0
+        for ( symbol = *symbolTable ; symbol != NULL ; symbol = symbol->next ) {
+
+            memset( batch.values[symbol->slot] , 0 , ( symbol->length > 0 ? symbol->length : 1 ) * BATCH_LANES * valueSize( symbol->type ) );
+
+        }
+
+        memcpy( mask , batch.alive , sizeof( mask ) );
+
+        resolveBatchTree( tree , mask , &batch );
+
+        //the outputs are demultiplexed in the order of the records
+        for ( lane = 0 ; lane < BATCH_LANES && batch.outputs[lane] != NULL ; lane++ ) {
+
+            fclose( batch.outputs[lane] );
+
+            fprintf( output , "--- record %d\n" , recordIndex++ );
+            fwrite( batch.outputTexts[lane] , 1 , batch.outputLengths[lane] , output );
+
+            free( batch.outputTexts[lane] );
+
+        }
+    }
+
+    for ( symbol = *symbolTable ; symbol != NULL ; symbol = symbol->next ) {
+
+        releaseRuntimeMemory( ( symbol->length > 0 ? symbol->length : 1 ) * BATCH_LANES * valueSize( symbol->type ) );
+        free( batch.values[symbol->slot] );
+
+    }
+
+    free( batch.values );
+    free( records );
+
+    return batch.failed;
+
+}
+
+//end batch.c
@@ -0,0 +1,35 @@
+/**
+ * batch.h
+ * Definition of the batch execution, which runs a program once for every record of an input file in a single pass. Every symbol
+ * holds one value per record, the operations are computed for all the records at once and the conditions of if, while and for
+ * statements become masks of the records that take the branch
+ * @author Jose Pablo Ortiz Lack
+ */
+#ifndef __BATCH_H__
+#define __BATCH_H__
+
+#include <stdio.h>
+
+#include "symbolTable.h"
+#include "syntaxTree.h"
+
+/**
+ * @brief number of records executed together by a pass of the tree
+ */
+#define BATCH_LANES 256
+
+/**
+ * @brief executes a program for every line of an input file. The values of the read statements of a record are taken in order
+ * from its line, and a read without a value assigns 0. The output of every record, prompts and errors included, is written after
+ * a "--- record n" line in the order of the records. A record whose execution ends with an error does not stop the others
+ * @param tree tree of the program
+ * @param symbolTable the symbolTable of the compiler
+ * @param fileName file with one record per line
+ * @param output stream where the output of the records is written
+ * @return the number of records that ended with an error, -1 if the file cannot be read
+ */
+int resolveBatch( Node *tree , Symbol **symbolTable , const char *fileName , FILE *output );
+
+#endif //__BATCH_H__
+
+//end batch.h
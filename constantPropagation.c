@@ -0,0 +1,993 @@
+/**
+ * constantPropagation.c
+ * Implementation of the sparse conditional constant propagation
+ *
+ * The facts of the symbols are kept per slot in a state that flows through the statements. Loops are visited until the state at
+ * their entry is stable without rewriting anything, and then once more to rewrite their body with the facts of that state, so the
+ * tree is only changed with facts that hold for every iteration. A copy remembers the assignment of its source it was made from
+ * and is valid while the source keeps it, so assigning a symbol does not need to find the copies made from it
+ * @author Jose Pablo Ortiz Lack
+ */
+#include "constantPropagation.h"
+#include "syntaxTree.h"
+#include "symbolTable.h"
+#include "vectorLoop.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+int constantPropagationEnabled = 1;
+
+int constantPropagationReportEnabled = 0;
+
+/**
+ * @brief what is known of the value of a symbol
+ */
+typedef enum tagConstantKind {
+
+    kCONSTANT, //the symbol has the same value on every path that reaches the statement
+    kVARYING //the value depends on the path, the input or a call
+
+} ConstantKind;
+
+/**
+ * @brief the value of a constant, the bytes not used by its type are 0 so two values are compared as bytes
+ */
+typedef union tagConstantValue {
+
+    int iValue;
+    float fValue;
+    long long lValue;
+    double dValue;
+
+} ConstantValue;
+
+/**
+ * @brief the facts of a symbol at a statement
+ */
+typedef struct tagSymbolFact {
+
+    ConstantKind kind;
+    ConstantValue value; //value of a constant symbol
+
+    int copyOf; //slot of the symbol this one is a copy of, -1 if it is not a copy
+    unsigned int copiedAt; //assignment of the source when the copy was made
+    unsigned int assignedAt; //assignment that gave the symbol its value
+
+} SymbolFact;
+
+/**
+ * @brief the facts of every symbol at a statement
+ */
+typedef struct tagConstantState {
+
+    SymbolFact *facts; //facts indexed by slot
+    int reachable; //0 if no path of the program reaches the statement
+
+} ConstantState;
+
+/**
+ * @brief the state shared by the constant propagation functions
+ */
+typedef struct tagConstantContext {
+
+    Symbol **symbolTable; //the symbolTable of the compiler
+    Symbol **symbols; //symbols of the table indexed by slot
+    int slotCount; //number of slots of the table
+    unsigned int clock; //advances with every assignment
+    int *copies; //copies kept by the merge of two states, indexed by slot
+
+    int rewriting; //0 while a loop is visited until its entry is stable, 1 while the tree is rewritten
+
+    int replaced; //reads of constant symbols replaced by literals
+    int folded; //operations replaced by literals
+    int forwarded; //reads of copies replaced by reads of their source
+    int removed; //if and while statements removed or replaced by their body
+
+} ConstantContext;
+
+/**
+ * @brief Allocates memory for the constant propagation
+ * @param size number of bytes
+ * @return the memory, the program will terminate if there is not enough memory
+ */
+static void *allocateConstantMemory( size_t size ) {
+
+    void *memory = malloc( size > 0 ? size : 1 );
+
+    if ( memory == NULL ) {
+
+        printf( "Error: Memory allocation failed. Program will be terminated\n" );
+        exit(1);
+
+    }
+
+    return memory;
+}
+
+/**
+ * @brief creates a state where every symbol is the constant 0, as when a program starts
+ */
+static ConstantState createState( ConstantContext *context ) {
+
+    ConstantState state;
+    int slot;
+
+    state.facts     = allocateConstantMemory( context->slotCount * sizeof( SymbolFact ) );
+    state.reachable = 1;
+
+    memset( state.facts , 0 , context->slotCount * sizeof( SymbolFact ) );
+
+    for ( slot = 0 ; slot < context->slotCount ; slot++ ) {
+
+        state.facts[slot].copyOf = -1;
+
+    }
+
+    return state;
+}
+
+static ConstantState copyState( ConstantState *state , ConstantContext *context ) {
+
+    ConstantState copy;
+
+    copy.facts     = allocateConstantMemory( context->slotCount * sizeof( SymbolFact ) );
+    copy.reachable = state->reachable;
+
+    memcpy( copy.facts , state->facts , context->slotCount * sizeof( SymbolFact ) );
+
+    return copy;
+}
+
+/**
+ * @brief obtains the slot of the symbol a symbol is a copy of
+ * @return the slot of the source, -1 if the symbol is not a copy or its source was assigned since
+ */
+static int validCopy( ConstantState *state , int slot ) {
+
+    SymbolFact *fact = &state->facts[slot];
+
+    return fact->copyOf >= 0 && fact->copiedAt == state->facts[fact->copyOf].assignedAt ? fact->copyOf : -1;
+
+}
+
+/**
+ * @brief records the assignment of a symbol
+ * @param known 1 if the value assigned is the constant value
+ * @param source slot of the symbol whose value is copied, -1 if the value is not a copy
+ */
+static void assignFact( ConstantState *state , int slot , int known , ConstantValue value , int source , ConstantContext *context ) {
+
+    SymbolFact *fact = &state->facts[slot];
+
+    fact->kind       = known ? kCONSTANT : kVARYING;
+    fact->value      = value;
+    fact->assignedAt = ++context->clock;
+    fact->copyOf     = known || source == slot ? -1 : source;
+    fact->copiedAt   = fact->copyOf >= 0 ? state->facts[source].assignedAt : 0;
+
+}
+
+/**
+ * @brief records the assignment of a symbol with a value that is not known
+ */
+static void varyFact( ConstantState *state , int slot , ConstantContext *context ) {
+
+    ConstantValue unknown = { 0 };
+
+    assignFact( state , slot , 0 , unknown , -1 , context );
+
+}
+
+/**
+ * @brief merges the state of another path into a state: a symbol stays constant or a copy only if it is on both paths
+ * @return 1 if a fact of the state changed
+ */
+static int mergeStates( ConstantState *state , ConstantState *other , ConstantContext *context ) {
+
+    int changed = 0;
+    int slot;
+
+    if ( !other->reachable ) {
+
+        return 0;
+
+    }
+
+    if ( !state->reachable ) {
+
+        memcpy( state->facts , other->facts , context->slotCount * sizeof( SymbolFact ) );
+        state->reachable = 1;
+
+        return 1;
+
+    }
+
+    //the copies are found before the assignments of their sources are merged
+    for ( slot = 0 ; slot < context->slotCount ; slot++ ) {
+
+        int copy = validCopy( state , slot );
+
+        context->copies[slot] = copy == validCopy( other , slot ) ? copy : -1;
+
+        changed |= context->copies[slot] != copy;
+
+    }
+
+    for ( slot = 0 ; slot < context->slotCount ; slot++ ) {
+
+        SymbolFact *fact = &state->facts[slot];
+
+        if ( fact->kind == kCONSTANT &&
+             ( other->facts[slot].kind != kCONSTANT || memcmp( &fact->value , &other->facts[slot].value , sizeof( ConstantValue ) ) != 0 ) ) {
+
+            memset( &fact->value , 0 , sizeof( ConstantValue ) );
+
+            fact->kind = kVARYING;
+            changed    = 1;
+
+        }
+
+        //a symbol assigned differently by the paths has a new value where they join
+        if ( fact->assignedAt != other->facts[slot].assignedAt ) {
+
+            fact->assignedAt = ++context->clock;
+
+        }
+    }
+
+    for ( slot = 0 ; slot < context->slotCount ; slot++ ) {
+
+        state->facts[slot].copyOf   = context->copies[slot];
+        state->facts[slot].copiedAt = context->copies[slot] >= 0 ? state->facts[context->copies[slot]].assignedAt : 0;
+
+    }
+
+    return changed;
+}
+
+/**
+ * @brief obtains the value of a literal, widened literals have the value of their type
+ */
+static ConstantValue literalValue( Node *literal ) {
+
+    ConstantValue value = { 0 };
+
+    switch ( literal->symbolType ) {
+
+        case sINTEGER: value.iValue = literal->value.iValue; break;
+        case sFLOAT:   value.fValue = literal->value.fValue; break;
+        case sLONG:    value.lValue = literal->value.lValue; break;
+        case sDOUBLE:  value.dValue = literal->value.dValue; break;
+
+    }
+
+    return value;
+}
+
+/**
+ * @brief creates the literal of a constant value
+ */
+static Node *createConstant( SymbolType type , ConstantValue value , int line ) {
+
+    Node *literal = NULL;
+
+    switch ( type ) {
+
+        case sINTEGER: literal = createInteger( value.iValue ); break;
+        case sFLOAT:   literal = createFloat( value.fValue ); break;
+        case sLONG:    literal = createLong( value.lValue ); break;
+        case sDOUBLE:  literal = createDouble( value.dValue ); break;
+
+    }
+
+    literal->line = line;
+
+    return literal;
+}
+
+/**
+ * @brief calculates an operation of two constants as evaluateIntegerOperation and the other evaluations do
+ * @return 1 if the operation was calculated, 0 if it fails at run time and must be kept
+ */
+static int foldOperation( OperationType operationType , SymbolType type , ConstantValue left , ConstantValue right , ConstantValue *result ) {
+
+    int overflow = 0;
+
+    memset( result , 0 , sizeof( ConstantValue ) );
+
+    switch ( type ) {
+
+        case sINTEGER:
+
+            switch ( operationType ) {
+
+                case oSUM:  overflow = __builtin_add_overflow( left.iValue , right.iValue , &result->iValue ); break;
+                case oSUB:  overflow = __builtin_sub_overflow( left.iValue , right.iValue , &result->iValue ); break;
+                case oMULT: overflow = __builtin_mul_overflow( left.iValue , right.iValue , &result->iValue ); break;
+
+                case oDIV:
+
+                    if ( right.iValue == 0 ) {
+
+                        return 0;
+
+                    }
+
+                    if ( right.iValue == -1 ) { //the smallest integer divided by -1 overflows
+
+                        overflow = __builtin_sub_overflow( 0 , left.iValue , &result->iValue );
+
+                    } else {
+
+                        result->iValue = left.iValue / right.iValue;
+
+                    }
+
+                break;
+
+                default: return 0;
+
+            }
+
+        break;
+
+        case sLONG:
+
+            switch ( operationType ) {
+
+                case oSUM:  overflow = __builtin_add_overflow( left.lValue , right.lValue , &result->lValue ); break;
+                case oSUB:  overflow = __builtin_sub_overflow( left.lValue , right.lValue , &result->lValue ); break;
+                case oMULT: overflow = __builtin_mul_overflow( left.lValue , right.lValue , &result->lValue ); break;
+
+                case oDIV:
+
+                    if ( right.lValue == 0 ) {
+
+                        return 0;
+
+                    }
+
+                    if ( right.lValue == -1 ) {
+
+                        overflow = __builtin_sub_overflow( 0 , left.lValue , &result->lValue );
+
+                    } else {
+
+                        result->lValue = left.lValue / right.lValue;
+
+                    }
+
+                break;
+
+                default: return 0;
+
+            }
+
+        break;
+
+        case sFLOAT:
+
+            switch ( operationType ) {
+
+                case oSUM:  result->fValue = left.fValue + right.fValue; break;
+                case oSUB:  result->fValue = left.fValue - right.fValue; break;
+                case oMULT: result->fValue = left.fValue * right.fValue; break;
+                case oDIV:  result->fValue = left.fValue / right.fValue; break;
+                default: return 0;
+
+            }
+
+        break;
+
+        case sDOUBLE:
+
+            switch ( operationType ) {
+
+                case oSUM:  result->dValue = left.dValue + right.dValue; break;
+                case oSUB:  result->dValue = left.dValue - right.dValue; break;
+                case oMULT: result->dValue = left.dValue * right.dValue; break;
+                case oDIV:  result->dValue = left.dValue / right.dValue; break;
+                default: return 0;
+
+            }
+
+        break;
+
+    }
+
+    return !( overflow && overflowTrapEnabled );
+
+}
+
+/**
+ * @brief finds the value of an expresion and, while rewriting, replaces its constant parts by literals and its copies by their
+ * sources. The expresions that change are built again, the nodes of the tree are not modified
+ * @param expr expresion to be propagated, NULL if the statement has none
+ * @param known set to 1 if the value of the expresion is constant
+ * @param value set to the value of a constant expresion
+ * @return the expresion to be evaluated instead
+ */
+static Node *propagateExpresion( Node *expr , ConstantState *state , ConstantContext *context , int *known , ConstantValue *value ) {
+
+    Node *leftOperand;
+    Node *rightOperand;
+    ConstantValue left;
+    ConstantValue right;
+    int leftKnown;
+    int rightKnown;
+
+    *known = 0;
+
+    if ( expr == NULL ) {
+
+        return NULL;
+
+    }
+
+    if ( expr->type == nVALUE ) {
+
+        switch ( expr->operationType ) {
+
+            case oID: {
+
+                Symbol *symbol = findSymbol( context->symbolTable , expr->value.idValue );
+                int source;
+
+                if ( symbol->length > 0 ) {
+
+                    return expr;
+
+                }
+
+                if ( state->facts[symbol->slot].kind == kCONSTANT ) {
+
+                    *known = 1;
+                    *value = state->facts[symbol->slot].value;
+
+                    if ( context->rewriting ) {
+
+                        context->replaced++;
+
+                        return createConstant( expr->symbolType , *value , expr->line );
+
+                    }
+
+                } else if ( context->rewriting && ( source = validCopy( state , symbol->slot ) ) >= 0 ) {
+
+                    Node *copy = createSymbol( context->symbols[source]->identifier , context->symbolTable );
+
+                    copy->line = expr->line;
+
+                    context->forwarded++;
+
+                    return copy;
+
+                }
+
+                return expr;
+            }
+
+            case oINDEX: {
+
+                Node *index = propagateExpresion( expr->indexExpr , state , context , &leftKnown , &left );
+
+                if ( index != expr->indexExpr ) {
+
+                    expr = copyNode( expr );
+                    expr->indexExpr = index;
+
+                }
+
+                return expr;
+            }
+
+            default:
+
+                *known = 1;
+                *value = literalValue( expr );
+
+                return expr;
+
+        }
+    }
+
+    if ( expr->type != nOPERATION || expr->operationType == oKEEP || expr->operationType == oREUSE ) {
+
+        return expr;
+
+    }
+
+    leftOperand  = propagateExpresion( expr->leftOperand , state , context , &leftKnown , &left );
+    rightOperand = propagateExpresion( expr->rightOperand , state , context , &rightKnown , &right );
+
+    if ( leftKnown && rightKnown && foldOperation( expr->operationType , expr->symbolType , left , right , value ) ) {
+
+        *known = 1;
+
+        if ( context->rewriting ) {
+
+            context->folded++;
+
+            return createConstant( expr->symbolType , *value , expr->line );
+
+        }
+
+        return expr;
+
+    }
+
+    if ( leftOperand != expr->leftOperand || rightOperand != expr->rightOperand ) {
+
+        Node *operation = createOperation( expr->operationType , leftOperand , rightOperand , NULL );
+
+        operation->line = expr->line;
+
+        return operation;
+
+    }
+
+    return expr;
+
+}
+
+/**
+ * @brief compares two constants as evaluateExpresion does
+ */
+static int compareConstants( ExpresionType expresionType , SymbolType type , ConstantValue left , ConstantValue right ) {
+
+    switch ( type ) {
+
+        case sINTEGER:
+
+            return expresionType == eGREATER_THAN ? left.iValue > right.iValue :
+                   expresionType == eLESS_THAN ? left.iValue < right.iValue : left.iValue == right.iValue;
+
+        case sFLOAT:
+
+            return expresionType == eGREATER_THAN ? left.fValue > right.fValue :
+                   expresionType == eLESS_THAN ? left.fValue < right.fValue : left.fValue == right.fValue;
+
+        case sLONG:
+
+            return expresionType == eGREATER_THAN ? left.lValue > right.lValue :
+                   expresionType == eLESS_THAN ? left.lValue < right.lValue : left.lValue == right.lValue;
+
+        default:
+
+            return expresionType == eGREATER_THAN ? left.dValue > right.dValue :
+                   expresionType == eLESS_THAN ? left.dValue < right.dValue : left.dValue == right.dValue;
+
+    }
+}
+
+/**
+ * @brief propagates the operands of a condition
+ * @return 1 if the condition is always true, 0 if it is always false, -1 if it is not known
+ */
+static int propagateCondition( Node *expresion , ConstantState *state , ConstantContext *context ) {
+
+    ConstantValue left;
+    ConstantValue right;
+    int leftKnown;
+    int rightKnown;
+    Node *leftOperand  = propagateExpresion( expresion->leftOperand , state , context , &leftKnown , &left );
+    Node *rightOperand = propagateExpresion( expresion->rightOperand , state , context , &rightKnown , &right );
+
+    if ( context->rewriting ) {
+
+        expresion->leftOperand  = leftOperand;
+        expresion->rightOperand = rightOperand;
+
+    }
+
+    return leftKnown && rightKnown ? compareConstants( expresion->expresionType , expresion->symbolType , left , right ) : -1;
+
+}
+
+/**
+ * @brief propagates the arguments of a call
+ */
+static void propagateArguments( Node *argument , ConstantState *state , ConstantContext *context ) {
+
+    ConstantValue value;
+    int known;
+
+    for ( ; argument != NULL ; argument = argument->nextArgument ) {
+
+        Node *expr = propagateExpresion( argument->expr , state , context , &known , &value );
+
+        if ( context->rewriting ) {
+
+            argument->expr = expr;
+
+        }
+    }
+}
+
+static Node *propagateStatement( Node *tree , ConstantState *state , ConstantContext *context );
+
+/**
+ * @brief propagates a while loop: its body is visited from the entry state until the state that reaches the condition again
+ * adds nothing to it
+ * @return the loop, NULL while rewriting if the body is never executed
+ */
+static Node *propagateWhile( Node *tree , ConstantState *state , ConstantContext *context ) {
+
+    int rewriting = context->rewriting;
+    int condition;
+
+    context->rewriting = 0;
+
+    while ( ( condition = propagateCondition( tree->expresion , state , context ) ) != 0 ) {
+
+        ConstantState body = copyState( state , context );
+        int changed;
+
+        propagateStatement( tree->doOptStmts , &body , context );
+
+        changed = mergeStates( state , &body , context );
+
+        free( body.facts );
+
+        if ( !changed ) {
+
+            break;
+
+        }
+    }
+
+    context->rewriting = rewriting;
+
+    if ( rewriting ) {
+
+        condition = propagateCondition( tree->expresion , state , context );
+
+        if ( condition == 0 ) {
+
+            context->removed++;
+
+            return NULL;
+
+        }
+
+        {
+            ConstantState body = copyState( state , context );
+
+            tree->doOptStmts = propagateStatement( tree->doOptStmts , &body , context );
+
+            free( body.facts );
+        }
+    }
+
+    //a condition true on every iteration never lets the loop end
+    if ( condition == 1 ) {
+
+        state->reachable = 0;
+
+    }
+
+    return tree;
+
+}
+
+/**
+ * @brief propagates a for loop. The loop assigns its iterator before every iteration and after the last one, so the iterator
+ * varies in the body and after the loop
+ */
+static Node *propagateFor( Node *tree , ConstantState *state , ConstantContext *context ) {
+
+    int slot      = findSymbol( context->symbolTable , tree->value.idValue )->slot;
+    int rewriting = context->rewriting;
+    int changes   = context->replaced + context->folded + context->forwarded + context->removed;
+    ConstantValue value;
+    int known;
+    Node *start = propagateExpresion( tree->expr , state , context , &known , &value );
+    Node *step  = propagateExpresion( tree->stepExpr , state , context , &known , &value );
+    Node *until = propagateExpresion( tree->untilExpr , state , context , &known , &value );
+
+    if ( rewriting ) {
+
+        tree->expr      = start;
+        tree->stepExpr  = step;
+        tree->untilExpr = until;
+
+    }
+
+    varyFact( state , slot , context );
+
+    context->rewriting = 0;
+
+    while ( 1 ) {
+
+        ConstantState body = copyState( state , context );
+        int changed;
+
+        varyFact( &body , slot , context );
+        propagateStatement( tree->doOptStmts , &body , context );
+
+        changed = mergeStates( state , &body , context );
+
+        free( body.facts );
+
+        if ( !changed ) {
+
+            break;
+
+        }
+    }
+
+    context->rewriting = rewriting;
+
+    if ( rewriting ) {
+
+        ConstantState body = copyState( state , context );
+
+        varyFact( &body , slot , context );
+
+        tree->doOptStmts = propagateStatement( tree->doOptStmts , &body , context );
+
+        free( body.facts );
+
+        //the plan of a body with new literals is built again, the literals are cheaper than the invariants they replace
+        if ( changes != context->replaced + context->folded + context->forwarded + context->removed ) {
+
+            tree->vectorLoop = createVectorLoop( tree );
+
+        }
+    }
+
+    varyFact( state , slot , context );
+
+    return tree;
+
+}
+
+/**
+ * @brief propagates the statements of a tree in the order they are executed, updating the state
+ * @return the statement to be executed instead, NULL while rewriting if the statement was removed
+ */
+static Node *propagateStatement( Node *tree , ConstantState *state , ConstantContext *context ) {
+
+    ConstantValue value;
+    int known;
+
+    if ( tree == NULL || !state->reachable ) {
+
+        return tree;
+
+    }
+
+    switch ( tree->type ) {
+
+        case nSEMICOLON: {
+
+            Node *left  = propagateStatement( tree->leftStatement , state , context );
+            Node *right = propagateStatement( tree->rightStatement , state , context );
+
+            if ( left == NULL || right == NULL ) {
+
+                return left == NULL ? right : left;
+
+            }
+
+            tree->leftStatement  = left;
+            tree->rightStatement = right;
+
+        }
+
+        break;
+
+        case nASSIGNMENT: {
+
+            Symbol *symbol = findSymbol( context->symbolTable , tree->value.idValue );
+            Node *expr     = tree->expr;
+            int source     = -1;
+
+            //the index of an element is evaluated before the value assigned
+            Node *index    = propagateExpresion( tree->indexExpr , state , context , &known , &value );
+            Node *assigned = propagateExpresion( tree->expr , state , context , &known , &value );
+
+            if ( context->rewriting ) {
+
+                tree->indexExpr = index;
+                tree->expr      = assigned;
+
+            }
+
+            if ( symbol->length > 0 ) { //the elements of the arrays are not followed
+
+                break;
+
+            }
+
+            if ( expr->type == nVALUE && expr->operationType == oID ) {
+
+                Symbol *copied = findSymbol( context->symbolTable , expr->value.idValue );
+
+                source = validCopy( state , copied->slot );
+
+                if ( source < 0 ) {
+
+                    source = copied->slot;
+
+                }
+            }
+
+            assignFact( state , symbol->slot , known , value , source , context );
+
+        }
+
+        break;
+
+        case nPRINT: {
+
+            Node *expr = propagateExpresion( tree->expr , state , context , &known , &value );
+
+            if ( context->rewriting ) {
+
+                tree->expr = expr;
+
+            }
+
+        }
+
+        break;
+
+        case nREAD:
+
+            varyFact( state , findSymbol( context->symbolTable , tree->value.idValue )->slot , context );
+
+        break;
+
+        case nCALL: { //the procedure may assign any symbol
+
+            int slot;
+
+            propagateArguments( tree->arguments , state , context );
+
+            for ( slot = 0 ; slot < context->slotCount ; slot++ ) {
+
+                varyFact( state , slot , context );
+
+            }
+
+        }
+
+        break;
+
+        case nIF: {
+
+            int condition = propagateCondition( tree->expresion , state , context );
+
+            if ( condition == 1 ) {
+
+                Node *body = propagateStatement( tree->thenOptStmts , state , context );
+
+                if ( context->rewriting ) {
+
+                    context->removed++;
+
+                    return body;
+
+                }
+
+            } else if ( condition == 0 ) {
+
+                if ( context->rewriting ) {
+
+                    context->removed++;
+
+                    return NULL;
+
+                }
+
+            } else {
+
+                ConstantState body = copyState( state , context );
+                Node *then = propagateStatement( tree->thenOptStmts , &body , context );
+
+                if ( context->rewriting ) {
+
+                    tree->thenOptStmts = then;
+
+                }
+
+                mergeStates( state , &body , context );
+
+                free( body.facts );
+
+            }
+        }
+
+        break;
+
+        case nWHILE:
+
+            return propagateWhile( tree , state , context );
+
+        case nFOR:
+
+            return propagateFor( tree , state , context );
+
+        default:
+
+        break;
+
+    }
+
+    return tree;
+
+}
+
+int propagateConstants( Node **tree , Symbol **symbolTable ) {
+
+    ConstantContext context = { 0 };
+    ConstantState state;
+    Symbol *symbol;
+
+    context.symbolTable = symbolTable;
+    context.slotCount   = getSlotCount( symbolTable );
+    context.symbols     = allocateConstantMemory( context.slotCount * sizeof( Symbol * ) );
+    context.copies      = allocateConstantMemory( context.slotCount * sizeof( int ) );
+    context.rewriting   = 1;
+
+    for ( symbol = *symbolTable ; symbol != NULL ; symbol = symbol->next ) {
+
+        context.symbols[symbol->slot] = symbol;
+
+    }
+
+    //a procedure is called with any values of the globals and its parameters, the other locals start as 0
+    for ( symbol = *symbolTable ; symbol != NULL ; symbol = symbol->next ) {
+
+        if ( symbol->procedure != NULL ) {
+
+            Node *procedure = symbol->procedure;
+            int slot;
+            int index;
+
+            state = createState( &context );
+
+            for ( slot = 0 ; slot < context.slotCount ; slot++ ) {
+
+                varyFact( &state , slot , &context );
+
+            }
+
+            for ( index = procedure->parameterCount ; index < procedure->localCount ; index++ ) {
+
+                ConstantValue zero = { 0 };
+
+                assignFact( &state , procedure->locals[index]->slot , 1 , zero , -1 , &context );
+
+            }
+
+            procedure->body = propagateStatement( procedure->body , &state , &context );
+
+            free( state.facts );
+
+        }
+    }
+
+    state = createState( &context );
+
+    *tree = propagateStatement( *tree , &state , &context );
+
+    free( state.facts );
+    free( context.symbols );
+    free( context.copies );
+
+    if ( constantPropagationReportEnabled ) {
+
+        fprintf( stderr , "Constant propagation: %d symbols replaced by literals, %d operations folded, %d copies forwarded, %d branches removed\n" ,
+                 context.replaced , context.folded , context.forwarded , context.removed );
+
+    }
+
+    return context.replaced + context.folded + context.forwarded + context.removed;
+
+}
+
+//end constantPropagation.c
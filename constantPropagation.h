@@ -0,0 +1,44 @@
+/**
+ * constantPropagation.h
+ * Definition of the sparse conditional constant propagation, which replaces the symbols whose value is known where they are read
+ * by literals, forwards the copies of symbols and removes the branches whose condition is known
+ * @author Jose Pablo Ortiz Lack
+ */
+#ifndef __CONSTANT_PROPAGATION_H__
+#define __CONSTANT_PROPAGATION_H__
+
+#include "symbolTable.h"
+#include "syntaxTree.h"
+
+/**
+ * @brief propagates the constants of the programs before they are executed, 1 by default
+ */
+extern int constantPropagationEnabled;
+
+/**
+ * @brief prints the symbols replaced by literals, the operations folded, the copies forwarded and the branches removed
+ */
+extern int constantPropagationReportEnabled;
+
+/**
+ * @brief follows the values of the scalar symbols through the statements in the order they are executed. Every symbol starts as
+ * the constant 0 and an assignment makes it constant if its value is made only of literals and constant symbols. A read, a call,
+ * which may assign any symbol, and the iterator of a for loop make symbols vary. Where the paths of an if statement join, or the
+ * back edge of a loop meets its entry, a symbol stays constant only if it has the same value on every path; loops are visited again
+ * until their entry no longer changes. Conditions are evaluated with the constants, so the body of an if whose condition is false
+ * is never visited and does not spoil the symbols after it.
+ * Once the facts are known the reads of constant symbols are replaced by literals and their operations are folded, except the
+ * operations that fail at run time, which are kept so the program fails as before: divisions by 0 and, in trapping mode, overflows.
+ * A symbol that holds a copy of another one, y := x, is read from x while neither is assigned again. An if whose condition is true
+ * is replaced by its body, and an if whose condition is false, or a while whose condition is false when it is reached, is removed.
+ * The bodies of the procedures are propagated too, their locals start as 0 and their parameters and the globals vary.
+ * Operations shared by the parse are never modified, the operations that contain a replaced operand are built again
+ * @param tree reference to the tree of the program, which is replaced if its statements are removed
+ * @param symbolTable the symbolTable of the compiler
+ * @return the number of symbols replaced, operations folded, copies forwarded and branches removed
+ */
+int propagateConstants( Node **tree , Symbol **symbolTable );
+
+#endif //__CONSTANT_PROPAGATION_H__
+
+//end constantPropagation.h
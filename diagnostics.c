@@ -0,0 +1,179 @@
+/**
+ * diagnostics.c
+ * Implementation of the list of errors found while compiling a program
+ * @author Jose Pablo Ortiz Lack
+ */
+#include "diagnostics.h"
+
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+
+_Thread_local int diagnosticCount = 0;
+
+_Thread_local int diagnosticLine = 1;
+
+_Thread_local int diagnosticColumn = 1;
+
+static _Thread_local Diagnostic *firstDiagnostic = NULL; //errors in the order they were reported
+
+static _Thread_local Diagnostic *lastDiagnostic = NULL;
+
+/**
+ * @brief adds an error to the end of the list
+ */
+static void appendDiagnostic( int line , int column , const char *format , va_list arguments ) {
+
+    Diagnostic *diagnostic = malloc( sizeof( Diagnostic ) );
+    va_list copy;
+    int length;
+
+    va_copy( copy , arguments );
+    length = vsnprintf( NULL , 0 , format , copy );
+    va_end( copy );
+
+    if ( diagnostic == NULL || length < 0 || ( diagnostic->message = malloc( length + 1 ) ) == NULL ) {
+
+        printf( "Error: Memory allocation failed. Program will be terminated\n" );
+        exit(1);
+
+    }
+
+    vsnprintf( diagnostic->message , length + 1 , format , arguments );
+
+    diagnostic->line   = line;
+    diagnostic->column = column;
+    diagnostic->next   = NULL;
+
+    if ( lastDiagnostic == NULL ) {
+
+        firstDiagnostic = diagnostic;
+
+    } else {
+
+        lastDiagnostic->next = diagnostic;
+
+    }
+
+    lastDiagnostic = diagnostic;
+
+    diagnosticCount++;
+
+}
+
+void reportDiagnostic( int line , int column , const char *format , ... ) {
+
+    va_list arguments;
+
+    va_start( arguments , format );
+    appendDiagnostic( line , column , format , arguments );
+    va_end( arguments );
+
+}
+
+void reportError( const char *format , ... ) {
+
+    va_list arguments;
+
+    va_start( arguments , format );
+    appendDiagnostic( diagnosticLine , diagnosticColumn , format , arguments );
+    va_end( arguments );
+
+}
+
+/**
+ * @brief orders two errors by line and column, keeping the order they were reported in if both match
+ */
+static int compareDiagnostics( const void *left , const void *right ) {
+
+    const Diagnostic *leftDiagnostic  = *(Diagnostic * const *) left;
+    const Diagnostic *rightDiagnostic = *(Diagnostic * const *) right;
+
+    if ( leftDiagnostic->line != rightDiagnostic->line ) {
+
+        return leftDiagnostic->line < rightDiagnostic->line ? -1 : 1;
+
+    }
+
+    if ( leftDiagnostic->column != rightDiagnostic->column ) {
+
+        return leftDiagnostic->column < rightDiagnostic->column ? -1 : 1;
+
+    }
+
+    return leftDiagnostic < rightDiagnostic ? -1 : leftDiagnostic > rightDiagnostic;
+
+}
+
+int printDiagnostics( FILE *stream ) {
+
+    return printFileDiagnostics( stream , NULL );
+
+}
+
+int printFileDiagnostics( FILE *stream , const char *fileName ) {
+
+    Diagnostic **sorted;
+    Diagnostic *diagnostic;
+    int index = 0;
+
+    if ( diagnosticCount == 0 ) {
+
+        return 0;
+
+    }
+
+    sorted = malloc( diagnosticCount * sizeof( Diagnostic * ) );
+
+    if ( sorted == NULL ) {
+
+        printf( "Error: Memory allocation failed. Program will be terminated\n" );
+        exit(1);
+
+    }
+
+    for ( diagnostic = firstDiagnostic ; diagnostic != NULL ; diagnostic = diagnostic->next ) {
+
+        sorted[index++] = diagnostic;
+
+    }
+
+    qsort( sorted , diagnosticCount , sizeof( Diagnostic * ) , compareDiagnostics );
+
+    for ( index = 0 ; index < diagnosticCount ; index++ ) {
+
+        if ( fileName != NULL ) {
+
+            fprintf( stream , "%s:" , fileName );
+
+        }
+
+        fprintf( stream , "%d:%d: Error: %s\n" , sorted[index]->line , sorted[index]->column , sorted[index]->message );
+
+    }
+
+    free( sorted );
+
+    return diagnosticCount;
+
+}
+
+void clearDiagnostics() {
+
+    while ( firstDiagnostic != NULL ) {
+
+        Diagnostic *next = firstDiagnostic->next;
+
+        free( firstDiagnostic->message );
+        free( firstDiagnostic );
+
+        firstDiagnostic = next;
+
+    }
+
+    lastDiagnostic  = NULL;
+    diagnosticCount = 0;
+
+}
+
+//end diagnostics.c
@@ -0,0 +1,72 @@
+/**
+ * diagnostics.h
+ * Definition of the list of errors found while compiling a program
+ * @author Jose Pablo Ortiz Lack
+ */
+#ifndef __DIAGNOSTICS_H__
+#define __DIAGNOSTICS_H__
+
+#include <stdio.h>
+
+/**
+ * @brief an error found in the source
+ */
+typedef struct tagDiagnostic {
+
+    int line; //line of the source where the error was found
+    int column; //column of the source where the error was found, starting at 1
+
+    char *message; //description of the error
+
+    struct tagDiagnostic *next; //next error of the list
+
+} Diagnostic;
+
+/**
+ * @brief number of errors reported since the list was last cleared. Every thread has its own list
+ */
+extern _Thread_local int diagnosticCount;
+
+/**
+ * @brief line and column of the construct being built by the parser, used to locate the errors found while building the tree
+ */
+extern _Thread_local int diagnosticLine;
+extern _Thread_local int diagnosticColumn;
+
+/**
+ * @brief adds an error to the list
+ * @param line line of the error
+ * @param column column of the error
+ * @param format printf format of the message, followed by its arguments
+ */
+void reportDiagnostic( int line , int column , const char *format , ... );
+
+/**
+ * @brief adds an error located at the construct being built by the parser
+ * @param format printf format of the message, followed by its arguments
+ */
+void reportError( const char *format , ... );
+
+/**
+ * @brief prints the errors of the list sorted by line and column
+ * @param stream where the errors are printed
+ * @return the number of errors printed
+ */
+int printDiagnostics( FILE *stream );
+
+/**
+ * @brief prints the errors of the list sorted by line and column, each one preceded by the name of the file where it was found
+ * @param stream where the errors are printed
+ * @param fileName name of the file
+ * @return the number of errors printed
+ */
+int printFileDiagnostics( FILE *stream , const char *fileName );
+
+/**
+ * @brief removes every error of the list
+ */
+void clearDiagnostics();
+
+#endif //__DIAGNOSTICS_H__
+
+//end diagnostics.h
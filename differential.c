@@ -0,0 +1,1863 @@
+/**
+ * differential.c
+ * Implementation of the differential testing of the execution engines
+ *
+ * The generated programs are well-typed and cannot fail at run time, so every difference is a defect of an engine:
+ *  - divisors are non-zero literals
+ *  - array indexes are literals or the iterator of an enclosing for loop whose range stays within the array
+ *  - for loops have literal bounds, while loops count with a variable that only their own header assigns,
+ *    and iterators and counters are never assigned by the body
+ *  - procedures only call the procedures declared before them, and a recursive procedure only calls itself while its parameter d,
+ *    which starts at a literal and grows by 1 per call, is below a literal
+ * Every engine executes the program as a session with the same input, so programs may read values. The native engine compiles the
+ * tree of the session to an executable and runs it with the input, so only its output is compared. The batch engine executes the tree
+ * for several records of input in one pass, and its output is compared with the tree walker executed once for every record. The
+ * streamed engines parse the source again with the statement stream, executing every statement once it is parsed
+ * @author Jose Pablo Ortiz Lack
+ */
+#include "differential.h"
+#include "session.h"
+#include "vectorLoop.h"
+#include "valueNumbering.h"
+#include "unrolling.h"
+#include "nativeCode.h"
+#include "constantPropagation.h"
+#include "inlining.h"
+#include "batch.h"
+#include "streaming.h"
+#include "arena.h"
+#include "Parser.h"
+#include "diagnostics.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define ARRAY_LENGTH 8 //length of the arrays of the generated programs
+
+#define MAXIMUM_DEPTH 3 //nesting depth of the statements of the generated programs
+
+#define INPUT_VALUES 32 //values available for the read statements
+
+#define REPEATED_EXPRESIONS 4 //compound expresions of each type kept to be generated again
+
+#define MAXIMUM_PROCEDURES 3 //procedures of the generated programs
+
+#define PROCEDURE_SCALARS 2 //parameters, and local scalars, of a generated procedure at most
+
+#define RECURSION_DEPTH 3 //depth a recursive procedure stops calling itself at, at most
+
+#define BATCH_RECORDS 4 //records the batch engine executes every program with
+
+#define ACCUMULATION_TRIPS 70 //iterations of a generated accumulation loop at most, more than four blocks of the vectorized path
+
+/**
+ * @brief a statement of a generated program. Statements with a body are written as header, body and footer
+ */
+typedef struct tagGeneratedStatement {
+
+    char *header; //the statement, or the text before its body
+    char *footer; //the text after the body, NULL if the statement has no body
+    int headerIsStatement; //1 if the header ends with a statement, so a non-empty body must be separated with a ;
+
+    struct tagGeneratedStatement *body; //first statement of the body
+    struct tagGeneratedStatement *next; //next statement of the same list
+
+    int removed; //1 if the statement was removed while reducing the program
+
+} GeneratedStatement;
+
+/**
+ * @brief an iterator of a for loop that encloses the statement being generated
+ */
+typedef struct tagIteratorScope {
+
+    char name[8];
+    SymbolType type;
+    int indexable; //1 if every value of the iterator is an index of the arrays
+    int low; //lowest value of an indexable iterator
+    int high; //highest value of an indexable iterator
+
+} IteratorScope;
+
+/**
+ * @brief a procedure of a generated program. Its loops have iterators and counters of their own, so a call never changes the loops
+ * of the caller, and its parameters are never assigned
+ */
+typedef struct tagGeneratedProcedure {
+
+    int recursive; //1 if the procedure calls itself, with its first parameter d counting the depth of the recursion
+    int recursionLimit; //value of d the recursion stops at
+
+    int parameterCount;
+    SymbolType parameterTypes[PROCEDURE_SCALARS]; //types of the parameters a0, a1, or d and a1 if the procedure is recursive
+
+    int localCount;
+    SymbolType localTypes[PROCEDURE_SCALARS]; //types of the local scalars s0, s1
+
+    struct tagGeneratedStatement *body; //first statement of the body
+
+} GeneratedProcedure;
+
+/**
+ * @brief an engine, a configuration of the interpreter the programs are executed with
+ */
+typedef struct tagEngine {
+
+    const char *name;
+    int vectorized; //1 to execute accumulation loops with the vectorized path
+    int boundsChecked; //1 to verify array indexes, hoisting the verification out of for loops
+    int trickledInput; //1 to feed the input one character per resume, so every read suspends the program
+    int valueNumbered; //1 to reuse the values of common subexpressions
+    int unrolled; //1 to unroll for loops and execute small if statements as conditional selects
+    int propagated; //1 to replace the constant symbols by literals and remove the branches whose condition is known
+    int native; //1 to execute the program as a native executable, which leaves the symbols of the session untouched
+    int inlined; //1 to replace the calls of small procedures that are not recursive by their bodies
+    int batched; //1 to execute the program for several records of input at once, which leaves the symbols of the session untouched
+    int padded; //1 to read 0 once the input is consumed, as the batch execution does, instead of waiting for more input
+    int streamed; //1 to execute every statement as soon as it is parsed, with the statement stream, instead of as a session
+    int queued; //statements the stream parses ahead of the execution, 0 to execute them on the thread of the parser
+
+    double milliseconds; //time taken by the executions, with the parses for the streamed engines, which execute while they parse
+
+} Engine;
+
+/**
+ * @brief what an engine produced for a program
+ */
+typedef struct tagEngineResult {
+
+    char *output; //text written by print statements and read prompts
+    size_t outputLength;
+
+    char *values; //final values of the symbols
+    size_t valuesLength;
+
+    SessionStatus status; //pNEEDS_INPUT if the program read more values than the input had, pFAILED after a run-time error
+
+} EngineResult;
+
+static Engine engines[] = {
+    { "tree walker" , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 }, //the reference every other engine is compared with
+    { "vectorized" , 1 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 },
+    { "bounds checked" , 1 , 1 , 0 , 1 , 1 , 1 , 0 , 1 , 0 , 0 , 0 , 0 , 0 },
+    { "suspended reads" , 1 , 0 , 1 , 1 , 1 , 1 , 0 , 0 , 0 , 0 , 0 , 0 , 0 }, //not inlined, so the reads suspend inside the calls too
+    { "inlined" , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 1 , 0 , 0 , 0 , 0 , 0 },
+    { "common subexpressions" , 0 , 0 , 0 , 1 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 },
+    { "unrolled" , 0 , 0 , 0 , 0 , 1 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 },
+    { "constant propagation" , 0 , 0 , 0 , 0 , 0 , 1 , 0 , 1 , 0 , 0 , 0 , 0 , 0 },
+    { "native" , 0 , 1 , 0 , 1 , 1 , 1 , 1 , 1 , 0 , 0 , 0 , 0 , 0 },
+    { "batch" , 0 , 0 , 0 , 1 , 1 , 1 , 0 , 1 , 1 , 0 , 0 , 0 , 0 }, //compared with the tree walker executed once per record
+    { "streamed" , 1 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 1 , 0 , 0 },
+    { "streamed with a queue" , 1 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 1 , 4 , 0 }
+};
+
+static Engine recordWalker = { "tree walker per record" , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 1 , 0 , 0 , 0 }; //the reference of the batch engine
+
+#define ENGINE_COUNT ( (int) ( sizeof( engines ) / sizeof( engines[0] ) ) )
+
+static const char *scalarNames[4][4] = { //assignable scalars by type
+    { "n0" , "n1" , "n2" , "n3" },
+    { "f0" , "f1" , "f2" , "f3" },
+    { "l0" , "l1" , "l2" , "l3" },
+    { "d0" , "d1" , "d2" , "d3" }
+};
+
+static const char *arrayNames[4] = { "ai" , "af" , "al" , "ad" };
+
+static const char *iteratorPrefixes[4] = { "it" , "ft" , "lt" , "dt" };
+
+/**
+ * @brief programs that made an engine differ from the tree walker, executed by every engine before the generated programs
+ */
+static const char *regressionPrograms[] = {
+
+    //the parameter of q was replaced by its argument, g, although the call to the recursive setg left in the body assigns g
+    "program r\n"
+    "int g\n"
+    "procedure setg( int d )\n"
+    "begin\n"
+    "  g := 100;\n"
+    "  if d < 0 then setg( d + 1 ) endif\n"
+    "end\n"
+    "procedure q( int a )\n"
+    "begin\n"
+    "  setg( 0 );\n"
+    "  print a\n"
+    "end\n"
+    "begin\n"
+    "  g := 1;\n"
+    "  q( g )\n"
+    "end\n"
+
+};
+
+#define REGRESSION_COUNT ( (int) ( sizeof( regressionPrograms ) / sizeof( regressionPrograms[0] ) ) )
+
+static const char *decimalLiterals[] = { "0.5" , "1.25" , "2.0" , "3.75" , "0.1" , "10.5" , "0.0" , "7.125" };
+
+static unsigned long long generatorState; //state of the xorshift generator
+
+static IteratorScope scopes[MAXIMUM_DEPTH + 1]; //iterators of the enclosing for loops
+
+static int scopeCount = 0;
+
+static char *repeatedExpresions[4][REPEATED_EXPRESIONS]; //recent compound expresions by type, so programs compute some values twice
+
+static int repeatedCount[4];
+
+static GeneratedProcedure procedures[MAXIMUM_PROCEDURES]; //procedures of the program being generated
+
+static int procedureCount = 0;
+
+static int callableCount = 0; //procedures the statements being generated may call, the ones declared before the procedure they belong to
+
+static GeneratedProcedure *scopeProcedure = NULL; //procedure whose body is being generated, NULL for the statements of the program
+
+/**
+ * @brief obtains a random number between 0 and bound - 1
+ */
+static int randomBelow( int bound ) {
+
+    generatorState ^= generatorState << 13;
+    generatorState ^= generatorState >> 7;
+    generatorState ^= generatorState << 17;
+
+    return (int) ( generatorState % (unsigned long long) bound );
+
+}
+
+/**
+ * @brief formats text in newly allocated memory
+ */
+static char *formatText( const char *format , ... ) {
+
+    va_list arguments;
+    va_list copy;
+    int length;
+    char *text;
+
+    va_start( arguments , format );
+    va_copy( copy , arguments );
+
+    length = vsnprintf( NULL , 0 , format , copy );
+    text   = malloc( length + 1 );
+
+    if ( text == NULL ) {
+
+        printf( "Error: Memory allocation failed. Program will be terminated\n" );
+        exit(1);
+
+    }
+
+    vsnprintf( text , length + 1 , format , arguments );
+
+    va_end( copy );
+    va_end( arguments );
+
+    return text;
+}
+
+/**
+ * @brief generates a literal of a type
+ */
+static char *generateLiteral( SymbolType type ) {
+
+    if ( type == sFLOAT || type == sDOUBLE ) {
+
+        return formatText( "%s" , decimalLiterals[randomBelow( sizeof( decimalLiterals ) / sizeof( decimalLiterals[0] ) )] );
+
+    }
+
+    //large literals make multiplications overflow, which every engine must wrap the same way
+    return formatText( "%d" , randomBelow( 10 ) == 0 ? 40000 + randomBelow( 10000 ) : randomBelow( 21 ) );
+
+}
+
+/**
+ * @brief generates an index that is within the bounds of the arrays
+ */
+static char *generateIndex() {
+
+    int candidates[MAXIMUM_DEPTH + 1];
+    int count = 0;
+    int index;
+
+    for ( index = 0 ; index < scopeCount ; index++ ) {
+
+        if ( scopes[index].indexable ) {
+
+            candidates[count++] = index;
+
+        }
+    }
+
+    if ( count == 0 || randomBelow( 4 ) == 0 ) {
+
+        return formatText( "%d" , randomBelow( ARRAY_LENGTH ) );
+
+    }
+
+    index = candidates[randomBelow( count )];
+
+    switch ( randomBelow( 4 ) ) {
+
+        case 0:
+
+            if ( scopes[index].high < ARRAY_LENGTH - 1 ) {
+
+                return formatText( "%s + %d" , scopes[index].name , 1 + randomBelow( ARRAY_LENGTH - 1 - scopes[index].high ) );
+
+            }
+
+        break;
+
+        case 1:
+
+            if ( scopes[index].low > 0 ) {
+
+                return formatText( "%s - %d" , scopes[index].name , 1 + randomBelow( scopes[index].low ) );
+
+            }
+
+        break;
+
+        default:
+
+        break;
+
+    }
+
+    return formatText( "%s" , scopes[index].name );
+
+}
+
+/**
+ * @brief chooses, half of the times, a parameter or a local scalar of a type of the procedure whose body is being generated
+ * @param assignable 1 to choose only among the local scalars
+ * @return the name in newly allocated memory, NULL to use a scalar of the program
+ */
+static char *generateProcedureScalar( SymbolType type , int assignable ) {
+
+    char *candidates[2 * PROCEDURE_SCALARS];
+    int count = 0;
+    int index;
+
+    if ( scopeProcedure == NULL || randomBelow( 2 ) == 0 ) {
+
+        return NULL;
+
+    }
+
+    for ( index = 0 ; !assignable && index < scopeProcedure->parameterCount ; index++ ) {
+
+        if ( scopeProcedure->parameterTypes[index] == type ) {
+
+            candidates[count++] = index == 0 && scopeProcedure->recursive ? formatText( "d" ) : formatText( "a%d" , index );
+
+        }
+    }
+
+    for ( index = 0 ; index < scopeProcedure->localCount ; index++ ) {
+
+        if ( scopeProcedure->localTypes[index] == type ) {
+
+            candidates[count++] = formatText( "s%d" , index );
+
+        }
+    }
+
+    if ( count == 0 ) {
+
+        return NULL;
+
+    }
+
+    index = randomBelow( count );
+
+    while ( count-- > 0 ) {
+
+        if ( count != index ) {
+
+            free( candidates[count] );
+
+        }
+    }
+
+    return candidates[index];
+}
+
+/**
+ * @brief generates an operand without operators: a scalar, an iterator, an array element or a literal
+ */
+static char *generateLeaf( SymbolType type ) {
+
+    int choice = randomBelow( 10 );
+    int index;
+
+    if ( choice < 2 ) {
+
+        for ( index = scopeCount - 1 ; index >= 0 ; index-- ) {
+
+            if ( scopes[index].type == type && randomBelow( 2 ) == 0 ) {
+
+                return formatText( "%s" , scopes[index].name );
+
+            }
+        }
+    }
+
+    if ( choice < 5 ) {
+
+        char *scalar = generateProcedureScalar( type , 0 );
+
+        return scalar != NULL ? scalar : formatText( "%s" , scalarNames[type][randomBelow( 4 )] );
+
+    }
+
+    if ( choice < 7 ) {
+
+        char *arrayIndex = generateIndex();
+        char *leaf       = formatText( "%s[%s]" , arrayNames[type] , arrayIndex );
+
+        free( arrayIndex );
+
+        return leaf;
+
+    }
+
+    return generateLiteral( type );
+
+}
+
+/**
+ * @brief forgets the compound expresions kept to be generated again. Called whenever an iterator enters or leaves the scope,
+ * since their indexes are only within bounds for the iterators of the scope they were generated in
+ */
+static void forgetRepeatedExpresions() {
+
+    int type;
+
+    for ( type = 0 ; type < 4 ; type++ ) {
+
+        while ( repeatedCount[type] > 0 ) {
+
+            free( repeatedExpresions[type][--repeatedCount[type]] );
+
+        }
+    }
+}
+
+/**
+ * @brief keeps a compound expresion to be generated again, replacing a random one when there are too many
+ */
+static void repeatExpresion( SymbolType type , const char *expresion ) {
+
+    int index;
+
+    if ( repeatedCount[type] < REPEATED_EXPRESIONS ) {
+
+        repeatedExpresions[type][repeatedCount[type]++] = formatText( "%s" , expresion );
+
+        return;
+
+    }
+
+    index = randomBelow( REPEATED_EXPRESIONS );
+
+    free( repeatedExpresions[type][index] );
+
+    repeatedExpresions[type][index] = formatText( "%s" , expresion );
+
+}
+
+/**
+ * @brief generates an expresion of a type
+ */
+static char *generateExpresion( SymbolType type , int depth ) {
+
+    static const char operators[] = { '+' , '-' , '*' , '/' };
+    char operator = operators[randomBelow( 4 )];
+    char *left;
+    char *right;
+    char *expresion;
+
+    if ( depth >= 3 || randomBelow( 5 ) < 2 ) {
+
+        char *leaf = generateLeaf( type );
+
+        if ( randomBelow( 12 ) == 0 ) {
+
+            expresion = formatText( "(-%s)" , leaf );
+            free( leaf );
+
+            return expresion;
+
+        }
+
+        return leaf;
+
+    }
+
+    //a repeated expresion is a common subexpression of the program, its parentheses keep it a subtree of the expresion
+    if ( repeatedCount[type] > 0 && randomBelow( 4 ) == 0 ) {
+
+        return formatText( "(%s)" , repeatedExpresions[type][randomBelow( repeatedCount[type] )] );
+
+    }
+
+    left  = generateExpresion( type , depth + 1 );
+    right = operator == '/' ? ( type == sFLOAT || type == sDOUBLE ? formatText( "%s" , decimalLiterals[randomBelow( 6 )] ) : formatText( "%d" , 1 + randomBelow( 9 ) ) )
+                            : generateExpresion( type , depth + 1 );
+
+    //without parentheses the operators are grouped by the grammar; divisors stay literals either way
+    expresion = randomBelow( 2 ) == 0 ? formatText( "(%s %c %s)" , left , operator , right ) : formatText( "%s %c %s" , left , operator , right );
+
+    if ( randomBelow( 3 ) == 0 ) {
+
+        repeatExpresion( type , expresion );
+
+    }
+
+    free( left );
+    free( right );
+
+    return expresion;
+}
+
+/**
+ * @brief generates a condition comparing two expresions of the same type
+ */
+static char *generateCondition() {
+
+    static const char comparisons[] = { '<' , '>' , '=' };
+    SymbolType type = (SymbolType) randomBelow( 4 );
+    char *left      = generateExpresion( type , 1 );
+    char *right     = generateExpresion( type , 1 );
+    char *condition = formatText( "%s %c %s" , left , comparisons[randomBelow( 3 )] , right );
+
+    free( left );
+    free( right );
+
+    return condition;
+}
+
+/**
+ * @brief allocates a generated statement
+ */
+static GeneratedStatement *createGeneratedStatement( char *header , char *footer , int headerIsStatement ) {
+
+    GeneratedStatement *statement = calloc( 1 , sizeof( GeneratedStatement ) );
+
+    if ( statement == NULL ) {
+
+        printf( "Error: Memory allocation failed. Program will be terminated\n" );
+        exit(1);
+
+    }
+
+    statement->header            = header;
+    statement->footer            = footer;
+    statement->headerIsStatement = headerIsStatement;
+
+    return statement;
+}
+
+static GeneratedStatement *generateStatements( int depth , int count );
+
+/**
+ * @brief generates a for loop whose iterator may index the arrays
+ */
+static GeneratedStatement *generateIndexLoop( int depth ) {
+
+    int step  = 1 + randomBelow( 3 );
+    int start = randomBelow( ARRAY_LENGTH );
+    int until = randomBelow( ARRAY_LENGTH );
+    GeneratedStatement *statement;
+    IteratorScope *scope = &scopes[scopeCount];
+
+    if ( randomBelow( 3 ) == 0 ) {
+
+        step = -step;
+
+    }
+
+    snprintf( scope->name , sizeof( scope->name ) , "it%d" , depth );
+
+    scope->type      = sINTEGER;
+    scope->indexable = 1;
+    scope->low       = start < until ? start : until;
+    scope->high      = start < until ? until : start;
+
+    statement = createGeneratedStatement( formatText( "for %s := %d step %d until %d do" , scope->name , start , step , until ) , formatText( "endfor" ) , 0 );
+
+    forgetRepeatedExpresions();
+    scopeCount++;
+    statement->body = generateStatements( depth + 1 , 1 + randomBelow( 3 ) );
+    scopeCount--;
+    forgetRepeatedExpresions();
+
+    return statement;
+}
+
+/**
+ * @brief generates a for loop whose body only accumulates integers, the shape executed by the vectorized path.
+ * The step takes both signs and the trip count goes from 0 past several vector blocks, so every tail length is covered
+ */
+static GeneratedStatement *generateAccumulationLoop( int depth ) {
+
+    int step  = 1 + randomBelow( 4 );
+    int trips = randomBelow( ACCUMULATION_TRIPS + 1 );
+    int start = randomBelow( 9 ) - 4;
+    int count = 1 + randomBelow( 2 );
+    GeneratedStatement *statement;
+    GeneratedStatement **last;
+    IteratorScope *scope = &scopes[scopeCount];
+
+    snprintf( scope->name , sizeof( scope->name ) , "it%d" , depth );
+
+    scope->type      = sINTEGER;
+    scope->indexable = 0;
+
+    if ( randomBelow( 2 ) == 0 ) {
+
+        step = -step;
+
+    }
+
+    //with 0 trips the until value is one step behind the start
+    statement = createGeneratedStatement( formatText( "for %s := %d step %d until %d do" , scope->name , start , step , start + ( trips - 1 ) * step ) ,
+                                          formatText( "endfor" ) , 0 );
+
+    forgetRepeatedExpresions();
+    scopeCount++;
+
+    for ( last = &statement->body ; count > 0 ; count-- ) {
+
+        const char *accumulator = scalarNames[sINTEGER][randomBelow( 4 )];
+        char *value = generateExpresion( sINTEGER , 1 );
+
+        *last = createGeneratedStatement( formatText( "%s := %s %c %s" , accumulator , accumulator , randomBelow( 2 ) ? '+' : '-' , value ) , NULL , 0 );
+        last  = &( *last )->next;
+
+        free( value );
+
+    }
+
+    scopeCount--;
+    forgetRepeatedExpresions();
+
+    return statement;
+}
+
+/**
+ * @brief generates a for loop with a float, long or double iterator
+ */
+static GeneratedStatement *generateTypedLoop( int depth ) {
+
+    static const char *floatLoops[] = { "0.5 step 0.25 until 2.0" , "3.0 step -0.5 until 0.5" , "0.0 step 0.1 until 0.5" };
+    static const char *longLoops[]  = { "0 step 3 until 20" , "10 step -4 until 0" , "5 step 1 until 5" };
+    SymbolType type = (SymbolType) ( 1 + randomBelow( 3 ) );
+    const char *range = type == sLONG ? longLoops[randomBelow( 3 )] : floatLoops[randomBelow( 3 )];
+    GeneratedStatement *statement;
+    IteratorScope *scope = &scopes[scopeCount];
+
+    snprintf( scope->name , sizeof( scope->name ) , "%s%d" , iteratorPrefixes[type] , depth );
+
+    scope->type      = type;
+    scope->indexable = 0;
+
+    statement = createGeneratedStatement( formatText( "for %s := %s do" , scope->name , range ) , formatText( "endfor" ) , 0 );
+
+    forgetRepeatedExpresions();
+    scopeCount++;
+    statement->body = generateStatements( depth + 1 , 1 + randomBelow( 3 ) );
+    scopeCount--;
+    forgetRepeatedExpresions();
+
+    return statement;
+}
+
+/**
+ * @brief generates the arguments of a call to a procedure
+ * @param depth the argument of the parameter d of a recursive procedure
+ */
+static char *generateArguments( GeneratedProcedure *procedure , const char *depth ) {
+
+    char *arguments = formatText( "%s" , "" );
+    int index;
+
+    for ( index = 0 ; index < procedure->parameterCount ; index++ ) {
+
+        char *value = index == 0 && procedure->recursive ? formatText( "%s" , depth ) : generateExpresion( procedure->parameterTypes[index] , 1 );
+        char *joined = formatText( index == 0 ? "%s%s" : "%s , %s" , arguments , value );
+
+        free( arguments );
+        free( value );
+
+        arguments = joined;
+
+    }
+
+    return arguments;
+}
+
+/**
+ * @brief generates a call to one of the procedures declared before the statement, starting the recursion of a recursive one at 0 or 1
+ */
+static GeneratedStatement *generateCall() {
+
+    int index = randomBelow( callableCount );
+    char depth[2] = { (char) ( '0' + randomBelow( 2 ) ) , '\0' };
+    char *arguments = generateArguments( &procedures[index] , depth );
+    GeneratedStatement *statement = createGeneratedStatement( formatText( "p%d( %s )" , index , arguments ) , NULL , 0 );
+
+    free( arguments );
+
+    return statement;
+}
+
+/**
+ * @brief generates a statement
+ */
+static GeneratedStatement *generateStatement( int depth ) {
+
+    int choice = randomBelow( depth < MAXIMUM_DEPTH ? 100 : 65 );
+    SymbolType type = (SymbolType) randomBelow( 4 );
+    GeneratedStatement *statement;
+    char *target;
+    char *value;
+
+    if ( callableCount > 0 && randomBelow( 10 ) == 0 ) {
+
+        return generateCall();
+
+    }
+
+    if ( choice < 25 ) { //scalar assignment
+
+        target    = generateProcedureScalar( type , 1 );
+        value     = generateExpresion( type , 0 );
+        statement = createGeneratedStatement( formatText( "%s := %s" , target != NULL ? target : scalarNames[type][randomBelow( 4 )] , value ) , NULL , 0 );
+
+        free( target );
+
+    } else if ( choice < 40 ) { //array element assignment
+
+        target    = generateIndex();
+        value     = generateExpresion( type , 0 );
+        statement = createGeneratedStatement( formatText( "%s[%s] := %s" , arrayNames[type] , target , value ) , NULL , 0 );
+
+        free( target );
+
+    } else if ( choice < 57 ) {
+
+        value     = generateExpresion( type , 0 );
+        statement = createGeneratedStatement( formatText( "print %s" , value ) , NULL , 0 );
+
+    } else if ( choice < 65 ) {
+
+        target    = generateProcedureScalar( type , 1 );
+        statement = createGeneratedStatement( formatText( "read %s" , target != NULL ? target : scalarNames[type][randomBelow( 4 )] ) , NULL , 0 );
+
+        free( target );
+
+        return statement;
+
+    } else if ( choice < 75 ) {
+
+        value     = generateCondition();
+        statement = createGeneratedStatement( formatText( "if %s then" , value ) , formatText( "endif" ) , 0 );
+
+        statement->body = generateStatements( depth + 1 , 1 + randomBelow( 3 ) );
+
+    } else if ( choice < 82 ) { //the counter is only assigned by the header, so the loop always ends
+
+        value     = NULL;
+        statement = createGeneratedStatement( formatText( "w%d := 0; while w%d < %d do w%d := w%d + 1" , depth , depth , 1 + randomBelow( 4 ) , depth , depth ) ,
+                                              formatText( "endw" ) , 1 );
+
+        statement->body = generateStatements( depth + 1 , 1 + randomBelow( 3 ) );
+
+    } else if ( choice < 90 ) {
+
+        return generateIndexLoop( depth );
+
+    } else if ( choice < 95 ) {
+
+        return generateAccumulationLoop( depth );
+
+    } else {
+
+        return generateTypedLoop( depth );
+
+    }
+
+    free( value );
+
+    return statement;
+}
+
+/**
+ * @brief generates a list of statements
+ */
+static GeneratedStatement *generateStatements( int depth , int count ) {
+
+    GeneratedStatement *first = NULL;
+    GeneratedStatement **last = &first;
+
+    for ( ; count > 0 ; count-- ) {
+
+        *last = generateStatement( depth );
+        last  = &( *last )->next;
+
+    }
+
+    return first;
+}
+
+/**
+ * @brief generates the procedures of a program. A procedure may call the procedures declared before it, and a recursive procedure
+ * calls itself in an if statement that stops the recursion once its parameter d reaches a literal
+ */
+static void generateProcedures() {
+
+    int index;
+
+    procedureCount = randomBelow( MAXIMUM_PROCEDURES + 1 );
+
+    for ( index = 0 ; index < procedureCount ; index++ ) {
+
+        GeneratedProcedure *procedure = &procedures[index];
+        GeneratedStatement *guard;
+        GeneratedStatement **last;
+        char *arguments;
+        int position;
+        int scalar;
+
+        procedure->recursive      = randomBelow( 3 ) == 0;
+        procedure->recursionLimit = 1 + randomBelow( RECURSION_DEPTH );
+        procedure->parameterCount = 1 + randomBelow( PROCEDURE_SCALARS );
+        procedure->localCount     = randomBelow( PROCEDURE_SCALARS + 1 );
+
+        for ( scalar = 0 ; scalar < procedure->parameterCount ; scalar++ ) {
+
+            procedure->parameterTypes[scalar] = scalar == 0 && procedure->recursive ? sINTEGER : (SymbolType) randomBelow( 4 );
+
+        }
+
+        for ( scalar = 0 ; scalar < procedure->localCount ; scalar++ ) {
+
+            procedure->localTypes[scalar] = (SymbolType) randomBelow( 4 );
+
+        }
+
+        //the expresions kept for the program or another procedure use scalars this body may not have
+        forgetRepeatedExpresions();
+
+        callableCount  = index;
+        scopeProcedure = procedure;
+
+        procedure->body = generateStatements( 1 , 1 + randomBelow( 4 ) );
+
+        if ( procedure->recursive ) {
+
+            arguments = generateArguments( procedure , "d + 1" );
+            guard     = createGeneratedStatement( formatText( "if d < %d then" , procedure->recursionLimit ) , formatText( "endif" ) , 0 );
+
+            guard->body = createGeneratedStatement( formatText( "p%d( %s )" , index , arguments ) , NULL , 0 );
+
+            free( arguments );
+
+            for ( last = &procedure->body , position = randomBelow( 3 ) ; *last != NULL && position > 0 ; last = &( *last )->next , position-- );
+
+            guard->next = *last;
+            *last       = guard;
+
+        }
+
+        scopeProcedure = NULL;
+
+    }
+
+    forgetRepeatedExpresions();
+
+    callableCount = procedureCount;
+
+}
+
+/**
+ * @brief releases a list of generated statements
+ */
+static void freeGeneratedStatements( GeneratedStatement *statement ) {
+
+    while ( statement != NULL ) {
+
+        GeneratedStatement *next = statement->next;
+
+        freeGeneratedStatements( statement->body );
+
+        free( statement->header );
+        free( statement->footer );
+        free( statement );
+
+        statement = next;
+
+    }
+}
+
+/**
+ * @brief verifies if a list has a statement that was not removed
+ */
+static int hasStatements( GeneratedStatement *statement ) {
+
+    for ( ; statement != NULL ; statement = statement->next ) {
+
+        if ( !statement->removed ) {
+
+            return 1;
+
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief writes the statements of a list that were not removed, separated by ;
+ */
+static void writeStatements( FILE *stream , GeneratedStatement *statement , int indentation ) {
+
+    int first = 1;
+
+    for ( ; statement != NULL ; statement = statement->next ) {
+
+        if ( statement->removed ) {
+
+            continue;
+
+        }
+
+        fprintf( stream , first ? "%*s%s" : ";\n%*s%s" , indentation , "" , statement->header );
+
+        first = 0;
+
+        if ( statement->footer != NULL ) {
+
+            if ( hasStatements( statement->body ) ) {
+
+                fprintf( stream , statement->headerIsStatement ? ";\n" : "\n" );
+
+                writeStatements( stream , statement->body , indentation + 2 );
+
+            }
+
+            fprintf( stream , "\n%*s%s" , indentation , "" , statement->footer );
+
+        }
+    }
+}
+
+/**
+ * @brief writes a generated procedure, declaring as locals the iterators and counters its loops may use
+ */
+static void writeProcedure( FILE *stream , int index ) {
+
+    static const char *typeNames[] = { "int" , "float" , "long" , "double" };
+    GeneratedProcedure *procedure = &procedures[index];
+    int scalar;
+    int type;
+
+    fprintf( stream , "procedure p%d(" , index );
+
+    for ( scalar = 0 ; scalar < procedure->parameterCount ; scalar++ ) {
+
+        if ( scalar == 0 && procedure->recursive ) {
+
+            fprintf( stream , " int d" );
+
+        } else {
+
+            fprintf( stream , scalar == 0 ? " %s a%d" : " , %s a%d" , typeNames[procedure->parameterTypes[scalar]] , scalar );
+
+        }
+    }
+
+    fprintf( stream , " )\n  " );
+
+    for ( scalar = 0 ; scalar < procedure->localCount ; scalar++ ) {
+
+        fprintf( stream , "%s s%d; " , typeNames[procedure->localTypes[scalar]] , scalar );
+
+    }
+
+    for ( type = sINTEGER ; type <= sDOUBLE ; type++ ) {
+
+        for ( scalar = 0 ; scalar <= MAXIMUM_DEPTH ; scalar++ ) {
+
+            fprintf( stream , "%s %s%d; " , typeNames[type] , iteratorPrefixes[type] , scalar );
+
+        }
+    }
+
+    for ( scalar = 0 ; scalar <= MAXIMUM_DEPTH ; scalar++ ) {
+
+        fprintf( stream , scalar < MAXIMUM_DEPTH ? "int w%d; " : "int w%d\n" , scalar );
+
+    }
+
+    fprintf( stream , "begin\n" );
+
+    writeStatements( stream , procedure->body , 2 );
+
+    fprintf( stream , "\nend\n" );
+
+}
+
+/**
+ * @brief writes the source of a generated program
+ * @return the source in newly allocated memory
+ */
+static char *writeProgram( GeneratedStatement *statements , size_t *length ) {
+
+    char *source;
+    FILE *stream = open_memstream( &source , length );
+    int type;
+    int index;
+    int procedure;
+
+    fprintf( stream , "program differential\n" );
+
+    for ( type = sINTEGER ; type <= sDOUBLE ; type++ ) {
+
+        static const char *typeNames[] = { "int" , "float" , "long" , "double" };
+
+        for ( index = 0 ; index < 4 ; index++ ) {
+
+            fprintf( stream , "%s %s; " , typeNames[type] , scalarNames[type][index] );
+
+        }
+
+        fprintf( stream , "%s %s[%d]; " , typeNames[type] , arrayNames[type] , ARRAY_LENGTH );
+
+        for ( index = 0 ; index <= MAXIMUM_DEPTH ; index++ ) {
+
+            fprintf( stream , "%s %s%d; " , typeNames[type] , iteratorPrefixes[type] , index );
+
+        }
+
+        fprintf( stream , "\n" );
+
+    }
+
+    for ( index = 0 ; index <= MAXIMUM_DEPTH ; index++ ) {
+
+        fprintf( stream , index < MAXIMUM_DEPTH ? "int w%d; " : "int w%d\n" , index );
+
+    }
+
+    for ( procedure = 0 ; procedure < procedureCount ; procedure++ ) {
+
+        writeProcedure( stream , procedure );
+
+    }
+
+    fprintf( stream , "begin\n" );
+
+    writeStatements( stream , statements , 2 );
+
+    fprintf( stream , "\nend\n" );
+
+    fclose( stream );
+
+    return source;
+}
+
+/**
+ * @brief obtains the current time in milliseconds
+ */
+static double currentMilliseconds() {
+
+    struct timespec now;
+
+    clock_gettime( CLOCK_MONOTONIC , &now );
+
+    return now.tv_sec * 1000.0 + now.tv_nsec / 1000000.0;
+}
+
+/**
+ * @brief writes the final values of the symbols, with floating point values in hexadecimal so they are compared exactly. The locals
+ * of the procedures, qualified with the name of their procedure, are left out: a call restores them when it returns, but an inlined
+ * body leaves the values of its last execution, which no statement can read
+ */
+static void writeSymbolValues( FILE *stream , Symbol *symbol ) {
+
+    for ( ; symbol != NULL ; symbol = symbol->next ) {
+
+        int count = symbol->length == 0 ? 1 : symbol->length;
+        int index;
+
+        if ( strchr( symbol->identifier , '.' ) != NULL ) {
+
+            continue;
+
+        }
+
+        fprintf( stream , "%s =" , symbol->identifier );
+
+        for ( index = 0 ; index < count ; index++ ) {
+
+            switch ( symbol->type ) {
+
+                case sINTEGER:
+
+                    fprintf( stream , " %d" , symbol->length == 0 ? symbol->value.iValue : symbol->value.iElements[index] );
+
+                break;
+
+                case sFLOAT:
+
+                    fprintf( stream , " %a" , symbol->length == 0 ? symbol->value.fValue : symbol->value.fElements[index] );
+
+                break;
+
+                case sLONG:
+
+                    fprintf( stream , " %lld" , symbol->length == 0 ? symbol->value.lValue : symbol->value.lElements[index] );
+
+                break;
+
+                case sDOUBLE:
+
+                    fprintf( stream , " %a" , symbol->length == 0 ? symbol->value.dValue : symbol->value.dElements[index] );
+
+                break;
+
+            }
+        }
+
+        fprintf( stream , "\n" );
+
+    }
+}
+
+/**
+ * @brief writes the tree of a session as a native executable, runs it with the input and copies what it prints to output
+ * @return 1 if the executable ran, 0 if it could not be written or started
+ */
+static int runNativeExecutable( Session *session , const char *input , size_t inputLength , FILE *output ) {
+
+    char executable[] = "/tmp/slcnativeXXXXXX";
+    char inputFile[]  = "/tmp/slcinputXXXXXX";
+    char command[2 * sizeof( executable ) + 32];
+    char buffer[4096];
+    int executableDescriptor = mkstemp( executable );
+    int inputDescriptor      = mkstemp( inputFile );
+    int written = inputDescriptor >= 0 && write( inputDescriptor , input , inputLength ) == (ssize_t) inputLength;
+    int ran     = 0;
+    FILE *process;
+    size_t length;
+
+    //the executable is written again by name, and no descriptor of it may stay open once it is executed
+    if ( executableDescriptor >= 0 ) {
+
+        close( executableDescriptor );
+
+    }
+
+    if ( inputDescriptor >= 0 ) {
+
+        close( inputDescriptor );
+
+    }
+
+    if ( executableDescriptor < 0 || !written ) {
+
+        fprintf( stderr , "Error: cannot prepare the native executable\n" );
+
+    } else if ( emitNativeExecutable( session->tree , &session->program->symbolTable , executable ) ) {
+
+        snprintf( command , sizeof( command ) , "exec '%s' < '%s'" , executable , inputFile );
+
+        process = popen( command , "r" );
+
+        if ( process != NULL ) {
+
+            while ( ( length = fread( buffer , 1 , sizeof( buffer ) , process ) ) > 0 ) {
+
+                fwrite( buffer , 1 , length , output );
+
+            }
+
+            ran = pclose( process ) == 0;
+
+        }
+    }
+
+    if ( executableDescriptor >= 0 ) {
+
+        unlink( executable );
+
+    }
+
+    if ( inputDescriptor >= 0 ) {
+
+        unlink( inputFile );
+
+    }
+
+    return ran;
+}
+
+/**
+ * @brief writes the tree of a session to a file of records, executes it with resolveBatch and copies its output to output
+ * @return 1 if the records were executed, 0 if they could not be written
+ */
+static int runBatch( Session *session , const char *records , size_t recordsLength , FILE *output ) {
+
+    char recordFile[] = "/tmp/slcrecordsXXXXXX";
+    int descriptor = mkstemp( recordFile );
+    int written    = descriptor >= 0 && write( descriptor , records , recordsLength ) == (ssize_t) recordsLength;
+
+    if ( descriptor >= 0 ) {
+
+        close( descriptor );
+
+    }
+
+    if ( written ) {
+
+        resolveBatch( session->tree , &session->program->symbolTable , recordFile , output );
+
+    } else {
+
+        fprintf( stderr , "Error: cannot prepare the batch records\n" );
+
+    }
+
+    if ( descriptor >= 0 ) {
+
+        unlink( recordFile );
+
+    }
+
+    return written;
+}
+
+/**
+ * @brief executes a program with the statement stream, parsing it from memory with the values of its read statements taken from
+ * the input. The parse builds a symbol table of its own, whose final values are written once the stream is closed
+ * @return 1 if the program was executed, 0 if it has compile errors
+ */
+static int runStream( Engine *engine , const char *source , size_t length , const char *input , size_t inputLength , EngineResult *result ) {
+
+    int vectorized        = vectorLoopEnabled;
+    int capacity          = streamQueueCapacity;
+    int errors            = diagnosticCount;
+    FILE *outerOutput     = programOutput;
+    FILE *outerInput      = programInput;
+    Arena *outerArena     = currentArena;
+    ParseContext context  = { 0 };
+    Arena arena;
+    FILE *values;
+    double start;
+
+    memset( &arena , 0 , sizeof( Arena ) );
+
+    vectorLoopEnabled   = engine->vectorized;
+    streamQueueCapacity = engine->queued;
+    programOutput       = open_memstream( &result->output , &result->outputLength );
+    programInput        = fmemopen( (void *) input , inputLength , "r" );
+    currentArena        = &arena;
+
+    start = currentMilliseconds();
+
+    streamSource( &context , source , (int) length );
+
+    engine->milliseconds += currentMilliseconds() - start;
+
+    fclose( programOutput );
+    fclose( programInput );
+
+    values = open_memstream( &result->values , &result->valuesLength );
+
+    writeSymbolValues( values , context.symbolTable );
+    fprintf( values , "status = finished\n" );
+
+    fclose( values );
+
+    result->status = pFINISHED;
+
+    currentArena = outerArena;
+
+    releaseArena( &arena );
+
+    vectorLoopEnabled   = vectorized;
+    streamQueueCapacity = capacity;
+    programOutput       = outerOutput;
+    programInput        = outerInput;
+
+    return diagnosticCount == errors;
+}
+
+/**
+ * @brief executes a program with an engine
+ * @return 1 if the program was executed, 0 if it has compile errors
+ */
+static int runEngine( Engine *engine , const char *source , size_t length , const char *input , size_t inputLength , EngineResult *result ) {
+
+    int vectorized    = vectorLoopEnabled;
+    int boundsChecked = boundsCheckEnabled;
+    int valueNumbered = valueNumberingEnabled;
+    int unrolled      = unrollingEnabled;
+    int propagated    = constantPropagationEnabled;
+    int inlined       = inliningEnabled;
+    FILE *output;
+    FILE *values;
+    Session *session;
+    double start;
+
+    if ( engine->streamed ) {
+
+        return runStream( engine , source , length , input , inputLength , result );
+
+    }
+
+    output = open_memstream( &result->output , &result->outputLength );
+
+    vectorLoopEnabled          = engine->vectorized;
+    boundsCheckEnabled         = engine->boundsChecked;
+    valueNumberingEnabled      = engine->valueNumbered;
+    unrollingEnabled           = engine->unrolled;
+    constantPropagationEnabled = engine->propagated;
+    inliningEnabled            = engine->inlined;
+
+    session = createSession( source , length , output );
+
+    if ( session == NULL ) {
+
+        fclose( output );
+
+        vectorLoopEnabled          = vectorized;
+        boundsCheckEnabled         = boundsChecked;
+        valueNumberingEnabled      = valueNumbered;
+        unrollingEnabled           = unrolled;
+        constantPropagationEnabled = propagated;
+        inliningEnabled            = inlined;
+
+        return 0;
+
+    }
+
+    start = currentMilliseconds();
+
+    if ( engine->native ) {
+
+        runNativeExecutable( session , input , inputLength , output );
+
+        result->status = pFINISHED;
+
+    } else if ( engine->batched ) {
+
+        runBatch( session , input , inputLength , output );
+
+        result->status = pFINISHED;
+
+    } else if ( engine->trickledInput ) {
+
+        size_t position = 0;
+
+        result->status = resumeSession( session );
+
+        while ( result->status == pNEEDS_INPUT && position < inputLength ) {
+
+            feedSession( session , input + position++ , 1 );
+
+            result->status = resumeSession( session );
+
+        }
+
+    } else {
+
+        feedSession( session , input , inputLength );
+
+        result->status = resumeSession( session );
+
+        while ( engine->padded && result->status == pNEEDS_INPUT ) {
+
+            feedSession( session , "0 " , 2 );
+
+            result->status = resumeSession( session );
+
+        }
+    }
+
+    engine->milliseconds += currentMilliseconds() - start;
+
+    fclose( output );
+
+    values = open_memstream( &result->values , &result->valuesLength );
+
+    writeSymbolValues( values , session->program->symbolTable );
+    fprintf( values , "status = %s\n" , result->status == pFINISHED ? "finished" : result->status == pFAILED ? "failed" : "waiting for input" );
+
+    fclose( values );
+
+    destroySession( session );
+
+    vectorLoopEnabled          = vectorized;
+    boundsCheckEnabled         = boundsChecked;
+    valueNumberingEnabled      = valueNumbered;
+    unrollingEnabled           = unrolled;
+    constantPropagationEnabled = propagated;
+    inliningEnabled            = inlined;
+
+    return 1;
+}
+
+/**
+ * @brief releases what an engine produced
+ */
+static void freeEngineResult( EngineResult *result ) {
+
+    free( result->output );
+    free( result->values );
+
+}
+
+/**
+ * @brief writes the records of the batch engine, one line per record. Every record has the values of the input, rotated so each one
+ * starts at a different value
+ * @return the records in newly allocated memory
+ */
+static char *writeRecords( const char *input , size_t inputLength , size_t *recordsLength ) {
+
+    char *records;
+    FILE *stream = open_memstream( &records , recordsLength );
+    int values[INPUT_VALUES];
+    int count = 0;
+    int record;
+    int index;
+    char *end;
+
+    for ( ; count < INPUT_VALUES ; input = end , count++ ) {
+
+        values[count] = (int) strtol( input , &end , 10 );
+
+        if ( end == input ) {
+
+            break;
+
+        }
+    }
+
+    for ( record = 0 ; record < BATCH_RECORDS ; record++ ) {
+
+        for ( index = 0 ; index < count ; index++ ) {
+
+            fprintf( stream , index + 1 < count ? "%d " : "%d" , values[( index + 5 * record ) % count] );
+
+        }
+
+        fprintf( stream , "\n" );
+
+    }
+
+    fclose( stream );
+
+    return records;
+}
+
+/**
+ * @brief executes a program with the tree walker once for every record, the way the batch execution writes them: the output of
+ * every record follows a "--- record n" line, and the reads that find no value in the record read 0
+ */
+static void runRecords( const char *source , size_t length , const char *records , size_t recordsLength , EngineResult *result ) {
+
+    FILE *output = open_memstream( &result->output , &result->outputLength );
+    const char *record;
+    int recordIndex = 0;
+
+    for ( record = records ; record < records + recordsLength ; recordIndex++ ) {
+
+        const char *end = memchr( record , '\n' , records + recordsLength - record );
+        EngineResult recordResult;
+
+        end = end != NULL ? end + 1 : records + recordsLength;
+
+        runEngine( &recordWalker , source , length , record , end - record , &recordResult );
+
+        fprintf( output , "--- record %d\n" , recordIndex );
+        fwrite( recordResult.output , 1 , recordResult.outputLength , output );
+
+        freeEngineResult( &recordResult );
+
+        record = end;
+
+    }
+
+    fclose( output );
+
+    result->values       = NULL;
+    result->valuesLength = 0;
+    result->status       = pFINISHED;
+
+}
+
+/**
+ * @brief verifies if an engine leaves the symbols of the session untouched, so only its output is compared
+ */
+static int comparesOutputOnly( Engine *engine ) {
+
+    return engine->native || engine->batched;
+
+}
+
+/**
+ * @brief executes a program with every engine
+ * @return the index of the first engine whose output or final values differ from the ones of the tree walker, 0 if every engine matches
+ * or the program has compile errors. The native engine only runs the programs that finish with the input, and only its output is compared.
+ * The batch engine executes several records and its output is compared with the tree walker executed once per record. The
+ * streamed engines also only run the programs that finish with the input
+ */
+static int findSourceDifference( const char *source , size_t length , const char *input , size_t inputLength , int *compiled ) {
+
+    size_t recordsLength;
+    char *records = writeRecords( input , inputLength , &recordsLength );
+    EngineResult reference;
+    int difference = 0;
+    int engine;
+
+    *compiled = runEngine( &engines[0] , source , length , input , inputLength , &reference );
+
+    for ( engine = 1 ; *compiled && engine < ENGINE_COUNT && difference == 0 ; engine++ ) {
+
+        EngineResult *expected = &reference;
+        EngineResult recordReference;
+        EngineResult result;
+
+        //without a session the reads of a program that does not finish with the input find no value to wait for
+        if ( ( engines[engine].native || engines[engine].streamed ) && reference.status != pFINISHED ) {
+
+            continue;
+
+        }
+
+        if ( engines[engine].batched ) {
+
+            runRecords( source , length , records , recordsLength , &recordReference );
+            runEngine( &engines[engine] , source , length , records , recordsLength , &result );
+
+            expected = &recordReference;
+
+        } else {
+
+            runEngine( &engines[engine] , source , length , input , inputLength , &result );
+
+        }
+
+        if ( result.outputLength != expected->outputLength || memcmp( result.output , expected->output , expected->outputLength ) != 0 ||
+             ( !comparesOutputOnly( &engines[engine] ) &&
+               ( result.valuesLength != reference.valuesLength || memcmp( result.values , reference.values , reference.valuesLength ) != 0 ) ) ) {
+
+            difference = engine;
+
+        }
+
+        if ( expected != &reference ) {
+
+            freeEngineResult( expected );
+
+        }
+
+        freeEngineResult( &result );
+
+    }
+
+    free( records );
+
+    if ( *compiled ) {
+
+        freeEngineResult( &reference );
+
+    } else {
+
+        printDiagnostics( stderr );
+
+    }
+
+    clearDiagnostics();
+
+    return difference;
+}
+
+/**
+ * @brief executes a generated program with every engine
+ * @return the index of the first engine that differs from the tree walker, 0 if every engine matches or the program has compile errors
+ */
+static int findDifference( GeneratedStatement *statements , const char *input , size_t inputLength , int *compiled ) {
+
+    size_t length;
+    char *source   = writeProgram( statements , &length );
+    int difference = findSourceDifference( source , length , input , inputLength , compiled );
+
+    free( source );
+
+    return difference;
+}
+
+/**
+ * @brief collects the statements of a program in pre-order
+ */
+static void collectGeneratedStatements( GeneratedStatement *statement , GeneratedStatement ***list , int *count , int *capacity ) {
+
+    for ( ; statement != NULL ; statement = statement->next ) {
+
+        if ( *count == *capacity ) {
+
+            *capacity = *capacity == 0 ? 64 : 2 * *capacity;
+            *list     = realloc( *list , *capacity * sizeof( GeneratedStatement * ) );
+
+            if ( *list == NULL ) {
+
+                printf( "Error: Memory allocation failed. Program will be terminated\n" );
+                exit(1);
+
+            }
+        }
+
+        ( *list )[( *count )++] = statement;
+
+        collectGeneratedStatements( statement->body , list , count , capacity );
+
+    }
+}
+
+/**
+ * @brief removes statements, with their bodies, while the executions still differ, until no single statement can be removed
+ */
+static void reduceProgram( GeneratedStatement *statements , const char *input , size_t inputLength ) {
+
+    GeneratedStatement **list = NULL;
+    int count    = 0;
+    int capacity = 0;
+    int removed  = 1;
+    int index;
+
+    collectGeneratedStatements( statements , &list , &count , &capacity );
+
+    for ( index = 0 ; index < procedureCount ; index++ ) {
+
+        collectGeneratedStatements( procedures[index].body , &list , &count , &capacity );
+
+    }
+
+    while ( removed ) {
+
+        removed = 0;
+
+        for ( index = 0 ; index < count ; index++ ) {
+
+            int compiled;
+
+            if ( list[index]->removed ) {
+
+                continue;
+
+            }
+
+            list[index]->removed = 1;
+
+            if ( findDifference( statements , input , inputLength , &compiled ) != 0 ) {
+
+                removed = 1;
+
+            } else {
+
+                list[index]->removed = 0;
+
+            }
+        }
+    }
+
+    free( list );
+
+}
+
+/**
+ * @brief prints a program whose executions differ and what the tree walker and the differing engine produced
+ */
+static void reportDifference( GeneratedStatement *statements , const char *input , size_t inputLength , int engine , int originalCount ) {
+
+    size_t length;
+    size_t recordsLength;
+    char *source  = writeProgram( statements , &length );
+    char *records = writeRecords( input , inputLength , &recordsLength );
+    Engine *referenceEngine = engines[engine].batched ? &recordWalker : &engines[0];
+    EngineResult reference;
+    EngineResult result;
+
+    if ( engines[engine].batched ) {
+
+        runRecords( source , length , records , recordsLength , &reference );
+        runEngine( &engines[engine] , source , length , records , recordsLength , &result );
+
+        input       = records;
+        inputLength = recordsLength;
+
+    } else {
+
+        runEngine( &engines[0] , source , length , input , inputLength , &reference );
+        runEngine( &engines[engine] , source , length , input , inputLength , &result );
+
+    }
+
+    fprintf( stderr , "difference between %s and %s, reduced from %d statements:\n%s" , referenceEngine->name , engines[engine].name , originalCount , source );
+    fprintf( stderr , "input: %.*s" , (int) inputLength , input );
+    fprintf( stderr , "--- %s output:\n%.*s--- %s output:\n%.*s" , referenceEngine->name , (int) reference.outputLength , reference.output ,
+             engines[engine].name , (int) result.outputLength , result.output );
+    fprintf( stderr , "--- final values that differ:\n" );
+
+    //both engines write the symbols in the same order, one per line
+    if ( !comparesOutputOnly( &engines[engine] ) ) {
+        char *referenceLine = reference.values;
+        char *resultLine    = result.values;
+
+        while ( *referenceLine != '\0' || *resultLine != '\0' ) {
+
+            size_t referenceLength = strcspn( referenceLine , "\n" );
+            size_t resultLength    = strcspn( resultLine , "\n" );
+
+            if ( referenceLength != resultLength || memcmp( referenceLine , resultLine , referenceLength ) != 0 ) {
+
+                fprintf( stderr , "%s: %.*s\n%s: %.*s\n" , engines[0].name , (int) referenceLength , referenceLine ,
+                         engines[engine].name , (int) resultLength , resultLine );
+
+            }
+
+            referenceLine += referenceLength + ( referenceLine[referenceLength] == '\n' );
+            resultLine    += resultLength + ( resultLine[resultLength] == '\n' );
+
+        }
+    }
+
+    fprintf( stderr , "\n" );
+
+    freeEngineResult( &reference );
+    freeEngineResult( &result );
+    free( records );
+    free( source );
+
+}
+
+int runDifferentialTests( int count , unsigned long long seed ) {
+
+    int differences = 0;
+    int program;
+    int engine;
+
+    generatorState = seed != 0 ? seed : 1;
+
+    for ( program = 0 ; program < REGRESSION_COUNT ; program++ ) {
+
+        int compiled;
+
+        engine = findSourceDifference( regressionPrograms[program] , strlen( regressionPrograms[program] ) , "1 2 3\n" , 6 , &compiled );
+
+        if ( !compiled || engine != 0 ) {
+
+            fprintf( stderr , "regression program %d %s:\n%s" , program , compiled ? "differs" : "does not compile" , regressionPrograms[program] );
+
+            if ( engine != 0 ) {
+
+                fprintf( stderr , "engine %s differs from the tree walker\n" , engines[engine].name );
+
+            }
+
+            differences++;
+
+        }
+    }
+
+    for ( program = 0 ; program < count ; program++ ) {
+
+        GeneratedStatement *statements;
+        GeneratedStatement **list = NULL;
+        char input[INPUT_VALUES * 4 + 1];
+        size_t inputLength = 0;
+        int statementCount = 0;
+        int capacity = 0;
+        int compiled;
+        int value;
+
+        generateProcedures();
+
+        statements = generateStatements( 0 , 3 + randomBelow( 6 ) );
+
+        //only integers are read, so every type reads the same values
+        for ( value = 0 ; value < INPUT_VALUES ; value++ ) {
+
+            inputLength += snprintf( input + inputLength , sizeof( input ) - inputLength , value + 1 < INPUT_VALUES ? "%d " : "%d\n" , randomBelow( 25 ) - 5 );
+
+        }
+
+        engine = findDifference( statements , input , inputLength , &compiled );
+
+        if ( !compiled ) {
+
+            size_t length;
+            char *source = writeProgram( statements , &length );
+
+            fprintf( stderr , "generated program %d does not compile:\n%s" , program , source );
+
+            free( source );
+
+            differences++;
+
+        } else if ( engine != 0 ) {
+
+            collectGeneratedStatements( statements , &list , &statementCount , &capacity );
+
+            for ( value = 0 ; value < procedureCount ; value++ ) {
+
+                collectGeneratedStatements( procedures[value].body , &list , &statementCount , &capacity );
+
+            }
+
+            free( list );
+
+            reduceProgram( statements , input , inputLength );
+            reportDifference( statements , input , inputLength , findDifference( statements , input , inputLength , &compiled ) , statementCount );
+
+            differences++;
+
+        }
+
+        freeGeneratedStatements( statements );
+        forgetRepeatedExpresions();
+
+        for ( value = 0 ; value < procedureCount ; value++ ) {
+
+            freeGeneratedStatements( procedures[value].body );
+
+        }
+
+    }
+
+    fprintf( stderr , "differential testing: %d programs, %d regression programs, %d engines, %d differences\n" , count , REGRESSION_COUNT ,
+             ENGINE_COUNT , differences );
+
+    for ( engine = 0 ; engine < ENGINE_COUNT ; engine++ ) {
+
+        fprintf( stderr , "%-22s %10.3f ms %6.2fx\n" , engines[engine].name , engines[engine].milliseconds ,
+                 engines[engine].milliseconds > 0 ? engines[0].milliseconds / engines[engine].milliseconds : 0 );
+
+    }
+
+    return differences;
+}
+
+//end differential.c
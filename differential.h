@@ -0,0 +1,23 @@
+/**
+ * differential.h
+ * Definition of the differential testing of the execution engines: random well-typed programs are executed by every engine
+ * and their output and final symbol values are compared with the ones of the tree walker
+ * @author Jose Pablo Ortiz Lack
+ */
+#ifndef __DIFFERENTIAL_H__
+#define __DIFFERENTIAL_H__
+
+/**
+ * @brief generates random programs and executes each one with every engine. A program whose output or final symbol values differ
+ * between the tree walker and another engine is reduced to the fewest statements that still differ and printed to stderr,
+ * together with the time taken by every engine relative to the tree walker. The fixed programs that once made an engine differ are
+ * executed by every engine first
+ * @param count number of programs
+ * @param seed seed of the generator, the same seed generates the same programs
+ * @return the number of programs whose executions differ
+ */
+int runDifferentialTests( int count , unsigned long long seed );
+
+#endif //__DIFFERENTIAL_H__
+
+//end differential.h
@@ -0,0 +1,869 @@
+/**
+ * fastScanner.c
+ * Implementation of the hand-written scanner
+ *
+ * The scanner is written after the rules of lexer.l: the longest match wins and a keyword wins over an identifier of the same length.
+ * Runs of blanks and the characters of identifiers and numbers are classified one block at a time, 32 characters with AVX2 or
+ * 16 with SSE2, and the first character outside the run is found in the movemask of the block. Keywords are found with a perfect
+ * hash of their first and last characters, and numbers are converted without copying them.
+ * The locations after runs of blanks and the errors of unexpected characters follow the flex scanner. The scanner is only used with
+ * --fast-scanner, make scanner-differential compares its tokens, locations and errors with the ones of the flex scanner
+ * @author Jose Pablo Ortiz Lack
+ */
+#include "fastScanner.h"
+#include "Parser.h"
+#include "diagnostics.h"
+#include "arena.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <time.h>
+
+#if defined( __GNUC__ ) && defined( __x86_64__ )
+#include <immintrin.h>
+#define SCANNER_SIMD //SSE2 is always available on x86-64, AVX2 is used if the processor has it
+#endif
+
+/**
+ * @brief classes of the characters, the {WS} of lexer.l and the first characters of {ID} and {NUM}
+ */
+#define SCAN_BLANK 1
+#define SCAN_LETTER 2
+#define SCAN_DIGIT 3
+
+/**
+ * @brief index of a keyword in the perfect hash table, unique for every keyword
+ */
+#define KEYWORD_HASH( first , last ) ( ( (first) + 20 * (last) ) & 63 )
+
+/**
+ * @brief largest integer a double represents exactly
+ */
+#define EXACT_MANTISSA ( 1ULL << 53 )
+
+/**
+ * @brief lengths of the sources generated by the differential test
+ */
+#define SCANNER_FRAGMENTS 200
+
+int fastScannerEnabled = 0;
+
+/**
+ * @brief a keyword of the language
+ */
+typedef struct tagKeyword {
+
+    const char *text;
+    int length; //0 in the entries of the table without keyword
+    int token;
+    int typed; //1 if the keyword is a type, whose SymbolType is the value of the token
+    SymbolType symbolType;
+
+} Keyword;
+
+/**
+ * @brief a run of blanks, with the newlines needed to locate its last character
+ */
+typedef struct tagBlankRun {
+
+    const unsigned char *lastNewLine; //last newline of the run, NULL if the run has none
+    const unsigned char *previousNewLine; //newline before the last one, NULL if the run has less than two
+    int newLines; //newlines of the run
+
+} BlankRun;
+
+static const unsigned char characterClasses[256] = {
+
+    [' '] = SCAN_BLANK , ['\t'] = SCAN_BLANK , ['\n'] = SCAN_BLANK ,
+    ['a' ... 'z'] = SCAN_LETTER , ['A' ... 'Z'] = SCAN_LETTER ,
+    ['0' ... '9'] = SCAN_DIGIT
+
+};
+
+static const unsigned short operatorTokens[256] = {
+
+    ['('] = LPAREN , [')'] = RPAREN , ['['] = LBRACKET , [']'] = RBRACKET ,
+    ['+'] = SUM , ['-'] = SUB , ['*'] = MULT , ['/'] = DIV , [';'] = SEMICOLON , [','] = COMMA ,
+    ['>'] = GREATER_THAN , ['<'] = LESS_THAN , ['='] = EQUAL_TO
+
+};
+
+static const Keyword keywords[64] = {
+
+    [KEYWORD_HASH( 'p' , 'm' )] = { "program" , 7 , PROGRAM , 0 , 0 },
+    [KEYWORD_HASH( 'b' , 'n' )] = { "begin" , 5 , P_BEGIN , 0 , 0 },
+    [KEYWORD_HASH( 'e' , 'd' )] = { "end" , 3 , END , 0 , 0 },
+    [KEYWORD_HASH( 'i' , 't' )] = { "int" , 3 , INTEGER , 1 , sINTEGER },
+    [KEYWORD_HASH( 'f' , 't' )] = { "float" , 5 , FLOAT , 1 , sFLOAT },
+    [KEYWORD_HASH( 'l' , 'g' )] = { "long" , 4 , LONG , 1 , sLONG },
+    [KEYWORD_HASH( 'd' , 'e' )] = { "double" , 6 , DOUBLE , 1 , sDOUBLE },
+    [KEYWORD_HASH( 'i' , 'f' )] = { "if" , 2 , IF , 0 , 0 },
+    [KEYWORD_HASH( 't' , 'n' )] = { "then" , 4 , THEN , 0 , 0 },
+    [KEYWORD_HASH( 'e' , 'f' )] = { "endif" , 5 , ENDIF , 0 , 0 },
+    [KEYWORD_HASH( 'w' , 'e' )] = { "while" , 5 , WHILE , 0 , 0 },
+    [KEYWORD_HASH( 'd' , 'o' )] = { "do" , 2 , DO , 0 , 0 },
+    [KEYWORD_HASH( 'e' , 'w' )] = { "endw" , 4 , ENDW , 0 , 0 },
+    [KEYWORD_HASH( 'f' , 'r' )] = { "for" , 3 , FOR , 0 , 0 },
+    [KEYWORD_HASH( 's' , 'p' )] = { "step" , 4 , STEP , 0 , 0 },
+    [KEYWORD_HASH( 'u' , 'l' )] = { "until" , 5 , UNTIL , 0 , 0 },
+    [KEYWORD_HASH( 'e' , 'r' )] = { "endfor" , 6 , ENDFOR , 0 , 0 },
+    [KEYWORD_HASH( 'r' , 'd' )] = { "read" , 4 , READ , 0 , 0 },
+    [KEYWORD_HASH( 'p' , 't' )] = { "print" , 5 , PRINT , 0 , 0 },
+    [KEYWORD_HASH( 'p' , 'e' )] = { "procedure" , 9 , PROCEDURE , 0 , 0 }
+
+};
+
+static const double powersOfTen[23] = {
+
+    1e0 , 1e1 , 1e2 , 1e3 , 1e4 , 1e5 , 1e6 , 1e7 , 1e8 , 1e9 , 1e10 , 1e11 , 1e12 , 1e13 , 1e14 , 1e15 , 1e16 , 1e17 , 1e18 , 1e19 ,
+    1e20 , 1e21 , 1e22
+
+};
+
+/**
+ * @brief records the newlines of a block of blanks
+ * @param run the run of blanks
+ * @param block first character of the block
+ * @param newLines mask of the newlines of the block, bit i for the character i
+ */
+static inline void recordNewLines( BlankRun *run , const unsigned char *block , unsigned int newLines ) {
+
+    int last;
+
+    if ( newLines == 0 ) {
+
+        return;
+
+    }
+
+    last = 31 - __builtin_clz( newLines );
+
+    run->newLines       += __builtin_popcount( newLines );
+    newLines            &= ~( 1u << last );
+    run->previousNewLine = newLines != 0 ? block + 31 - __builtin_clz( newLines ) : run->lastNewLine;
+    run->lastNewLine     = block + last;
+
+}
+
+#ifdef SCANNER_SIMD
+
+/**
+ * @brief obtains the mask of the characters of a block within a range, bit i for the character i
+ */
+#define RANGE_MASK_SSE2( block , low , count ) \
+    _mm_movemask_epi8( _mm_cmplt_epi8( _mm_add_epi8( block , _mm_set1_epi8( (char) ( 128 - (low) ) ) ) , _mm_set1_epi8( (char) ( -128 + (count) ) ) ) )
+
+#define RANGE_MASK_AVX2( block , low , count ) \
+    (unsigned int) _mm256_movemask_epi8( _mm256_cmpgt_epi8( _mm256_set1_epi8( (char) ( -128 + (count) ) ) , \
+                                                            _mm256_add_epi8( block , _mm256_set1_epi8( (char) ( 128 - (low) ) ) ) ) )
+
+/**
+ * @brief skips the blanks of the blocks of 16 characters, stopping at the first character that is not a blank
+ * @return the first character that is not a blank, or the first character of the last incomplete block
+ */
+static const unsigned char *spanBlanksSse2( const unsigned char *cursor , const unsigned char *limit , BlankRun *run ) {
+
+    while ( limit - cursor >= 16 ) {
+
+        __m128i block      = _mm_loadu_si128( (const __m128i *) cursor );
+        __m128i newLine    = _mm_cmpeq_epi8( block , _mm_set1_epi8( '\n' ) );
+        __m128i blank      = _mm_or_si128( newLine , _mm_or_si128( _mm_cmpeq_epi8( block , _mm_set1_epi8( ' ' ) ) ,
+                                                                   _mm_cmpeq_epi8( block , _mm_set1_epi8( '\t' ) ) ) );
+        unsigned int stop  = ~_mm_movemask_epi8( blank ) & 0xffff;
+        unsigned int lines = _mm_movemask_epi8( newLine );
+
+        if ( stop != 0 ) {
+
+            int length = __builtin_ctz( stop );
+
+            recordNewLines( run , cursor , lines & ( ( 1u << length ) - 1 ) );
+
+            return cursor + length;
+
+        }
+
+        recordNewLines( run , cursor , lines );
+
+        cursor += 16;
+
+    }
+
+    return cursor;
+
+}
+
+__attribute__(( target( "avx2" ) ))
+static const unsigned char *spanBlanksAvx2( const unsigned char *cursor , const unsigned char *limit , BlankRun *run ) {
+
+    while ( limit - cursor >= 32 ) {
+
+        __m256i block      = _mm256_loadu_si256( (const __m256i *) cursor );
+        __m256i newLine    = _mm256_cmpeq_epi8( block , _mm256_set1_epi8( '\n' ) );
+        __m256i blank      = _mm256_or_si256( newLine , _mm256_or_si256( _mm256_cmpeq_epi8( block , _mm256_set1_epi8( ' ' ) ) ,
+                                                                         _mm256_cmpeq_epi8( block , _mm256_set1_epi8( '\t' ) ) ) );
+        unsigned int stop  = ~(unsigned int) _mm256_movemask_epi8( blank );
+        unsigned int lines = (unsigned int) _mm256_movemask_epi8( newLine );
+
+        if ( stop != 0 ) {
+
+            int length = __builtin_ctz( stop );
+
+            recordNewLines( run , cursor , lines & ( ( 1u << length ) - 1 ) );
+
+            return cursor + length;
+
+        }
+
+        recordNewLines( run , cursor , lines );
+
+        cursor += 32;
+
+    }
+
+    return cursor;
+
+}
+
+/**
+ * @brief skips the letters and digits of the blocks of 16 characters
+ * @param digitsOnly 1 to skip only digits
+ * @return the first character that is not skipped, or the first character of the last incomplete block
+ */
+static const unsigned char *spanWordSse2( const unsigned char *cursor , const unsigned char *limit , int digitsOnly ) {
+
+    while ( limit - cursor >= 16 ) {
+
+        __m128i block     = _mm_loadu_si128( (const __m128i *) cursor );
+        unsigned int word = RANGE_MASK_SSE2( block , '0' , 10 );
+
+        if ( !digitsOnly ) {
+
+            word |= RANGE_MASK_SSE2( _mm_or_si128( block , _mm_set1_epi8( 0x20 ) ) , 'a' , 26 ); //the bit 0x20 makes upper case letters lower case
+
+        }
+
+        if ( word != 0xffff ) {
+
+            return cursor + __builtin_ctz( ~word );
+
+        }
+
+        cursor += 16;
+
+    }
+
+    return cursor;
+
+}
+
+__attribute__(( target( "avx2" ) ))
+static const unsigned char *spanWordAvx2( const unsigned char *cursor , const unsigned char *limit , int digitsOnly ) {
+
+    while ( limit - cursor >= 32 ) {
+
+        __m256i block     = _mm256_loadu_si256( (const __m256i *) cursor );
+        unsigned int word = RANGE_MASK_AVX2( block , '0' , 10 );
+
+        if ( !digitsOnly ) {
+
+            word |= RANGE_MASK_AVX2( _mm256_or_si256( block , _mm256_set1_epi8( 0x20 ) ) , 'a' , 26 );
+
+        }
+
+        if ( word != 0xffffffffu ) {
+
+            return cursor + __builtin_ctz( ~word );
+
+        }
+
+        cursor += 32;
+
+    }
+
+    return cursor;
+
+}
+
+#endif
+
+/**
+ * @brief skips a run of blanks
+ * @return the first character after the run
+ */
+static const unsigned char *spanBlanks( const unsigned char *cursor , const unsigned char *limit , BlankRun *run ) {
+
+#ifdef SCANNER_SIMD
+
+    cursor = __builtin_cpu_supports( "avx2" ) ? spanBlanksAvx2( cursor , limit , run ) : spanBlanksSse2( cursor , limit , run );
+
+#endif
+
+    //the characters after the last complete block
+    while ( cursor < limit && characterClasses[*cursor] == SCAN_BLANK ) {
+
+        recordNewLines( run , cursor , *cursor == '\n' );
+
+        cursor++;
+
+    }
+
+    return cursor;
+
+}
+
+/**
+ * @brief skips the letters and digits of an identifier, or only the digits of a number
+ * @return the first character after them
+ */
+static const unsigned char *spanWord( const unsigned char *cursor , const unsigned char *limit , int digitsOnly ) {
+
+#ifdef SCANNER_SIMD
+
+    cursor = __builtin_cpu_supports( "avx2" ) ? spanWordAvx2( cursor , limit , digitsOnly ) : spanWordSse2( cursor , limit , digitsOnly );
+
+#endif
+
+    while ( cursor < limit && ( characterClasses[*cursor] == SCAN_DIGIT || ( !digitsOnly && characterClasses[*cursor] == SCAN_LETTER ) ) ) {
+
+        cursor++;
+
+    }
+
+    return cursor;
+
+}
+
+/**
+ * @brief locates a token of the given length at the column of the scanner, as YY_USER_ACTION does in lexer.l
+ */
+static inline void locateToken( YYLTYPE *location , ParseContext *context , int length ) {
+
+    location->first_line   = location->last_line = context->line;
+    location->first_column = context->column;
+    context->column       += length;
+    location->last_column  = context->column - 1;
+    lexerLine              = context->line;
+
+}
+
+/**
+ * @brief skips a run of blanks. The location is left as the rule {WS} of lexer.l, with YY_USER_ACTION, should leave it after matching
+ * the last blank of the run
+ * @return the first character after the run
+ */
+static const unsigned char *skipBlanks( const unsigned char *cursor , const unsigned char *limit , YYLTYPE *location , ParseContext *context ) {
+
+    BlankRun run = { NULL , NULL , 0 };
+    const unsigned char *start = cursor;
+    const unsigned char *last;
+
+    cursor = spanBlanks( cursor , limit , &run );
+    last   = cursor - 1;
+
+    context->line += run.newLines;
+
+    location->first_line = location->last_line = context->line;
+
+    //a newline restarts the column, the column of a blank is counted from the newline before it
+    if ( *last == '\n' ) {
+
+        location->first_column = run.previousNewLine != NULL ? (int) ( last - run.previousNewLine ) : context->column + (int) ( last - start );
+        context->column        = 1;
+
+    } else {
+
+        location->first_column = run.lastNewLine != NULL ? (int) ( last - run.lastNewLine ) : context->column + (int) ( last - start );
+        context->column        = location->first_column + 1;
+
+    }
+
+    location->last_column = context->column - 1;
+    lexerLine             = context->line;
+
+    return cursor;
+
+}
+
+/**
+ * @brief converts the digits of an integer as strtoll does, saturating at the largest long
+ */
+static long long convertInteger( const unsigned char *digit , const unsigned char *end ) {
+
+    long long value = 0;
+
+    for ( ; digit < end ; digit++ ) {
+
+        if ( __builtin_mul_overflow( value , 10 , &value ) || __builtin_add_overflow( value , *digit - '0' , &value ) ) {
+
+            return LLONG_MAX;
+
+        }
+    }
+
+    return value;
+
+}
+
+/**
+ * @brief converts a decimal number to the double strtod returns. A number with at most 15 significant digits and 22 decimals is
+ * the division of two doubles that represent their values exactly, which is rounded correctly. Other numbers are converted by strtod
+ */
+static double convertDecimal( const unsigned char *start , const unsigned char *end ) {
+
+    char digits[64];
+    char *text = digits;
+    unsigned long long mantissa = 0;
+    const unsigned char *digit;
+    int decimals = -1; //digits after the point, -1 before the point
+    size_t length = end - start;
+    double value;
+
+    if ( length <= 20 ) { //at most 19 digits and the point, so the mantissa does not overflow
+
+        for ( digit = start ; digit < end ; digit++ ) {
+
+            if ( *digit == '.' ) {
+
+                decimals = 0;
+
+                continue;
+
+            }
+
+            mantissa  = 10 * mantissa + ( *digit - '0' );
+            decimals += decimals >= 0;
+
+        }
+
+        if ( mantissa <= EXACT_MANTISSA && decimals <= 22 ) {
+
+            return (double) mantissa / powersOfTen[decimals];
+
+        }
+    }
+
+    if ( length >= sizeof( digits ) && ( text = malloc( length + 1 ) ) == NULL ) {
+
+        printf( "Error: Memory allocation failed. Program will be terminated\n" );
+        exit(1);
+
+    }
+
+    memcpy( text , start , length );
+    text[length] = '\0';
+
+    value = strtod( text , NULL );
+
+    if ( text != digits ) {
+
+        free( text );
+
+    }
+
+    return value;
+
+}
+
+void openFastScanner( ParseContext *context , const char *text , size_t length , int line ) {
+
+    context->cursor = text;
+    context->limit  = text + length;
+    context->line   = line;
+    lexerLine       = line;
+
+}
+
+int scanFastToken( YYSTYPE *value , YYLTYPE *location , ParseContext *context ) {
+
+    const unsigned char *cursor = (const unsigned char *) context->cursor;
+    const unsigned char *limit  = (const unsigned char *) context->limit;
+
+    for ( ;; ) {
+
+        const unsigned char *start = cursor;
+        int token;
+
+        if ( cursor == limit ) {
+
+            context->cursor = (const char *) cursor;
+
+            return 0;
+
+        }
+
+        switch ( characterClasses[*cursor] ) {
+
+            case SCAN_BLANK:
+
+                cursor = skipBlanks( cursor , limit , location , context );
+
+            continue;
+
+            case SCAN_LETTER: { //{ID}, or a keyword if the identifier is one
+
+                const Keyword *keyword;
+                int length;
+
+                cursor  = spanWord( cursor + 1 , limit , 0 );
+                length  = (int) ( cursor - start );
+                keyword = &keywords[KEYWORD_HASH( start[0] , start[length - 1] )];
+
+                locateToken( location , context , length );
+
+                if ( keyword->length == length && memcmp( keyword->text , start , length ) == 0 ) {
+
+                    if ( keyword->typed ) {
+
+                        value->sValue = keyword->symbolType;
+
+                    }
+
+                    token = keyword->token;
+
+                } else {
+
+                    value->idValue = copyCompilerString( (const char *) start , length );
+                    token          = ID;
+
+                }
+            }
+            break;
+
+            case SCAN_DIGIT: //{NUM}, or {NUMFLOAT} if the integer part is followed by a point
+
+                cursor = *cursor == '0' ? cursor + 1 : spanWord( cursor + 1 , limit , 1 ); //only 0 may start with 0
+
+                if ( cursor < limit && *cursor == '.' ) {
+
+                    cursor = spanWord( cursor + 1 , limit , 1 );
+
+                    locateToken( location , context , (int) ( cursor - start ) );
+
+                    value->dValue = convertDecimal( start , cursor );
+                    token         = NUMFLOAT;
+
+                } else {
+
+                    locateToken( location , context , (int) ( cursor - start ) );
+
+                    value->lValue = convertInteger( start , cursor );
+                    token         = NUM;
+
+                }
+
+            break;
+
+            default:
+
+                if ( operatorTokens[*cursor] != 0 ) {
+
+                    token = operatorTokens[*cursor];
+                    cursor++;
+
+                } else if ( *cursor == ':' && cursor + 1 < limit && cursor[1] == '=' ) {
+
+                    token   = ASSIGNMENT;
+                    cursor += 2;
+
+                } else { //the rule . of lexer.l reports the character and the scanner continues
+
+                    char text[2] = { (char) *cursor , '\0' };
+
+                    locateToken( location , context , 1 );
+                    reportDiagnostic( context->line , location->first_column , "Unexpected character %s" , text );
+
+                    cursor++;
+
+                    continue;
+
+                }
+
+                locateToken( location , context , (int) ( cursor - start ) );
+
+            break;
+
+        }
+
+        context->cursor = (const char *) cursor;
+
+        return token;
+
+    }
+}
+
+/********** differential test **********/
+
+static unsigned long long scannerState; //state of the xorshift generator of the sources
+
+/**
+ * @brief obtains a random number between 0 and bound - 1
+ */
+static int randomFragment( int bound ) {
+
+    scannerState ^= scannerState << 13;
+    scannerState ^= scannerState >> 7;
+    scannerState ^= scannerState << 17;
+
+    return (int) ( scannerState % (unsigned long long) bound );
+
+}
+
+/**
+ * @brief generates a source of random fragments. Fragments are often joined without blanks, so the longest match decides where
+ * the tokens end
+ * @return the length of the source
+ */
+static size_t generateScannerSource( char *source , size_t capacity ) {
+
+    static const char *fragments[] = {
+        "program" , "begin" , "end" , "int" , "float" , "long" , "double" , "if" , "then" , "endif" , "while" , "do" , "endw" ,
+        "for" , "step" , "until" , "endfor" , "read" , "print" , "procedure" , "proc" , "en" , "endfo" , "endforx" , "Int" , "printf" ,
+        "x" , "a1" , "Z9z" , "identifierLongerThanOneBlockOfThirtyTwoCharacters" , "0" , "007" , "42" , "1." , "0.5" , "12.340" ,
+        "3.14159265358979323846" , "99999999999999999999" , "9007199254740993.0" , "0.0000000000000000000000001" , "123456789012345678901234567890" ,
+        ":=" , ":" , "=" , "(" , ")" , "[" , "]" , "+" , "-" , "*" , "/" , ";" , "," , "<" , ">" , "." , " " , "\t" , "\n" , "\n\n" ,
+        "  \t \n   " , "                                        " , "\n                                    \t\n  " , "\r" , "#" ,
+        "@" , "\x80" , "\xff" , "_"
+    };
+    int fragmentCount = (int) ( sizeof( fragments ) / sizeof( fragments[0] ) );
+    int count = 1 + randomFragment( SCANNER_FRAGMENTS );
+    size_t length = 0;
+
+    for ( ; count > 0 ; count-- ) {
+
+        const char *fragment = fragments[randomFragment( fragmentCount )];
+        size_t fragmentLength = strlen( fragment );
+
+        if ( length + fragmentLength + 1 >= capacity ) {
+
+            break;
+
+        }
+
+        memcpy( source + length , fragment , fragmentLength );
+        length += fragmentLength;
+
+        if ( randomFragment( 3 ) == 0 ) {
+
+            source[length++] = randomFragment( 4 ) == 0 ? '\n' : ' ';
+
+        }
+    }
+
+    return length;
+
+}
+
+/**
+ * @brief lexes a source with one of the scanners into the token list of a context, and its errors into text
+ * @return the time taken in seconds
+ */
+static double lexWithScanner( ParseContext *context , const char *source , size_t length , int fast , char **errors , size_t *errorsLength ) {
+
+    int enabled = fastScannerEnabled;
+    struct timespec start;
+    struct timespec end;
+    FILE *stream;
+
+    fastScannerEnabled = fast;
+
+    clock_gettime( CLOCK_MONOTONIC , &start );
+    lexProgram( context , source , (int) length );
+    clock_gettime( CLOCK_MONOTONIC , &end );
+
+    fastScannerEnabled = enabled;
+
+    stream = open_memstream( errors , errorsLength );
+    printDiagnostics( stream );
+    fclose( stream );
+
+    clearDiagnostics();
+
+    return ( end.tv_sec - start.tv_sec ) + ( end.tv_nsec - start.tv_nsec ) / 1e9;
+
+}
+
+/**
+ * @brief compares the tokens of two lists
+ * @return the index of the first token that differs, -1 if the lists are equal
+ */
+static int compareTokens( ParseContext *flex , ParseContext *fast ) {
+
+    int index;
+
+    for ( index = 0 ; index < flex->tokenCount && index < fast->tokenCount ; index++ ) {
+
+        Token *expected = &flex->tokens[index];
+        Token *token    = &fast->tokens[index];
+
+        if ( expected->type != token->type || expected->line != token->line ||
+             memcmp( &expected->location , &token->location , sizeof( YYLTYPE ) ) != 0 ) {
+
+            return index;
+
+        }
+
+        switch ( token->type ) {
+
+            case ID:
+
+                if ( strcmp( expected->value.idValue , token->value.idValue ) != 0 ) {
+
+                    return index;
+
+                }
+
+            break;
+
+            case NUM:
+
+                if ( expected->value.lValue != token->value.lValue ) {
+
+                    return index;
+
+                }
+
+            break;
+
+            case NUMFLOAT:
+
+                if ( memcmp( &expected->value.dValue , &token->value.dValue , sizeof( double ) ) != 0 ) {
+
+                    return index;
+
+                }
+
+            break;
+
+            case INTEGER:
+            case FLOAT:
+            case LONG:
+            case DOUBLE:
+
+                if ( expected->value.sValue != token->value.sValue ) {
+
+                    return index;
+
+                }
+
+            break;
+
+            default:
+
+            break;
+
+        }
+    }
+
+    return flex->tokenCount == fast->tokenCount ? -1 : index;
+
+}
+
+/**
+ * @brief prints a token of a list, or the end of the list
+ */
+static void printToken( const char *scanner , ParseContext *context , int index ) {
+
+    Token *token;
+
+    if ( index >= context->tokenCount ) {
+
+        fprintf( stderr , "  %s: no token\n" , scanner );
+
+        return;
+
+    }
+
+    token = &context->tokens[index];
+
+    fprintf( stderr , "  %s: token %d at %d:%d-%d:%d, line %d" , scanner , token->type , token->location.first_line ,
+             token->location.first_column , token->location.last_line , token->location.last_column , token->line );
+
+    if ( token->type == ID ) {
+
+        fprintf( stderr , ", %s" , token->value.idValue );
+
+    } else if ( token->type == NUM ) {
+
+        fprintf( stderr , ", %lld" , token->value.lValue );
+
+    } else if ( token->type == NUMFLOAT ) {
+
+        fprintf( stderr , ", %.17g" , token->value.dValue );
+
+    }
+
+    fprintf( stderr , "\n" );
+
+}
+
+int runScannerDifferential( int count , unsigned long long seed ) {
+
+    static char source[16384];
+    double seconds[2] = { 0 , 0 };
+    size_t bytes = 0;
+    int differences = 0;
+    int index;
+
+    scannerState = seed != 0 ? seed : 1;
+
+    for ( index = 0 ; index < count ; index++ ) {
+
+        size_t length = generateScannerSource( source , sizeof( source ) );
+        ParseContext flex = { 0 };
+        ParseContext fast = { 0 };
+        Arena arena = { 0 };
+        char *flexErrors;
+        char *fastErrors;
+        size_t flexErrorsLength;
+        size_t fastErrorsLength;
+        int token;
+
+        currentArena = &arena; //the identifiers of both lists are released with the arena
+
+        seconds[0] += lexWithScanner( &flex , source , length , 0 , &flexErrors , &flexErrorsLength );
+        seconds[1] += lexWithScanner( &fast , source , length , 1 , &fastErrors , &fastErrorsLength );
+        bytes      += length;
+
+        token = compareTokens( &flex , &fast );
+
+        if ( token >= 0 || flexErrorsLength != fastErrorsLength || memcmp( flexErrors , fastErrors , flexErrorsLength ) != 0 ) {
+
+            fprintf( stderr , "difference between the flex and the hand-written scanner in source %d:\n%.*s\n" , index , (int) length , source );
+
+            if ( token >= 0 ) {
+
+                fprintf( stderr , "token %d differs:\n" , token );
+                printToken( "flex" , &flex , token );
+                printToken( "hand-written" , &fast , token );
+
+            } else {
+
+                fprintf( stderr , "--- flex errors:\n%s--- hand-written errors:\n%s" , flexErrors , fastErrors );
+
+            }
+
+            differences++;
+
+        }
+
+        free( flexErrors );
+        free( fastErrors );
+        free( flex.tokens );
+        free( fast.tokens );
+
+        currentArena = NULL;
+        releaseArena( &arena );
+
+    }
+
+    fprintf( stderr , "scanner differential testing: %d sources, %.3f MB, %d differences\n" , count , bytes / 1048576.0 , differences );
+    fprintf( stderr , "flex scanner: %.3f ms, %.3f MB/s\nhand-written scanner: %.3f ms, %.3f MB/s\n" , 1000 * seconds[0] ,
+             seconds[0] > 0 ? bytes / 1048576.0 / seconds[0] : 0 , 1000 * seconds[1] , seconds[1] > 0 ? bytes / 1048576.0 / seconds[1] : 0 );
+
+    return differences;
+
+}
+
+//end fastScanner.c
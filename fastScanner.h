@@ -0,0 +1,51 @@
+/**
+ * fastScanner.h
+ * Definition of the hand-written scanner, an alternative to the flex scanner of lexer.l meant to return the same tokens, locations
+ * and errors. Blanks, identifiers and numbers are scanned 16 or 32 characters at a time with SSE2 or AVX2. The scanner is opt-in until
+ * make scanner-differential, which compares it with the scanner flex generates from lexer.l, reports no differences
+ * @author Jose Pablo Ortiz Lack
+ */
+#ifndef __FAST_SCANNER_H__
+#define __FAST_SCANNER_H__
+
+#include <stddef.h>
+
+#include "Parser.h"
+
+/**
+ * @brief reads the sources with the hand-written scanner instead of the flex scanner
+ */
+extern int fastScannerEnabled;
+
+/**
+ * @brief makes the hand-written scanner read a source from memory. The scanner keeps no state besides the context
+ * @param context context of the parse, its column must be set by the caller
+ * @param text source to be scanned, it is not modified and needs no null terminator
+ * @param length length of the source
+ * @param line line of the first character
+ */
+void openFastScanner( ParseContext *context , const char *text , size_t length , int line );
+
+/**
+ * @brief scans the next token of the source, with the value and location the flex scanner is meant to give it. Unexpected characters are
+ * added to the diagnostics and skipped. At the end of the source the location is not modified
+ * @param value semantic value of the token
+ * @param location location of the token
+ * @param context context of the parse, opened by openFastScanner
+ * @return the token type, 0 at the end of the source
+ */
+int scanFastToken( YYSTYPE *value , YYLTYPE *location , ParseContext *context );
+
+/**
+ * @brief lexes random sources made of keywords, identifiers, numbers, operators, blanks and invalid characters with both
+ * scanners and compares the tokens, values, locations, lines and errors they produce. Every difference is printed to stderr
+ * followed by the throughput of both scanners. The comparison is only meaningful in a build whose Lexer.c was generated by flex
+ * @param count number of sources
+ * @param seed seed of the generator of the sources
+ * @return the number of sources with differences
+ */
+int runScannerDifferential( int count , unsigned long long seed );
+
+#endif //__FAST_SCANNER_H__
+
+//end fastScanner.h
@@ -0,0 +1,373 @@
+/**
+ * frontEnd.c
+ * Implementation of the parallel front end
+ *
+ * The workers claim the files one at a time from a shared counter, so a large file does not hold back the files queued behind it.
+ * Every worker compiles with its own parse context and arena, and the diagnostics and metrics it reports are thread local.
+ * The errors of a file are formatted into its result and printed once every worker has finished, so they always come out in the
+ * order of the files no matter which thread compiled them
+ * @author Jose Pablo Ortiz Lack
+ */
+#include "frontEnd.h"
+#include "Parser.h"
+#include "arena.h"
+#include "diagnostics.h"
+#include "metrics.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <time.h>
+#include <unistd.h>
+
+/**
+ * @brief number of phases of the compilation of a file
+ */
+#define FRONT_END_PHASES 3
+
+/**
+ * @brief the phases of the compilation of a file
+ */
+typedef enum tagFrontEndPhase {
+
+    fREAD, //the file is read into memory
+    fLEX, //the source is lexed into the token list
+    fPARSE //the tokens are parsed and the tree is checked
+
+} FrontEndPhase;
+
+/**
+ * @brief names of the phases, in FrontEndPhase order
+ */
+static const char *phaseNames[FRONT_END_PHASES] = { "read" , "lex" , "parse and check" };
+
+/**
+ * @brief the outcome of the compilation of a file
+ */
+typedef struct tagFileResult {
+
+    char *errors; //formatted errors of the file
+    size_t errorsLength; //length of the formatted errors
+    int errorCount; //number of errors
+
+    size_t bytes; //length of the source
+
+} FileResult;
+
+/**
+ * @brief the files compiled by the workers
+ */
+typedef struct tagFrontEnd {
+
+    char **fileNames; //names of the files
+    int fileCount; //number of files
+
+    FileResult *results; //results of the files, in the order of the files
+
+    atomic_int nextFile; //index of the next file claimed by a worker
+
+} FrontEnd;
+
+/**
+ * @brief a thread of the front end
+ */
+typedef struct tagFrontEndWorker {
+
+    pthread_t thread; //thread running the worker
+    FrontEnd *frontEnd; //files compiled by the worker
+
+    Token *tokens; //token list, reused by every file the worker compiles
+    int tokenCapacity; //capacity of the token list
+
+    double milliseconds[FRONT_END_PHASES]; //time spent in every phase
+    size_t largestArena; //bytes of the largest arena of the files of the worker
+
+    Metrics metrics; //counters of the thread once it finished
+
+} FrontEndWorker;
+
+/**
+ * @brief obtains the current time in milliseconds
+ */
+static double currentMilliseconds() {
+
+    struct timespec now;
+
+    clock_gettime( CLOCK_MONOTONIC , &now );
+
+    return now.tv_sec * 1000.0 + now.tv_nsec / 1000000.0;
+}
+
+/**
+ * @brief reads a complete file into memory
+ * @return the contents of the file, NULL if it cannot be read
+ */
+static char *readFile( const char *fileName , size_t *length ) {
+
+    FILE *file = fopen( fileName , "r" );
+    char *source = NULL;
+    size_t capacity = 0;
+    size_t count;
+
+    if ( file == NULL ) {
+
+        return NULL;
+
+    }
+
+    *length = 0;
+
+    do {
+
+        if ( *length == capacity ) {
+
+            capacity = capacity == 0 ? 4096 : 2 * capacity;
+            source   = realloc( source , capacity );
+
+            if ( source == NULL ) {
+
+                printf( "Error: Memory allocation failed. Program will be terminated\n" );
+                exit(1);
+
+            }
+        }
+
+        count    = fread( source + *length , 1 , capacity - *length , file );
+        *length += count;
+
+    } while ( count > 0 );
+
+    fclose( file );
+
+    return source;
+}
+
+/**
+ * @brief lexes, parses and checks one file, keeping its formatted errors in its result
+ */
+static void compileFile( FrontEndWorker *worker , int index ) {
+
+    FrontEnd *frontEnd = worker->frontEnd;
+    FileResult *result = &frontEnd->results[index];
+    ParseContext context = { 0 };
+    Arena arena = { 0 };
+    FILE *errors;
+    char *source;
+    double start = currentMilliseconds();
+    double end;
+
+    source = readFile( frontEnd->fileNames[index] , &result->bytes );
+
+    end = currentMilliseconds();
+    worker->milliseconds[fREAD] += end - start;
+    start = end;
+
+    errors = open_memstream( &result->errors , &result->errorsLength );
+
+    if ( errors == NULL ) {
+
+        printf( "Error: Memory allocation failed. Program will be terminated\n" );
+        exit(1);
+
+    }
+
+    if ( source == NULL ) {
+
+        fprintf( errors , "Error: cannot open %s\n" , frontEnd->fileNames[index] );
+        fclose( errors );
+
+        result->errorCount = 1;
+
+        return;
+
+    }
+
+    //the tree, the symbols and the identifiers of the file are allocated from its arena
+    currentArena          = &arena;
+    memoryLimitExceeded   = 0;
+    context.tokens        = worker->tokens;
+    context.tokenCapacity = worker->tokenCapacity;
+
+    lexProgram( &context , source , (int) result->bytes );
+
+    free( source );
+
+    end = currentMilliseconds();
+    worker->milliseconds[fLEX] += end - start;
+    start = end;
+
+    parseProgram( &context );
+
+    end = currentMilliseconds();
+    worker->milliseconds[fPARSE] += end - start;
+
+    currentArena          = NULL;
+    worker->tokens        = context.tokens;
+    worker->tokenCapacity = context.tokenCapacity;
+
+    if ( arena.bytes > worker->largestArena ) {
+
+        worker->largestArena = arena.bytes;
+
+    }
+
+    result->errorCount = printFileDiagnostics( errors , frontEnd->fileNames[index] );
+
+    fclose( errors );
+
+    clearDiagnostics();
+    releaseArena( &arena );
+
+}
+
+/**
+ * @brief compiles the files claimed by a worker until every file was claimed
+ */
+static void *runWorker( void *argument ) {
+
+    FrontEndWorker *worker = argument;
+    int index;
+
+    while ( ( index = atomic_fetch_add( &worker->frontEnd->nextFile , 1 ) ) < worker->frontEnd->fileCount ) {
+
+        compileFile( worker , index );
+
+    }
+
+    worker->metrics = metrics;
+
+    free( worker->tokens );
+
+    return NULL;
+}
+
+int runFrontEnd( char **fileNames , int fileCount , int threadCount ) {
+
+    FrontEnd frontEnd;
+    FrontEndWorker *workers;
+    sigset_t blocked;
+    sigset_t previous;
+    double milliseconds[FRONT_END_PHASES] = { 0 };
+    double start;
+    double elapsed;
+    size_t bytes = 0;
+    size_t largestArena = 0;
+    MemoryUsage usage;
+    int failedFiles = 0;
+    int index;
+    int phase;
+
+    if ( threadCount <= 0 ) {
+
+        threadCount = (int) sysconf( _SC_NPROCESSORS_ONLN );
+
+    }
+
+    if ( threadCount > fileCount ) {
+
+        threadCount = fileCount;
+
+    }
+
+    if ( threadCount < 1 ) {
+
+        threadCount = 1;
+
+    }
+
+    frontEnd.fileNames = fileNames;
+    frontEnd.fileCount = fileCount;
+    frontEnd.results   = calloc( fileCount > 0 ? fileCount : 1 , sizeof( FileResult ) );
+    workers            = calloc( threadCount , sizeof( FrontEndWorker ) );
+
+    atomic_init( &frontEnd.nextFile , 0 );
+
+    if ( frontEnd.results == NULL || workers == NULL ) {
+
+        printf( "Error: Memory allocation failed. Program will be terminated\n" );
+        exit(1);
+
+    }
+
+    //the workers inherit a mask with every signal blocked, so the signals keep being handled by the main thread
+    sigfillset( &blocked );
+    pthread_sigmask( SIG_SETMASK , &blocked , &previous );
+
+    start = currentMilliseconds();
+
+    for ( index = 0 ; index < threadCount ; index++ ) {
+
+        workers[index].frontEnd = &frontEnd;
+
+        if ( pthread_create( &workers[index].thread , NULL , runWorker , &workers[index] ) != 0 ) {
+
+            printf( "Error: Cannot create the threads of the front end. Program will be terminated\n" );
+            exit(1);
+
+        }
+    }
+
+    for ( index = 0 ; index < threadCount ; index++ ) {
+
+        pthread_join( workers[index].thread , NULL );
+
+        addMetrics( &workers[index].metrics );
+
+        for ( phase = 0 ; phase < FRONT_END_PHASES ; phase++ ) {
+
+            milliseconds[phase] += workers[index].milliseconds[phase];
+
+        }
+
+        if ( workers[index].largestArena > largestArena ) {
+
+            largestArena = workers[index].largestArena;
+
+        }
+    }
+
+    elapsed = currentMilliseconds() - start;
+
+    pthread_sigmask( SIG_SETMASK , &previous , NULL );
+
+    for ( index = 0 ; index < fileCount ; index++ ) {
+
+        fwrite( frontEnd.results[index].errors , 1 , frontEnd.results[index].errorsLength , stderr );
+
+        failedFiles += frontEnd.results[index].errorCount > 0;
+        bytes       += frontEnd.results[index].bytes;
+
+        free( frontEnd.results[index].errors );
+
+    }
+
+    fprintf( stderr , "front end: %d files, %.3f MB, %d threads, %.3f ms, %.0f files/s, %.3f MB/s\n" , fileCount , bytes / 1048576.0 , threadCount ,
+             elapsed , elapsed > 0 ? 1000.0 * fileCount / elapsed : 0 , elapsed > 0 ? 1000.0 * bytes / 1048576.0 / elapsed : 0 );
+
+    //the time of a phase is the time the workers spent in it divided by the number of workers, its share of the elapsed time
+    for ( phase = 0 ; phase < FRONT_END_PHASES ; phase++ ) {
+
+        double phaseMilliseconds = milliseconds[phase] / threadCount;
+
+        fprintf( stderr , "%s: %.3f ms, %.0f files/s, %.3f MB/s\n" , phaseNames[phase] , phaseMilliseconds ,
+                 phaseMilliseconds > 0 ? 1000.0 * fileCount / phaseMilliseconds : 0 , phaseMilliseconds > 0 ? 1000.0 * bytes / 1048576.0 / phaseMilliseconds : 0 );
+
+    }
+
+    getMemoryUsage( &usage );
+
+    fprintf( stderr , "largest arena: %zu bytes\n" , largestArena );
+    fprintf( stderr , "peak memory: %zu bytes, the arenas of every worker at once\n" , usage.peakTotal );
+    fprintf( stderr , "files with errors: %d\n" , failedFiles );
+
+    free( frontEnd.results );
+    free( workers );
+
+    return failedFiles;
+
+}
+
+//end frontEnd.c
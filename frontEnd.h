@@ -0,0 +1,22 @@
+/**
+ * frontEnd.h
+ * Definition of the parallel front end, which lexes, parses and checks many programs at once on a pool of threads
+ * @author Jose Pablo Ortiz Lack
+ */
+#ifndef __FRONT_END_H__
+#define __FRONT_END_H__
+
+/**
+ * @brief lexes, parses and checks files without executing them. Every file is compiled by one of the threads with its own
+ * symbol table and arena; the errors of the files are printed to stderr in the order of the files, followed by the time
+ * and the throughput of every phase
+ * @param fileNames names of the files
+ * @param fileCount number of files
+ * @param threadCount number of threads, 0 to use one per online processor
+ * @return the number of files with errors
+ */
+int runFrontEnd( char **fileNames , int fileCount , int threadCount );
+
+#endif //__FRONT_END_H__
+
+//end frontEnd.h
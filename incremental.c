@@ -0,0 +1,1170 @@
+/**
+ * incremental.c
+ * Implementation of the recompilation of a program after an edit
+ * @author Jose Pablo Ortiz Lack
+ */
+#include "incremental.h"
+#include "symbolTable.h"
+#include "syntaxTree.h"
+#include "rangeAnalysis.h"
+#include "diagnostics.h"
+#include "Parser.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <ctype.h>
+#include <time.h>
+
+/**
+ * @brief Allocates zeroed memory for the incremental program
+ * @param size number of bytes
+ * @return the memory, the program will terminate if there is not enough memory
+ */
+static void *allocateIncrementalMemory( size_t size ) {
+
+    void *memory = calloc( 1 , size > 0 ? size : 1 );
+
+    if ( memory == NULL ) {
+
+        printf( "Error: Memory allocation failed. Program will be terminated\n" );
+        exit(1);
+
+    }
+
+    return memory;
+}
+
+/**
+ * @brief resizes memory of the incremental program
+ * @return the memory, the program will terminate if there is not enough memory
+ */
+static void *reallocateIncrementalMemory( void *memory , size_t size ) {
+
+    memory = realloc( memory , size > 0 ? size : 1 );
+
+    if ( memory == NULL ) {
+
+        printf( "Error: Memory allocation failed. Program will be terminated\n" );
+        exit(1);
+
+    }
+
+    return memory;
+}
+
+/**
+ * @brief obtains the current time in milliseconds
+ */
+static double currentMilliseconds() {
+
+    struct timespec now;
+
+    clock_gettime( CLOCK_MONOTONIC , &now );
+
+    return now.tv_sec * 1000.0 + now.tv_nsec / 1000000.0;
+}
+
+/**
+ * @brief counts the new lines of a range of text
+ */
+static int countLines( const char *text , size_t length ) {
+
+    int lines = 0;
+    size_t index;
+
+    for ( index = 0 ; index < length ; index++ ) {
+
+        lines += text[index] == '\n';
+
+    }
+
+    return lines;
+}
+
+/**
+ * @brief verifies if a word of the source is a keyword
+ */
+static int isWord( const char *word , size_t length , const char *keyword ) {
+
+    return strlen( keyword ) == length && strncmp( word , keyword , length ) == 0;
+
+}
+
+/**
+ * @brief finds the end of the top-level statement that starts at a position. Statements nested in if, while and for are skipped
+ * @param source source of the program
+ * @param position offset of the first character of the statement
+ * @param length length of the source
+ * @param isLast set to 1 if the statement is followed by the final end keyword, 0 if it is followed by a ;
+ * @return offset of the ; or of the end keyword that follows the statement
+ */
+static size_t scanStatement( const char *source , size_t position , size_t length , int *isLast ) {
+
+    int depth = 0;
+
+    while ( position < length ) {
+
+        if ( isalpha( (unsigned char) source[position] ) ) {
+
+            size_t wordStart = position;
+            size_t wordLength;
+
+            while ( position < length && isalnum( (unsigned char) source[position] ) ) {
+
+                position++;
+
+            }
+
+            wordLength = position - wordStart;
+
+            if ( isWord( source + wordStart , wordLength , "if" ) || isWord( source + wordStart , wordLength , "while" ) || isWord( source + wordStart , wordLength , "for" ) ) {
+
+                depth++;
+
+            } else if ( isWord( source + wordStart , wordLength , "endif" ) || isWord( source + wordStart , wordLength , "endw" ) || isWord( source + wordStart , wordLength , "endfor" ) ) {
+
+                depth--;
+
+            } else if ( depth == 0 && isWord( source + wordStart , wordLength , "end" ) ) {
+
+                *isLast = 1;
+
+                return wordStart;
+
+            }
+
+        } else if ( depth == 0 && source[position] == ';' ) {
+
+            *isLast = 0;
+
+            return position;
+
+        } else {
+
+            position++;
+
+        }
+    }
+
+    *isLast = 1;
+
+    return length;
+}
+
+/**
+ * @brief finds the begin keyword that ends the header of the program, after the bodies of the procedures
+ * @return offset of the begin keyword or the length of the source if there is none
+ */
+static size_t findBegin( const char *source , size_t length ) {
+
+    size_t position = 0;
+    int procedure   = 0; //1 in the declarations of a procedure, 2 in its body
+
+    while ( position < length ) {
+
+        if ( isalpha( (unsigned char) source[position] ) ) {
+
+            size_t wordStart = position;
+
+            while ( position < length && isalnum( (unsigned char) source[position] ) ) {
+
+                position++;
+
+            }
+
+            if ( isWord( source + wordStart , position - wordStart , "procedure" ) ) {
+
+                procedure = 1;
+
+            } else if ( isWord( source + wordStart , position - wordStart , "begin" ) ) {
+
+                if ( procedure == 0 ) {
+
+                    return wordStart;
+
+                }
+
+                procedure = 2;
+
+            } else if ( procedure == 2 && isWord( source + wordStart , position - wordStart , "end" ) ) {
+
+                procedure = 0;
+
+            }
+
+        } else {
+
+            position++;
+
+        }
+    }
+
+    return length;
+}
+
+/**
+ * @brief verifies if the identifier of a node is the identifier of a symbol
+ */
+static int namesSymbol( Node *tree ) {
+
+    return ( tree->type == nVALUE && ( tree->operationType == oID || tree->operationType == oINDEX ) ) || tree->type == nASSIGNMENT ||
+           tree->type == nREAD || tree->type == nFOR || tree->type == nCALL || tree->type == nPROCEDURE;
+
+}
+
+/**
+ * @brief hashes an identifier into a bucket of the lists of dependents
+ */
+static unsigned int hashIdentifier( const char *identifier ) {
+
+    unsigned int hash = 2166136261u;
+
+    while ( *identifier != '\0' ) {
+
+        hash = ( hash ^ (unsigned char) *identifier++ ) * 16777619u;
+
+    }
+
+    return hash & ( DEPENDENT_BUCKETS - 1 );
+}
+
+/**
+ * @brief finds the list of the statements that use a symbol
+ * @param create 1 to add an empty list if the symbol has none
+ * @return the list, NULL if the symbol has none and create is 0
+ */
+static DependentList *findDependentList( IncrementalProgram *program , char *identifier , int create ) {
+
+    DependentList **bucket = &program->dependentLists[hashIdentifier( identifier )];
+    DependentList *list;
+
+    for ( list = *bucket ; list != NULL ; list = list->next ) {
+
+        if ( strcmp( list->identifier , identifier ) == 0 ) {
+
+            return list;
+
+        }
+    }
+
+    if ( !create ) {
+
+        return NULL;
+
+    }
+
+    list             = allocateIncrementalMemory( sizeof( DependentList ) );
+    list->identifier = identifier;
+    list->next       = *bucket;
+    *bucket          = list;
+
+    return list;
+}
+
+/**
+ * @brief gives a new handle to a statement that was just parsed and adds it to the lists of the symbols it uses
+ * @param index position of the statement in the statement list
+ */
+static void indexDependencies( IncrementalProgram *program , IncrementalStatement *statement , int index ) {
+
+    int dependency;
+
+    if ( program->handleCount == program->handleCapacity ) {
+
+        program->handleCapacity  = program->handleCapacity == 0 ? 64 : 2 * program->handleCapacity;
+        program->handlePositions = reallocateIncrementalMemory( program->handlePositions , program->handleCapacity * sizeof( int ) );
+
+    }
+
+    statement->handle                           = program->handleCount++;
+    program->handlePositions[statement->handle] = index;
+
+    statement->dependents = allocateIncrementalMemory( statement->dependencyCount * sizeof( Dependent ) );
+
+    for ( dependency = 0 ; dependency < statement->dependencyCount ; dependency++ ) {
+
+        Dependent *entry    = &statement->dependents[dependency];
+        DependentList *list = findDependentList( program , statement->dependencies[dependency] , 1 );
+
+        entry->handle = statement->handle;
+        entry->list   = list;
+        entry->next   = list->first;
+
+        if ( list->first != NULL ) {
+
+            list->first->previous = entry;
+
+        }
+
+        list->first = entry;
+
+    }
+}
+
+/**
+ * @brief removes a statement from the lists of the symbols it uses and releases its dependencies, before it is parsed again or replaced
+ */
+static void releaseDependencies( IncrementalProgram *program , IncrementalStatement *statement ) {
+
+    int dependency;
+
+    for ( dependency = 0 ; dependency < statement->dependencyCount ; dependency++ ) {
+
+        Dependent *entry = &statement->dependents[dependency];
+
+        if ( entry->previous != NULL ) {
+
+            entry->previous->next = entry->next;
+
+        } else {
+
+            entry->list->first = entry->next;
+
+        }
+
+        if ( entry->next != NULL ) {
+
+            entry->next->previous = entry->previous;
+
+        }
+    }
+
+    program->handlePositions[statement->handle] = -1;
+
+    free( statement->dependents );
+    free( statement->dependencies );
+
+    statement->dependents      = NULL;
+    statement->dependencies    = NULL;
+    statement->dependencyCount = 0;
+
+}
+
+/**
+ * @brief adds an identifier to the dependencies of a statement if it is not there yet
+ */
+static void addDependency( IncrementalStatement *statement , char *identifier , int *capacity ) {
+
+    int index;
+
+    for ( index = 0 ; index < statement->dependencyCount ; index++ ) {
+
+        if ( strcmp( statement->dependencies[index] , identifier ) == 0 ) {
+
+            return;
+
+        }
+    }
+
+    if ( statement->dependencyCount == *capacity ) {
+
+        *capacity = *capacity == 0 ? 4 : 2 * *capacity;
+        statement->dependencies = reallocateIncrementalMemory( statement->dependencies , *capacity * sizeof( char * ) );
+
+    }
+
+    statement->dependencies[statement->dependencyCount++] = identifier;
+
+}
+
+/**
+ * @brief collects the identifiers of the symbols used by a tree
+ */
+static void collectDependencies( Node *tree , IncrementalStatement *statement , int *capacity ) {
+
+    if ( tree == NULL ) {
+
+        return;
+
+    }
+
+    if ( namesSymbol( tree ) ) {
+
+        addDependency( statement , tree->value.idValue , capacity );
+
+    }
+
+    collectDependencies( tree->leftOperand , statement , capacity );
+    collectDependencies( tree->rightOperand , statement , capacity );
+    collectDependencies( tree->indexExpr , statement , capacity );
+    collectDependencies( tree->leftStatement , statement , capacity );
+    collectDependencies( tree->rightStatement , statement , capacity );
+    collectDependencies( tree->expr , statement , capacity );
+    collectDependencies( tree->expresion , statement , capacity );
+    collectDependencies( tree->thenOptStmts , statement , capacity );
+    collectDependencies( tree->doOptStmts , statement , capacity );
+    collectDependencies( tree->stepExpr , statement , capacity );
+    collectDependencies( tree->untilExpr , statement , capacity );
+    collectDependencies( tree->arguments , statement , capacity );
+    collectDependencies( tree->nextArgument , statement , capacity );
+
+}
+
+/**
+ * @brief lexes, parses and checks a statement and collects its dependencies
+ */
+static void parseStatement( IncrementalProgram *program , IncrementalStatement *statement ) {
+
+    int capacity = 0;
+    int errors   = diagnosticCount;
+    size_t lineStart = statement->start;
+
+    while ( lineStart > 0 && program->source[lineStart - 1] != '\n' ) {
+
+        lineStart--;
+
+    }
+
+    statement->tree            = parseStatements( program->source + statement->start , (int) ( statement->end - statement->start ) , statement->line ,
+                                                  (int) ( statement->start - lineStart ) + 1 , program->symbolTable );
+    statement->errors          = diagnosticCount - errors;
+    statement->dependencies    = NULL;
+    statement->dependencyCount = 0;
+
+    collectDependencies( statement->tree , statement , &capacity );
+    indexDependencies( program , statement , (int) ( statement - program->statements ) );
+
+    if ( statement->link == NULL ) {
+
+        statement->link = createSemiColon( NULL , NULL );
+
+    }
+
+    statement->link->leftStatement = statement->tree;
+    statement->link->line          = statement->line;
+
+    program->reparsedStatements++;
+
+}
+
+/**
+ * @brief links the semicolon node of a statement to the following statement
+ */
+static void linkStatement( IncrementalProgram *program , int index ) {
+
+    if ( index >= 0 && index < program->statementCount ) {
+
+        program->statements[index].link->rightStatement = index + 1 < program->statementCount ? program->statements[index + 1].link : NULL;
+
+    }
+}
+
+/**
+ * @brief splits the body of the program into top-level statements starting at a position
+ * @param statements list where the statements are added
+ * @param count number of statements in the list, updated
+ * @param capacity capacity of the list, updated
+ * @param position offset of the first statement
+ * @param line line of the first statement
+ * @param stopAfter the split stops at the first ; after this offset that is also in stopBoundaries, or at the final end
+ * @param stopBoundaries sorted offsets where the split may stop, NULL to split until the final end
+ * @param stopCount number of offsets in stopBoundaries
+ * @param stopIndex set to the index of the offset in stopBoundaries where the split stopped, or -1 if it reached the final end
+ * @return the offset of the ; or final end that follows the last statement
+ */
+static size_t splitStatements( IncrementalProgram *program , IncrementalStatement **statements , int *count , int *capacity , size_t position , int line ,
+                               size_t stopAfter , size_t *stopBoundaries , int stopCount , int *stopIndex ) {
+
+    int stop = 0;
+
+    while ( 1 ) {
+
+        int isLast;
+        size_t boundary = scanStatement( program->source , position , program->length , &isLast );
+        IncrementalStatement *statement;
+
+        if ( *count == *capacity ) {
+
+            *capacity  = *capacity == 0 ? 16 : 2 * *capacity;
+            *statements = reallocateIncrementalMemory( *statements , *capacity * sizeof( IncrementalStatement ) );
+
+        }
+
+        statement = &( *statements )[( *count )++];
+        memset( statement , 0 , sizeof( IncrementalStatement ) );
+
+        statement->start = position;
+        statement->end   = boundary;
+        statement->line  = line;
+
+        line += countLines( program->source + position , boundary - position );
+
+        if ( isLast ) {
+
+            *stopIndex = -1;
+
+            return boundary;
+
+        }
+
+        //the rest of the old statements can be reused once a boundary after the edit matches one of their boundaries
+        if ( stopBoundaries != NULL && boundary >= stopAfter ) {
+
+            while ( stop < stopCount && stopBoundaries[stop] < boundary ) {
+
+                stop++;
+
+            }
+
+            if ( stop < stopCount && stopBoundaries[stop] == boundary ) {
+
+                *stopIndex = stop;
+
+                return boundary;
+
+            }
+        }
+
+        position = boundary + 1;
+
+    }
+}
+
+/**
+ * @brief compiles the complete source of the program
+ */
+static void buildIncrementalProgram( IncrementalProgram *program ) {
+
+    int stopIndex;
+    int index;
+    int errors;
+
+    program->beginStart = findBegin( program->source , program->length );
+    program->bodyStart  = program->beginStart + strlen( "begin" );
+
+    if ( program->bodyStart > program->length ) {
+
+        printf( "Error: Program has no begin. Program will be terminated\n" );
+        exit(1);
+
+    }
+
+    //the trees of the previous version stay in the arena until the program is released
+    for ( index = 0 ; index < program->statementCount ; index++ ) {
+
+        releaseDependencies( program , &program->statements[index] );
+
+    }
+
+    program->handleCount = 0;
+
+    errors = diagnosticCount;
+
+    program->symbolTable    = parseDeclarations( program->source , (int) program->bodyStart );
+    program->headerErrors   = diagnosticCount - errors;
+    program->statementCount = 0;
+
+    program->bodyEnd = splitStatements( program , &program->statements , &program->statementCount , &program->statementCapacity , program->bodyStart ,
+                                        1 + countLines( program->source , program->bodyStart ) , 0 , NULL , 0 , &stopIndex );
+
+    for ( index = 0 ; index < program->statementCount ; index++ ) {
+
+        parseStatement( program , &program->statements[index] );
+
+    }
+
+    for ( index = 0 ; index < program->statementCount ; index++ ) {
+
+        linkStatement( program , index );
+
+    }
+}
+
+/**
+ * @brief replaces a range of the source
+ */
+static void spliceSource( IncrementalProgram *program , size_t editStart , size_t editEnd , const char *text , size_t textLength ) {
+
+    size_t newLength = program->length - ( editEnd - editStart ) + textLength;
+
+    if ( newLength + 1 > program->capacity ) {
+
+        program->capacity = 2 * ( newLength + 1 );
+        program->source   = reallocateIncrementalMemory( program->source , program->capacity );
+
+    }
+
+    memmove( program->source + editStart + textLength , program->source + editEnd , program->length - editEnd + 1 );
+    memcpy( program->source + editStart , text , textLength );
+
+    program->length = newLength;
+
+}
+
+/**
+ * @brief moves the line of every node of a tree that was not parsed again
+ */
+static void shiftTreeLines( Node *tree , int lineDelta ) {
+
+    if ( tree == NULL ) {
+
+        return;
+
+    }
+
+    tree->line += lineDelta;
+
+    shiftTreeLines( tree->leftOperand , lineDelta );
+    shiftTreeLines( tree->rightOperand , lineDelta );
+    shiftTreeLines( tree->indexExpr , lineDelta );
+    shiftTreeLines( tree->leftStatement , lineDelta );
+    shiftTreeLines( tree->rightStatement , lineDelta );
+    shiftTreeLines( tree->expr , lineDelta );
+    shiftTreeLines( tree->expresion , lineDelta );
+    shiftTreeLines( tree->thenOptStmts , lineDelta );
+    shiftTreeLines( tree->doOptStmts , lineDelta );
+    shiftTreeLines( tree->stepExpr , lineDelta );
+    shiftTreeLines( tree->untilExpr , lineDelta );
+
+}
+
+/**
+ * @brief moves the statements from an index onwards by a number of characters and lines
+ */
+static void shiftStatements( IncrementalProgram *program , int from , long long delta , int lineDelta ) {
+
+    int index;
+
+    for ( index = from ; index < program->statementCount ; index++ ) {
+
+        program->statements[index].start += delta;
+        program->statements[index].end   += delta;
+        program->statements[index].line  += lineDelta;
+
+        program->statements[index].link->line += lineDelta;
+
+        program->handlePositions[program->statements[index].handle] = index;
+
+        if ( lineDelta != 0 ) {
+
+            shiftTreeLines( program->statements[index].tree , lineDelta );
+
+        }
+
+    }
+}
+
+/**
+ * @brief finds the first statement whose end is at or after an offset
+ */
+static int findStatement( IncrementalProgram *program , size_t offset ) {
+
+    int low  = 0;
+    int high = program->statementCount - 1;
+
+    while ( low < high ) {
+
+        int middle = ( low + high ) / 2;
+
+        if ( program->statements[middle].end < offset ) {
+
+            low = middle + 1;
+
+        } else {
+
+            high = middle;
+
+        }
+    }
+
+    return low;
+}
+
+/**
+ * @brief verifies if two trees were parsed from the same text, up to spaces that do not move them to other lines. The procedures
+ * called are compared by their identifier
+ */
+static int sameTree( Node *tree , Node *oldTree ) {
+
+    if ( tree == NULL || oldTree == NULL ) {
+
+        return tree == oldTree;
+
+    }
+
+    if ( tree->type != oldTree->type || tree->line != oldTree->line || tree->operationType != oldTree->operationType ||
+         tree->valueType != oldTree->valueType || tree->expresionType != oldTree->expresionType || tree->symbolType != oldTree->symbolType ||
+         tree->parameterCount != oldTree->parameterCount ) {
+
+        return 0;
+
+    }
+
+    if ( namesSymbol( tree ) ) {
+
+        if ( strcmp( tree->value.idValue , oldTree->value.idValue ) != 0 ) {
+
+            return 0;
+
+        }
+
+    } else if ( tree->type == nVALUE ) {
+
+        int same = 1;
+
+        switch ( tree->operationType ) {
+
+            case oINTEGER: same = tree->value.iValue == oldTree->value.iValue; break;
+            case oFLOAT:   same = tree->value.fValue == oldTree->value.fValue && tree->floatLiteral == oldTree->floatLiteral; break;
+            case oLONG:    same = tree->value.lValue == oldTree->value.lValue; break;
+            case oDOUBLE:  same = tree->value.dValue == oldTree->value.dValue; break;
+            default:       break;
+
+        }
+
+        if ( !same ) {
+
+            return 0;
+
+        }
+    }
+
+    return sameTree( tree->leftOperand , oldTree->leftOperand ) && sameTree( tree->rightOperand , oldTree->rightOperand ) &&
+           sameTree( tree->indexExpr , oldTree->indexExpr ) && sameTree( tree->leftStatement , oldTree->leftStatement ) &&
+           sameTree( tree->rightStatement , oldTree->rightStatement ) && sameTree( tree->expr , oldTree->expr ) &&
+           sameTree( tree->expresion , oldTree->expresion ) && sameTree( tree->thenOptStmts , oldTree->thenOptStmts ) &&
+           sameTree( tree->doOptStmts , oldTree->doOptStmts ) && sameTree( tree->stepExpr , oldTree->stepExpr ) &&
+           sameTree( tree->untilExpr , oldTree->untilExpr ) && sameTree( tree->arguments , oldTree->arguments ) &&
+           sameTree( tree->nextArgument , oldTree->nextArgument ) && sameTree( tree->body , oldTree->body );
+
+}
+
+/**
+ * @brief verifies if a symbol is declared as it was, a procedure also needs the same parameters and body
+ * @param oldSymbol symbol with the same identifier in the old table, NULL if there is none
+ */
+static int sameDeclaration( Symbol *symbol , Symbol *oldSymbol ) {
+
+    return oldSymbol != NULL && symbol->type == oldSymbol->type && symbol->length == oldSymbol->length &&
+           ( symbol->procedure == NULL ) == ( oldSymbol->procedure == NULL ) &&
+           ( symbol->procedure == NULL || sameTree( symbol->procedure , oldSymbol->procedure ) );
+
+}
+
+/**
+ * @brief finds a symbol of a table, trying first the symbol that follows the previous one found. The declarations an edit did not
+ * touch keep their order, so comparing two tables rarely needs to search one of them
+ * @param expected symbol that follows the previous one found, NULL if there is none
+ * @return the symbol, NULL if the table does not declare it
+ */
+static Symbol *matchSymbol( Symbol **table , Symbol *expected , char *identifier ) {
+
+    return expected != NULL && strcmp( expected->identifier , identifier ) == 0 ? expected : findSymbol( table , identifier );
+
+}
+
+/**
+ * @brief adds an identifier to a list of identifiers
+ */
+static void addIdentifier( char ***identifiers , int *count , int *capacity , char *identifier ) {
+
+    if ( *count == *capacity ) {
+
+        *capacity    = *capacity == 0 ? 16 : 2 * *capacity;
+        *identifiers = reallocateIncrementalMemory( *identifiers , *capacity * sizeof( char * ) );
+
+    }
+
+    ( *identifiers )[( *count )++] = identifier;
+
+}
+
+/**
+ * @brief orders the indexes of statements
+ */
+static int compareIndexes( const void *left , const void *right ) {
+
+    return *(const int *) left - *(const int *) right;
+
+}
+
+/**
+ * @brief re-parses the header and the statements that depend on a symbol whose declaration changed
+ */
+static void editDeclarations( IncrementalProgram *program ) {
+
+    Symbol *oldTable = program->symbolTable;
+    Symbol *newTable;
+    Symbol *symbol;
+    Symbol *match;
+    char **changed = NULL;
+    int changedCount = 0;
+    int changedCapacity = 0;
+    int *dependents = NULL;
+    int dependentCount = 0;
+    int dependentCapacity = 0;
+    int errors = diagnosticCount;
+    int index;
+
+    newTable              = parseDeclarations( program->source , (int) program->bodyStart );
+    program->headerErrors = diagnosticCount - errors;
+
+    //the symbols declared, changed or removed by the edit, walking each table once
+    for ( symbol = newTable , match = oldTable ; symbol != NULL ; symbol = symbol->next ) {
+
+        match = matchSymbol( &oldTable , match , symbol->identifier );
+
+        if ( !sameDeclaration( symbol , match ) ) {
+
+            addIdentifier( &changed , &changedCount , &changedCapacity , symbol->identifier );
+
+        }
+
+        match = match != NULL ? match->next : NULL;
+
+    }
+
+    for ( symbol = oldTable , match = newTable ; symbol != NULL ; symbol = symbol->next ) {
+
+        match = matchSymbol( &newTable , match , symbol->identifier );
+
+        if ( match == NULL ) {
+
+            addIdentifier( &changed , &changedCount , &changedCapacity , symbol->identifier );
+
+        }
+
+        match = match != NULL ? match->next : NULL;
+
+    }
+
+    //the statements keep the old symbols, and the calls the old procedures, if no declaration changed
+    if ( changedCount == 0 ) {
+
+        return;
+
+    }
+
+    program->symbolTable = newTable;
+
+    //a call is built again with the new procedure, which holds the new local symbols
+    for ( symbol = newTable ; symbol != NULL ; symbol = symbol->next ) {
+
+        if ( symbol->procedure != NULL ) {
+
+            addIdentifier( &changed , &changedCount , &changedCapacity , symbol->identifier );
+
+        }
+    }
+
+    //only the statements in the lists of the changed symbols are visited, each one is parsed again once
+    for ( index = 0 ; index < changedCount ; index++ ) {
+
+        DependentList *list = findDependentList( program , changed[index] , 0 );
+        Dependent *entry;
+
+        for ( entry = list != NULL ? list->first : NULL ; entry != NULL ; entry = entry->next ) {
+
+            if ( dependentCount == dependentCapacity ) {
+
+                dependentCapacity = dependentCapacity == 0 ? 16 : 2 * dependentCapacity;
+                dependents        = reallocateIncrementalMemory( dependents , dependentCapacity * sizeof( int ) );
+
+            }
+
+            dependents[dependentCount++] = program->handlePositions[entry->handle];
+
+        }
+    }
+
+    qsort( dependents , dependentCount , sizeof( int ) , compareIndexes );
+
+    for ( index = 0 ; index < dependentCount ; index++ ) {
+
+        if ( index == 0 || dependents[index] != dependents[index - 1] ) {
+
+            releaseDependencies( program , &program->statements[dependents[index]] );
+            parseStatement( program , &program->statements[dependents[index]] );
+
+        }
+    }
+
+    free( dependents );
+    free( changed );
+
+}
+
+/**
+ * @brief re-lexes and re-parses the top-level statements touched by an edit of the body
+ */
+static void editStatements( IncrementalProgram *program , size_t editStart , size_t editEnd , long long delta , int lineDelta ) {
+
+    int first = findStatement( program , editStart );
+    int last  = findStatement( program , editEnd );
+    int oldCount = program->statementCount - last;
+    size_t *oldBoundaries = allocateIncrementalMemory( oldCount * sizeof( size_t ) );
+    IncrementalStatement *replacement = NULL;
+    int replacementCount = 0;
+    int replacementCapacity = 0;
+    int stopIndex;
+    int replacedCount;
+    int index;
+
+    //boundaries of the untouched statements, moved to their position after the edit
+    for ( index = 0 ; index < oldCount ; index++ ) {
+
+        oldBoundaries[index] = program->statements[last + index].end + delta;
+
+    }
+
+    splitStatements( program , &replacement , &replacementCount , &replacementCapacity , program->statements[first].start , program->statements[first].line ,
+                     editEnd + delta , oldBoundaries , oldCount , &stopIndex );
+
+    replacedCount = stopIndex == -1 ? program->statementCount - first : last + stopIndex - first + 1;
+
+    if ( stopIndex == -1 ) {
+
+        program->bodyEnd = replacement[replacementCount - 1].end;
+
+    } else {
+
+        program->bodyEnd += delta;
+
+    }
+
+    //make room for the new statements and move the following ones
+    if ( program->statementCount - replacedCount + replacementCount > program->statementCapacity ) {
+
+        program->statementCapacity = 2 * ( program->statementCount - replacedCount + replacementCount );
+        program->statements        = reallocateIncrementalMemory( program->statements , program->statementCapacity * sizeof( IncrementalStatement ) );
+
+    }
+
+    for ( index = first ; index < first + replacedCount ; index++ ) {
+
+        releaseDependencies( program , &program->statements[index] );
+
+    }
+
+    memmove( &program->statements[first + replacementCount] , &program->statements[first + replacedCount] , ( program->statementCount - first - replacedCount ) * sizeof( IncrementalStatement ) );
+    memcpy( &program->statements[first] , replacement , replacementCount * sizeof( IncrementalStatement ) );
+
+    program->statementCount += replacementCount - replacedCount;
+
+    shiftStatements( program , first + replacementCount , delta , lineDelta );
+
+    for ( index = first ; index < first + replacementCount ; index++ ) {
+
+        parseStatement( program , &program->statements[index] );
+
+    }
+
+    for ( index = first - 1 ; index < first + replacementCount ; index++ ) {
+
+        linkStatement( program , index );
+
+    }
+
+    free( replacement );
+    free( oldBoundaries );
+
+}
+
+IncrementalProgram *createIncrementalProgram( const char *source , size_t length ) {
+
+    IncrementalProgram *program = allocateIncrementalMemory( sizeof( IncrementalProgram ) );
+    Arena *outerArena = currentArena;
+    double start = currentMilliseconds();
+
+    program->capacity = 2 * ( length + 1 );
+    program->source   = allocateIncrementalMemory( program->capacity );
+    program->length   = length;
+
+    memcpy( program->source , source , length );
+
+    program->dependentLists = allocateIncrementalMemory( DEPENDENT_BUCKETS * sizeof( DependentList * ) );
+
+    currentArena        = &program->arena;
+    memoryLimitExceeded = 0;
+
+    buildIncrementalProgram( program );
+
+    program->truncated = memoryLimitExceeded;
+    currentArena       = outerArena;
+
+    program->lastLatency = currentMilliseconds() - start;
+
+    return program;
+}
+
+double editIncrementalProgram( IncrementalProgram *program , size_t editStart , size_t editEnd , const char *text , size_t textLength ) {
+
+    double start      = currentMilliseconds();
+    long long delta   = (long long) textLength - (long long) ( editEnd - editStart );
+    int lineDelta     = countLines( text , textLength ) - countLines( program->source + editStart , editEnd - editStart );
+    Arena *outerArena = currentArena;
+
+    program->reparsedStatements = 0;
+
+    currentArena        = &program->arena;
+    memoryLimitExceeded = 0;
+
+    if ( editEnd < program->beginStart ) { //only the declarations changed
+
+        spliceSource( program , editStart , editEnd , text , textLength );
+
+        program->beginStart += delta;
+        program->bodyStart  += delta;
+        program->bodyEnd    += delta;
+
+        shiftStatements( program , 0 , delta , lineDelta );
+
+        editDeclarations( program );
+
+    } else if ( program->statementCount > 0 && editStart >= program->bodyStart && editEnd <= program->bodyEnd &&
+                ( editStart > program->bodyStart || !isalnum( (unsigned char) ( textLength > 0 ? text[0] : program->source[editEnd] ) ) ) &&
+                ( editEnd < program->bodyEnd || !isalnum( (unsigned char) ( textLength > 0 ? text[textLength - 1] : program->source[editStart - 1] ) ) ) ) {
+
+        //only statements changed, and the edit does not join a word to the begin or end keywords
+
+        spliceSource( program , editStart , editEnd , text , textLength );
+
+        editStatements( program , editStart , editEnd , delta , lineDelta );
+
+    } else { //the edit touches begin or end, the complete program is compiled again
+
+        spliceSource( program , editStart , editEnd , text , textLength );
+
+        program->truncated = 0;
+
+        buildIncrementalProgram( program );
+
+        program->fullRebuilds++;
+
+    }
+
+    program->truncated |= memoryLimitExceeded;
+    currentArena        = outerArena;
+
+    program->lastLatency = currentMilliseconds() - start;
+
+    return program->lastLatency;
+}
+
+Node *getIncrementalTree( IncrementalProgram *program ) {
+
+    return program->statementCount > 0 ? program->statements[0].link : NULL;
+
+}
+
+int resolveIncrementalProgram( IncrementalProgram *program ) {
+
+    Node *tree = getIncrementalTree( program );
+    int index;
+
+    //a program with errors or stopped by the memory limit is not executed
+    if ( program->headerErrors > 0 || program->truncated ) {
+
+        return 0;
+
+    }
+
+    for ( index = 0 ; index < program->statementCount ; index++ ) {
+
+        if ( program->statements[index].errors > 0 ) {
+
+            return 0;
+
+        }
+    }
+
+    analyzeRanges( tree , &program->symbolTable );
+
+    return resolveTree( tree , &program->symbolTable );
+
+}
+
+void destroyIncrementalProgram( IncrementalProgram *program ) {
+
+    int index;
+
+    for ( index = 0 ; index < program->statementCount ; index++ ) {
+
+        free( program->statements[index].dependents );
+        free( program->statements[index].dependencies );
+
+    }
+
+    for ( index = 0 ; index < DEPENDENT_BUCKETS ; index++ ) {
+
+        while ( program->dependentLists[index] != NULL ) {
+
+            DependentList *next = program->dependentLists[index]->next;
+
+            free( program->dependentLists[index] );
+
+            program->dependentLists[index] = next;
+
+        }
+    }
+
+    releaseArena( &program->arena );
+
+    free( program->dependentLists );
+    free( program->handlePositions );
+
+    free( program->statements );
+    free( program->source );
+    free( program );
+
+}
+
+void benchmarkIncrementalProgram( const char *source , size_t length ) {
+
+    IncrementalProgram *program = createIncrementalProgram( source , length );
+    int edits = program->statementCount < 100 ? program->statementCount : 100;
+    int reparsed = 0;
+    double total = 0;
+    double maximum = 0;
+    int edit;
+
+    fprintf( stderr , "initial compilation: %d statements in %.3f ms\n" , program->statementCount , program->lastLatency );
+
+    for ( edit = 0 ; edit < edits ; edit++ ) {
+
+        IncrementalStatement *statement = &program->statements[(long long) edit * program->statementCount / edits];
+        size_t textLength = statement->end - statement->start;
+        char *text = allocateIncrementalMemory( textLength );
+        double latency;
+
+        memcpy( text , program->source + statement->start , textLength );
+
+        latency = editIncrementalProgram( program , statement->start , statement->end , text , textLength );
+
+        total    += latency;
+        maximum   = latency > maximum ? latency : maximum;
+        reparsed += program->reparsedStatements;
+
+        free( text );
+
+    }
+
+    if ( edits > 0 ) {
+
+        fprintf( stderr , "statement edits: %d, average %.3f ms, maximum %.3f ms, %d statements re-parsed\n" , edits , total / edits , maximum , reparsed );
+
+    }
+
+    //the header is replaced with its own text, so no declaration changes and no statement should be re-parsed
+    {
+        size_t textLength = program->beginStart;
+        char *text = allocateIncrementalMemory( textLength );
+        double latency;
+
+        memcpy( text , program->source , textLength );
+
+        latency = editIncrementalProgram( program , 0 , textLength > 0 ? textLength - 1 : 0 , text , textLength > 0 ? textLength - 1 : 0 );
+
+        fprintf( stderr , "declaration edit: %.3f ms, %d statements re-parsed\n" , latency , program->reparsedStatements );
+
+        free( text );
+    }
+
+    fprintf( stderr , "full rebuilds: %d\n" , program->fullRebuilds );
+
+    destroyIncrementalProgram( program );
+
+}
+
+//end incremental.c
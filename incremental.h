@@ -0,0 +1,152 @@
+/**
+ * incremental.h
+ * Definition of the structures used to recompile a program after an edit, re-parsing only the statements that changed
+ * @author Jose Pablo Ortiz Lack
+ */
+#ifndef __INCREMENTAL_H__
+#define __INCREMENTAL_H__
+
+#include <stddef.h>
+
+#include "symbolTable.h"
+#include "syntaxTree.h"
+#include "arena.h"
+
+/**
+ * @brief buckets of the index of the statements that use each symbol, a power of 2
+ */
+#define DEPENDENT_BUCKETS 1024
+
+/**
+ * @brief an entry of the list of the statements that use a symbol
+ */
+typedef struct tagDependent {
+
+    int handle; //handle of the statement, whose index is kept in the handlePositions of the program
+    struct tagDependentList *list; //list that holds the entry
+    struct tagDependent *previous; //previous entry of the list, NULL for the first one
+    struct tagDependent *next; //next entry of the list, NULL for the last one
+
+} Dependent;
+
+/**
+ * @brief the statements that use a symbol
+ */
+typedef struct tagDependentList {
+
+    char *identifier; //identifier of the symbol
+    Dependent *first; //first statement that uses the symbol, NULL if no statement uses it now
+    struct tagDependentList *next; //next list of the same bucket
+
+} DependentList;
+
+/**
+ * @brief a top-level statement of the program
+ */
+typedef struct tagIncrementalStatement {
+
+    size_t start; //offset of the first character of the statement
+    size_t end; //offset of the character after the statement, which is the separating ; or the final end
+
+    int line; //line of the first character of the statement
+
+    Node *tree; //statement tree, NULL if the statement is empty
+    Node *link; //semicolon node linking the statement to the next one
+
+    char **dependencies; //identifiers of the symbols used by the statement
+    int dependencyCount; //number of dependencies
+    Dependent *dependents; //entries of the statement in the lists of its dependencies, one per dependency
+
+    int handle; //identifies the statement in the lists of dependents while it is not parsed again, even if it moves in the list of statements
+
+    int errors; //number of errors found the last time the statement was parsed
+
+} IncrementalStatement;
+
+/**
+ * @brief a program kept in memory between edits
+ */
+typedef struct tagIncrementalProgram {
+
+    char *source; //current source of the program
+    size_t length; //length of the source
+    size_t capacity; //capacity of the source buffer
+
+    size_t beginStart; //offset of the begin keyword
+    size_t bodyStart; //offset of the first character after the begin keyword
+    size_t bodyEnd; //offset of the final end keyword
+
+    Symbol *symbolTable; //declarations of the program
+    int headerErrors; //number of errors found the last time the declarations were parsed
+
+    IncrementalStatement *statements; //top-level statements in source order
+    int statementCount; //number of statements
+    int statementCapacity; //capacity of the statement list
+
+    DependentList **dependentLists; //statements that use each symbol, DEPENDENT_BUCKETS lists chained by the hash of the identifier
+    int *handlePositions; //index in the statement list of every handle, -1 once the statement of the handle is replaced or parsed again
+    int handleCount; //handles given since the last complete compilation
+    int handleCapacity; //capacity of handlePositions
+
+    Arena arena; //nodes, symbols and identifiers of every version of the program, the trees replaced by edits are released with it
+    int truncated; //1 if a compilation was stopped by the memory limit since the last complete compilation, the program is not executed
+
+    double lastLatency; //milliseconds taken by the last edit
+    int reparsedStatements; //statements re-lexed and re-parsed by the last edit
+    int fullRebuilds; //number of edits that needed to rebuild the complete program
+
+} IncrementalProgram;
+
+/**
+ * @brief compiles a program and keeps its tree, statements and symbol table for later edits, allocated from the arena of the program.
+ * Errors are added to the diagnostics
+ * @param source source of the program
+ * @param length length of the source
+ * @return the compiled program
+ */
+IncrementalProgram *createIncrementalProgram( const char *source , size_t length );
+
+/**
+ * @brief replaces a range of the source and recompiles the program. Only the top-level statements touched by the edit are re-lexed and
+ * re-parsed; an edit of the declarations compares the old and new declarations once, keeps the old symbol table if none changed and
+ * otherwise re-parses only the statements that use a symbol whose declaration changed, found through the lists of dependents
+ * @param program program to be edited
+ * @param editStart offset of the first replaced character
+ * @param editEnd offset of the character after the last replaced character
+ * @param text replacement text
+ * @param textLength length of the replacement text
+ * @return the milliseconds taken by the edit, also kept in lastLatency
+ */
+double editIncrementalProgram( IncrementalProgram *program , size_t editStart , size_t editEnd , const char *text , size_t textLength );
+
+/**
+ * @brief obtains the syntax tree of the current source
+ * @param program compiled program
+ * @return the tree of the statements, NULL if the program has no statements
+ */
+Node *getIncrementalTree( IncrementalProgram *program );
+
+/**
+ * @brief analyzes and executes the current source
+ * @param program compiled program
+ * @return 1 if the resolution concluded successfully, 0 if the current source has errors and was not executed
+ */
+int resolveIncrementalProgram( IncrementalProgram *program );
+
+/**
+ * @brief releases a program with its trees, symbol table, source and statements
+ * @param program program to be released
+ */
+void destroyIncrementalProgram( IncrementalProgram *program );
+
+/**
+ * @brief compiles a program and replaces up to 100 of its statements, spread across the program, and one declaration with their own text,
+ * printing to stderr the latency of the edits and the number of statements re-parsed
+ * @param source source of the program
+ * @param length length of the source
+ */
+void benchmarkIncrementalProgram( const char *source , size_t length );
+
+#endif //__INCREMENTAL_H__
+
+//end incremental.h
@@ -0,0 +1,658 @@
+/**
+ * inlining.c
+ * Implementation of the inlining
+ *
+ * The locals of a procedure are symbols of the table, qualified with the name of the procedure, so an inlined body reads and
+ * assigns the same symbols as the called one. A procedure can only call itself and the procedures declared before it, so the copy
+ * of a body that is not recursive never runs while another execution of the same body is active, and needs no symbols of its own
+ * @author Jose Pablo Ortiz Lack
+ */
+#include "inlining.h"
+#include "syntaxTree.h"
+#include "symbolTable.h"
+#include "vectorLoop.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+int inliningEnabled = 1;
+
+int inliningReportEnabled = 0;
+
+/**
+ * @brief the state shared by the inlining functions
+ */
+typedef struct tagInliningContext {
+
+    Symbol **symbolTable; //the symbolTable of the compiler
+
+    int inlined; //calls replaced by a body
+    int kept; //calls executed with a frame
+    int copiedNodes; //nodes of the bodies copied into the calls
+
+} InliningContext;
+
+/**
+ * @brief counts the nodes of a tree, the statements, expresions and arguments
+ */
+static int countNodes( Node *tree ) {
+
+    if ( tree == NULL ) {
+
+        return 0;
+
+    }
+
+    return 1 + countNodes( tree->leftOperand ) + countNodes( tree->rightOperand ) + countNodes( tree->indexExpr ) +
+           countNodes( tree->leftStatement ) + countNodes( tree->rightStatement ) + countNodes( tree->expr ) +
+           countNodes( tree->expresion ) + countNodes( tree->thenOptStmts ) + countNodes( tree->doOptStmts ) +
+           countNodes( tree->stepExpr ) + countNodes( tree->untilExpr ) + countNodes( tree->arguments ) + countNodes( tree->nextArgument );
+}
+
+/**
+ * @brief counts the calls of the statements of a tree in the procedures they call, and marks the procedures that call themselves
+ * @param tree statements to be searched
+ * @param caller procedure whose body is searched, NULL for the program
+ */
+static void countCallSites( Node *tree , Node *caller ) {
+
+    if ( tree == NULL ) {
+
+        return;
+
+    }
+
+    switch ( tree->type ) {
+
+        case nSEMICOLON:
+
+            countCallSites( tree->leftStatement , caller );
+            countCallSites( tree->rightStatement , caller );
+
+        break;
+
+        case nIF:
+
+            countCallSites( tree->thenOptStmts , caller );
+
+        break;
+
+        case nWHILE:
+        case nFOR:
+
+            countCallSites( tree->doOptStmts , caller );
+
+        break;
+
+        case nCALL:
+
+            tree->procedure->callSites++;
+
+            if ( tree->procedure == caller ) {
+
+                tree->procedure->recursive = 1;
+
+            }
+
+        break;
+
+        default:
+
+        break;
+
+    }
+}
+
+/**
+ * @brief copies a tree, so the copy of a body can be optimized apart from the body and from the other copies
+ */
+static Node *copyTree( Node *tree ) {
+
+    Node *copy;
+
+    if ( tree == NULL ) {
+
+        return NULL;
+
+    }
+
+    copy = copyNode( tree );
+
+    copy->leftOperand    = copyTree( tree->leftOperand );
+    copy->rightOperand   = copyTree( tree->rightOperand );
+    copy->indexExpr      = copyTree( tree->indexExpr );
+    copy->leftStatement  = copyTree( tree->leftStatement );
+    copy->rightStatement = copyTree( tree->rightStatement );
+    copy->expr           = copyTree( tree->expr );
+    copy->expresion      = copyTree( tree->expresion );
+    copy->thenOptStmts   = copyTree( tree->thenOptStmts );
+    copy->doOptStmts     = copyTree( tree->doOptStmts );
+    copy->stepExpr       = copyTree( tree->stepExpr );
+    copy->untilExpr      = copyTree( tree->untilExpr );
+    copy->arguments      = copyTree( tree->arguments );
+    copy->nextArgument   = copyTree( tree->nextArgument );
+
+    return copy;
+
+}
+
+/**
+ * @brief gives the for loops of a copied body vectorization plans of their own, built once its parameters are replaced
+ */
+static void planLoops( Node *tree ) {
+
+    if ( tree == NULL ) {
+
+        return;
+
+    }
+
+    switch ( tree->type ) {
+
+        case nSEMICOLON:
+
+            planLoops( tree->leftStatement );
+            planLoops( tree->rightStatement );
+
+        break;
+
+        case nIF:
+
+            planLoops( tree->thenOptStmts );
+
+        break;
+
+        case nWHILE:
+
+            planLoops( tree->doOptStmts );
+
+        break;
+
+        case nFOR:
+
+            planLoops( tree->doOptStmts );
+
+            tree->vectorLoop = createVectorLoop( tree );
+
+        break;
+
+        default:
+
+        break;
+
+    }
+}
+
+/**
+ * @brief creates the literal 0 of a type
+ */
+static Node *createZero( SymbolType symbolType ) {
+
+    switch ( symbolType ) {
+
+        case sFLOAT: return createFloat( 0 );
+        case sLONG: return createLong( 0 );
+        case sDOUBLE: return createDouble( 0 );
+        default: return createInteger( 0 );
+
+    }
+}
+
+/**
+ * @brief tells if a tree reads or assigns a symbol
+ */
+static int mentionsSymbol( Node *tree , char *identifier ) {
+
+    if ( tree == NULL ) {
+
+        return 0;
+
+    }
+
+    switch ( tree->type ) {
+
+        case nVALUE:
+
+            if ( ( tree->operationType == oID || tree->operationType == oINDEX ) && strcmp( tree->value.idValue , identifier ) == 0 ) {
+
+                return 1;
+
+            }
+
+        break;
+
+        case nASSIGNMENT:
+        case nREAD:
+        case nFOR:
+
+            if ( strcmp( tree->value.idValue , identifier ) == 0 ) {
+
+                return 1;
+
+            }
+
+        break;
+
+        default:
+
+        break;
+
+    }
+
+    return mentionsSymbol( tree->leftOperand , identifier ) || mentionsSymbol( tree->rightOperand , identifier ) ||
+           mentionsSymbol( tree->indexExpr , identifier ) || mentionsSymbol( tree->leftStatement , identifier ) ||
+           mentionsSymbol( tree->rightStatement , identifier ) || mentionsSymbol( tree->expr , identifier ) ||
+           mentionsSymbol( tree->expresion , identifier ) || mentionsSymbol( tree->thenOptStmts , identifier ) ||
+           mentionsSymbol( tree->doOptStmts , identifier ) || mentionsSymbol( tree->stepExpr , identifier ) ||
+           mentionsSymbol( tree->untilExpr , identifier ) || mentionsSymbol( tree->arguments , identifier ) ||
+           mentionsSymbol( tree->nextArgument , identifier );
+
+}
+
+/**
+ * @brief finds how a sequence of statements first uses a local
+ * @return 1 if the local is assigned before it is read, 0 if it may be read first, -1 if it is not used
+ */
+static int firstUse( Node *tree , char *identifier ) {
+
+    int use;
+
+    if ( tree == NULL ) {
+
+        return -1;
+
+    }
+
+    if ( tree->type == nSEMICOLON ) {
+
+        use = firstUse( tree->leftStatement , identifier );
+
+        return use != -1 ? use : firstUse( tree->rightStatement , identifier );
+
+    }
+
+    if ( tree->type == nASSIGNMENT && tree->indexExpr == NULL && strcmp( tree->value.idValue , identifier ) == 0 ) {
+
+        return mentionsSymbol( tree->expr , identifier ) ? 0 : 1;
+
+    }
+
+    return mentionsSymbol( tree , identifier ) ? 0 : -1;
+
+}
+
+/**
+ * @brief tells if a tree assigns a symbol. A call left in the tree may assign any global symbol; the locals of the procedures being
+ * executed are restored when it returns, since a procedure only calls itself and the procedures declared before it
+ */
+static int assignsSymbol( Node *tree , char *identifier ) {
+
+    if ( tree == NULL ) {
+
+        return 0;
+
+    }
+
+    if ( tree->type == nCALL && strchr( identifier , LOCAL_SEPARATOR ) == NULL ) {
+
+        return 1;
+
+    }
+
+    if ( ( tree->type == nASSIGNMENT || tree->type == nREAD || tree->type == nFOR ) && strcmp( tree->value.idValue , identifier ) == 0 ) {
+
+        return 1;
+
+    }
+
+    return assignsSymbol( tree->leftStatement , identifier ) || assignsSymbol( tree->rightStatement , identifier ) ||
+           assignsSymbol( tree->thenOptStmts , identifier ) || assignsSymbol( tree->doOptStmts , identifier );
+
+}
+
+/**
+ * @brief tells if an expresion reads a symbol assigned by a body
+ */
+static int readsAssignedSymbol( Node *expr , Node *body ) {
+
+    if ( expr == NULL ) {
+
+        return 0;
+
+    }
+
+    if ( expr->type == nVALUE && ( expr->operationType == oID || expr->operationType == oINDEX ) && assignsSymbol( body , expr->value.idValue ) ) {
+
+        return 1;
+
+    }
+
+    return readsAssignedSymbol( expr->leftOperand , body ) || readsAssignedSymbol( expr->rightOperand , body ) ||
+           readsAssignedSymbol( expr->indexExpr , body );
+
+}
+
+/**
+ * @brief counts the reads of a symbol, the ones inside a loop count as INLINE_ARGUMENT_READS + 1 since they may be executed
+ * many times
+ */
+static int countReads( Node *tree , char *identifier , int weight ) {
+
+    int reads = 0;
+
+    if ( tree == NULL ) {
+
+        return 0;
+
+    }
+
+    if ( tree->type == nVALUE && tree->operationType == oID && strcmp( tree->value.idValue , identifier ) == 0 ) {
+
+        reads = weight;
+
+    }
+
+    if ( tree->type == nWHILE || tree->type == nFOR ) {
+
+        weight = INLINE_ARGUMENT_READS + 1;
+
+    }
+
+    return reads + countReads( tree->leftOperand , identifier , weight ) + countReads( tree->rightOperand , identifier , weight ) +
+           countReads( tree->indexExpr , identifier , weight ) + countReads( tree->leftStatement , identifier , weight ) +
+           countReads( tree->rightStatement , identifier , weight ) + countReads( tree->expr , identifier , weight ) +
+           countReads( tree->expresion , identifier , weight ) + countReads( tree->thenOptStmts , identifier , weight ) +
+           countReads( tree->doOptStmts , identifier , weight ) + countReads( tree->stepExpr , identifier , weight ) +
+           countReads( tree->untilExpr , identifier , weight ) + countReads( tree->arguments , identifier , weight ) +
+           countReads( tree->nextArgument , identifier , weight );
+
+}
+
+/**
+ * @brief tells if the reads of a parameter in a body can be replaced by its argument: the body never assigns the parameter nor
+ * the symbols of the argument, and the argument is a literal, a symbol or is read at most INLINE_ARGUMENT_READS times outside
+ * of loops, where the value numbering may share its evaluations
+ */
+static int canSubstitute( Node *body , Symbol *parameter , Node *argument ) {
+
+    if ( assignsSymbol( body , parameter->identifier ) || readsAssignedSymbol( argument , body ) ) {
+
+        return 0;
+
+    }
+
+    return ( argument->type == nVALUE && argument->operationType != oINDEX ) || countReads( body , parameter->identifier , 1 ) <= INLINE_ARGUMENT_READS;
+
+}
+
+/**
+ * @brief replaces the reads of a symbol in a tree by copies of an expresion
+ */
+static void substituteSymbol( Node **tree , char *identifier , Node *argument ) {
+
+    if ( *tree == NULL ) {
+
+        return;
+
+    }
+
+    if ( ( *tree )->type == nVALUE && ( *tree )->operationType == oID && strcmp( ( *tree )->value.idValue , identifier ) == 0 ) {
+
+        *tree = copyTree( argument );
+
+        return;
+
+    }
+
+    substituteSymbol( &( *tree )->leftOperand , identifier , argument );
+    substituteSymbol( &( *tree )->rightOperand , identifier , argument );
+    substituteSymbol( &( *tree )->indexExpr , identifier , argument );
+    substituteSymbol( &( *tree )->leftStatement , identifier , argument );
+    substituteSymbol( &( *tree )->rightStatement , identifier , argument );
+    substituteSymbol( &( *tree )->expr , identifier , argument );
+    substituteSymbol( &( *tree )->expresion , identifier , argument );
+    substituteSymbol( &( *tree )->thenOptStmts , identifier , argument );
+    substituteSymbol( &( *tree )->doOptStmts , identifier , argument );
+    substituteSymbol( &( *tree )->stepExpr , identifier , argument );
+    substituteSymbol( &( *tree )->untilExpr , identifier , argument );
+    substituteSymbol( &( *tree )->arguments , identifier , argument );
+    substituteSymbol( &( *tree )->nextArgument , identifier , argument );
+
+}
+
+/**
+ * @brief decides if a call is inlined
+ * @param call call statement
+ * @param loopDepth number of loops around the call
+ * @return 1 if the call is replaced by the body of the procedure
+ */
+static int shouldInline( Node *call , int loopDepth ) {
+
+    Node *procedure = call->procedure;
+    int size        = countNodes( procedure->body );
+
+    if ( procedure->recursive ) {
+
+        return 0;
+
+    }
+
+    return procedure->callSites == 1 || size <= INLINE_NODE_BUDGET || ( loopDepth > 0 && size <= INLINE_LOOP_NODE_BUDGET );
+
+}
+
+/**
+ * @brief replaces a call by the assignments of its frame followed by a copy of the body of the procedure. The call node becomes
+ * the first node of the replacement, so the statements that contain it need not change
+ */
+static void expandCall( Node *call , InliningContext *context ) {
+
+    Node *procedure = call->procedure;
+    Node *arguments[procedure->parameterCount > 0 ? procedure->parameterCount : 1];
+    Node *argument  = call->arguments;
+    Node *expansion = copyTree( procedure->body );
+    int line        = call->line;
+    int index;
+
+    context->copiedNodes += countNodes( expansion );
+
+    for ( index = 0 ; index < procedure->parameterCount ; index++ , argument = argument->nextArgument ) {
+
+        arguments[index] = argument->expr;
+
+    }
+
+    //built from the last local, so the parameters are assigned first and in order
+    for ( index = procedure->localCount - 1 ; index >= 0 ; index-- ) {
+
+        Symbol *local = procedure->locals[index];
+        Node *binding;
+
+        //a parameter read as its argument needs no assignment
+        if ( index < procedure->parameterCount && canSubstitute( procedure->body , local , arguments[index] ) ) {
+
+            substituteSymbol( &expansion , local->identifier , arguments[index] );
+
+            continue;
+
+        }
+
+        //a local the body assigns before reading it, or never uses, needs not start at 0
+        if ( index >= procedure->parameterCount && firstUse( procedure->body , local->identifier ) != 0 ) {
+
+            continue;
+
+        }
+
+        binding = createAssignment( local->identifier , index < procedure->parameterCount ? arguments[index] : createZero( local->type ) ,
+                                    context->symbolTable );
+
+        binding->line   = line;
+        expansion       = expansion == NULL ? binding : createSemiColon( binding , expansion );
+        expansion->line = line;
+
+    }
+
+    planLoops( expansion );
+
+    if ( expansion == NULL ) { //a procedure without locals nor statements
+
+        expansion = createSemiColon( NULL , NULL );
+
+    }
+
+    *call      = *expansion;
+    call->line = line;
+
+}
+
+/**
+ * @brief inlines the calls of the statements of a tree selected by the cost model
+ * @param tree statements to be searched
+ * @param loopDepth number of loops around the statements
+ * @return 1 if a call was inlined
+ */
+static int inlineCalls( Node *tree , int loopDepth , InliningContext *context ) {
+
+    int changed;
+
+    if ( tree == NULL ) {
+
+        return 0;
+
+    }
+
+    switch ( tree->type ) {
+
+        case nSEMICOLON:
+
+            changed = inlineCalls( tree->leftStatement , loopDepth , context );
+
+            return inlineCalls( tree->rightStatement , loopDepth , context ) || changed;
+
+        case nIF:
+
+            return inlineCalls( tree->thenOptStmts , loopDepth , context );
+
+        case nWHILE:
+
+            return inlineCalls( tree->doOptStmts , loopDepth + 1 , context );
+
+        case nFOR:
+
+            //a body made only of accumulations once its calls are inlined may be vectorized
+            if ( inlineCalls( tree->doOptStmts , loopDepth + 1 , context ) ) {
+
+                tree->vectorLoop = createVectorLoop( tree );
+
+                return 1;
+
+            }
+
+            return 0;
+
+        case nCALL:
+
+            if ( shouldInline( tree , loopDepth ) ) {
+
+                expandCall( tree , context );
+                context->inlined++;
+
+                return 1;
+
+            }
+
+            context->kept++;
+
+            return 0;
+
+        default:
+
+            return 0;
+
+    }
+}
+
+int inlineProcedures( Node *tree , Symbol **symbolTable ) {
+
+    InliningContext context = { symbolTable , 0 , 0 , 0 };
+    Node **procedures;
+    Symbol *symbol;
+    int procedureCount = 0;
+    int index;
+
+    for ( symbol = *symbolTable ; symbol != NULL ; symbol = symbol->next ) {
+
+        procedureCount += symbol->procedure != NULL;
+
+    }
+
+    if ( procedureCount == 0 ) {
+
+        return 0;
+
+    }
+
+    procedures = malloc( procedureCount * sizeof( Node * ) );
+
+    if ( procedures == NULL ) {
+
+        printf( "Error: Memory allocation failed. Program will be terminated\n" );
+        exit(1);
+
+    }
+
+    //the table has the newest symbol first
+    for ( symbol = *symbolTable , index = procedureCount - 1 ; symbol != NULL ; symbol = symbol->next ) {
+
+        if ( symbol->procedure != NULL ) {
+
+            procedures[index--] = symbol->procedure;
+
+        }
+    }
+
+    for ( index = 0 ; index < procedureCount ; index++ ) {
+
+        procedures[index]->callSites = 0;
+        procedures[index]->recursive = 0;
+
+    }
+
+    countCallSites( tree , NULL );
+
+    for ( index = 0 ; index < procedureCount ; index++ ) {
+
+        countCallSites( procedures[index]->body , procedures[index] );
+
+    }
+
+    //a procedure only calls the ones declared before it, whose calls are already inlined
+    for ( index = 0 ; index < procedureCount ; index++ ) {
+
+        inlineCalls( procedures[index]->body , 0 , &context );
+
+    }
+
+    inlineCalls( tree , 0 , &context );
+
+    if ( inliningReportEnabled ) {
+
+        fprintf( stderr , "Inlining: %d calls inlined, %d calls kept, %d nodes copied\n" , context.inlined , context.kept , context.copiedNodes );
+
+        for ( index = 0 ; index < procedureCount ; index++ ) {
+
+            fprintf( stderr , "line %d: procedure %s: %d nodes, %d call sites%s\n" , procedures[index]->line , procedures[index]->value.idValue ,
+                     countNodes( procedures[index]->body ) , procedures[index]->callSites , procedures[index]->recursive ? ", recursive" : "" );
+
+        }
+    }
+
+    free( procedures );
+
+    return context.inlined;
+
+}
+
+//end inlining.c
@@ -0,0 +1,52 @@
+/**
+ * inlining.h
+ * Definition of the inlining, which replaces calls by a copy of the body of the procedure they call, so the calls of small
+ * procedures and the calls made from loops do not pay for a call frame
+ * @author Jose Pablo Ortiz Lack
+ */
+#ifndef __INLINING_H__
+#define __INLINING_H__
+
+#include "symbolTable.h"
+#include "syntaxTree.h"
+
+/**
+ * @brief nodes of the body of a procedure that is inlined at every call
+ */
+#define INLINE_NODE_BUDGET 40
+
+/**
+ * @brief nodes of the body of a procedure that is inlined at the calls made from the body of a loop
+ */
+#define INLINE_LOOP_NODE_BUDGET 160
+
+/**
+ * @brief reads of a parameter that may be replaced by an argument that is not a literal nor a symbol
+ */
+#define INLINE_ARGUMENT_READS 2
+
+/**
+ * @brief inlines the calls selected by the cost model before the programs are executed, 1 by default
+ */
+extern int inliningEnabled;
+
+/**
+ * @brief prints the size of every procedure and the calls inlined and kept
+ */
+extern int inliningReportEnabled;
+
+/**
+ * @brief replaces calls by the body of the procedure they call, preceded by the assignment of the arguments to the parameters and
+ * of 0 to the other locals. A parameter the body never assigns is replaced by its argument instead, and a local the body assigns
+ * before reading it is not set to 0. A recursive procedure is never inlined. Any other procedure is inlined if it is called only once, if its
+ * body has at most INLINE_NODE_BUDGET nodes, or at a call made from a loop if its body has at most INLINE_LOOP_NODE_BUDGET nodes.
+ * The bodies of the procedures are inlined first, in declaration order, so the size of a procedure counts the calls inlined into it
+ * @param tree tree of the program
+ * @param symbolTable the symbolTable of the compiler
+ * @return the number of calls inlined
+ */
+int inlineProcedures( Node *tree , Symbol **symbolTable );
+
+#endif //__INLINING_H__
+
+//end inlining.h
@@ -0,0 +1,322 @@
+/**
+ * metrics.c
+ * Implementation of the dump of the counters that describe the work done by the interpreter
+ * @author Jose Pablo Ortiz Lack
+ */
+#include "metrics.h"
+#include "arena.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <errno.h>
+#include <signal.h>
+#include <unistd.h>
+#include <pthread.h>
+
+_Thread_local Metrics metrics;
+
+static MetricsFormat exportFormat = mNONE; //format used by the dumps at exit and on SIGUSR1
+
+/**
+ * @brief a dump being formatted
+ */
+typedef struct tagMetricsText {
+
+    char *buffer; //where the dump is formatted
+    size_t capacity; //bytes of the buffer
+    size_t length; //bytes formatted so far
+
+} MetricsText;
+
+static char metricsBuffer[8192]; //the dumps of printMetrics are formatted here
+
+static char signalBuffer[8192]; //the dumps on SIGUSR1 are formatted here, so the handler does not need to allocate memory
+
+/**
+ * @brief names of the node types, in NodeType order
+ */
+static const char *nodeTypeNames[METRICS_NODE_TYPES] = {
+    "value" , "symbol_type" , "operation" , "expresion" , "semicolon" , "declaration" , "assignment" , "if" , "while" , "for" , "read" , "print" , "call"
+};
+
+/**
+ * @brief appends a character to a dump, dropping it if the buffer is full
+ */
+static void appendCharacter( MetricsText *text , char character ) {
+
+    if ( text->length < text->capacity ) {
+
+        text->buffer[text->length++] = character;
+
+    }
+}
+
+/**
+ * @brief appends the decimal digits of a number to a dump
+ */
+static void appendNumber( MetricsText *text , unsigned long long value ) {
+
+    char digits[20];
+    int count = 0;
+
+    do {
+
+        digits[count++] = (char) ( '0' + value % 10 );
+        value          /= 10;
+
+    } while ( value > 0 );
+
+    while ( count > 0 ) {
+
+        appendCharacter( text , digits[--count] );
+
+    }
+}
+
+/**
+ * @brief appends formatted text to a dump, truncating it if it does not fit. Only %s, %llu and %zu are understood, the text is
+ * formatted by hand because vsnprintf is not async-signal-safe and the SIGUSR1 handler formats dumps too
+ */
+static void appendText( MetricsText *text , const char *format , ... ) {
+
+    va_list arguments;
+
+    va_start( arguments , format );
+
+    while ( *format != '\0' ) {
+
+        if ( format[0] == '%' && format[1] == 's' ) {
+
+            const char *string = va_arg( arguments , const char * );
+
+            while ( *string != '\0' ) {
+
+                appendCharacter( text , *string++ );
+
+            }
+
+            format += 2;
+
+        } else if ( format[0] == '%' && format[1] == 'l' && format[2] == 'l' && format[3] == 'u' ) {
+
+            appendNumber( text , va_arg( arguments , unsigned long long ) );
+
+            format += 4;
+
+        } else if ( format[0] == '%' && format[1] == 'z' && format[2] == 'u' ) {
+
+            appendNumber( text , va_arg( arguments , size_t ) );
+
+            format += 3;
+
+        } else {
+
+            appendCharacter( text , *format++ );
+
+        }
+    }
+
+    va_end( arguments );
+
+}
+
+/**
+ * @brief appends a counter in Prometheus text format
+ */
+static void appendPrometheusCounter( MetricsText *text , const char *name , const char *help , unsigned long long value ) {
+
+    appendText( text , "# HELP %s %s\n# TYPE %s counter\n%s %llu\n" , name , help , name , name , value );
+
+}
+
+/**
+ * @brief appends a gauge of the memory in use or most ever in use by category in Prometheus text format
+ */
+static void appendPrometheusMemory( MetricsText *text , const char *name , const char *help , const size_t *bytes , size_t total ) {
+
+    int category;
+
+    appendText( text , "# HELP %s %s\n# TYPE %s gauge\n" , name , help , name );
+
+    for ( category = 0 ; category < ALLOCATION_CATEGORIES ; category++ ) {
+
+        appendText( text , "%s{category=\"%s\"} %zu\n" , name , allocationCategoryNames[category] , bytes[category] );
+
+    }
+
+    appendText( text , "%s{category=\"total\"} %zu\n" , name , total );
+
+}
+
+/**
+ * @brief formats the counters in a buffer, without calling functions that are not async-signal-safe
+ * @param buffer where the dump is formatted
+ * @param capacity bytes of the buffer, the dump is truncated if it does not fit
+ * @return the length of the dump
+ */
+static size_t formatMetrics( char *buffer , size_t capacity , MetricsFormat format ) {
+
+    MetricsText dump = { buffer , capacity , 0 };
+    MetricsText *text = &dump;
+    MemoryUsage usage;
+    int category;
+    int type;
+
+    getMemoryUsage( &usage );
+
+    if ( format == mPROMETHEUS ) {
+
+        appendPrometheusCounter( text , "slc_symbol_lookups_total" , "Symbol table lookups." , metrics.symbolLookups );
+        appendPrometheusCounter( text , "slc_symbols_traversed_total" , "Symbols visited by the lookups, the chain length of every lookup added up." , metrics.symbolsTraversed );
+        appendPrometheusCounter( text , "slc_nodes_allocated_total" , "Syntax tree nodes allocated." , metrics.nodesAllocated );
+        appendPrometheusCounter( text , "slc_node_bytes_total" , "Bytes of the syntax tree nodes allocated." , metrics.nodeBytes );
+        appendPrometheusCounter( text , "slc_loop_iterations_total" , "Iterations of while and for loops." , metrics.loopIterations );
+        appendPrometheusCounter( text , "slc_operations_reused_total" , "Operations not evaluated because their value was reused." , metrics.operationsReused );
+        appendPrometheusCounter( text , "slc_print_calls_total" , "Print statements executed." , metrics.statements[nPRINT] );
+        appendPrometheusCounter( text , "slc_read_calls_total" , "Read statements executed." , metrics.statements[nREAD] );
+
+        appendText( text , "# HELP slc_statements_total Nodes resolved by the interpreter, by node type.\n# TYPE slc_statements_total counter\n" );
+
+        for ( type = 0 ; type < METRICS_NODE_TYPES ; type++ ) {
+
+            appendText( text , "slc_statements_total{type=\"%s\"} %llu\n" , nodeTypeNames[type] , metrics.statements[type] );
+
+        }
+
+        appendPrometheusMemory( text , "slc_memory_bytes" , "Bytes of the compiler in use, by category." , usage.current , usage.currentTotal );
+        appendPrometheusMemory( text , "slc_memory_peak_bytes" , "Most bytes of the compiler in use at once, by category." , usage.peak , usage.peakTotal );
+
+    } else if ( format == mJSON ) {
+
+        appendText( text , "{\"symbolLookups\":%llu" , metrics.symbolLookups );
+        appendText( text , ",\"symbolsTraversed\":%llu" , metrics.symbolsTraversed );
+        appendText( text , ",\"nodesAllocated\":%llu" , metrics.nodesAllocated );
+        appendText( text , ",\"nodeBytes\":%llu" , metrics.nodeBytes );
+        appendText( text , ",\"loopIterations\":%llu" , metrics.loopIterations );
+        appendText( text , ",\"operationsReused\":%llu" , metrics.operationsReused );
+        appendText( text , ",\"printCalls\":%llu" , metrics.statements[nPRINT] );
+        appendText( text , ",\"readCalls\":%llu" , metrics.statements[nREAD] );
+        appendText( text , ",\"statements\":{" );
+
+        for ( type = 0 ; type < METRICS_NODE_TYPES ; type++ ) {
+
+            appendText( text , type == 0 ? "\"%s\":%llu" : ",\"%s\":%llu" , nodeTypeNames[type] , metrics.statements[type] );
+
+        }
+
+        appendText( text , "},\"memory\":{" );
+
+        for ( category = 0 ; category < ALLOCATION_CATEGORIES ; category++ ) {
+
+            appendText( text , "\"%s\":{\"current\":%zu,\"peak\":%zu}," , allocationCategoryNames[category] , usage.current[category] , usage.peak[category] );
+
+        }
+
+        appendText( text , "\"total\":{\"current\":%zu,\"peak\":%zu}}}\n" , usage.currentTotal , usage.peakTotal );
+
+    }
+
+    return text->length;
+
+}
+
+void addMetrics( const Metrics *counters ) {
+
+    int type;
+
+    metrics.symbolLookups    += counters->symbolLookups;
+    metrics.symbolsTraversed += counters->symbolsTraversed;
+    metrics.nodesAllocated   += counters->nodesAllocated;
+    metrics.nodeBytes        += counters->nodeBytes;
+    metrics.loopIterations   += counters->loopIterations;
+    metrics.operationsReused += counters->operationsReused;
+
+    for ( type = 0 ; type < METRICS_NODE_TYPES ; type++ ) {
+
+        metrics.statements[type] += counters->statements[type];
+
+    }
+}
+
+void printMetrics( FILE *stream , MetricsFormat format ) {
+
+    sigset_t blocked;
+    sigset_t previous;
+
+    //a dump on SIGUSR1 is not written in the middle of this one
+    sigemptyset( &blocked );
+    sigaddset( &blocked , SIGUSR1 );
+    pthread_sigmask( SIG_BLOCK , &blocked , &previous );
+
+    fwrite( metricsBuffer , 1 , formatMetrics( metricsBuffer , sizeof( metricsBuffer ) , format ) , stream );
+    fflush( stream );
+
+    pthread_sigmask( SIG_SETMASK , &previous , NULL );
+
+}
+
+/**
+ * @brief dumps the counters to stderr when the program exits
+ */
+static void dumpMetricsAtExit() {
+
+    fflush( stdout );
+
+    printMetrics( stderr , exportFormat );
+
+}
+
+/**
+ * @brief dumps the counters to stderr when SIGUSR1 is received, the program keeps running. Only async-signal-safe functions are called
+ */
+static void dumpMetricsOnSignal( int signalNumber ) {
+
+    int savedErrno = errno;
+    size_t length  = formatMetrics( signalBuffer , sizeof( signalBuffer ) , exportFormat );
+    size_t written = 0;
+
+    (void) signalNumber;
+
+    while ( written < length ) {
+
+        ssize_t result = write( STDERR_FILENO , signalBuffer + written , length - written );
+
+        if ( result <= 0 ) {
+
+            break;
+
+        }
+
+        written += (size_t) result;
+
+    }
+
+    errno = savedErrno;
+
+}
+
+void exportMetrics( MetricsFormat format ) {
+
+    struct sigaction action;
+
+    exportFormat = format;
+
+    if ( format == mNONE ) {
+
+        return;
+
+    }
+
+    atexit( dumpMetricsAtExit );
+
+    memset( &action , 0 , sizeof( action ) );
+    action.sa_handler = dumpMetricsOnSignal;
+    sigemptyset( &action.sa_mask );
+    action.sa_flags = SA_RESTART; //a read waiting for input keeps waiting after the dump
+
+    sigaction( SIGUSR1 , &action , NULL );
+
+}
+
+//end metrics.c
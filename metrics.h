@@ -0,0 +1,88 @@
+/**
+ * metrics.h
+ * Definition of the counters that describe the work done by the interpreter
+ * Compiling with -DNO_METRICS removes every counter from the hot paths
+ * @author Jose Pablo Ortiz Lack
+ */
+#ifndef __METRICS_H__
+#define __METRICS_H__
+
+#include <stdio.h>
+
+#include "syntaxTree.h"
+
+/**
+ * @brief number of node types counted by the statement counters
+ */
+#define METRICS_NODE_TYPES ( nCALL + 1 )
+
+/**
+ * @brief the format of the metrics dump
+ */
+typedef enum tagMetricsFormat {
+
+    mNONE, //metrics are not dumped
+    mPROMETHEUS, //Prometheus text exposition format
+    mJSON //a single JSON object
+
+} MetricsFormat;
+
+/**
+ * @brief the counters of the interpreter
+ */
+typedef struct tagMetrics {
+
+    unsigned long long symbolLookups; //calls to findSymbol
+    unsigned long long symbolsTraversed; //symbols visited by findSymbol, the chain length of every lookup added up
+
+    unsigned long long nodesAllocated; //nodes of the syntax tree
+    unsigned long long nodeBytes; //bytes of the nodes of the syntax tree
+
+    unsigned long long statements[METRICS_NODE_TYPES]; //nodes resolved by resolveTree, by node type
+
+    unsigned long long loopIterations; //iterations of while and for loops, including the ones run by the vectorized path
+
+    unsigned long long operationsReused; //operations not evaluated because the value numbering reused their value
+
+} Metrics;
+
+/**
+ * @brief the counters of the interpreter. Every thread counts its own work
+ */
+extern _Thread_local Metrics metrics;
+
+#ifdef NO_METRICS
+
+#define METRIC_ADD( counter , amount ) ( (void) 0 )
+
+#else
+
+/**
+ * @brief adds an amount to a counter of the metrics
+ */
+#define METRIC_ADD( counter , amount ) ( metrics.counter += ( amount ) )
+
+#endif
+
+/**
+ * @brief adds the counters of another thread to the counters of the current thread
+ * @param counters counters of the other thread
+ */
+void addMetrics( const Metrics *counters );
+
+/**
+ * @brief prints the counters and the memory of the compiler in use and most ever in use by category
+ * @param stream where the counters are printed
+ * @param format format of the counters
+ */
+void printMetrics( FILE *stream , MetricsFormat format );
+
+/**
+ * @brief dumps the counters to stderr when the program exits and every time it receives SIGUSR1
+ * @param format format of the counters
+ */
+void exportMetrics( MetricsFormat format );
+
+#endif //__METRICS_H__
+
+//end metrics.h
@@ -0,0 +1,3226 @@
+/**
+ * nativeCode.c
+ * Implementation of the native backend: an x86-64 code generator for the tree, the runtime of the executables and the ELF writer
+ *
+ * The generated code evaluates the operations in rax and xmm0, with the right operand in rcx and xmm1, and keeps on the stack the left
+ * operands whose right operand is not a literal or a scalar. r15 holds the address of the data during the whole execution:
+ *  - the state of the runtime: the length of the output buffer, the position in the input buffer and the word being read
+ *  - one 8 byte slot per symbol, by slot, with the parameters and locals of the procedures
+ *  - the output and input buffers, the elements of the arrays and the values kept by the oKEEP nodes
+ * A call saves the slots of the locals of the procedure on the stack, as the frame of callProcedure does, so procedures are recursive
+ * @author Jose Pablo Ortiz Lack
+ */
+#include "nativeCode.h"
+#include "diagnostics.h"
+
+#include <elf.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+/**
+ * @brief offsets of the state of the runtime from the start of the data
+ */
+#define OUTPUT_LENGTH 0 //bytes waiting in the output buffer
+#define INPUT_POSITION 8 //next byte of the input buffer
+#define INPUT_LENGTH 16 //bytes read into the input buffer
+#define INPUT_ENDED 24 //1 once the input reached its end
+#define DIGIT_COUNT 32 //significant digits of the number being read
+#define DECIMAL_EXPONENT 40 //power of 10 of the last significant digit of the number being read
+#define TOKEN 64 //first bytes of the word being read
+#define TOKEN_SIZE 64
+#define DIGITS 128 //significant digits of the number being read, one per byte
+#define STATE_SIZE 192 //the slots of the symbols follow the state
+
+/**
+ * @brief longest word taken as a value, the words a session reads
+ */
+#define LONGEST_WORD 63
+
+/**
+ * @brief headers at the start of the file: the ELF header and the program headers of the code, the data and the stack
+ */
+#define HEADERS_SIZE ( sizeof( Elf64_Ehdr ) + 3 * sizeof( Elf64_Phdr ) )
+
+#define PAGE_SIZE 4096
+
+/**
+ * @brief the general purpose registers
+ */
+typedef enum tagRegister {
+
+    rAX, rCX, rDX, rBX, rSP, rBP, rSI, rDI,
+    rR8, rR9, rR10, rR11, rR12, rR13, rR14, rR15
+
+} Register;
+
+/**
+ * @brief the conditions of the branches
+ */
+typedef enum tagCondition {
+
+    cOVERFLOW = 0x0 ,
+    cBELOW = 0x2 ,
+    cABOVE_OR_EQUAL = 0x3 ,
+    cEQUAL = 0x4 ,
+    cNOT_EQUAL = 0x5 ,
+    cBELOW_OR_EQUAL = 0x6 ,
+    cABOVE = 0x7 ,
+    cSIGN = 0x8 ,
+    cNOT_SIGN = 0x9 ,
+    cPARITY = 0xA ,
+    cLESS = 0xC ,
+    cGREATER_OR_EQUAL = 0xD ,
+    cLESS_OR_EQUAL = 0xE ,
+    cGREATER = 0xF
+
+} Condition;
+
+/**
+ * @brief the run-time errors of the programs, each one with a stub that writes its message and terminates
+ */
+typedef enum tagNativeError {
+
+    nDIVISION,
+    nOVERFLOW,
+    nSTEP,
+    nBOUNDS_FINITE,
+    NATIVE_ERRORS
+
+} NativeError;
+
+static const char *errorMessages[NATIVE_ERRORS] = {
+    "Error: Division by zero. Program will be terminated.\n",
+    "Error: Integer overflow. Program will be terminated.\n",
+    "Error: Step cannot be 0.0 . Program will be terminated.\n",
+    "Error: For loop bounds must be finite. Program will be terminated.\n"
+};
+
+/**
+ * @brief a memory operand: base + index * scale + displacement, or a constant addressed relative to the instruction
+ */
+typedef struct tagMemory {
+
+    int base;
+    int index; //-1 without index
+    int scale;
+    int displacement;
+    long long constant; //offset of the constant in the constant pool, -1 if the operand is not a constant
+
+} Memory;
+
+/**
+ * @brief a 32 bit field of the code completed once the code is laid out
+ */
+typedef struct tagFixup {
+
+    size_t position; //position of the field in the code, the field is the last of its instruction
+    int isConstant; //1 if the field is the distance to a constant, 0 if it is the distance to a label
+    long long target; //label or offset of the constant
+
+} Fixup;
+
+/**
+ * @brief the slot of the value kept by an oKEEP node
+ */
+typedef struct tagKeptSlot {
+
+    Node *kept;
+    long long offset;
+
+} KeptSlot;
+
+/**
+ * @brief the executable being generated
+ */
+typedef struct tagNativeCode {
+
+    unsigned char *bytes; //machine code
+    size_t length;
+    size_t capacity;
+
+    unsigned char *constants; //strings and tables, placed after the code
+    size_t constantLength;
+    size_t constantCapacity;
+
+    long long *labels; //position of each label in the code, -1 until it is placed
+    int labelCount;
+    int labelCapacity;
+
+    Fixup *fixups;
+    int fixupCount;
+    int fixupCapacity;
+
+    Symbol **symbolTable;
+    Symbol **symbols; //symbols by slot
+    long long *arrayOffsets; //offset of the elements of each array by slot
+    int *boundsLabels; //stub of the bounds error of each array by slot, -1 until an access needs it
+    int slotCount;
+
+    long long dataSize; //bytes of the data, the kept values are added as they are found
+
+    KeptSlot *keptSlots; //open addressing table of the slots of the oKEEP nodes
+    int keptCapacity;
+    int keptCount;
+
+    Node **procedures; //procedures called, compiled after the statements of the program
+    int *procedureLabels;
+    int procedureCount;
+    int procedureCapacity;
+
+    int errorLabels[NATIVE_ERRORS]; //stub of each error, -1 until an operation needs it
+
+    //routines of the runtime
+    int writeRoutine;
+    int flushRoutine;
+    int putBytesRoutine;
+    int newLineRoutine;
+    int digitsRoutine;
+    int putLongRoutine;
+    int printLongRoutine;
+    int printDoubleRoutine;
+    int getCharRoutine;
+    int readWordRoutine;
+    int readIntegerRoutine;
+    int matchWordRoutine;
+    int readRealRoutine;
+    int bigMultiplyRoutine;
+    int bigShiftRoutine;
+    int compareMidpointRoutine;
+    int failRoutine;
+
+} NativeCode;
+
+/**
+ * @brief grows a buffer to hold at least needed elements
+ */
+static void *growBuffer( void *buffer , int *capacity , int needed , size_t elementSize ) {
+
+    if ( needed > *capacity ) {
+
+        *capacity = *capacity == 0 ? 64 : *capacity;
+
+        while ( *capacity < needed ) {
+
+            *capacity *= 2;
+
+        }
+
+        buffer = realloc( buffer , *capacity * elementSize );
+
+        if ( buffer == NULL ) {
+
+            printf( "Error: Memory allocation failed. Program will be terminated\n" );
+            exit(1);
+
+        }
+    }
+
+    return buffer;
+}
+
+/**
+ * @brief grows a byte buffer to hold at least needed bytes
+ */
+static unsigned char *growBytes( unsigned char *buffer , size_t *capacity , size_t needed ) {
+
+    if ( needed > *capacity ) {
+
+        *capacity = *capacity == 0 ? 4096 : *capacity;
+
+        while ( *capacity < needed ) {
+
+            *capacity *= 2;
+
+        }
+
+        buffer = realloc( buffer , *capacity );
+
+        if ( buffer == NULL ) {
+
+            printf( "Error: Memory allocation failed. Program will be terminated\n" );
+            exit(1);
+
+        }
+    }
+
+    return buffer;
+}
+
+/**
+ * @brief rounds a size up to a multiple of a power of 2
+ */
+static long long alignSize( long long size , long long alignment ) {
+
+    return ( size + alignment - 1 ) & ~( alignment - 1 );
+
+}
+
+static int elementSize( SymbolType type ) {
+
+    return type == sINTEGER || type == sFLOAT ? 4 : 8;
+
+}
+
+static int isReal( SymbolType type ) {
+
+    return type == sFLOAT || type == sDOUBLE;
+
+}
+
+/********** encoding of the instructions **********/
+
+static void emitByte( NativeCode *code , int byte ) {
+
+    code->bytes = growBytes( code->bytes , &code->capacity , code->length + 1 );
+    code->bytes[code->length++] = (unsigned char) byte;
+
+}
+
+static void emit32( NativeCode *code , unsigned int value ) {
+
+    int index;
+
+    for ( index = 0 ; index < 4 ; index++ ) {
+
+        emitByte( code , ( value >> ( 8 * index ) ) & 0xFF );
+
+    }
+}
+
+static void emit64( NativeCode *code , unsigned long long value ) {
+
+    emit32( code , (unsigned int) value );
+    emit32( code , (unsigned int) ( value >> 32 ) );
+
+}
+
+/**
+ * @brief emits an opcode of 1 to 3 bytes, written as one number: 0x0FAF is 0F AF
+ */
+static void emitOpcode( NativeCode *code , unsigned int opcode ) {
+
+    if ( opcode > 0xFFFF ) {
+
+        emitByte( code , opcode >> 16 );
+
+    }
+
+    if ( opcode > 0xFF ) {
+
+        emitByte( code , ( opcode >> 8 ) & 0xFF );
+
+    }
+
+    emitByte( code , opcode & 0xFF );
+
+}
+
+/**
+ * @brief emits an instruction whose operands are two registers. reg is the register or the extension of the opcode in the ModRM byte
+ * @param prefix 0x66, 0xF2 or 0xF3 for the SSE instructions, 0 for none
+ * @param wide 1 for a 64 bit operation
+ */
+static void emitRegisters( NativeCode *code , int prefix , int wide , unsigned int opcode , int reg , int rm ) {
+
+    int rex = ( wide ? 8 : 0 ) | ( reg & 8 ? 4 : 0 ) | ( rm & 8 ? 1 : 0 );
+
+    if ( prefix != 0 ) {
+
+        emitByte( code , prefix );
+
+    }
+
+    if ( rex != 0 ) {
+
+        emitByte( code , 0x40 | rex );
+
+    }
+
+    emitOpcode( code , opcode );
+    emitByte( code , 0xC0 | ( reg & 7 ) << 3 | ( rm & 7 ) );
+
+}
+
+static Memory memoryAt( int base , long long displacement ) {
+
+    Memory memory = { base , -1 , 1 , (int) displacement , -1 };
+
+    return memory;
+}
+
+static Memory memoryIndexed( int base , int index , int scale , long long displacement ) {
+
+    Memory memory = { base , index , scale , (int) displacement , -1 };
+
+    return memory;
+}
+
+static Memory memoryConstant( long long offset ) {
+
+    Memory memory = { 0 , -1 , 1 , 0 , offset };
+
+    return memory;
+}
+
+/**
+ * @brief emits an instruction with a register, or an extension of the opcode, and a memory operand. An immediate may follow unless
+ * the operand is a constant, whose distance must be the last field of the instruction
+ */
+static void emitMemory( NativeCode *code , int prefix , int wide , unsigned int opcode , int reg , Memory memory ) {
+
+    int rex = ( wide ? 8 : 0 ) | ( reg & 8 ? 4 : 0 );
+    int mode;
+
+    if ( memory.constant < 0 ) {
+
+        rex |= ( memory.index >= 0 && ( memory.index & 8 ) ? 2 : 0 ) | ( memory.base & 8 ? 1 : 0 );
+
+    }
+
+    if ( prefix != 0 ) {
+
+        emitByte( code , prefix );
+
+    }
+
+    if ( rex != 0 ) {
+
+        emitByte( code , 0x40 | rex );
+
+    }
+
+    emitOpcode( code , opcode );
+
+    if ( memory.constant >= 0 ) { //rip + displacement
+
+        emitByte( code , 0x05 | ( reg & 7 ) << 3 );
+
+        code->fixups = growBuffer( code->fixups , &code->fixupCapacity , code->fixupCount + 1 , sizeof( Fixup ) );
+        code->fixups[code->fixupCount].position   = code->length;
+        code->fixups[code->fixupCount].isConstant = 1;
+        code->fixups[code->fixupCount].target     = memory.constant;
+        code->fixupCount++;
+
+        emit32( code , 0 );
+
+        return;
+
+    }
+
+    //rbp and r13 as base have no form without displacement
+    if ( memory.displacement == 0 && ( memory.base & 7 ) != rBP ) {
+
+        mode = 0;
+
+    } else {
+
+        mode = memory.displacement >= -128 && memory.displacement <= 127 ? 1 : 2;
+
+    }
+
+    if ( memory.index >= 0 ) {
+
+        static const int scales[9] = { 0 , 0 , 1 , 0 , 2 , 0 , 0 , 0 , 3 };
+
+        emitByte( code , mode << 6 | ( reg & 7 ) << 3 | 4 );
+        emitByte( code , scales[memory.scale] << 6 | ( memory.index & 7 ) << 3 | ( memory.base & 7 ) );
+
+    } else if ( ( memory.base & 7 ) == rSP ) { //rsp and r12 as base need the SIB byte
+
+        emitByte( code , mode << 6 | ( reg & 7 ) << 3 | 4 );
+        emitByte( code , 0x24 );
+
+    } else {
+
+        emitByte( code , mode << 6 | ( reg & 7 ) << 3 | ( memory.base & 7 ) );
+
+    }
+
+    if ( mode == 1 ) {
+
+        emitByte( code , memory.displacement & 0xFF );
+
+    } else if ( mode == 2 ) {
+
+        emit32( code , (unsigned int) memory.displacement );
+
+    }
+}
+
+/**
+ * @brief emits an arithmetic operation of a register and an immediate: extension 0 add, 1 or, 4 and, 5 sub, 6 xor, 7 cmp
+ */
+static void emitImmediate( NativeCode *code , int wide , int extension , int rm , int value ) {
+
+    if ( value >= -128 && value <= 127 ) {
+
+        emitRegisters( code , 0 , wide , 0x83 , extension , rm );
+        emitByte( code , value & 0xFF );
+
+    } else {
+
+        emitRegisters( code , 0 , wide , 0x81 , extension , rm );
+        emit32( code , (unsigned int) value );
+
+    }
+}
+
+/**
+ * @brief emits an arithmetic operation of a memory operand and an immediate, with the extensions of emitImmediate
+ */
+static void emitMemoryImmediate( NativeCode *code , int wide , int extension , Memory memory , int value ) {
+
+    if ( value >= -128 && value <= 127 ) {
+
+        emitMemory( code , 0 , wide , 0x83 , extension , memory );
+        emitByte( code , value & 0xFF );
+
+    } else {
+
+        emitMemory( code , 0 , wide , 0x81 , extension , memory );
+        emit32( code , (unsigned int) value );
+
+    }
+}
+
+/**
+ * @brief emits a shift of a register by an immediate: extension 4 shl, 5 shr
+ */
+static void emitShift( NativeCode *code , int wide , int extension , int rm , int count ) {
+
+    emitRegisters( code , 0 , wide , 0xC1 , extension , rm );
+    emitByte( code , count );
+
+}
+
+/**
+ * @brief loads an immediate into a register with the shortest move
+ * @param wide 1 to load the 64 bits of value, 0 to load its low 32 bits
+ */
+static void emitMoveImmediate( NativeCode *code , int reg , long long value , int wide ) {
+
+    if ( !wide || ( value >= 0 && value <= 0xFFFFFFFFLL ) ) { //the 32 bit move clears the high half
+
+        if ( reg & 8 ) {
+
+            emitByte( code , 0x41 );
+
+        }
+
+        emitByte( code , 0xB8 + ( reg & 7 ) );
+        emit32( code , (unsigned int) value );
+
+    } else if ( value >= -0x80000000LL && value < 0 ) {
+
+        emitRegisters( code , 0 , 1 , 0xC7 , 0 , reg );
+        emit32( code , (unsigned int) value );
+
+    } else {
+
+        emitByte( code , 0x48 | ( reg & 8 ? 1 : 0 ) );
+        emitByte( code , 0xB8 + ( reg & 7 ) );
+        emit64( code , (unsigned long long) value );
+
+    }
+}
+
+static void emitPush( NativeCode *code , int reg ) {
+
+    if ( reg & 8 ) {
+
+        emitByte( code , 0x41 );
+
+    }
+
+    emitByte( code , 0x50 + ( reg & 7 ) );
+
+}
+
+static void emitPop( NativeCode *code , int reg ) {
+
+    if ( reg & 8 ) {
+
+        emitByte( code , 0x41 );
+
+    }
+
+    emitByte( code , 0x58 + ( reg & 7 ) );
+
+}
+
+static void emitReturn( NativeCode *code ) {
+
+    emitByte( code , 0xC3 );
+
+}
+
+static void emitSyscall( NativeCode *code ) {
+
+    emitOpcode( code , 0x0F05 );
+
+}
+
+/**
+ * @brief loads a value of a type into a general purpose register, or an xmm register for floats and doubles
+ */
+static void emitLoad( NativeCode *code , SymbolType type , int reg , Memory memory ) {
+
+    switch ( type ) {
+
+        case sINTEGER: emitMemory( code , 0 , 0 , 0x8B , reg , memory ); break;
+        case sLONG:    emitMemory( code , 0 , 1 , 0x8B , reg , memory ); break;
+        case sFLOAT:   emitMemory( code , 0xF3 , 0 , 0x0F10 , reg , memory ); break;
+        case sDOUBLE:  emitMemory( code , 0xF2 , 0 , 0x0F10 , reg , memory ); break;
+
+    }
+}
+
+/**
+ * @brief stores a value of a type from a general purpose register, or an xmm register for floats and doubles
+ */
+static void emitStore( NativeCode *code , SymbolType type , int reg , Memory memory ) {
+
+    switch ( type ) {
+
+        case sINTEGER: emitMemory( code , 0 , 0 , 0x89 , reg , memory ); break;
+        case sLONG:    emitMemory( code , 0 , 1 , 0x89 , reg , memory ); break;
+        case sFLOAT:   emitMemory( code , 0xF3 , 0 , 0x0F11 , reg , memory ); break;
+        case sDOUBLE:  emitMemory( code , 0xF2 , 0 , 0x0F11 , reg , memory ); break;
+
+    }
+}
+
+/********** labels and constants **********/
+
+static int createLabel( NativeCode *code ) {
+
+    code->labels = growBuffer( code->labels , &code->labelCapacity , code->labelCount + 1 , sizeof( long long ) );
+    code->labels[code->labelCount] = -1;
+
+    return code->labelCount++;
+}
+
+static void placeLabel( NativeCode *code , int label ) {
+
+    code->labels[label] = code->length;
+
+}
+
+/**
+ * @brief emits the 32 bit distance to a label, completed once the code is laid out
+ */
+static void emitLabelDistance( NativeCode *code , int label ) {
+
+    code->fixups = growBuffer( code->fixups , &code->fixupCapacity , code->fixupCount + 1 , sizeof( Fixup ) );
+    code->fixups[code->fixupCount].position   = code->length;
+    code->fixups[code->fixupCount].isConstant = 0;
+    code->fixups[code->fixupCount].target     = label;
+    code->fixupCount++;
+
+    emit32( code , 0 );
+
+}
+
+static void emitJump( NativeCode *code , int label ) {
+
+    emitByte( code , 0xE9 );
+    emitLabelDistance( code , label );
+
+}
+
+static void emitBranch( NativeCode *code , Condition condition , int label ) {
+
+    emitByte( code , 0x0F );
+    emitByte( code , 0x80 + condition );
+    emitLabelDistance( code , label );
+
+}
+
+static void emitCall( NativeCode *code , int label ) {
+
+    emitByte( code , 0xE8 );
+    emitLabelDistance( code , label );
+
+}
+
+/**
+ * @brief adds a constant to the pool placed after the code
+ * @return the offset of the constant in the pool
+ */
+static long long addConstant( NativeCode *code , const void *data , size_t length , size_t alignment ) {
+
+    size_t offset = (size_t) alignSize( code->constantLength , alignment );
+
+    code->constants = growBytes( code->constants , &code->constantCapacity , offset + length );
+
+    memset( code->constants + code->constantLength , 0 , offset - code->constantLength );
+    memcpy( code->constants + offset , data , length );
+
+    code->constantLength = offset + length;
+
+    return offset;
+}
+
+/**
+ * @brief loads into rsi the address of a text and into edx its length, the arguments of putBytesRoutine and failRoutine
+ */
+static void emitText( NativeCode *code , const char *text , size_t length ) {
+
+    emitMemory( code , 0 , 1 , 0x8D , rSI , memoryConstant( addConstant( code , text , length , 1 ) ) ); //lea rsi, [text]
+    emitMoveImmediate( code , rDX , (long long) length , 0 );
+
+}
+
+/********** runtime **********/
+
+/**
+ * @brief write: writes rdx bytes from rsi to the standard output, repeating the system call until every byte is written
+ */
+static void emitWriteRoutine( NativeCode *code ) {
+
+    int loop = createLabel( code );
+    int done = createLabel( code );
+
+    placeLabel( code , code->writeRoutine );
+    placeLabel( code , loop );
+    emitRegisters( code , 0 , 1 , 0x85 , rDX , rDX ); //test rdx, rdx
+    emitBranch( code , cEQUAL , done );
+    emitMoveImmediate( code , rAX , 1 , 0 ); //write
+    emitMoveImmediate( code , rDI , 1 , 0 );
+    emitSyscall( code );
+    emitImmediate( code , 1 , 7 , rAX , -4 ); //interrupted
+    emitBranch( code , cEQUAL , loop );
+    emitRegisters( code , 0 , 1 , 0x85 , rAX , rAX );
+    emitBranch( code , cLESS_OR_EQUAL , done );
+    emitRegisters( code , 0 , 1 , 0x01 , rAX , rSI ); //add rsi, rax
+    emitRegisters( code , 0 , 1 , 0x29 , rAX , rDX ); //sub rdx, rax
+    emitJump( code , loop );
+    placeLabel( code , done );
+    emitReturn( code );
+
+}
+
+/**
+ * @brief flush: writes the output buffer
+ */
+static void emitFlushRoutine( NativeCode *code , long long outputBuffer ) {
+
+    placeLabel( code , code->flushRoutine );
+    emitMemory( code , 0 , 1 , 0x8D , rSI , memoryAt( rR15 , outputBuffer ) ); //lea rsi, [buffer]
+    emitMemory( code , 0 , 1 , 0x8B , rDX , memoryAt( rR15 , OUTPUT_LENGTH ) );
+    emitCall( code , code->writeRoutine );
+    emitMemoryImmediate( code , 1 , 4 , memoryAt( rR15 , OUTPUT_LENGTH ) , 0 ); //and qword [length], 0
+    emitReturn( code );
+
+}
+
+/**
+ * @brief putBytes: appends rdx bytes from rsi to the output buffer, flushing it when it is full. Bytes that do not fit in the empty
+ * buffer are written directly
+ */
+static void emitPutBytesRoutine( NativeCode *code , long long outputBuffer ) {
+
+    int copy = createLabel( code );
+
+    placeLabel( code , code->putBytesRoutine );
+    emitMemory( code , 0 , 1 , 0x8B , rAX , memoryAt( rR15 , OUTPUT_LENGTH ) );
+    emitRegisters( code , 0 , 1 , 0x01 , rDX , rAX ); //add rax, rdx
+    emitImmediate( code , 1 , 7 , rAX , NATIVE_BUFFER_SIZE );
+    emitBranch( code , cBELOW_OR_EQUAL , copy );
+    emitPush( code , rSI );
+    emitPush( code , rDX );
+    emitCall( code , code->flushRoutine );
+    emitPop( code , rDX );
+    emitPop( code , rSI );
+    emitImmediate( code , 1 , 7 , rDX , NATIVE_BUFFER_SIZE );
+    emitBranch( code , cBELOW_OR_EQUAL , copy );
+    emitJump( code , code->writeRoutine );
+    placeLabel( code , copy );
+    emitMemory( code , 0 , 1 , 0x8B , rAX , memoryAt( rR15 , OUTPUT_LENGTH ) );
+    emitMemory( code , 0 , 1 , 0x8D , rDI , memoryIndexed( rR15 , rAX , 1 , outputBuffer ) ); //lea rdi, [buffer + length]
+    emitRegisters( code , 0 , 1 , 0x89 , rDX , rCX ); //mov rcx, rdx
+    emitOpcode( code , 0xF3A4 ); //rep movsb
+    emitMemory( code , 0 , 1 , 0x01 , rDX , memoryAt( rR15 , OUTPUT_LENGTH ) ); //add [length], rdx
+    emitReturn( code );
+
+}
+
+/**
+ * @brief newLine: appends a new line to the output buffer
+ */
+static void emitNewLineRoutine( NativeCode *code ) {
+
+    placeLabel( code , code->newLineRoutine );
+    emitText( code , "\n" , 1 );
+    emitJump( code , code->putBytesRoutine );
+
+}
+
+/**
+ * @brief digits: writes the unsigned value of rax in decimal at rdi, with at least ecx digits padded with zeros, and advances rdi
+ */
+static void emitDigitsRoutine( NativeCode *code ) {
+
+    int divide = createLabel( code );
+    int pad    = createLabel( code );
+    int copy   = createLabel( code );
+
+    placeLabel( code , code->digitsRoutine );
+    emitImmediate( code , 1 , 5 , rSP , 32 ); //sub rsp, 32, the digits are written backwards from its end
+    emitMemory( code , 0 , 1 , 0x8D , rSI , memoryAt( rSP , 32 ) );
+    emitRegisters( code , 0 , 0 , 0x89 , rCX , rR8 ); //mov r8d, ecx
+    emitMoveImmediate( code , rCX , 10 , 0 );
+    placeLabel( code , divide );
+    emitRegisters( code , 0 , 0 , 0x31 , rDX , rDX ); //xor edx, edx
+    emitRegisters( code , 0 , 1 , 0xF7 , 6 , rCX ); //div rcx
+    emitImmediate( code , 0 , 0 , rDX , '0' );
+    emitRegisters( code , 0 , 1 , 0xFF , 1 , rSI ); //dec rsi
+    emitMemory( code , 0 , 0 , 0x88 , rDX , memoryAt( rSI , 0 ) ); //mov [rsi], dl
+    emitRegisters( code , 0 , 0 , 0xFF , 1 , rR8 ); //dec r8d
+    emitRegisters( code , 0 , 1 , 0x85 , rAX , rAX );
+    emitBranch( code , cNOT_EQUAL , divide );
+    placeLabel( code , pad );
+    emitRegisters( code , 0 , 0 , 0x85 , rR8 , rR8 );
+    emitBranch( code , cLESS_OR_EQUAL , copy );
+    emitRegisters( code , 0 , 1 , 0xFF , 1 , rSI );
+    emitMemory( code , 0 , 0 , 0xC6 , 0 , memoryAt( rSI , 0 ) ); //mov byte [rsi], '0'
+    emitByte( code , '0' );
+    emitRegisters( code , 0 , 0 , 0xFF , 1 , rR8 );
+    emitJump( code , pad );
+    placeLabel( code , copy );
+    emitMemory( code , 0 , 1 , 0x8D , rCX , memoryAt( rSP , 32 ) );
+    emitRegisters( code , 0 , 1 , 0x29 , rSI , rCX ); //sub rcx, rsi
+    emitOpcode( code , 0xF3A4 ); //rep movsb
+    emitImmediate( code , 1 , 0 , rSP , 32 );
+    emitReturn( code );
+
+}
+
+/**
+ * @brief putLong: appends the signed value of rax in decimal to the output buffer. printLong appends a new line after it, "%lld\n"
+ */
+static void emitPutLongRoutine( NativeCode *code ) {
+
+    int positive = createLabel( code );
+
+    placeLabel( code , code->putLongRoutine );
+    emitImmediate( code , 1 , 5 , rSP , 40 );
+    emitRegisters( code , 0 , 1 , 0x89 , rSP , rDI ); //mov rdi, rsp
+    emitRegisters( code , 0 , 1 , 0x85 , rAX , rAX );
+    emitBranch( code , cNOT_SIGN , positive );
+    emitMemory( code , 0 , 0 , 0xC6 , 0 , memoryAt( rDI , 0 ) ); //mov byte [rdi], '-'
+    emitByte( code , '-' );
+    emitRegisters( code , 0 , 1 , 0xFF , 0 , rDI ); //inc rdi
+    emitRegisters( code , 0 , 1 , 0xF7 , 3 , rAX ); //neg rax, the smallest long keeps its bits, which are its magnitude unsigned
+    placeLabel( code , positive );
+    emitMoveImmediate( code , rCX , 1 , 0 );
+    emitCall( code , code->digitsRoutine );
+    emitRegisters( code , 0 , 1 , 0x89 , rSP , rSI ); //mov rsi, rsp
+    emitRegisters( code , 0 , 1 , 0x89 , rDI , rDX ); //mov rdx, rdi
+    emitRegisters( code , 0 , 1 , 0x29 , rSI , rDX ); //sub rdx, rsi
+    emitCall( code , code->putBytesRoutine );
+    emitImmediate( code , 1 , 0 , rSP , 40 );
+    emitReturn( code );
+
+    placeLabel( code , code->printLongRoutine );
+    emitCall( code , code->putLongRoutine );
+    emitJump( code , code->newLineRoutine );
+
+}
+
+/**
+ * @brief printDouble: appends the double of xmm0 as "%f\n" to the output buffer, rounded to 6 decimals as printf does: the exact
+ * binary value, to the nearest and to even on ties. The value is m * 2^e with m below 2^53. If e < 0, m * 10^6 fits in 128 bits
+ * and is shifted right by -e, rounding with the half bit and the bits below it; from -e >= 75 on the value rounds to 0. If e >= 0
+ * the value is an integer of up to 1024 bits, kept as 32 bit limbs on the stack and written 9 digits at a time by dividing it by 10^9
+ */
+static void emitPrintDoubleRoutine( NativeCode *code ) {
+
+    int noSign       = createLabel( code );
+    int finite       = createLabel( code );
+    int special      = createLabel( code );
+    int normal       = createLabel( code );
+    int scaled       = createLabel( code );
+    int fraction     = createLabel( code );
+    int small        = createLabel( code );
+    int wideShift    = createLabel( code );
+    int shifted      = createLabel( code );
+    int stickyLow    = createLabel( code );
+    int stickyHigh   = createLabel( code );
+    int stickySmall  = createLabel( code );
+    int noRound      = createLabel( code );
+    int roundUp      = createLabel( code );
+    int zeroFraction = createLabel( code );
+    int newLine      = createLabel( code );
+    int chunks       = createLabel( code );
+    int trim         = createLabel( code );
+    int divide       = createLabel( code );
+    int divideLimb   = createLabel( code );
+    int chunksDone   = createLabel( code );
+    int printChunks  = createLabel( code );
+    const int limbs      = 512; //offsets in the frame of the routine: the text is written from its start
+    const int chunkList  = 704;
+    const int savedText  = 1016;
+
+    placeLabel( code , code->printDoubleRoutine );
+    emitImmediate( code , 1 , 5 , rSP , 1024 );
+    emitRegisters( code , 0 , 1 , 0x89 , rSP , rDI ); //mov rdi, rsp
+    emitRegisters( code , 0x66 , 1 , 0x0F7E , 0 , rAX ); //movq rax, xmm0
+    emitRegisters( code , 0 , 1 , 0x89 , rAX , rR8 );
+    emitShift( code , 1 , 5 , rR8 , 52 );
+    emitImmediate( code , 0 , 4 , rR8 , 0x7FF ); //r8d: exponent
+    emitRegisters( code , 0 , 1 , 0x89 , rAX , rR9 );
+    emitShift( code , 1 , 4 , rR9 , 12 );
+    emitShift( code , 1 , 5 , rR9 , 12 ); //r9: mantissa
+    emitRegisters( code , 0 , 1 , 0x85 , rAX , rAX );
+    emitBranch( code , cNOT_SIGN , noSign );
+    emitMemory( code , 0 , 0 , 0xC6 , 0 , memoryAt( rDI , 0 ) );
+    emitByte( code , '-' );
+    emitRegisters( code , 0 , 1 , 0xFF , 0 , rDI );
+    placeLabel( code , noSign );
+
+    //infinities and NaNs
+    emitImmediate( code , 0 , 7 , rR8 , 0x7FF );
+    emitBranch( code , cNOT_EQUAL , finite );
+    emitMemory( code , 0 , 1 , 0x8D , rSI , memoryConstant( addConstant( code , "inf" , 3 , 1 ) ) );
+    emitRegisters( code , 0 , 1 , 0x85 , rR9 , rR9 );
+    emitBranch( code , cEQUAL , special );
+    emitMemory( code , 0 , 1 , 0x8D , rSI , memoryConstant( addConstant( code , "nan" , 3 , 1 ) ) );
+    placeLabel( code , special );
+    emitMoveImmediate( code , rCX , 3 , 0 );
+    emitOpcode( code , 0xF3A4 );
+    emitJump( code , newLine );
+
+    //m and e, subnormals have the exponent of the smallest normal without the implicit bit
+    placeLabel( code , finite );
+    emitRegisters( code , 0 , 0 , 0x85 , rR8 , rR8 );
+    emitBranch( code , cNOT_EQUAL , normal );
+    emitMoveImmediate( code , rR8 , 1 , 0 );
+    emitJump( code , scaled );
+    placeLabel( code , normal );
+    emitMoveImmediate( code , rAX , 1LL << 52 , 1 );
+    emitRegisters( code , 0 , 1 , 0x09 , rAX , rR9 ); //or r9, rax
+    placeLabel( code , scaled );
+    emitImmediate( code , 0 , 5 , rR8 , 1075 ); //r8d: e
+    emitBranch( code , cSIGN , fraction );
+
+    //e >= 0: the limbs of m << e
+    emitMemory( code , 0 , 1 , 0x89 , rDI , memoryAt( rSP , savedText ) );
+    emitMemory( code , 0 , 1 , 0x8D , rDI , memoryAt( rSP , limbs ) );
+    emitRegisters( code , 0 , 0 , 0x31 , rAX , rAX );
+    emitMoveImmediate( code , rCX , 40 , 0 );
+    emitOpcode( code , 0xF3AB ); //rep stosd
+    emitRegisters( code , 0 , 0 , 0x89 , rR8 , rR10 );
+    emitShift( code , 0 , 5 , rR10 , 5 ); //r10d: limb of the lowest bit of m
+    emitRegisters( code , 0 , 0 , 0x89 , rR8 , rCX );
+    emitImmediate( code , 0 , 4 , rCX , 31 );
+    emitRegisters( code , 0 , 1 , 0x89 , rR9 , rAX );
+    emitRegisters( code , 0 , 0 , 0x31 , rDX , rDX );
+    emitRegisters( code , 0 , 1 , 0x0FA5 , rAX , rDX ); //shld rdx, rax, cl
+    emitRegisters( code , 0 , 1 , 0xD3 , 4 , rAX ); //shl rax, cl
+    emitMemory( code , 0 , 1 , 0x89 , rAX , memoryIndexed( rSP , rR10 , 4 , limbs ) );
+    emitMemory( code , 0 , 0 , 0x89 , rDX , memoryIndexed( rSP , rR10 , 4 , limbs + 8 ) );
+    emitImmediate( code , 0 , 0 , rR10 , 3 ); //r10d: limbs in use
+    emitRegisters( code , 0 , 0 , 0x31 , rR11 , rR11 ); //r11d: chunks of 9 digits
+    placeLabel( code , chunks );
+    placeLabel( code , trim );
+    emitRegisters( code , 0 , 0 , 0x85 , rR10 , rR10 );
+    emitBranch( code , cEQUAL , chunksDone );
+    emitMemoryImmediate( code , 0 , 7 , memoryIndexed( rSP , rR10 , 4 , limbs - 4 ) , 0 );
+    emitBranch( code , cNOT_EQUAL , divide );
+    emitRegisters( code , 0 , 0 , 0xFF , 1 , rR10 );
+    emitJump( code , trim );
+    placeLabel( code , divide );
+    emitRegisters( code , 0 , 0 , 0x31 , rDX , rDX );
+    emitRegisters( code , 0 , 0 , 0x89 , rR10 , rCX );
+    emitMoveImmediate( code , rR8 , 1000000000 , 0 );
+    placeLabel( code , divideLimb );
+    emitMemory( code , 0 , 0 , 0x8B , rAX , memoryIndexed( rSP , rCX , 4 , limbs - 4 ) );
+    emitRegisters( code , 0 , 0 , 0xF7 , 6 , rR8 ); //div r8d
+    emitMemory( code , 0 , 0 , 0x89 , rAX , memoryIndexed( rSP , rCX , 4 , limbs - 4 ) );
+    emitRegisters( code , 0 , 0 , 0xFF , 1 , rCX );
+    emitBranch( code , cNOT_EQUAL , divideLimb );
+    emitMemory( code , 0 , 0 , 0x89 , rDX , memoryIndexed( rSP , rR11 , 4 , chunkList ) );
+    emitRegisters( code , 0 , 0 , 0xFF , 0 , rR11 );
+    emitJump( code , chunks );
+    placeLabel( code , chunksDone );
+    emitMemory( code , 0 , 1 , 0x8B , rDI , memoryAt( rSP , savedText ) );
+    emitRegisters( code , 0 , 0 , 0xFF , 1 , rR11 );
+    emitMemory( code , 0 , 0 , 0x8B , rAX , memoryIndexed( rSP , rR11 , 4 , chunkList ) );
+    emitMoveImmediate( code , rCX , 1 , 0 );
+    emitCall( code , code->digitsRoutine );
+    placeLabel( code , printChunks );
+    emitRegisters( code , 0 , 0 , 0x85 , rR11 , rR11 );
+    emitBranch( code , cEQUAL , zeroFraction );
+    emitRegisters( code , 0 , 0 , 0xFF , 1 , rR11 );
+    emitMemory( code , 0 , 0 , 0x8B , rAX , memoryIndexed( rSP , rR11 , 4 , chunkList ) );
+    emitMoveImmediate( code , rCX , 9 , 0 );
+    emitCall( code , code->digitsRoutine );
+    emitJump( code , printChunks );
+
+    //e < 0: k = -e
+    placeLabel( code , fraction );
+    emitRegisters( code , 0 , 0 , 0xF7 , 3 , rR8 ); //neg r8d
+    emitImmediate( code , 0 , 7 , rR8 , 75 );
+    emitBranch( code , cBELOW , small );
+    emitMemory( code , 0 , 0 , 0xC6 , 0 , memoryAt( rDI , 0 ) );
+    emitByte( code , '0' );
+    emitRegisters( code , 0 , 1 , 0xFF , 0 , rDI );
+    emitJump( code , zeroFraction );
+    placeLabel( code , small );
+    emitRegisters( code , 0 , 1 , 0x89 , rR9 , rAX );
+    emitMoveImmediate( code , rCX , 1000000 , 0 );
+    emitRegisters( code , 0 , 1 , 0xF7 , 4 , rCX ); //mul rcx, rdx:rax = m * 10^6
+    emitMemory( code , 0 , 0 , 0x8D , rCX , memoryAt( rR8 , -1 ) ); //ecx: k - 1
+    emitRegisters( code , 0 , 0 , 0x31 , rR10 , rR10 ); //r10d: sticky bits
+    emitImmediate( code , 0 , 7 , rCX , 64 );
+    emitBranch( code , cBELOW , wideShift );
+    emitRegisters( code , 0 , 1 , 0x85 , rAX , rAX ); //k - 1 >= 64: the low half is shifted out
+    emitBranch( code , cEQUAL , stickyLow );
+    emitMoveImmediate( code , rR10 , 1 , 0 );
+    placeLabel( code , stickyLow );
+    emitImmediate( code , 0 , 5 , rCX , 64 );
+    emitMoveImmediate( code , rR11 , 1 , 0 );
+    emitRegisters( code , 0 , 1 , 0xD3 , 4 , rR11 );
+    emitRegisters( code , 0 , 1 , 0xFF , 1 , rR11 );
+    emitRegisters( code , 0 , 1 , 0x21 , rDX , rR11 ); //and r11, rdx
+    emitBranch( code , cEQUAL , stickyHigh );
+    emitMoveImmediate( code , rR10 , 1 , 0 );
+    placeLabel( code , stickyHigh );
+    emitRegisters( code , 0 , 1 , 0xD3 , 5 , rDX ); //shr rdx, cl
+    emitRegisters( code , 0 , 1 , 0x89 , rDX , rAX );
+    emitRegisters( code , 0 , 0 , 0x31 , rDX , rDX );
+    emitJump( code , shifted );
+    placeLabel( code , wideShift );
+    emitMoveImmediate( code , rR11 , 1 , 0 );
+    emitRegisters( code , 0 , 1 , 0xD3 , 4 , rR11 );
+    emitRegisters( code , 0 , 1 , 0xFF , 1 , rR11 );
+    emitRegisters( code , 0 , 1 , 0x21 , rAX , rR11 );
+    emitBranch( code , cEQUAL , stickySmall );
+    emitMoveImmediate( code , rR10 , 1 , 0 );
+    placeLabel( code , stickySmall );
+    emitRegisters( code , 0 , 1 , 0x0FAD , rDX , rAX ); //shrd rax, rdx, cl
+    emitRegisters( code , 0 , 1 , 0xD3 , 5 , rDX );
+    placeLabel( code , shifted ); //rdx:rax = m * 10^6 >> ( k - 1 ), its lowest bit is the half bit
+    emitRegisters( code , 0 , 1 , 0x89 , rAX , rR11 );
+    emitImmediate( code , 0 , 4 , rR11 , 1 );
+    emitRegisters( code , 0 , 1 , 0x0FAC , rDX , rAX ); //shrd rax, rdx, 1
+    emitByte( code , 1 );
+    emitShift( code , 1 , 5 , rDX , 1 );
+    emitRegisters( code , 0 , 0 , 0x85 , rR11 , rR11 );
+    emitBranch( code , cEQUAL , noRound );
+    emitRegisters( code , 0 , 0 , 0x85 , rR10 , rR10 );
+    emitBranch( code , cNOT_EQUAL , roundUp );
+    emitByte( code , 0xA8 ); //test al, 1: a tie rounds to even
+    emitByte( code , 1 );
+    emitBranch( code , cEQUAL , noRound );
+    placeLabel( code , roundUp );
+    emitImmediate( code , 1 , 0 , rAX , 1 );
+    emitImmediate( code , 1 , 2 , rDX , 0 ); //adc rdx, 0
+    placeLabel( code , noRound );
+    emitMoveImmediate( code , rCX , 1000000 , 0 );
+    emitRegisters( code , 0 , 1 , 0xF7 , 6 , rCX ); //div rcx: the quotient is below 2^53
+    emitRegisters( code , 0 , 1 , 0x89 , rDX , rR11 );
+    emitMoveImmediate( code , rCX , 1 , 0 );
+    emitCall( code , code->digitsRoutine );
+    emitMemory( code , 0 , 0 , 0xC6 , 0 , memoryAt( rDI , 0 ) );
+    emitByte( code , '.' );
+    emitRegisters( code , 0 , 1 , 0xFF , 0 , rDI );
+    emitRegisters( code , 0 , 1 , 0x89 , rR11 , rAX );
+    emitMoveImmediate( code , rCX , 6 , 0 );
+    emitCall( code , code->digitsRoutine );
+    emitJump( code , newLine );
+
+    placeLabel( code , zeroFraction );
+    emitMemory( code , 0 , 1 , 0x8D , rSI , memoryConstant( addConstant( code , ".000000" , 7 , 1 ) ) );
+    emitMoveImmediate( code , rCX , 7 , 0 );
+    emitOpcode( code , 0xF3A4 );
+    placeLabel( code , newLine );
+    emitMemory( code , 0 , 0 , 0xC6 , 0 , memoryAt( rDI , 0 ) );
+    emitByte( code , '\n' );
+    emitRegisters( code , 0 , 1 , 0xFF , 0 , rDI );
+    emitRegisters( code , 0 , 1 , 0x89 , rSP , rSI );
+    emitRegisters( code , 0 , 1 , 0x89 , rDI , rDX );
+    emitRegisters( code , 0 , 1 , 0x29 , rSI , rDX );
+    emitCall( code , code->putBytesRoutine );
+    emitImmediate( code , 1 , 0 , rSP , 1024 );
+    emitReturn( code );
+
+}
+
+/**
+ * @brief getChar: returns in eax the next byte of the standard input, -1 at its end. The output is flushed before the input is read,
+ * so the prompts are seen before the program waits. Preserves r8 to r10
+ */
+static void emitGetCharRoutine( NativeCode *code , long long inputBuffer ) {
+
+    int retry  = createLabel( code );
+    int have   = createLabel( code );
+    int ended  = createLabel( code );
+    int atEnd  = createLabel( code );
+
+    placeLabel( code , code->getCharRoutine );
+    placeLabel( code , retry );
+    emitMemory( code , 0 , 1 , 0x8B , rAX , memoryAt( rR15 , INPUT_POSITION ) );
+    emitMemory( code , 0 , 1 , 0x3B , rAX , memoryAt( rR15 , INPUT_LENGTH ) ); //cmp rax, [length]
+    emitBranch( code , cBELOW , have );
+    emitMemoryImmediate( code , 1 , 7 , memoryAt( rR15 , INPUT_ENDED ) , 0 );
+    emitBranch( code , cNOT_EQUAL , atEnd );
+    emitCall( code , code->flushRoutine );
+    emitRegisters( code , 0 , 0 , 0x31 , rAX , rAX ); //read
+    emitRegisters( code , 0 , 0 , 0x31 , rDI , rDI );
+    emitMemory( code , 0 , 1 , 0x8D , rSI , memoryAt( rR15 , inputBuffer ) );
+    emitMoveImmediate( code , rDX , NATIVE_BUFFER_SIZE , 0 );
+    emitSyscall( code );
+    emitImmediate( code , 1 , 7 , rAX , -4 ); //interrupted
+    emitBranch( code , cEQUAL , retry );
+    emitRegisters( code , 0 , 1 , 0x85 , rAX , rAX );
+    emitBranch( code , cLESS_OR_EQUAL , ended );
+    emitMemory( code , 0 , 1 , 0x89 , rAX , memoryAt( rR15 , INPUT_LENGTH ) );
+    emitRegisters( code , 0 , 0 , 0x31 , rAX , rAX );
+    placeLabel( code , have );
+    emitMemory( code , 0 , 0 , 0x0FB6 , rCX , memoryIndexed( rR15 , rAX , 1 , inputBuffer ) ); //movzx ecx, byte [buffer + rax]
+    emitRegisters( code , 0 , 1 , 0xFF , 0 , rAX );
+    emitMemory( code , 0 , 1 , 0x89 , rAX , memoryAt( rR15 , INPUT_POSITION ) );
+    emitRegisters( code , 0 , 0 , 0x89 , rCX , rAX );
+    emitReturn( code );
+    placeLabel( code , ended );
+    emitMemory( code , 0 , 1 , 0xC7 , 0 , memoryAt( rR15 , INPUT_ENDED ) );
+    emit32( code , 1 );
+    placeLabel( code , atEnd );
+    emitMoveImmediate( code , rAX , -1 , 0 );
+    emitReturn( code );
+
+}
+
+/**
+ * @brief emits a branch to a label if the byte of eax is white space, as isspace sees it. Clobbers ecx
+ */
+static void emitSpaceBranch( NativeCode *code , int label ) {
+
+    emitImmediate( code , 0 , 7 , rAX , ' ' );
+    emitBranch( code , cEQUAL , label );
+    emitMemory( code , 0 , 0 , 0x8D , rCX , memoryAt( rAX , -'\t' ) ); //lea ecx, [rax - 9]
+    emitImmediate( code , 0 , 7 , rCX , '\r' - '\t' );
+    emitBranch( code , cBELOW_OR_EQUAL , label );
+
+}
+
+/**
+ * @brief readWord: skips white space and reads the next word of the input, keeping its first TOKEN_SIZE bytes at TOKEN. Returns
+ * in rax the length of the word, 0 at the end of the input
+ */
+static void emitReadWordRoutine( NativeCode *code ) {
+
+    int skip    = createLabel( code );
+    int store   = createLabel( code );
+    int counted = createLabel( code );
+    int done    = createLabel( code );
+    int none    = createLabel( code );
+
+    placeLabel( code , code->readWordRoutine );
+    placeLabel( code , skip );
+    emitCall( code , code->getCharRoutine );
+    emitImmediate( code , 0 , 7 , rAX , -1 );
+    emitBranch( code , cEQUAL , none );
+    emitSpaceBranch( code , skip );
+    emitRegisters( code , 0 , 0 , 0x31 , rR8 , rR8 );
+    placeLabel( code , store );
+    emitImmediate( code , 1 , 7 , rR8 , TOKEN_SIZE );
+    emitBranch( code , cABOVE_OR_EQUAL , counted );
+    emitMemory( code , 0 , 0 , 0x88 , rAX , memoryIndexed( rR15 , rR8 , 1 , TOKEN ) ); //mov [token + r8], al
+    placeLabel( code , counted );
+    emitRegisters( code , 0 , 1 , 0xFF , 0 , rR8 );
+    emitCall( code , code->getCharRoutine );
+    emitImmediate( code , 0 , 7 , rAX , -1 );
+    emitBranch( code , cEQUAL , done );
+    emitSpaceBranch( code , done );
+    emitJump( code , store );
+    placeLabel( code , done );
+    emitRegisters( code , 0 , 1 , 0x89 , rR8 , rAX );
+    emitReturn( code );
+    placeLabel( code , none );
+    emitRegisters( code , 0 , 0 , 0x31 , rAX , rAX );
+    emitReturn( code );
+
+}
+
+/**
+ * @brief emits the parse of an optional sign at TOKEN + rcx, setting r10d to 1 if it is a minus and advancing rcx past it
+ */
+static void emitSign( NativeCode *code ) {
+
+    int plus   = createLabel( code );
+    int signed_ = createLabel( code );
+
+    emitRegisters( code , 0 , 0 , 0x31 , rR10 , rR10 );
+    emitMemory( code , 0 , 0 , 0x0FB6 , rAX , memoryIndexed( rR15 , rCX , 1 , TOKEN ) );
+    emitImmediate( code , 0 , 7 , rAX , '-' );
+    emitBranch( code , cNOT_EQUAL , plus );
+    emitMoveImmediate( code , rR10 , 1 , 0 );
+    emitRegisters( code , 0 , 1 , 0xFF , 0 , rCX );
+    emitJump( code , signed_ );
+    placeLabel( code , plus );
+    emitImmediate( code , 0 , 7 , rAX , '+' );
+    emitBranch( code , cNOT_EQUAL , signed_ );
+    emitRegisters( code , 0 , 1 , 0xFF , 0 , rCX );
+    placeLabel( code , signed_ );
+
+}
+
+/**
+ * @brief readInteger: reads words until one is a decimal integer, converted as strtoll does: out of range values are clamped to the
+ * smallest and largest long. Returns the value in rax, whose low half is the value strtol gives an int, and 1 in edx. Returns 0 in edx
+ * at the end of the input
+ */
+static void emitReadIntegerRoutine( NativeCode *code ) {
+
+    int next       = createLabel( code );
+    int digit      = createLabel( code );
+    int overflowed = createLabel( code );
+    int skipped    = createLabel( code );
+    int saturate   = createLabel( code );
+    int positive   = createLabel( code );
+    int none       = createLabel( code );
+
+    placeLabel( code , code->readIntegerRoutine );
+    placeLabel( code , next );
+    emitCall( code , code->readWordRoutine );
+    emitRegisters( code , 0 , 1 , 0x85 , rAX , rAX );
+    emitBranch( code , cEQUAL , none );
+    emitImmediate( code , 1 , 7 , rAX , LONGEST_WORD );
+    emitBranch( code , cABOVE , next );
+    emitRegisters( code , 0 , 1 , 0x89 , rAX , rR9 ); //r9: length of the word
+    emitRegisters( code , 0 , 0 , 0x31 , rCX , rCX ); //rcx: position
+    emitSign( code );
+    emitRegisters( code , 0 , 1 , 0x39 , rR9 , rCX ); //cmp rcx, r9
+    emitBranch( code , cABOVE_OR_EQUAL , next );
+    emitRegisters( code , 0 , 0 , 0x31 , rAX , rAX ); //rax: magnitude
+    emitRegisters( code , 0 , 0 , 0x31 , rR11 , rR11 ); //r11d: 1 once the magnitude went over 64 bits
+    placeLabel( code , digit );
+    emitMemory( code , 0 , 0 , 0x0FB6 , rDX , memoryIndexed( rR15 , rCX , 1 , TOKEN ) );
+    emitImmediate( code , 0 , 5 , rDX , '0' );
+    emitImmediate( code , 0 , 7 , rDX , 9 );
+    emitBranch( code , cABOVE , next );
+    emitRegisters( code , 0 , 0 , 0x85 , rR11 , rR11 );
+    emitBranch( code , cNOT_EQUAL , skipped );
+    emitRegisters( code , 0 , 1 , 0x89 , rDX , rR8 );
+    emitMoveImmediate( code , rDX , 10 , 0 );
+    emitRegisters( code , 0 , 1 , 0xF7 , 4 , rDX ); //mul rdx
+    emitBranch( code , cBELOW , overflowed ); //carry: the product needs rdx
+    emitRegisters( code , 0 , 1 , 0x01 , rR8 , rAX );
+    emitBranch( code , cBELOW , overflowed );
+    emitJump( code , skipped );
+    placeLabel( code , overflowed );
+    emitMoveImmediate( code , rR11 , 1 , 0 );
+    placeLabel( code , skipped );
+    emitRegisters( code , 0 , 1 , 0xFF , 0 , rCX );
+    emitRegisters( code , 0 , 1 , 0x39 , rR9 , rCX );
+    emitBranch( code , cBELOW , digit );
+    emitMoveImmediate( code , rDX , 0x7FFFFFFFFFFFFFFFLL , 1 );
+    emitRegisters( code , 0 , 1 , 0x01 , rR10 , rDX ); //rdx: largest magnitude of the sign
+    emitRegisters( code , 0 , 0 , 0x85 , rR11 , rR11 );
+    emitBranch( code , cNOT_EQUAL , saturate );
+    emitRegisters( code , 0 , 1 , 0x39 , rDX , rAX );
+    emitBranch( code , cABOVE , saturate );
+    emitRegisters( code , 0 , 0 , 0x85 , rR10 , rR10 );
+    emitBranch( code , cEQUAL , positive );
+    emitRegisters( code , 0 , 1 , 0xF7 , 3 , rAX );
+    placeLabel( code , positive );
+    emitMoveImmediate( code , rDX , 1 , 0 );
+    emitReturn( code );
+    placeLabel( code , saturate );
+    emitRegisters( code , 0 , 1 , 0x89 , rDX , rAX );
+    emitMoveImmediate( code , rDX , 1 , 0 );
+    emitReturn( code );
+    placeLabel( code , none );
+    emitRegisters( code , 0 , 0 , 0x31 , rDX , rDX );
+    emitReturn( code );
+
+}
+
+/**
+ * @brief matchWord: compares the rest of the word, from rcx to r9, with the rdx lowercase letters at rsi ignoring the case.
+ * Returns 1 in eax if they are equal
+ */
+static void emitMatchWordRoutine( NativeCode *code ) {
+
+    int loop     = createLabel( code );
+    int match    = createLabel( code );
+    int mismatch = createLabel( code );
+
+    placeLabel( code , code->matchWordRoutine );
+    emitRegisters( code , 0 , 1 , 0x89 , rR9 , rAX );
+    emitRegisters( code , 0 , 1 , 0x29 , rCX , rAX );
+    emitRegisters( code , 0 , 1 , 0x39 , rDX , rAX );
+    emitBranch( code , cNOT_EQUAL , mismatch );
+    emitRegisters( code , 0 , 0 , 0x31 , rAX , rAX );
+    placeLabel( code , loop );
+    emitRegisters( code , 0 , 1 , 0x39 , rDX , rAX );
+    emitBranch( code , cABOVE_OR_EQUAL , match );
+    emitMemory( code , 0 , 1 , 0x8D , rR13 , memoryIndexed( rCX , rAX , 1 , 0 ) );
+    emitMemory( code , 0 , 0 , 0x0FB6 , rR14 , memoryIndexed( rR15 , rR13 , 1 , TOKEN ) );
+    emitImmediate( code , 0 , 1 , rR14 , 0x20 ); //or r14d, 0x20: lowercase
+    emitMemory( code , 0 , 0 , 0x0FB6 , rR13 , memoryIndexed( rSI , rAX , 1 , 0 ) );
+    emitRegisters( code , 0 , 0 , 0x39 , rR13 , rR14 );
+    emitBranch( code , cNOT_EQUAL , mismatch );
+    emitRegisters( code , 0 , 1 , 0xFF , 0 , rAX );
+    emitJump( code , loop );
+    placeLabel( code , match );
+    emitMoveImmediate( code , rAX , 1 , 0 );
+    emitReturn( code );
+    placeLabel( code , mismatch );
+    emitRegisters( code , 0 , 0 , 0x31 , rAX , rAX );
+    emitReturn( code );
+
+}
+
+/**
+ * @brief emits a call of matchWordRoutine with a word and a branch to a label if it matches
+ */
+static void emitWordBranch( NativeCode *code , const char *word , int label ) {
+
+    emitText( code , word , strlen( word ) );
+    emitCall( code , code->matchWordRoutine );
+    emitRegisters( code , 0 , 0 , 0x85 , rAX , rAX );
+    emitBranch( code , cNOT_EQUAL , label );
+
+}
+
+/**
+ * @brief emits the multiplication or division of xmm0 by the power of 10 of r11 in the table at rdx, a float or a double table
+ */
+static void emitScale( NativeCode *code , SymbolType type ) {
+
+    int divide = createLabel( code );
+    int done   = createLabel( code );
+    int prefix = type == sFLOAT ? 0xF3 : 0xF2;
+
+    emitRegisters( code , 0 , 1 , 0x85 , rR11 , rR11 );
+    emitBranch( code , cSIGN , divide );
+    emitMemory( code , prefix , 0 , 0x0F59 , 0 , memoryIndexed( rDX , rR11 , elementSize( type ) , 0 ) ); //mul xmm0, [table + e * size]
+    emitJump( code , done );
+    placeLabel( code , divide );
+    emitRegisters( code , 0 , 1 , 0xF7 , 3 , rR11 );
+    emitMemory( code , prefix , 0 , 0x0F5E , 0 , memoryIndexed( rDX , rR11 , elementSize( type ) , 0 ) ); //div
+    placeLabel( code , done );
+
+}
+
+/**
+ * @brief readReal: reads words until one is a decimal number, inf, infinity or nan, as strtod and strtof read them. Returns the value
+ * in xmm0, a float if edi is 1 and a double otherwise, and 1 in edx. Returns 0 in edx at the end of the input.
+ * Up to 18 significant digits are kept in a long m, the others only move the decimal exponent e. If no digit was dropped and m and
+ * 10^|e| are exact, m * 10^e is a single correctly rounded operation: m up to 2^53 and |e| up to 22 for doubles, m up to 2^24 and
+ * |e| up to 10 for floats. Otherwise the value is approximated by scaling m by 10^22 and rounded correctly by comparing every digit
+ * with the midpoints between the approximation and its neighbours
+ */
+static void emitReadRealRoutine( NativeCode *code ) {
+
+    static const char *words[] = { "inf" , "infinity" , "nan" };
+    double doublePowers[23];
+    float floatPowers[11];
+    long long doubleTable;
+    long long floatTable;
+    int next        = createLabel( code );
+    int decimal     = createLabel( code );
+    int infinity    = createLabel( code );
+    int notANumber  = createLabel( code );
+    int mantissa    = createLabel( code );
+    int notDot      = createLabel( code );
+    int significant = createLabel( code );
+    int drop        = createLabel( code );
+    int droppedZero = createLabel( code );
+    int advance     = createLabel( code );
+    int check       = createLabel( code );
+    int mantissaEnd = createLabel( code );
+    int exponentPlus  = createLabel( code );
+    int exponentStart = createLabel( code );
+    int exponentDigit = createLabel( code );
+    int saturated     = createLabel( code );
+    int exponentDone  = createLabel( code );
+    int build       = createLabel( code );
+    int doubleFast  = createLabel( code );
+    int slow        = createLabel( code );
+    int scaleUp     = createLabel( code );
+    int scaleDown   = createLabel( code );
+    int scaled      = createLabel( code );
+    int refineDouble = createLabel( code );
+    int down        = createLabel( code );
+    int lower       = createLabel( code );
+    int up          = createLabel( code );
+    int higher      = createLabel( code );
+    int refined     = createLabel( code );
+    int zero        = createLabel( code );
+    int sign        = createLabel( code );
+    int signDone    = createLabel( code );
+    int doubleNegative = createLabel( code );
+    int done        = createLabel( code );
+    int none        = createLabel( code );
+    int index;
+
+    for ( index = 0 ; index <= 22 ; index++ ) {
+
+        doublePowers[index] = index == 0 ? 1 : doublePowers[index - 1] * 10; //exact up to 10^22
+
+    }
+
+    for ( index = 0 ; index <= 10 ; index++ ) {
+
+        floatPowers[index] = (float) doublePowers[index]; //exact up to 10^10
+
+    }
+
+    doubleTable = addConstant( code , doublePowers , sizeof( doublePowers ) , 8 );
+    floatTable  = addConstant( code , floatPowers , sizeof( floatPowers ) , 4 );
+
+    placeLabel( code , code->readRealRoutine );
+    emitPush( code , rDI ); //[rsp]: 1 for a float
+    placeLabel( code , next );
+    emitCall( code , code->readWordRoutine );
+    emitRegisters( code , 0 , 1 , 0x85 , rAX , rAX );
+    emitBranch( code , cEQUAL , none );
+    emitImmediate( code , 1 , 7 , rAX , LONGEST_WORD );
+    emitBranch( code , cABOVE , next );
+    emitRegisters( code , 0 , 1 , 0x89 , rAX , rR9 );
+    emitRegisters( code , 0 , 0 , 0x31 , rCX , rCX );
+    emitSign( code );
+    emitRegisters( code , 0 , 1 , 0x39 , rR9 , rCX );
+    emitBranch( code , cABOVE_OR_EQUAL , next );
+
+    emitWordBranch( code , words[0] , infinity );
+    emitWordBranch( code , words[1] , infinity );
+    emitWordBranch( code , words[2] , notANumber );
+
+    //rax: m, r8d: digits kept, r11: e, esi: 1 once a digit was seen, edi: 1 if a dropped digit was not 0, r12d: 1 after the point,
+    //rbx: significant digits, kept or dropped, which are copied to DIGITS
+    placeLabel( code , decimal );
+    emitRegisters( code , 0 , 0 , 0x31 , rAX , rAX );
+    emitRegisters( code , 0 , 0 , 0x31 , rBX , rBX );
+    emitRegisters( code , 0 , 0 , 0x31 , rR8 , rR8 );
+    emitRegisters( code , 0 , 0 , 0x31 , rR11 , rR11 );
+    emitRegisters( code , 0 , 0 , 0x31 , rSI , rSI );
+    emitRegisters( code , 0 , 0 , 0x31 , rDI , rDI );
+    emitRegisters( code , 0 , 0 , 0x31 , rR12 , rR12 );
+    emitJump( code , check );
+    placeLabel( code , mantissa );
+    emitMemory( code , 0 , 0 , 0x0FB6 , rDX , memoryIndexed( rR15 , rCX , 1 , TOKEN ) );
+    emitImmediate( code , 0 , 7 , rDX , '.' );
+    emitBranch( code , cNOT_EQUAL , notDot );
+    emitRegisters( code , 0 , 0 , 0x85 , rR12 , rR12 );
+    emitBranch( code , cNOT_EQUAL , next );
+    emitMoveImmediate( code , rR12 , 1 , 0 );
+    emitJump( code , advance );
+    placeLabel( code , notDot );
+    emitMemory( code , 0 , 0 , 0x8D , rR13 , memoryAt( rDX , -'0' ) );
+    emitImmediate( code , 0 , 7 , rR13 , 9 );
+    emitBranch( code , cABOVE , mantissaEnd );
+    emitMoveImmediate( code , rSI , 1 , 0 );
+    emitRegisters( code , 0 , 1 , 0x85 , rAX , rAX ); //leading zeros are not significant
+    emitBranch( code , cNOT_EQUAL , significant );
+    emitRegisters( code , 0 , 0 , 0x85 , rR13 , rR13 );
+    emitBranch( code , cNOT_EQUAL , significant );
+    emitRegisters( code , 0 , 0 , 0x85 , rR12 , rR12 );
+    emitBranch( code , cEQUAL , advance );
+    emitRegisters( code , 0 , 1 , 0xFF , 1 , rR11 );
+    emitJump( code , advance );
+    placeLabel( code , significant );
+    emitMemory( code , 0 , 0 , 0x88 , rR13 , memoryIndexed( rR15 , rBX , 1 , DIGITS ) );
+    emitRegisters( code , 0 , 1 , 0xFF , 0 , rBX );
+    emitImmediate( code , 0 , 7 , rR8 , 18 );
+    emitBranch( code , cABOVE_OR_EQUAL , drop );
+    emitRegisters( code , 0 , 1 , 0x6B , rAX , rAX ); //imul rax, rax, 10
+    emitByte( code , 10 );
+    emitRegisters( code , 0 , 1 , 0x01 , rR13 , rAX );
+    emitRegisters( code , 0 , 0 , 0xFF , 0 , rR8 );
+    emitRegisters( code , 0 , 0 , 0x85 , rR12 , rR12 );
+    emitBranch( code , cEQUAL , advance );
+    emitRegisters( code , 0 , 1 , 0xFF , 1 , rR11 );
+    emitJump( code , advance );
+    placeLabel( code , drop );
+    emitRegisters( code , 0 , 0 , 0x85 , rR13 , rR13 );
+    emitBranch( code , cEQUAL , droppedZero );
+    emitMoveImmediate( code , rDI , 1 , 0 );
+    placeLabel( code , droppedZero );
+    emitRegisters( code , 0 , 0 , 0x85 , rR12 , rR12 );
+    emitBranch( code , cNOT_EQUAL , advance );
+    emitRegisters( code , 0 , 1 , 0xFF , 0 , rR11 );
+    placeLabel( code , advance );
+    emitRegisters( code , 0 , 1 , 0xFF , 0 , rCX );
+    placeLabel( code , check );
+    emitRegisters( code , 0 , 1 , 0x39 , rR9 , rCX );
+    emitBranch( code , cBELOW , mantissa );
+
+    //the exponent, which needs a digit after the e and its sign
+    placeLabel( code , mantissaEnd );
+    emitRegisters( code , 0 , 0 , 0x85 , rSI , rSI );
+    emitBranch( code , cEQUAL , next );
+    emitRegisters( code , 0 , 1 , 0x39 , rR9 , rCX );
+    emitBranch( code , cABOVE_OR_EQUAL , build );
+    emitMemory( code , 0 , 0 , 0x0FB6 , rDX , memoryIndexed( rR15 , rCX , 1 , TOKEN ) );
+    emitImmediate( code , 0 , 1 , rDX , 0x20 );
+    emitImmediate( code , 0 , 7 , rDX , 'e' );
+    emitBranch( code , cNOT_EQUAL , next );
+    emitRegisters( code , 0 , 1 , 0xFF , 0 , rCX );
+    emitRegisters( code , 0 , 1 , 0x39 , rR9 , rCX );
+    emitBranch( code , cABOVE_OR_EQUAL , next );
+    emitRegisters( code , 0 , 0 , 0x31 , rR13 , rR13 ); //r13d: 1 for a negative exponent
+    emitMemory( code , 0 , 0 , 0x0FB6 , rDX , memoryIndexed( rR15 , rCX , 1 , TOKEN ) );
+    emitImmediate( code , 0 , 7 , rDX , '-' );
+    emitBranch( code , cNOT_EQUAL , exponentPlus );
+    emitMoveImmediate( code , rR13 , 1 , 0 );
+    emitRegisters( code , 0 , 1 , 0xFF , 0 , rCX );
+    emitJump( code , exponentStart );
+    placeLabel( code , exponentPlus );
+    emitImmediate( code , 0 , 7 , rDX , '+' );
+    emitBranch( code , cNOT_EQUAL , exponentStart );
+    emitRegisters( code , 0 , 1 , 0xFF , 0 , rCX );
+    placeLabel( code , exponentStart );
+    emitRegisters( code , 0 , 1 , 0x39 , rR9 , rCX );
+    emitBranch( code , cABOVE_OR_EQUAL , next );
+    emitRegisters( code , 0 , 0 , 0x31 , rR14 , rR14 ); //r14: the exponent, saturated far beyond the range of doubles
+    placeLabel( code , exponentDigit );
+    emitMemory( code , 0 , 0 , 0x0FB6 , rDX , memoryIndexed( rR15 , rCX , 1 , TOKEN ) );
+    emitImmediate( code , 0 , 5 , rDX , '0' );
+    emitImmediate( code , 0 , 7 , rDX , 9 );
+    emitBranch( code , cABOVE , next );
+    emitImmediate( code , 0 , 7 , rR14 , 100000 );
+    emitBranch( code , cABOVE_OR_EQUAL , saturated );
+    emitRegisters( code , 0 , 0 , 0x6B , rR14 , rR14 );
+    emitByte( code , 10 );
+    emitRegisters( code , 0 , 0 , 0x01 , rDX , rR14 );
+    placeLabel( code , saturated );
+    emitRegisters( code , 0 , 1 , 0xFF , 0 , rCX );
+    emitRegisters( code , 0 , 1 , 0x39 , rR9 , rCX );
+    emitBranch( code , cBELOW , exponentDigit );
+    emitRegisters( code , 0 , 0 , 0x85 , rR13 , rR13 );
+    emitBranch( code , cEQUAL , exponentDone );
+    emitRegisters( code , 0 , 1 , 0xF7 , 3 , rR14 );
+    placeLabel( code , exponentDone );
+    emitRegisters( code , 0 , 1 , 0x01 , rR14 , rR11 );
+
+    //m * 10^e. The exponent of all the significant digits, which the exact comparisons use, is e minus the digits dropped
+    placeLabel( code , build );
+    emitRegisters( code , 0 , 1 , 0x85 , rAX , rAX );
+    emitBranch( code , cEQUAL , zero );
+    emitRegisters( code , 0 , 1 , 0x89 , rBX , rDX );
+    emitRegisters( code , 0 , 1 , 0x29 , rR8 , rDX );
+    emitRegisters( code , 0 , 1 , 0x89 , rR11 , rR13 );
+    emitRegisters( code , 0 , 1 , 0x29 , rDX , rR13 );
+    emitStore( code , sLONG , rBX , memoryAt( rR15 , DIGIT_COUNT ) );
+    emitStore( code , sLONG , rR13 , memoryAt( rR15 , DECIMAL_EXPONENT ) );
+    emitMemory( code , 0 , 1 , 0x8D , rDX , memoryIndexed( rBX , rR13 , 1 , 0 ) ); //the value is below 10^( digits + exponent )
+    emitImmediate( code , 1 , 7 , rDX , 330 );
+    emitBranch( code , cGREATER , infinity );
+    emitImmediate( code , 1 , 7 , rDX , -330 );
+    emitBranch( code , cLESS , zero );
+    emitRegisters( code , 0 , 0 , 0x85 , rDI , rDI );
+    emitBranch( code , cNOT_EQUAL , slow );
+    emitMemoryImmediate( code , 1 , 7 , memoryAt( rSP , 0 ) , 0 );
+    emitBranch( code , cEQUAL , doubleFast );
+    emitImmediate( code , 1 , 7 , rAX , 1 << 24 );
+    emitBranch( code , cABOVE , slow );
+    emitImmediate( code , 1 , 7 , rR11 , -10 );
+    emitBranch( code , cLESS , slow );
+    emitImmediate( code , 1 , 7 , rR11 , 10 );
+    emitBranch( code , cGREATER , slow );
+    emitRegisters( code , 0xF3 , 1 , 0x0F2A , 0 , rAX ); //cvtsi2ss xmm0, rax
+    emitMemory( code , 0 , 1 , 0x8D , rDX , memoryConstant( floatTable ) );
+    emitScale( code , sFLOAT );
+    emitJump( code , sign );
+    placeLabel( code , doubleFast );
+    emitMoveImmediate( code , rDX , 1LL << 53 , 1 );
+    emitRegisters( code , 0 , 1 , 0x39 , rDX , rAX );
+    emitBranch( code , cABOVE , slow );
+    emitImmediate( code , 1 , 7 , rR11 , -22 );
+    emitBranch( code , cLESS , slow );
+    emitImmediate( code , 1 , 7 , rR11 , 22 );
+    emitBranch( code , cGREATER , slow );
+    emitRegisters( code , 0xF2 , 1 , 0x0F2A , 0 , rAX ); //cvtsi2sd xmm0, rax
+    emitMemory( code , 0 , 1 , 0x8D , rDX , memoryConstant( doubleTable ) );
+    emitScale( code , sDOUBLE );
+    emitJump( code , sign );
+
+    //an approximation within a few units in the last place, scaled by 10^22 until the exponent is in the table
+    placeLabel( code , slow );
+    emitRegisters( code , 0xF2 , 1 , 0x0F2A , 0 , rAX );
+    emitMemory( code , 0 , 1 , 0x8D , rDX , memoryConstant( doubleTable ) );
+    placeLabel( code , scaleUp );
+    emitImmediate( code , 1 , 7 , rR11 , 22 );
+    emitBranch( code , cLESS_OR_EQUAL , scaleDown );
+    emitMemory( code , 0xF2 , 0 , 0x0F59 , 0 , memoryAt( rDX , 22 * 8 ) ); //mulsd xmm0, 10^22
+    emitImmediate( code , 1 , 5 , rR11 , 22 );
+    emitJump( code , scaleUp );
+    placeLabel( code , scaleDown );
+    emitImmediate( code , 1 , 7 , rR11 , -22 );
+    emitBranch( code , cGREATER_OR_EQUAL , scaled );
+    emitMemory( code , 0xF2 , 0 , 0x0F5E , 0 , memoryAt( rDX , 22 * 8 ) ); //divsd xmm0, 10^22
+    emitImmediate( code , 1 , 0 , rR11 , 22 );
+    emitJump( code , scaleDown );
+    placeLabel( code , scaled );
+    emitScale( code , sDOUBLE );
+
+    //rbx: bits of the approximation, moved to the neighbour closer to the value until the value is between the midpoints of its
+    //neighbours. r12: bits of the infinity, r13d: 1 for a float
+    emitLoad( code , sLONG , rR13 , memoryAt( rSP , 0 ) );
+    emitRegisters( code , 0 , 0 , 0x85 , rR13 , rR13 );
+    emitBranch( code , cEQUAL , refineDouble );
+    emitRegisters( code , 0xF2 , 0 , 0x0F5A , 0 , 0 ); //cvtsd2ss xmm0, xmm0
+    emitRegisters( code , 0x66 , 0 , 0x0F7E , 0 , rBX ); //movd ebx, xmm0
+    emitMoveImmediate( code , rR12 , 0x7F800000 , 0 );
+    emitJump( code , down );
+    placeLabel( code , refineDouble );
+    emitRegisters( code , 0x66 , 1 , 0x0F7E , 0 , rBX ); //movq rbx, xmm0
+    emitMoveImmediate( code , rR12 , 0x7FF0000000000000LL , 1 );
+    placeLabel( code , down );
+    emitRegisters( code , 0 , 1 , 0x85 , rBX , rBX );
+    emitBranch( code , cEQUAL , up );
+    emitMemory( code , 0 , 1 , 0x8D , rAX , memoryAt( rBX , -1 ) );
+    emitCall( code , code->compareMidpointRoutine );
+    emitRegisters( code , 0 , 0 , 0x85 , rAX , rAX );
+    emitBranch( code , cLESS , lower );
+    emitBranch( code , cNOT_EQUAL , up );
+    emitRegisters( code , 0 , 0 , 0xF6 , 0 , rBX ); //test bl, 1: a tie goes to the even neighbour
+    emitByte( code , 1 );
+    emitBranch( code , cEQUAL , up );
+    placeLabel( code , lower );
+    emitRegisters( code , 0 , 1 , 0xFF , 1 , rBX );
+    emitJump( code , down );
+    placeLabel( code , up );
+    emitRegisters( code , 0 , 1 , 0x39 , rR12 , rBX );
+    emitBranch( code , cABOVE_OR_EQUAL , refined );
+    emitRegisters( code , 0 , 1 , 0x89 , rBX , rAX );
+    emitCall( code , code->compareMidpointRoutine );
+    emitRegisters( code , 0 , 0 , 0x85 , rAX , rAX );
+    emitBranch( code , cGREATER , higher );
+    emitBranch( code , cNOT_EQUAL , refined );
+    emitRegisters( code , 0 , 0 , 0xF6 , 0 , rBX );
+    emitByte( code , 1 );
+    emitBranch( code , cEQUAL , refined );
+    placeLabel( code , higher );
+    emitRegisters( code , 0 , 1 , 0xFF , 0 , rBX );
+    emitJump( code , up );
+    placeLabel( code , refined );
+    emitRegisters( code , 0x66 , 1 , 0x0F6E , 0 , rBX ); //movq xmm0, rbx
+    emitJump( code , sign );
+
+    placeLabel( code , infinity );
+    emitMoveImmediate( code , rAX , 0x7F800000 , 0 );
+    emitMoveImmediate( code , rDX , 0x7FF0000000000000LL , 1 );
+    emitJump( code , done );
+    placeLabel( code , notANumber );
+    emitMoveImmediate( code , rAX , 0x7FC00000 , 0 );
+    emitMoveImmediate( code , rDX , 0x7FF8000000000000LL , 1 );
+    placeLabel( code , done );
+    emitMemoryImmediate( code , 1 , 7 , memoryAt( rSP , 0 ) , 0 );
+    emitRegisters( code , 0 , 1 , 0x0F44 , rAX , rDX ); //cmove rax, rdx
+    emitRegisters( code , 0x66 , 1 , 0x0F6E , 0 , rAX ); //movq xmm0, rax
+    emitJump( code , sign );
+    placeLabel( code , zero );
+    emitRegisters( code , 0 , 0 , 0x0F57 , 0 , 0 ); //xorps xmm0, xmm0
+
+    //the sign is applied last, so -0 and -nan keep it
+    placeLabel( code , sign );
+    emitRegisters( code , 0 , 0 , 0x85 , rR10 , rR10 );
+    emitBranch( code , cEQUAL , signDone );
+    emitRegisters( code , 0x66 , 1 , 0x0F7E , 0 , rAX ); //movq rax, xmm0
+    emitMoveImmediate( code , rDX , (long long) 0x8000000000000000ULL , 1 );
+    emitMemoryImmediate( code , 1 , 7 , memoryAt( rSP , 0 ) , 0 );
+    emitBranch( code , cEQUAL , doubleNegative );
+    emitMoveImmediate( code , rDX , 0x80000000LL , 0 );
+    placeLabel( code , doubleNegative );
+    emitRegisters( code , 0 , 1 , 0x31 , rDX , rAX ); //xor rax, rdx
+    emitRegisters( code , 0x66 , 1 , 0x0F6E , 0 , rAX );
+    placeLabel( code , signDone );
+    emitPop( code , rDI );
+    emitMoveImmediate( code , rDX , 1 , 0 );
+    emitReturn( code );
+    placeLabel( code , none );
+    emitPop( code , rDI );
+    emitRegisters( code , 0 , 0 , 0x31 , rDX , rDX );
+    emitReturn( code );
+
+}
+
+/**
+ * @brief bigMultiply: multiplies the number of rsi 32 bit limbs at rdi by r10, below 2^31, and adds r11. Returns in rsi the limbs
+ * of the product, which may have one more. Preserves rdx, r8 and r9
+ */
+static void emitBigMultiplyRoutine( NativeCode *code ) {
+
+    int loop = createLabel( code );
+    int tail = createLabel( code );
+    int done = createLabel( code );
+
+    placeLabel( code , code->bigMultiplyRoutine );
+    emitRegisters( code , 0 , 0 , 0x31 , rCX , rCX );
+    placeLabel( code , loop );
+    emitRegisters( code , 0 , 1 , 0x39 , rSI , rCX );
+    emitBranch( code , cABOVE_OR_EQUAL , tail );
+    emitLoad( code , sINTEGER , rAX , memoryIndexed( rDI , rCX , 4 , 0 ) );
+    emitRegisters( code , 0 , 1 , 0x0FAF , rAX , rR10 ); //imul rax, r10
+    emitRegisters( code , 0 , 1 , 0x01 , rR11 , rAX );
+    emitStore( code , sINTEGER , rAX , memoryIndexed( rDI , rCX , 4 , 0 ) );
+    emitShift( code , 1 , 5 , rAX , 32 );
+    emitRegisters( code , 0 , 1 , 0x89 , rAX , rR11 ); //r11: the carry into the next limb
+    emitRegisters( code , 0 , 1 , 0xFF , 0 , rCX );
+    emitJump( code , loop );
+    placeLabel( code , tail );
+    emitRegisters( code , 0 , 1 , 0x85 , rR11 , rR11 );
+    emitBranch( code , cEQUAL , done );
+    emitStore( code , sINTEGER , rR11 , memoryIndexed( rDI , rSI , 4 , 0 ) );
+    emitRegisters( code , 0 , 1 , 0xFF , 0 , rSI );
+    placeLabel( code , done );
+    emitReturn( code );
+
+}
+
+/**
+ * @brief bigShift: shifts the number of rsi 32 bit limbs at rdi left by ecx bits. Returns in rsi the limbs of the result, the
+ * highest of which may be 0
+ */
+static void emitBigShiftRoutine( NativeCode *code ) {
+
+    int loop   = createLabel( code );
+    int lowest = createLabel( code );
+
+    placeLabel( code , code->bigShiftRoutine );
+    emitRegisters( code , 0 , 0 , 0x89 , rCX , rR8 );
+    emitShift( code , 0 , 5 , rR8 , 5 ); //r8: whole limbs
+    emitImmediate( code , 0 , 4 , rCX , 31 );
+    emitMemory( code , 0 , 0 , 0xC7 , 0 , memoryIndexed( rDI , rSI , 4 , 0 ) ); //mov dword [rdi + rsi * 4], 0
+    emit32( code , 0 );
+    emitRegisters( code , 0 , 1 , 0x89 , rSI , rDX );
+
+    //from the highest limb down, so no limb is overwritten before it is read
+    placeLabel( code , loop );
+    emitRegisters( code , 0 , 1 , 0x85 , rDX , rDX );
+    emitBranch( code , cEQUAL , lowest );
+    emitLoad( code , sINTEGER , rAX , memoryIndexed( rDI , rDX , 4 , 0 ) );
+    emitShift( code , 1 , 4 , rAX , 32 );
+    emitLoad( code , sINTEGER , rR9 , memoryIndexed( rDI , rDX , 4 , -4 ) );
+    emitRegisters( code , 0 , 1 , 0x09 , rR9 , rAX );
+    emitRegisters( code , 0 , 1 , 0xD3 , 4 , rAX ); //shl rax, cl
+    emitShift( code , 1 , 5 , rAX , 32 );
+    emitMemory( code , 0 , 1 , 0x8D , rR10 , memoryIndexed( rDX , rR8 , 1 , 0 ) );
+    emitStore( code , sINTEGER , rAX , memoryIndexed( rDI , rR10 , 4 , 0 ) );
+    emitRegisters( code , 0 , 1 , 0xFF , 1 , rDX );
+    emitJump( code , loop );
+    placeLabel( code , lowest );
+    emitLoad( code , sINTEGER , rAX , memoryAt( rDI , 0 ) );
+    emitRegisters( code , 0 , 0 , 0xD3 , 4 , rAX );
+    emitStore( code , sINTEGER , rAX , memoryIndexed( rDI , rR8 , 4 , 0 ) );
+    emitMemory( code , 0 , 1 , 0x8D , rSI , memoryIndexed( rSI , rR8 , 1 , 1 ) );
+    emitPush( code , rDI );
+    emitRegisters( code , 0 , 0 , 0x89 , rR8 , rCX );
+    emitRegisters( code , 0 , 0 , 0x31 , rAX , rAX );
+    emitOpcode( code , 0xF3AB ); //rep stosd: the whole limbs shifted in are 0
+    emitPop( code , rDI );
+    emitReturn( code );
+
+}
+
+/**
+ * @brief emits the multiplication of the number of rsi limbs at rdi by 5^rdx, by 5^13 while it fits and then by the rest of the
+ * powers in the table
+ */
+static void emitPowerOfFive( NativeCode *code , long long powerTable ) {
+
+    int loop = createLabel( code );
+    int rest = createLabel( code );
+
+    placeLabel( code , loop );
+    emitImmediate( code , 1 , 7 , rDX , 13 );
+    emitBranch( code , cLESS , rest );
+    emitMoveImmediate( code , rR10 , 1220703125 , 0 );
+    emitRegisters( code , 0 , 0 , 0x31 , rR11 , rR11 );
+    emitCall( code , code->bigMultiplyRoutine );
+    emitImmediate( code , 1 , 5 , rDX , 13 );
+    emitJump( code , loop );
+    placeLabel( code , rest );
+    emitMemory( code , 0 , 1 , 0x8D , rAX , memoryConstant( powerTable ) );
+    emitLoad( code , sINTEGER , rR10 , memoryIndexed( rAX , rDX , 4 , 0 ) );
+    emitRegisters( code , 0 , 0 , 0x31 , rR11 , rR11 );
+    emitCall( code , code->bigMultiplyRoutine );
+
+}
+
+/**
+ * @brief compareMidpoint: compares the number being read, the DIGITS times 10^DECIMAL_EXPONENT, with the midpoint between the
+ * positive double whose bits are in rax, or the float if r13d is 1, and the next one. For the value M * 2^K the midpoint is
+ * ( 2M + 1 ) * 2^( K - 1 ), also when the next value has another exponent. Both sides are made integers on the stack: the power of
+ * 5 multiplies the digits or the midpoint and the power of 2 shifts the side whose exponent is lower. Returns in eax -1, 0 or 1 if
+ * the number is below, equal to or above the midpoint. Preserves rbx, r10 and r12 to r15
+ */
+static void emitCompareMidpointRoutine( NativeCode *code ) {
+
+    unsigned int powers[14];
+    long long powerTable;
+    int doubleBits  = createLabel( code );
+    int decoded     = createLabel( code );
+    int digits      = createLabel( code );
+    int built       = createLabel( code );
+    int scaleRight  = createLabel( code );
+    int scaled      = createLabel( code );
+    int shiftRight  = createLabel( code );
+    int shifted     = createLabel( code );
+    int trimLeft    = createLabel( code );
+    int trimRight   = createLabel( code );
+    int trimmed     = createLabel( code );
+    int limbs       = createLabel( code );
+    int above       = createLabel( code );
+    int below       = createLabel( code );
+    int equal       = createLabel( code );
+    int done        = createLabel( code );
+    const int right      = 512; //the frame: 128 limbs of the digits, 128 of the midpoint, the power of 2 and the limbs of each
+    const int twoShift   = 1024;
+    const int leftLimbs  = 1032;
+    const int rightLimbs = 1040;
+    const int frame      = 1048;
+    int index;
+
+    for ( index = 0 ; index < 14 ; index++ ) {
+
+        powers[index] = index == 0 ? 1 : powers[index - 1] * 5; //5^13 is the largest below 2^31
+
+    }
+
+    powerTable = addConstant( code , powers , sizeof( powers ) , 4 );
+
+    placeLabel( code , code->compareMidpointRoutine );
+
+    //rax: M, ecx: K. The subnormals have the exponent of the smallest normal and no implicit bit
+    emitRegisters( code , 0 , 1 , 0x89 , rAX , rDX );
+    emitRegisters( code , 0 , 0 , 0x85 , rR13 , rR13 );
+    emitBranch( code , cEQUAL , doubleBits );
+    emitShift( code , 0 , 5 , rDX , 23 );
+    emitImmediate( code , 0 , 4 , rAX , 0x7FFFFF );
+    emitMoveImmediate( code , rCX , -149 , 0 );
+    emitRegisters( code , 0 , 0 , 0x85 , rDX , rDX );
+    emitBranch( code , cEQUAL , decoded );
+    emitImmediate( code , 0 , 1 , rAX , 0x800000 );
+    emitMemory( code , 0 , 0 , 0x8D , rCX , memoryAt( rDX , -150 ) );
+    emitJump( code , decoded );
+    placeLabel( code , doubleBits );
+    emitShift( code , 1 , 5 , rDX , 52 );
+    emitShift( code , 1 , 4 , rAX , 12 );
+    emitShift( code , 1 , 5 , rAX , 12 );
+    emitMoveImmediate( code , rCX , -1074 , 0 );
+    emitRegisters( code , 0 , 0 , 0x85 , rDX , rDX );
+    emitBranch( code , cEQUAL , decoded );
+    emitMoveImmediate( code , rR8 , 1LL << 52 , 1 );
+    emitRegisters( code , 0 , 1 , 0x09 , rR8 , rAX );
+    emitMemory( code , 0 , 0 , 0x8D , rCX , memoryAt( rDX , -1075 ) );
+    placeLabel( code , decoded );
+    emitMemory( code , 0 , 1 , 0x8D , rR8 , memoryIndexed( rAX , rAX , 1 , 1 ) ); //r8: 2M + 1
+    emitRegisters( code , 0 , 1 , 0x63 , rR9 , rCX ); //r9: K - 1
+    emitRegisters( code , 0 , 1 , 0xFF , 1 , rR9 );
+    emitPush( code , rR10 ); //the sign of the number
+    emitImmediate( code , 1 , 5 , rSP , frame );
+
+    //the digits on the left, 2M + 1 on the right
+    emitRegisters( code , 0 , 1 , 0x89 , rSP , rDI );
+    emitRegisters( code , 0 , 0 , 0x31 , rSI , rSI );
+    emitRegisters( code , 0 , 0 , 0x31 , rDX , rDX );
+    placeLabel( code , digits );
+    emitMemory( code , 0 , 1 , 0x3B , rDX , memoryAt( rR15 , DIGIT_COUNT ) );
+    emitBranch( code , cABOVE_OR_EQUAL , built );
+    emitMemory( code , 0 , 0 , 0x0FB6 , rR11 , memoryIndexed( rR15 , rDX , 1 , DIGITS ) );
+    emitMoveImmediate( code , rR10 , 10 , 0 );
+    emitCall( code , code->bigMultiplyRoutine );
+    emitRegisters( code , 0 , 1 , 0xFF , 0 , rDX );
+    emitJump( code , digits );
+    placeLabel( code , built );
+    emitStore( code , sLONG , rSI , memoryAt( rSP , leftLimbs ) );
+    emitStore( code , sLONG , rR8 , memoryAt( rSP , right ) );
+    emitMoveImmediate( code , rAX , 2 , 0 );
+    emitStore( code , sLONG , rAX , memoryAt( rSP , rightLimbs ) );
+
+    //10^E is 5^E * 2^E, the 2^E goes with the 2^( K - 1 ) of the midpoint
+    emitLoad( code , sLONG , rDX , memoryAt( rR15 , DECIMAL_EXPONENT ) );
+    emitRegisters( code , 0 , 1 , 0x89 , rDX , rAX );
+    emitRegisters( code , 0 , 1 , 0x29 , rR9 , rAX );
+    emitStore( code , sLONG , rAX , memoryAt( rSP , twoShift ) );
+    emitRegisters( code , 0 , 1 , 0x85 , rDX , rDX );
+    emitBranch( code , cSIGN , scaleRight );
+    emitRegisters( code , 0 , 1 , 0x89 , rSP , rDI );
+    emitLoad( code , sLONG , rSI , memoryAt( rSP , leftLimbs ) );
+    emitPowerOfFive( code , powerTable );
+    emitStore( code , sLONG , rSI , memoryAt( rSP , leftLimbs ) );
+    emitJump( code , scaled );
+    placeLabel( code , scaleRight );
+    emitRegisters( code , 0 , 1 , 0xF7 , 3 , rDX );
+    emitMemory( code , 0 , 1 , 0x8D , rDI , memoryAt( rSP , right ) );
+    emitLoad( code , sLONG , rSI , memoryAt( rSP , rightLimbs ) );
+    emitPowerOfFive( code , powerTable );
+    emitStore( code , sLONG , rSI , memoryAt( rSP , rightLimbs ) );
+    placeLabel( code , scaled );
+
+    emitLoad( code , sLONG , rCX , memoryAt( rSP , twoShift ) );
+    emitRegisters( code , 0 , 1 , 0x85 , rCX , rCX );
+    emitBranch( code , cSIGN , shiftRight );
+    emitRegisters( code , 0 , 1 , 0x89 , rSP , rDI );
+    emitLoad( code , sLONG , rSI , memoryAt( rSP , leftLimbs ) );
+    emitCall( code , code->bigShiftRoutine );
+    emitStore( code , sLONG , rSI , memoryAt( rSP , leftLimbs ) );
+    emitJump( code , shifted );
+    placeLabel( code , shiftRight );
+    emitRegisters( code , 0 , 1 , 0xF7 , 3 , rCX );
+    emitMemory( code , 0 , 1 , 0x8D , rDI , memoryAt( rSP , right ) );
+    emitLoad( code , sLONG , rSI , memoryAt( rSP , rightLimbs ) );
+    emitCall( code , code->bigShiftRoutine );
+    emitStore( code , sLONG , rSI , memoryAt( rSP , rightLimbs ) );
+    placeLabel( code , shifted );
+
+    //rsi and rdx: the limbs of each side without the zeros on top, then the limbs compared from the highest
+    emitLoad( code , sLONG , rSI , memoryAt( rSP , leftLimbs ) );
+    emitLoad( code , sLONG , rDX , memoryAt( rSP , rightLimbs ) );
+    placeLabel( code , trimLeft );
+    emitRegisters( code , 0 , 1 , 0x85 , rSI , rSI );
+    emitBranch( code , cEQUAL , trimRight );
+    emitMemoryImmediate( code , 0 , 7 , memoryIndexed( rSP , rSI , 4 , -4 ) , 0 );
+    emitBranch( code , cNOT_EQUAL , trimRight );
+    emitRegisters( code , 0 , 1 , 0xFF , 1 , rSI );
+    emitJump( code , trimLeft );
+    placeLabel( code , trimRight );
+    emitRegisters( code , 0 , 1 , 0x85 , rDX , rDX );
+    emitBranch( code , cEQUAL , trimmed );
+    emitMemoryImmediate( code , 0 , 7 , memoryIndexed( rSP , rDX , 4 , right - 4 ) , 0 );
+    emitBranch( code , cNOT_EQUAL , trimmed );
+    emitRegisters( code , 0 , 1 , 0xFF , 1 , rDX );
+    emitJump( code , trimRight );
+    placeLabel( code , trimmed );
+    emitRegisters( code , 0 , 1 , 0x39 , rDX , rSI );
+    emitBranch( code , cBELOW , below );
+    emitBranch( code , cABOVE , above );
+    placeLabel( code , limbs );
+    emitRegisters( code , 0 , 1 , 0x85 , rSI , rSI );
+    emitBranch( code , cEQUAL , equal );
+    emitRegisters( code , 0 , 1 , 0xFF , 1 , rSI );
+    emitLoad( code , sINTEGER , rAX , memoryIndexed( rSP , rSI , 4 , 0 ) );
+    emitMemory( code , 0 , 0 , 0x3B , rAX , memoryIndexed( rSP , rSI , 4 , right ) );
+    emitBranch( code , cBELOW , below );
+    emitBranch( code , cABOVE , above );
+    emitJump( code , limbs );
+    placeLabel( code , below );
+    emitMoveImmediate( code , rAX , -1 , 0 );
+    emitJump( code , done );
+    placeLabel( code , above );
+    emitMoveImmediate( code , rAX , 1 , 0 );
+    emitJump( code , done );
+    placeLabel( code , equal );
+    emitRegisters( code , 0 , 0 , 0x31 , rAX , rAX );
+    placeLabel( code , done );
+    emitImmediate( code , 1 , 0 , rSP , frame );
+    emitPop( code , rR10 );
+    emitReturn( code );
+
+}
+
+/**
+ * @brief fail: writes the rdx bytes at rsi, flushes the output and terminates the program with status 1, as the errors of resolveTree
+ */
+static void emitFailRoutine( NativeCode *code ) {
+
+    placeLabel( code , code->failRoutine );
+    emitCall( code , code->putBytesRoutine );
+    emitCall( code , code->flushRoutine );
+    emitMoveImmediate( code , rDI , 1 , 0 );
+    emitMoveImmediate( code , rAX , 231 , 0 ); //exit_group
+    emitSyscall( code );
+
+}
+
+/********** code of the program **********/
+
+/**
+ * @brief returns the label of the stub of an error, which is emitted after the code of the program
+ */
+static int errorLabel( NativeCode *code , NativeError error ) {
+
+    if ( code->errorLabels[error] < 0 ) {
+
+        code->errorLabels[error] = createLabel( code );
+
+    }
+
+    return code->errorLabels[error];
+}
+
+/**
+ * @brief returns the label of the stub of the bounds error of an array
+ */
+static int boundsLabel( NativeCode *code , Symbol *array ) {
+
+    if ( code->boundsLabels[array->slot] < 0 ) {
+
+        code->boundsLabels[array->slot] = createLabel( code );
+
+    }
+
+    return code->boundsLabels[array->slot];
+}
+
+/**
+ * @brief returns the label of a procedure, adding it to the procedures to be compiled the first time it is called
+ */
+static int procedureLabel( NativeCode *code , Node *procedure ) {
+
+    int index;
+
+    for ( index = 0 ; index < code->procedureCount ; index++ ) {
+
+        if ( code->procedures[index] == procedure ) {
+
+            return code->procedureLabels[index];
+
+        }
+    }
+
+    code->procedures      = growBuffer( code->procedures , &code->procedureCapacity , code->procedureCount + 1 , sizeof( Node * ) );
+    code->procedureLabels = realloc( code->procedureLabels , code->procedureCapacity * sizeof( int ) );
+
+    if ( code->procedureLabels == NULL ) {
+
+        printf( "Error: Memory allocation failed. Program will be terminated\n" );
+        exit(1);
+
+    }
+
+    code->procedures[code->procedureCount]      = procedure;
+    code->procedureLabels[code->procedureCount] = createLabel( code );
+
+    return code->procedureLabels[code->procedureCount++];
+}
+
+/**
+ * @brief returns the offset of the slot where an oKEEP node keeps its value, assigned the first time the node is found
+ */
+static long long keptOffset( NativeCode *code , Node *kept ) {
+
+    unsigned int hash;
+    int index;
+
+    if ( 2 * ( code->keptCount + 1 ) > code->keptCapacity ) {
+
+        KeptSlot *old = code->keptSlots;
+        int oldCapacity = code->keptCapacity;
+
+        code->keptCapacity = oldCapacity == 0 ? 64 : oldCapacity * 2;
+        code->keptSlots    = calloc( code->keptCapacity , sizeof( KeptSlot ) );
+
+        if ( code->keptSlots == NULL ) {
+
+            printf( "Error: Memory allocation failed. Program will be terminated\n" );
+            exit(1);
+
+        }
+
+        for ( index = 0 ; index < oldCapacity ; index++ ) {
+
+            if ( old[index].kept != NULL ) {
+
+                hash = (unsigned int) ( ( (size_t) old[index].kept >> 4 ) * 2654435761u );
+
+                while ( code->keptSlots[hash & ( code->keptCapacity - 1 )].kept != NULL ) {
+
+                    hash++;
+
+                }
+
+                code->keptSlots[hash & ( code->keptCapacity - 1 )] = old[index];
+
+            }
+        }
+
+        free( old );
+
+    }
+
+    hash = (unsigned int) ( ( (size_t) kept >> 4 ) * 2654435761u );
+
+    while ( code->keptSlots[hash & ( code->keptCapacity - 1 )].kept != NULL ) {
+
+        if ( code->keptSlots[hash & ( code->keptCapacity - 1 )].kept == kept ) {
+
+            return code->keptSlots[hash & ( code->keptCapacity - 1 )].offset;
+
+        }
+
+        hash++;
+
+    }
+
+    code->keptSlots[hash & ( code->keptCapacity - 1 )].kept   = kept;
+    code->keptSlots[hash & ( code->keptCapacity - 1 )].offset = code->dataSize;
+    code->keptCount++;
+
+    code->dataSize += 8;
+
+    return code->dataSize - 8;
+}
+
+static Symbol *nativeSymbol( NativeCode *code , char *identifier ) {
+
+    return findSymbol( code->symbolTable , identifier );
+
+}
+
+static Memory scalarAt( Symbol *symbol ) {
+
+    return memoryAt( rR15 , STATE_SIZE + (long long) symbol->slot * 8 );
+
+}
+
+/**
+ * @brief emits an SSE operation of xmm0 and another xmm register: 0x58 add, 0x59 mul, 0x5C sub, 0x5E div, 0x2E ucomis
+ */
+static void emitRealOperation( NativeCode *code , SymbolType type , unsigned int opcode , int left , int right ) {
+
+    if ( opcode == 0x2E ) {
+
+        emitRegisters( code , type == sDOUBLE ? 0x66 : 0 , 0 , 0x0F2E , left , right );
+
+    } else {
+
+        emitRegisters( code , type == sDOUBLE ? 0xF2 : 0xF3 , 0 , 0x0F00 | opcode , left , right );
+
+    }
+}
+
+/**
+ * @brief emits an SSE operation of xmm0 and a memory operand, with the opcodes of emitRealOperation
+ */
+static void emitRealMemoryOperation( NativeCode *code , SymbolType type , unsigned int opcode , int left , Memory memory ) {
+
+    if ( opcode == 0x2E ) {
+
+        emitMemory( code , type == sDOUBLE ? 0x66 : 0 , 0 , 0x0F2E , left , memory );
+
+    } else {
+
+        emitMemory( code , type == sDOUBLE ? 0xF2 : 0xF3 , 0 , 0x0F00 | opcode , left , memory );
+
+    }
+}
+
+/**
+ * @brief loads a literal into a register. A literal of another type evaluates to 0, as in the evaluate functions
+ */
+static void emitLiteral( NativeCode *code , Node *literal , SymbolType type , int reg ) {
+
+    static const OperationType literalTypes[] = { oINTEGER , oFLOAT , oLONG , oDOUBLE };
+
+    if ( literal->operationType != literalTypes[type] ) {
+
+        if ( isReal( type ) ) {
+
+            emitRegisters( code , 0 , 0 , 0x0F57 , reg , reg ); //xorps
+
+        } else {
+
+            emitRegisters( code , 0 , 0 , 0x31 , reg , reg );
+
+        }
+
+        return;
+
+    }
+
+    switch ( type ) {
+
+        case sINTEGER: emitMoveImmediate( code , reg , literal->value.iValue , 0 ); break;
+        case sLONG:    emitMoveImmediate( code , reg , literal->value.lValue , 1 ); break;
+        case sFLOAT:   emitLoad( code , type , reg , memoryConstant( addConstant( code , &literal->value.fValue , 4 , 4 ) ) ); break;
+        case sDOUBLE:  emitLoad( code , type , reg , memoryConstant( addConstant( code , &literal->value.dValue , 8 , 8 ) ) ); break;
+
+    }
+}
+
+/**
+ * @brief verifies if an operand is loaded straight into a register, without evaluating anything
+ */
+static int isSimpleOperand( Node *operand ) {
+
+    return operand->type == nVALUE && operand->operationType != oINDEX;
+
+}
+
+static void emitOperation( NativeCode *code , Node *operation , SymbolType type );
+
+/**
+ * @brief computes the index of an array element into rax, verifying it against the length of the array unless it was proven to be
+ * within bounds, as resolveArrayIndex does
+ */
+static void emitIndex( NativeCode *code , Node *node , Symbol *array ) {
+
+    emitOperation( code , node->indexExpr , sINTEGER );
+
+    if ( boundsCheckEnabled && node->boundsProven == 0 ) {
+
+        emitImmediate( code , 0 , 7 , rAX , array->length );
+        emitBranch( code , cABOVE_OR_EQUAL , boundsLabel( code , array ) ); //negative indexes are above the length unsigned
+
+    }
+
+    emitRegisters( code , 0 , 1 , 0x63 , rAX , rAX ); //movsxd rax, eax
+
+}
+
+static Memory elementAt( NativeCode *code , Symbol *array , int index ) {
+
+    return memoryIndexed( rR15 , index , elementSize( array->type ) , code->arrayOffsets[array->slot] );
+
+}
+
+/**
+ * @brief evaluates the operands of an operation or an expresion, the left one into rax or xmm0 and the right one into rcx or xmm1.
+ * The left operand is evaluated first and kept on the stack while the right one is, unless the right one is loaded straight
+ */
+static void emitOperands( NativeCode *code , Node *left , Node *right , SymbolType type ) {
+
+    int real = isReal( type );
+
+    emitOperation( code , left , type );
+
+    if ( isSimpleOperand( right ) ) {
+
+        if ( right->operationType == oID ) {
+
+            emitLoad( code , type , real ? 1 : rCX , scalarAt( nativeSymbol( code , right->value.idValue ) ) );
+
+        } else {
+
+            emitLiteral( code , right , type , real ? 1 : rCX );
+
+        }
+
+        return;
+
+    }
+
+    if ( real ) {
+
+        emitImmediate( code , 1 , 5 , rSP , 8 );
+        emitMemory( code , 0xF2 , 0 , 0x0F11 , 0 , memoryAt( rSP , 0 ) ); //movsd [rsp], xmm0
+        emitOperation( code , right , type );
+        emitRegisters( code , 0 , 0 , 0x0F28 , 1 , 0 ); //movaps xmm1, xmm0
+        emitMemory( code , 0xF2 , 0 , 0x0F10 , 0 , memoryAt( rSP , 0 ) );
+        emitImmediate( code , 1 , 0 , rSP , 8 );
+
+    } else {
+
+        emitPush( code , rAX );
+        emitOperation( code , right , type );
+        emitRegisters( code , 0 , 1 , 0x89 , rAX , rCX );
+        emitPop( code , rAX );
+
+    }
+}
+
+/**
+ * @brief emits an integer or long division of rax by rcx with the checks of the evaluate functions that were not proven
+ */
+static void emitDivision( NativeCode *code , Node *operation , int wide ) {
+
+    int divide = createLabel( code );
+    int done   = createLabel( code );
+
+    if ( !( operation->provenChecks & cDIVISOR_NON_ZERO ) ) {
+
+        emitRegisters( code , 0 , wide , 0x85 , rCX , rCX );
+        emitBranch( code , cEQUAL , errorLabel( code , nDIVISION ) );
+
+    }
+
+    //the smallest value divided by -1 overflows, so -1 negates the dividend instead
+    if ( !( operation->provenChecks & cDIVISOR_NOT_MINUS_ONE ) ) {
+
+        emitImmediate( code , wide , 7 , rCX , -1 );
+        emitBranch( code , cNOT_EQUAL , divide );
+        emitRegisters( code , 0 , wide , 0xF7 , 3 , rAX ); //neg
+
+        if ( overflowTrapEnabled ) {
+
+            emitBranch( code , cOVERFLOW , errorLabel( code , nOVERFLOW ) );
+
+        }
+
+        emitJump( code , done );
+
+    }
+
+    placeLabel( code , divide );
+
+    if ( wide ) {
+
+        emitByte( code , 0x48 ); //cqo
+
+    }
+
+    emitByte( code , 0x99 ); //cdq
+    emitRegisters( code , 0 , wide , 0xF7 , 7 , rCX ); //idiv rcx
+    placeLabel( code , done );
+
+}
+
+/**
+ * @brief evaluates an operation of a type into eax, rax, or xmm0, as the evaluate function of the type does
+ */
+static void emitOperation( NativeCode *code , Node *operation , SymbolType type ) {
+
+    int real = isReal( type );
+    int wide = type == sLONG;
+    Symbol *symbol;
+
+    switch ( operation->operationType ) {
+
+        case oINTEGER:
+        case oFLOAT:
+        case oLONG:
+        case oDOUBLE:
+
+            emitLiteral( code , operation , type , real ? 0 : rAX );
+
+        break;
+
+        case oID:
+
+            emitLoad( code , type , real ? 0 : rAX , scalarAt( nativeSymbol( code , operation->value.idValue ) ) );
+
+        break;
+
+        case oINDEX:
+
+            symbol = nativeSymbol( code , operation->value.idValue );
+
+            emitIndex( code , operation , symbol );
+            emitLoad( code , type , real ? 0 : rAX , elementAt( code , symbol , rAX ) );
+
+        break;
+
+        case oSUM:
+        case oSUB:
+        case oMULT:
+        case oDIV:
+
+            emitOperands( code , operation->leftOperand , operation->rightOperand , type );
+
+            if ( real ) {
+
+                static const unsigned int opcodes[] = { 0x58 , 0x5C , 0x5E , 0x59 }; //in the order of the OperationType ENUM
+
+                emitRealOperation( code , type , opcodes[operation->operationType - oSUM] , 0 , 1 );
+
+                break;
+
+            }
+
+            switch ( operation->operationType ) {
+
+                case oSUM:  emitRegisters( code , 0 , wide , 0x01 , rCX , rAX ); break;
+                case oSUB:  emitRegisters( code , 0 , wide , 0x29 , rCX , rAX ); break;
+                case oMULT: emitRegisters( code , 0 , wide , 0x0FAF , rAX , rCX ); break;
+                default:
+
+                    emitDivision( code , operation , wide );
+
+                    return;
+
+            }
+
+            //the operations wrap around unless overflows trap
+            if ( overflowTrapEnabled ) {
+
+                emitBranch( code , cOVERFLOW , errorLabel( code , nOVERFLOW ) );
+
+            }
+
+        break;
+
+        case oKEEP:
+
+            emitOperation( code , operation->leftOperand , type );
+            emitStore( code , type , real ? 0 : rAX , memoryAt( rR15 , keptOffset( code , operation ) ) );
+
+        break;
+
+        case oREUSE:
+
+            //the value numbering only reuses values kept before by the same statement sequence, so the kept value is always there
+            emitLoad( code , type , real ? 0 : rAX , memoryAt( rR15 , keptOffset( code , operation->leftOperand ) ) );
+
+        break;
+
+        default:
+
+            emitLiteral( code , operation , type , real ? 0 : rAX );
+
+        break;
+
+    }
+}
+
+/**
+ * @brief evaluates an expresion and branches to a label if it is false. NaNs compare false, as in C
+ */
+static void emitCondition( NativeCode *code , Node *expresion , int falseLabel ) {
+
+    SymbolType type = expresion->symbolType;
+
+    emitOperands( code , expresion->leftOperand , expresion->rightOperand , type );
+
+    if ( !isReal( type ) ) {
+
+        emitRegisters( code , 0 , type == sLONG , 0x39 , rCX , rAX ); //cmp rax, rcx
+
+        switch ( expresion->expresionType ) {
+
+            case eGREATER_THAN: emitBranch( code , cLESS_OR_EQUAL , falseLabel ); break;
+            case eLESS_THAN:    emitBranch( code , cGREATER_OR_EQUAL , falseLabel ); break;
+            default:            emitBranch( code , cNOT_EQUAL , falseLabel ); break;
+
+        }
+
+        return;
+
+    }
+
+    switch ( expresion->expresionType ) {
+
+        case eGREATER_THAN:
+
+            emitRealOperation( code , type , 0x2E , 0 , 1 );
+            emitBranch( code , cBELOW_OR_EQUAL , falseLabel ); //unordered sets the carry
+
+        break;
+
+        case eLESS_THAN:
+
+            emitRealOperation( code , type , 0x2E , 1 , 0 );
+            emitBranch( code , cBELOW_OR_EQUAL , falseLabel );
+
+        break;
+
+        default:
+
+            emitRealOperation( code , type , 0x2E , 0 , 1 );
+            emitBranch( code , cNOT_EQUAL , falseLabel );
+            emitBranch( code , cPARITY , falseLabel );
+
+        break;
+
+    }
+}
+
+/**
+ * @brief stores rax, eax or xmm0 in a symbol. A value assigned to an array is assigned to every element, as the set functions do
+ */
+static void emitStoreSymbol( NativeCode *code , Symbol *symbol , SymbolType type ) {
+
+    if ( symbol->length == 0 ) {
+
+        emitStore( code , type , isReal( type ) ? 0 : rAX , scalarAt( symbol ) );
+
+        return;
+
+    }
+
+    if ( isReal( type ) ) {
+
+        emitRegisters( code , 0x66 , type == sDOUBLE , 0x0F7E , 0 , rAX ); //movd eax, xmm0 or movq rax, xmm0
+
+    }
+
+    emitMemory( code , 0 , 1 , 0x8D , rDI , memoryAt( rR15 , code->arrayOffsets[symbol->slot] ) );
+    emitMoveImmediate( code , rCX , symbol->length , 0 );
+    emitByte( code , 0xF3 );
+
+    if ( elementSize( type ) == 8 ) {
+
+        emitByte( code , 0x48 );
+
+    }
+
+    emitByte( code , 0xAB ); //rep stosd or rep stosq
+
+}
+
+/**
+ * @brief branches to a label if a float or double at [rsp + offset] is infinite or NaN
+ */
+static void emitFiniteCheck( NativeCode *code , SymbolType type , int offset ) {
+
+    if ( type == sFLOAT ) {
+
+        emitLoad( code , sINTEGER , rAX , memoryAt( rSP , offset ) );
+        emitImmediate( code , 0 , 4 , rAX , 0x7F800000 );
+        emitImmediate( code , 0 , 7 , rAX , 0x7F800000 );
+
+    } else {
+
+        emitLoad( code , sLONG , rAX , memoryAt( rSP , offset ) );
+        emitShift( code , 1 , 5 , rAX , 52 );
+        emitImmediate( code , 0 , 4 , rAX , 0x7FF );
+        emitImmediate( code , 0 , 7 , rAX , 0x7FF );
+
+    }
+
+    emitBranch( code , cEQUAL , errorLabel( code , nBOUNDS_FINITE ) );
+
+}
+
+/**
+ * @brief emits the test of a for loop for one direction of its step, branching to a label once the iterator is past the until value
+ */
+static void emitLoopTest( NativeCode *code , SymbolType type , int negative , int endLabel ) {
+
+    if ( !isReal( type ) ) {
+
+        emitLoad( code , type , rAX , memoryAt( rSP , 16 ) );
+        emitMemory( code , 0 , type == sLONG , 0x3B , rAX , memoryAt( rSP , 0 ) ); //cmp iterator, until
+        emitBranch( code , negative ? cLESS : cGREATER , endLabel );
+
+        return;
+
+    }
+
+    //the comparisons are false for NaNs, which set the carry
+    emitLoad( code , type , 0 , memoryAt( rSP , negative ? 16 : 0 ) );
+    emitRealMemoryOperation( code , type , 0x2E , 0 , memoryAt( rSP , negative ? 0 : 16 ) );
+    emitBranch( code , cBELOW , endLabel );
+
+}
+
+/**
+ * @brief returns 1 if the step of a for loop is a literal whose sign is known, storing in negative if it is below 0
+ */
+static int knownStepSign( Node *step , SymbolType type , int *negative ) {
+
+    static const OperationType literalTypes[] = { oINTEGER , oFLOAT , oLONG , oDOUBLE };
+
+    if ( step->type != nVALUE || step->operationType != literalTypes[type] ) {
+
+        return 0;
+
+    }
+
+    switch ( type ) {
+
+        case sINTEGER: *negative = step->value.iValue < 0; break;
+        case sFLOAT:   *negative = step->value.fValue < 0; break;
+        case sLONG:    *negative = step->value.lValue < 0; break;
+        case sDOUBLE:  *negative = step->value.dValue < 0; break;
+
+    }
+
+    return 1;
+}
+
+static void emitStatement( NativeCode *code , Node *tree );
+
+/**
+ * @brief emits a for loop. The iterator, the step and the until values are kept on the stack, at [rsp + 16], [rsp + 8] and [rsp],
+ * and the iterator is copied to its symbol at the start of every iteration, as resolveTree does
+ */
+static void emitForLoop( NativeCode *code , Node *tree ) {
+
+    SymbolType type  = tree->symbolType;
+    Symbol *iterator = nativeSymbol( code , tree->value.idValue );
+    int real         = isReal( type );
+    int top          = createLabel( code );
+    int negativeTest = createLabel( code );
+    int body         = createLabel( code );
+    int end          = createLabel( code );
+    int negative     = 0;
+    int known        = knownStepSign( tree->stepExpr , type , &negative );
+    Node *values[3];
+    int index;
+
+    values[0] = tree->expr;
+    values[1] = tree->stepExpr;
+    values[2] = tree->untilExpr;
+
+    for ( index = 0 ; index < 3 ; index++ ) {
+
+        emitOperation( code , values[index] , type );
+
+        if ( real ) {
+
+            emitImmediate( code , 1 , 5 , rSP , 8 );
+            emitStore( code , sDOUBLE , 0 , memoryAt( rSP , 0 ) );
+
+        } else {
+
+            emitPush( code , rAX );
+
+        }
+    }
+
+    emitLoad( code , type , real ? 0 : rAX , memoryAt( rSP , 16 ) );
+    emitStoreSymbol( code , iterator , type );
+
+    if ( real && !( tree->provenChecks & cBOUNDS_FINITE ) ) {
+
+        for ( index = 0 ; index < 3 ; index++ ) {
+
+            emitFiniteCheck( code , type , 16 - 8 * index );
+
+        }
+    }
+
+    if ( !( tree->provenChecks & cSTEP_NON_ZERO ) ) {
+
+        //-0.0 is 0 as well, so the sign bit is shifted out
+        emitLoad( code , real ? ( type == sFLOAT ? sINTEGER : sLONG ) : type , rAX , memoryAt( rSP , 8 ) );
+
+        if ( real ) {
+
+            emitRegisters( code , 0 , type == sDOUBLE , 0x01 , rAX , rAX );
+
+        } else {
+
+            emitRegisters( code , 0 , type == sLONG , 0x85 , rAX , rAX );
+
+        }
+
+        emitBranch( code , cEQUAL , errorLabel( code , nSTEP ) );
+
+    }
+
+    placeLabel( code , top );
+
+    if ( known ) {
+
+        emitLoopTest( code , type , negative , end );
+
+    } else {
+
+        if ( real ) {
+
+            emitRegisters( code , 0 , 0 , 0x0F57 , 1 , 1 ); //xorps xmm1, xmm1
+            emitRealMemoryOperation( code , type , 0x2E , 1 , memoryAt( rSP , 8 ) );
+            emitBranch( code , cABOVE , negativeTest ); //0 > step
+
+        } else {
+
+            emitMemoryImmediate( code , type == sLONG , 7 , memoryAt( rSP , 8 ) , 0 );
+            emitBranch( code , cLESS , negativeTest );
+
+        }
+
+        emitLoopTest( code , type , 0 , end );
+        emitJump( code , body );
+        placeLabel( code , negativeTest );
+        emitLoopTest( code , type , 1 , end );
+
+    }
+
+    placeLabel( code , body );
+    emitLoad( code , type , real ? 0 : rAX , memoryAt( rSP , 16 ) );
+    emitStoreSymbol( code , iterator , type );
+    emitStatement( code , tree->doOptStmts );
+
+    if ( real ) {
+
+        emitLoad( code , type , 0 , memoryAt( rSP , 16 ) );
+        emitRealMemoryOperation( code , type , 0x58 , 0 , memoryAt( rSP , 8 ) );
+        emitStore( code , type , 0 , memoryAt( rSP , 16 ) );
+
+    } else {
+
+        emitLoad( code , type , rAX , memoryAt( rSP , 8 ) );
+        emitMemory( code , 0 , type == sLONG , 0x01 , rAX , memoryAt( rSP , 16 ) ); //add [rsp + 16], rax
+
+    }
+
+    emitJump( code , top );
+
+    //the iterator ends with the last value that passed the test
+    placeLabel( code , end );
+    emitLoad( code , type , real ? 0 : rAX , memoryAt( rSP , 16 ) );
+
+    if ( real ) {
+
+        emitRealMemoryOperation( code , type , 0x5C , 0 , memoryAt( rSP , 8 ) );
+
+    } else {
+
+        emitMemory( code , 0 , type == sLONG , 0x2B , rAX , memoryAt( rSP , 8 ) );
+
+    }
+
+    emitStoreSymbol( code , iterator , type );
+    emitImmediate( code , 1 , 0 , rSP , 24 );
+
+}
+
+/**
+ * @brief emits a call. The values the locals of the procedure had before the call are kept on the stack, as the frame of
+ * callProcedure keeps them, and the arguments are evaluated before the frame is entered
+ */
+static void emitProcedureCall( NativeCode *code , Node *call ) {
+
+    Node *procedure = call->procedure;
+    Node *argument  = call->arguments;
+    int index;
+
+    for ( index = 0 ; index < procedure->parameterCount ; index++ , argument = argument->nextArgument ) {
+
+        SymbolType type = procedure->locals[index]->type;
+
+        emitOperation( code , argument->expr , type );
+
+        if ( isReal( type ) ) {
+
+            emitRegisters( code , 0x66 , 1 , 0x0F7E , 0 , rAX ); //movq rax, xmm0
+
+        }
+
+        emitPush( code , rAX );
+
+    }
+
+    for ( index = 0 ; index < procedure->localCount ; index++ ) {
+
+        emitMemory( code , 0 , 0 , 0xFF , 6 , scalarAt( procedure->locals[index] ) ); //push qword [local]
+
+    }
+
+    emitRegisters( code , 0 , 0 , 0x31 , rAX , rAX );
+
+    for ( index = 0 ; index < procedure->localCount ; index++ ) {
+
+        if ( index < procedure->parameterCount ) {
+
+            emitLoad( code , sLONG , rCX , memoryAt( rSP , 8 * ( procedure->localCount + procedure->parameterCount - 1 - index ) ) );
+            emitStore( code , sLONG , rCX , scalarAt( procedure->locals[index] ) );
+
+        } else {
+
+            emitStore( code , sLONG , rAX , scalarAt( procedure->locals[index] ) );
+
+        }
+    }
+
+    emitCall( code , procedureLabel( code , procedure ) );
+
+    for ( index = procedure->localCount - 1 ; index >= 0 ; index-- ) {
+
+        emitMemory( code , 0 , 0 , 0x8F , 0 , scalarAt( procedure->locals[index] ) ); //pop qword [local]
+
+    }
+
+    if ( procedure->parameterCount > 0 ) {
+
+        emitImmediate( code , 1 , 0 , rSP , 8 * procedure->parameterCount );
+
+    }
+}
+
+/**
+ * @brief emits a read, which writes the prompt of resolveTree, reads the next value of the type of the symbol and writes a new line
+ */
+static void emitRead( NativeCode *code , Node *tree ) {
+
+    Symbol *symbol = nativeSymbol( code , tree->value.idValue );
+    size_t length  = strlen( tree->value.idValue ) + sizeof( "read value for : " );
+    char *prompt   = malloc( length );
+    int ended      = createLabel( code );
+
+    if ( prompt == NULL ) {
+
+        printf( "Error: Memory allocation failed. Program will be terminated\n" );
+        exit(1);
+
+    }
+
+    snprintf( prompt , length , "read value for %s: " , tree->value.idValue );
+
+    emitText( code , prompt , strlen( prompt ) );
+    emitCall( code , code->putBytesRoutine );
+
+    free( prompt );
+
+    if ( isReal( symbol->type ) ) {
+
+        emitMoveImmediate( code , rDI , symbol->type == sFLOAT , 0 );
+        emitCall( code , code->readRealRoutine );
+
+    } else {
+
+        emitCall( code , code->readIntegerRoutine );
+
+    }
+
+    //at the end of the input the symbol keeps its value
+    emitRegisters( code , 0 , 0 , 0x85 , rDX , rDX );
+    emitBranch( code , cEQUAL , ended );
+    emitStoreSymbol( code , symbol , symbol->type );
+    placeLabel( code , ended );
+    emitCall( code , code->newLineRoutine );
+
+}
+
+/**
+ * @brief emits the code of a statement, as resolveTree executes it
+ */
+static void emitStatement( NativeCode *code , Node *tree ) {
+
+    Symbol *symbol;
+    int end;
+
+    if ( tree == NULL ) { //empty statement
+
+        return;
+
+    }
+
+    switch ( tree->type ) {
+
+        case nSEMICOLON:
+
+            emitStatement( code , tree->leftStatement );
+            emitStatement( code , tree->rightStatement );
+
+        break;
+
+        case nASSIGNMENT:
+
+            symbol = nativeSymbol( code , tree->value.idValue );
+
+            if ( tree->indexExpr != NULL ) { //array element assignment, the index is resolved before the value
+
+                emitIndex( code , tree , symbol );
+                emitPush( code , rAX );
+                emitOperation( code , tree->expr , tree->symbolType );
+                emitPop( code , rCX );
+                emitStore( code , tree->symbolType , isReal( tree->symbolType ) ? 0 : rAX , elementAt( code , symbol , rCX ) );
+
+                break;
+
+            }
+
+            emitOperation( code , tree->expr , tree->symbolType );
+            emitStoreSymbol( code , symbol , tree->symbolType );
+
+        break;
+
+        case nIF: //a conditional select assigns the same value as the branch
+
+            end = createLabel( code );
+
+            emitCondition( code , tree->expresion , end );
+            emitStatement( code , tree->thenOptStmts );
+            placeLabel( code , end );
+
+        break;
+
+        case nWHILE: {
+
+            int top = createLabel( code );
+
+            end = createLabel( code );
+
+            placeLabel( code , top );
+            emitCondition( code , tree->expresion , end );
+            emitStatement( code , tree->doOptStmts );
+            emitJump( code , top );
+            placeLabel( code , end );
+
+        break;
+        }
+
+        case nFOR:
+
+            emitForLoop( code , tree );
+
+        break;
+
+        case nREAD:
+
+            emitRead( code , tree );
+
+        break;
+
+        case nCALL:
+
+            emitProcedureCall( code , tree );
+
+        break;
+
+        case nPRINT:
+
+            emitOperation( code , tree->expr , tree->expr->symbolType );
+
+            switch ( tree->expr->symbolType ) {
+
+                case sINTEGER:
+
+                    emitRegisters( code , 0 , 1 , 0x63 , rAX , rAX );
+                    emitCall( code , code->printLongRoutine );
+
+                break;
+
+                case sLONG:
+
+                    emitCall( code , code->printLongRoutine );
+
+                break;
+
+                case sFLOAT:
+
+                    emitRegisters( code , 0xF3 , 0 , 0x0F5A , 0 , 0 ); //cvtss2sd xmm0, xmm0
+                    emitCall( code , code->printDoubleRoutine );
+
+                break;
+
+                case sDOUBLE:
+
+                    emitCall( code , code->printDoubleRoutine );
+
+                break;
+
+            }
+
+        break;
+
+        default: //declarations and procedures have no code of their own
+
+        break;
+
+    }
+}
+
+/**
+ * @brief emits the stub of the bounds error of an array: the index in eax is written within the message of resolveArrayIndex
+ */
+static void emitBoundsStub( NativeCode *code , Symbol *array ) {
+
+    const char *format = " out of bounds for array %s. Program will be terminated.\n";
+    size_t length      = strlen( format ) + strlen( array->identifier );
+    char *message      = malloc( length );
+
+    if ( message == NULL ) {
+
+        printf( "Error: Memory allocation failed. Program will be terminated\n" );
+        exit(1);
+
+    }
+
+    snprintf( message , length , format , array->identifier );
+
+    placeLabel( code , code->boundsLabels[array->slot] );
+    emitPush( code , rAX );
+    emitText( code , "Error: Index " , strlen( "Error: Index " ) );
+    emitCall( code , code->putBytesRoutine );
+    emitPop( code , rAX );
+    emitRegisters( code , 0 , 1 , 0x63 , rAX , rAX );
+    emitCall( code , code->putLongRoutine );
+    emitText( code , message , strlen( message ) );
+    emitJump( code , code->failRoutine );
+
+    free( message );
+
+}
+
+/**
+ * @brief assigns the offsets of the symbols, the buffers and the arrays in the data
+ * @return 1 if the data fits in NATIVE_DATA_LIMIT, 0 otherwise
+ */
+static int layoutData( NativeCode *code , long long *outputBuffer , long long *inputBuffer ) {
+
+    Symbol *symbol;
+    int slot;
+
+    code->slotCount = 0;
+
+    for ( symbol = *code->symbolTable ; symbol != NULL ; symbol = symbol->next ) {
+
+        if ( symbol->slot + 1 > code->slotCount ) {
+
+            code->slotCount = symbol->slot + 1;
+
+        }
+    }
+
+    code->symbols      = calloc( code->slotCount + 1 , sizeof( Symbol * ) );
+    code->arrayOffsets = calloc( code->slotCount + 1 , sizeof( long long ) );
+    code->boundsLabels = malloc( ( code->slotCount + 1 ) * sizeof( int ) );
+
+    if ( code->symbols == NULL || code->arrayOffsets == NULL || code->boundsLabels == NULL ) {
+
+        printf( "Error: Memory allocation failed. Program will be terminated\n" );
+        exit(1);
+
+    }
+
+    for ( symbol = *code->symbolTable ; symbol != NULL ; symbol = symbol->next ) {
+
+        code->symbols[symbol->slot] = symbol;
+
+    }
+
+    *outputBuffer  = alignSize( STATE_SIZE + (long long) code->slotCount * 8 , SYMBOL_ARRAY_ALIGNMENT );
+    *inputBuffer   = *outputBuffer + NATIVE_BUFFER_SIZE;
+    code->dataSize = *inputBuffer + NATIVE_BUFFER_SIZE;
+
+    //arrays in slot order, aligned as the buffers of the symbol table
+    for ( slot = 0 ; slot < code->slotCount ; slot++ ) {
+
+        code->boundsLabels[slot] = -1;
+        symbol = code->symbols[slot];
+
+        if ( symbol != NULL && symbol->length > 0 ) {
+
+            code->dataSize           = alignSize( code->dataSize , SYMBOL_ARRAY_ALIGNMENT );
+            code->arrayOffsets[slot] = code->dataSize;
+            code->dataSize          += (long long) symbol->length * elementSize( symbol->type );
+
+            if ( code->dataSize > NATIVE_DATA_LIMIT ) {
+
+                return 0;
+
+            }
+        }
+    }
+
+    code->dataSize = alignSize( code->dataSize , 8 );
+
+    return 1;
+}
+
+/**
+ * @brief completes the distances of the fixups and writes the executable
+ * @return 1 if the file was written, 0 otherwise
+ */
+static int writeExecutable( NativeCode *code , const char *fileName ) {
+
+    long long constantStart = alignSize( HEADERS_SIZE + code->length , 16 ); //offsets in the file, which are the offsets from NATIVE_TEXT_ADDRESS
+    long long textSize      = constantStart + code->constantLength;
+    long long dataStart     = alignSize( textSize , PAGE_SIZE );
+    unsigned char *image    = calloc( dataStart + STATE_SIZE , 1 );
+    Elf64_Ehdr *header      = (Elf64_Ehdr *) image;
+    Elf64_Phdr *segments    = (Elf64_Phdr *) ( image + sizeof( Elf64_Ehdr ) );
+    FILE *file;
+    int index;
+    int written;
+
+    if ( image == NULL ) {
+
+        printf( "Error: Memory allocation failed. Program will be terminated\n" );
+        exit(1);
+
+    }
+
+    for ( index = 0 ; index < code->fixupCount ; index++ ) {
+
+        Fixup *fixup = &code->fixups[index];
+        long long target = fixup->isConstant ? constantStart - HEADERS_SIZE + fixup->target : code->labels[fixup->target];
+        int distance = (int) ( target - (long long) ( fixup->position + 4 ) );
+
+        memcpy( code->bytes + fixup->position , &distance , sizeof( distance ) );
+
+    }
+
+    memcpy( header->e_ident , ELFMAG , SELFMAG );
+    header->e_ident[EI_CLASS]   = ELFCLASS64;
+    header->e_ident[EI_DATA]    = ELFDATA2LSB;
+    header->e_ident[EI_VERSION] = EV_CURRENT;
+    header->e_ident[EI_OSABI]   = ELFOSABI_SYSV;
+    header->e_type      = ET_EXEC;
+    header->e_machine   = EM_X86_64;
+    header->e_version   = EV_CURRENT;
+    header->e_entry     = NATIVE_TEXT_ADDRESS + HEADERS_SIZE;
+    header->e_phoff     = sizeof( Elf64_Ehdr );
+    header->e_ehsize    = sizeof( Elf64_Ehdr );
+    header->e_phentsize = sizeof( Elf64_Phdr );
+    header->e_phnum     = 3;
+
+    //the headers, the code and the constants
+    segments[0].p_type   = PT_LOAD;
+    segments[0].p_flags  = PF_R | PF_X;
+    segments[0].p_offset = 0;
+    segments[0].p_vaddr  = NATIVE_TEXT_ADDRESS;
+    segments[0].p_paddr  = NATIVE_TEXT_ADDRESS;
+    segments[0].p_filesz = textSize;
+    segments[0].p_memsz  = textSize;
+    segments[0].p_align  = PAGE_SIZE;
+
+    //the state of the runtime is in the file, the rest of the data is zeroed when the program is loaded
+    segments[1].p_type   = PT_LOAD;
+    segments[1].p_flags  = PF_R | PF_W;
+    segments[1].p_offset = dataStart;
+    segments[1].p_vaddr  = NATIVE_DATA_ADDRESS;
+    segments[1].p_paddr  = NATIVE_DATA_ADDRESS;
+    segments[1].p_filesz = STATE_SIZE;
+    segments[1].p_memsz  = code->dataSize;
+    segments[1].p_align  = PAGE_SIZE;
+
+    segments[2].p_type   = PT_GNU_STACK;
+    segments[2].p_flags  = PF_R | PF_W;
+
+    memcpy( image + HEADERS_SIZE , code->bytes , code->length );
+    memset( image + HEADERS_SIZE + code->length , 0xCC , constantStart - HEADERS_SIZE - code->length ); //int3 between the code and the constants
+    memcpy( image + constantStart , code->constants , code->constantLength );
+
+    file = fopen( fileName , "wb" );
+
+    if ( file == NULL ) {
+
+        reportError( "Cannot write the executable %s" , fileName );
+        free( image );
+
+        return 0;
+
+    }
+
+    written = fwrite( image , 1 , dataStart + STATE_SIZE , file ) == (size_t) ( dataStart + STATE_SIZE );
+    written = fclose( file ) == 0 && written;
+
+    free( image );
+
+    if ( !written || chmod( fileName , 0755 ) != 0 ) {
+
+        reportError( "Cannot write the executable %s" , fileName );
+
+        return 0;
+
+    }
+
+    return 1;
+}
+
+static void releaseNativeCode( NativeCode *code ) {
+
+    free( code->bytes );
+    free( code->constants );
+    free( code->labels );
+    free( code->fixups );
+    free( code->symbols );
+    free( code->arrayOffsets );
+    free( code->boundsLabels );
+    free( code->keptSlots );
+    free( code->procedures );
+    free( code->procedureLabels );
+
+}
+
+int emitNativeExecutable( Node *tree , Symbol **symbolTable , const char *fileName ) {
+
+    NativeCode code;
+    long long outputBuffer;
+    long long inputBuffer;
+    int written;
+    int index;
+
+    memset( &code , 0 , sizeof( code ) );
+
+    code.symbolTable = symbolTable;
+
+    if ( !layoutData( &code , &outputBuffer , &inputBuffer ) ) {
+
+        reportError( "Arrays of the program do not fit in the %d bytes of data of a native executable" , NATIVE_DATA_LIMIT );
+        releaseNativeCode( &code );
+
+        return 0;
+
+    }
+
+    for ( index = 0 ; index < NATIVE_ERRORS ; index++ ) {
+
+        code.errorLabels[index] = -1;
+
+    }
+
+    code.writeRoutine       = createLabel( &code );
+    code.flushRoutine       = createLabel( &code );
+    code.putBytesRoutine    = createLabel( &code );
+    code.newLineRoutine     = createLabel( &code );
+    code.digitsRoutine      = createLabel( &code );
+    code.putLongRoutine     = createLabel( &code );
+    code.printLongRoutine   = createLabel( &code );
+    code.printDoubleRoutine = createLabel( &code );
+    code.getCharRoutine     = createLabel( &code );
+    code.readWordRoutine    = createLabel( &code );
+    code.readIntegerRoutine = createLabel( &code );
+    code.matchWordRoutine   = createLabel( &code );
+    code.readRealRoutine    = createLabel( &code );
+    code.bigMultiplyRoutine = createLabel( &code );
+    code.bigShiftRoutine    = createLabel( &code );
+    code.compareMidpointRoutine = createLabel( &code );
+    code.failRoutine        = createLabel( &code );
+
+    //entry point: r15 addresses the data for the whole execution
+    emitMoveImmediate( &code , rR15 , NATIVE_DATA_ADDRESS , 0 );
+    emitStatement( &code , tree );
+    emitCall( &code , code.flushRoutine );
+    emitRegisters( &code , 0 , 0 , 0x31 , rDI , rDI );
+    emitMoveImmediate( &code , rAX , 231 , 0 ); //exit_group
+    emitSyscall( &code );
+
+    //procedures called by the program, which may call others
+    for ( index = 0 ; index < code.procedureCount ; index++ ) {
+
+        placeLabel( &code , code.procedureLabels[index] );
+        emitStatement( &code , code.procedures[index]->body );
+        emitReturn( &code );
+
+    }
+
+    for ( index = 0 ; index < NATIVE_ERRORS ; index++ ) {
+
+        if ( code.errorLabels[index] >= 0 ) {
+
+            placeLabel( &code , code.errorLabels[index] );
+            emitText( &code , errorMessages[index] , strlen( errorMessages[index] ) );
+            emitJump( &code , code.failRoutine );
+
+        }
+    }
+
+    for ( index = 0 ; index < code.slotCount ; index++ ) {
+
+        if ( code.boundsLabels[index] >= 0 ) {
+
+            emitBoundsStub( &code , code.symbols[index] );
+
+        }
+    }
+
+    emitWriteRoutine( &code );
+    emitFlushRoutine( &code , outputBuffer );
+    emitPutBytesRoutine( &code , outputBuffer );
+    emitNewLineRoutine( &code );
+    emitDigitsRoutine( &code );
+    emitPutLongRoutine( &code );
+    emitPrintDoubleRoutine( &code );
+    emitGetCharRoutine( &code , inputBuffer );
+    emitReadWordRoutine( &code );
+    emitReadIntegerRoutine( &code );
+    emitMatchWordRoutine( &code );
+    emitReadRealRoutine( &code );
+    emitBigMultiplyRoutine( &code );
+    emitBigShiftRoutine( &code );
+    emitCompareMidpointRoutine( &code );
+    emitFailRoutine( &code );
+
+    if ( code.dataSize > NATIVE_DATA_LIMIT ) {
+
+        reportError( "Data of the program does not fit in the %d bytes of data of a native executable" , NATIVE_DATA_LIMIT );
+        releaseNativeCode( &code );
+
+        return 0;
+
+    }
+
+    written = writeExecutable( &code , fileName );
+
+    releaseNativeCode( &code );
+
+    return written;
+}
+
+//end nativeCode.c
@@ -0,0 +1,53 @@
+/**
+ * nativeCode.h
+ * Definition of the native backend, which lowers the tree of a program to x86-64 machine code and writes it as a static ELF
+ * executable for Linux. The executable needs no C library: a runtime emitted with the program prints and reads the values with
+ * the formats of resolveTree and makes the system calls itself
+ * @author Jose Pablo Ortiz Lack
+ */
+#ifndef __NATIVE_CODE_H__
+#define __NATIVE_CODE_H__
+
+#include "symbolTable.h"
+#include "syntaxTree.h"
+
+/**
+ * @brief virtual address where the code, the headers and the constants of the executable are loaded
+ */
+#define NATIVE_TEXT_ADDRESS 0x400000
+
+/**
+ * @brief virtual address of the symbols, the arrays and the buffers of the runtime. It does not depend on the size of the code, so
+ * the data is addressed from a base register without relocations
+ */
+#define NATIVE_DATA_ADDRESS 0x40000000
+
+/**
+ * @brief largest data of a program, so every address of the data fits in the 32 bit displacement of an instruction
+ */
+#define NATIVE_DATA_LIMIT 0x40000000
+
+/**
+ * @brief bytes of the buffers of the standard output and the standard input of the runtime
+ */
+#define NATIVE_BUFFER_SIZE 65536
+
+/**
+ * @brief compiles a program to a static x86-64 ELF executable. The executable behaves as resolveTree: print statements write
+ * "%d\n", "%lld\n" and "%f\n", correctly rounded, read statements write the prompt "read value for x: " and a new line, and the
+ * run-time errors write the messages of the interpreter and terminate the program with status 1. The checks proven by the range
+ * analysis are not emitted, array indexes are verified when boundsCheckEnabled is set and overflows trap when overflowTrapEnabled is.
+ * The output is buffered and written when the program ends, fails or waits for input.
+ * Values are read as a session reads them: the input is split into words and a word that is not a number of the type of the symbol
+ * is skipped. Integers are converted as strtol and strtoll do, floats and doubles are correctly rounded as strtof and strtod round
+ * them, and hexadecimal floats are skipped. A read at the end of the input leaves the symbol unchanged
+ * @param tree tree of the program, after the optimizations
+ * @param symbolTable the symbolTable of the compiler
+ * @param fileName file where the executable is written
+ * @return 1 if the executable was written, 0 otherwise; the error is added to the diagnostics
+ */
+int emitNativeExecutable( Node *tree , Symbol **symbolTable , const char *fileName );
+
+#endif //__NATIVE_CODE_H__
+
+//end nativeCode.h
@@ -10,33 +10,189 @@
  */
  #include "symbolTable.h"
  #include "syntaxTree.h"
+ #include "vectorLoop.h"
+ #include "rangeAnalysis.h"
+ #include "valueNumbering.h"
+ #include "inlining.h"
+ #include "constantPropagation.h"
+ #include "streaming.h"
+ #include "unrolling.h"
+ #include "batch.h"
+ #include "incremental.h"
+ #include "diagnostics.h"
+ #include "metrics.h"
+ #include "snapshot.h"
+ #include "session.h"
+ #include "profile.h"
+ #include "trace.h"
+ #include "differential.h"
+ #include "frontEnd.h"
+ #include "startup.h"
+ #include "arena.h"
+ #include "nativeCode.h"
  #include "Parser.h"
  #include "Lexer.h"
+ #include "fastScanner.h"
  #include <stdio.h>
+ #include <stdlib.h>
+ #include <string.h>
+ #include <limits.h>
+ #include <fcntl.h>
+ #include <unistd.h>
+ #include <sys/stat.h>
 
- //Declaration of the syntax tree and symbol table
+_Thread_local int lexerLine = 1;
 
- Symbol *symbolTable;
+//External variables and methods
+static int yylex( YYSTYPE *value , YYLTYPE *location , ParseContext *context );
+static Node *enterProcedure( ParseContext *context , Node *procedure );
+static void leaveProcedure( ParseContext *context );
+int yyerror( YYLTYPE *location , ParseContext *context , char const *message );
 
- Node   *syntaxTree;
+//an identifier of a procedure body refers to the local symbol with its name if the procedure has one
+#define SCOPE( identifier ) scopeIdentifier( context->procedure , identifier , &context->symbolTable )
 
-//External variables and methods
-extern int yylex();
-extern int yyerror(char const *);
+//the location of a rule starts at its first symbol; it is also the location of the errors found while its tree is built
+#define YYLLOC_DEFAULT( Current , Rhs , N )                                                                 \
+    do {                                                                                                    \
+        if ( N ) {                                                                                          \
+            ( Current ).first_line   = YYRHSLOC( Rhs , 1 ).first_line;                                      \
+            ( Current ).first_column = YYRHSLOC( Rhs , 1 ).first_column;                                    \
+            ( Current ).last_line    = YYRHSLOC( Rhs , N ).last_line;                                       \
+            ( Current ).last_column  = YYRHSLOC( Rhs , N ).last_column;                                     \
+        } else {                                                                                            \
+            ( Current ).first_line   = ( Current ).last_line   = YYRHSLOC( Rhs , 0 ).last_line;             \
+            ( Current ).first_column = ( Current ).last_column = YYRHSLOC( Rhs , 0 ).last_column;           \
+        }                                                                                                   \
+        diagnosticLine   = ( Current ).first_line;                                                          \
+        diagnosticColumn = ( Current ).first_column;                                                        \
+    } while ( 0 )
 
 %}
 
 %error-verbose
+%locations
+%define api.pure full
+%parse-param { ParseContext *context }
+%lex-param { ParseContext *context }
 
 //Compiler directives
 %output  "Parser.c"
 %defines "Parser.h"
 
+%code requires {
+
+    #include "symbolTable.h"
+    #include "syntaxTree.h"
+
+    /**
+     * @brief the state of one parse. Every parse has its own context, so many programs can be parsed at once by different threads
+     */
+    typedef struct tagParseContext {
+
+        void *scanner; //flex scanner of the source
+        int column; //column of the next character read by the scanner, starting at 1
+        int startToken; //token returned before the first token of the input, 0 to read a complete program
+
+        const char *cursor; //next character of the hand-written scanner, NULL if the flex scanner reads the source
+        const char *limit; //end of the source of the hand-written scanner
+        int line; //line of the hand-written scanner
+
+        struct tagToken *tokens; //tokens lexed before the parse, NULL to read the tokens from the scanner
+        int tokenCount; //number of tokens in the list, the last one is the end of the input
+        int tokenCapacity; //capacity of the token list
+        int nextToken; //index of the next token returned to the parser
+
+        Symbol *symbolTable; //declarations of the program
+        Node *syntaxTree; //statements of the program
+        Node *procedure; //procedure whose declarations and body are being parsed, NULL outside procedures
+
+        OperationTable operations; //operations built by the parse, released once the parse ends
+        OperationTable programOperations; //operations of the program while a procedure is parsed, whose operations are not shared with it
+
+    } ParseContext;
+
+}
+
+%code provides {
+
+    /**
+     * @brief a token lexed before the parse
+     */
+    typedef struct tagToken {
+
+        int type; //token type, 0 at the end of the input
+        YYSTYPE value; //semantic value
+        YYLTYPE location; //location in the source
+        int line; //line of the scanner once the token was read
+
+    } Token;
+
+    /**
+     * @brief the flex scanner. The parser reads it through yylex, which returns the start token and the token list of the context first
+     */
+    #define YY_DECL int scanToken( YYSTYPE *yylval_param , YYLTYPE *yylloc_param , void *yyscanner )
+
+    YY_DECL;
+
+    /**
+     * @brief line of the scanner of the current thread, the line of the nodes being built
+     */
+    extern _Thread_local int lexerLine;
+
+    /**
+     * @brief parses a sequence of statements without executing them. The symbols must already be declared in the table
+     * @param text source of the statements
+     * @param length length of the source
+     * @param line line of the first statement
+     * @param column column of the first statement
+     * @param table symbol table with the declarations of the program
+     * @return the statement tree, NULL if the source has no statements. Errors are added to the diagnostics
+     */
+    Node *parseStatements( const char *text , int length , int line , int column , Symbol *table );
+
+    /**
+     * @brief parses the header of a program, from program to begin, and builds its symbol table
+     * @param text source of the header
+     * @param length length of the source
+     * @return the symbol table with the declarations. Errors are added to the diagnostics
+     */
+    Symbol *parseDeclarations( const char *text , int length );
+
+    /**
+     * @brief lexes a complete program into the token list of a context. Errors are added to the diagnostics
+     * @param context context of the parse, zeroed
+     * @param text source of the program
+     * @param length length of the source
+     */
+    void lexProgram( ParseContext *context , const char *text , int length );
+
+    /**
+     * @brief parses and checks a program from the token list of a context, building its symbol table and tree without executing it.
+     * Errors are added to the diagnostics
+     * @param context context filled by lexProgram
+     */
+    void parseProgram( ParseContext *context );
+
+    /**
+     * @brief parses a program from memory with the statement stream, which executes every statement of the body as soon as it is
+     * parsed. Errors are added to the diagnostics
+     * @param context context of the parse, zeroed, whose arena is the arena of the current thread. Its symbol table keeps the
+     * values of the symbols once the program ends
+     * @param text source of the program
+     * @param length length of the source
+     */
+    void streamSource( ParseContext *context , const char *text , int length );
+
+}
+
 //Unite tokens from flex with bison using bison %union directive
 %union {
 
     int iValue;
     float fValue;
+    long long lValue;
+    double dValue;
     char *idValue;
     SymbolType sValue;
     Node *node;
@@ -45,11 +201,13 @@ extern int yyerror(char const *);
 
 /********** TOKEN TYPE DECLARATION **********/
 
-%token <iValue>  NUM
-%token <fValue>  NUMFLOAT
+%token <lValue>  NUM
+%token <dValue>  NUMFLOAT
 %token <idValue> ID
 %token <sValue>  INTEGER
 %token <sValue>  FLOAT
+%token <sValue>  LONG
+%token <sValue>  DOUBLE
 
 %token <node> SEMICOLON
 %token <node> ASSIGNMENT
@@ -78,6 +236,9 @@ extern int yyerror(char const *);
 %type <node> term
 %type <node> factor
 %type <node> expresion
+%type <node> procedure
+%type <node> opt_args
+%type <node> args
 
 
 %token PROGRAM
@@ -92,13 +253,70 @@ extern int yyerror(char const *);
 %token ENDFOR
 %token LPAREN
 %token RPAREN
+%token LBRACKET
+%token RBRACKET
+%token PROCEDURE
+%token COMMA
+%token START_HEADER
+%token START_STATEMENTS
+%token START_STREAM
 
-%start prog //starting point of the parser
+%start unit //starting point of the parser
 
 %%
 
+unit:         prog
+            | START_HEADER header
+            | START_STATEMENTS opt_stmts                                      { context->syntaxTree = $2; }
+            | START_STREAM stream
+            ;
+
+header:       PROGRAM ID opt_decls opt_procs P_BEGIN
+            ;
+
 prog:
-              PROGRAM ID opt_decls P_BEGIN opt_stmts END                      { syntaxTree = $5; resolveTree( syntaxTree, &symbolTable ); YYACCEPT;}
+              PROGRAM ID opt_decls opt_procs P_BEGIN opt_stmts END            { context->syntaxTree = $6; YYACCEPT; }
+            ;
+
+//the body of a streamed program is a left recursive list, so every statement is reduced as soon as it is parsed
+stream:       PROGRAM ID opt_decls opt_procs P_BEGIN                          { openStatementStream( &context->symbolTable ); }
+              opt_stream END                                                  { YYACCEPT; }
+            ;
+
+opt_stream:   stream_lst
+            | /*empty*/                                                       { }
+            ;
+
+stream_lst:   stream_lst SEMICOLON stream_stmt
+            | stream_stmt
+            ;
+
+stream_stmt:  stmt                                                            { releaseOperationTable( &context->operations ); streamStatement( $1 ); }
+            ;
+
+opt_procs:    procs
+            | /*empty*/                                                       { }
+            ;
+
+procs:        proc procs
+            | proc
+            ;
+
+proc:         procedure LPAREN opt_params RPAREN opt_decls P_BEGIN opt_stmts END { closeProcedure( $1 , $7 , &context->symbolTable ); leaveProcedure( context ); }
+            ;
+
+procedure:    PROCEDURE ID                                                    { $$ = enterProcedure( context , createProcedure( $2 , &context->symbolTable ) ); }
+            ;
+
+opt_params:   params
+            | /*empty*/                                                       { }
+            ;
+
+params:       param COMMA params
+            | param
+            ;
+
+param:        tipo ID                                                         { declareLocalSymbol( context->procedure , $2 , $1->symbolType , 1 , &context->symbolTable ); }
             ;
 
 opt_decls:  
@@ -110,46 +328,64 @@ decls:        dec SEMICOLON decls
             | dec
             ;
 
-dec:          tipo ID                                                         { insertSymbol( &symbolTable , $2 , $1->symbolType ); }
+dec:          tipo ID                                                         { if ( context->procedure != NULL ) declareLocalSymbol( context->procedure , $2 , $1->symbolType , 0 , &context->symbolTable );
+                                                                                else insertSymbol( &context->symbolTable , $2 , $1->symbolType ); }
+            | tipo ID LBRACKET NUM RBRACKET                                   { if ( context->procedure != NULL ) reportError( "Array %s cannot be declared inside procedure %s" , $2 , context->procedure->value.idValue );
+                                                                                else insertArraySymbol( &context->symbolTable , $2 , $1->symbolType , $4 <= INT_MAX ? (int) $4 : 0 ); }
+            | error                                                           { /*resynchronize at the next ; or begin*/ }
             ;
 
 tipo:         INTEGER                                                         { $$ = createSymbolType( $1 ); }
             | FLOAT                                                           { $$ = createSymbolType( $1 ); }
+            | LONG                                                            { $$ = createSymbolType( $1 ); }
+            | DOUBLE                                                          { $$ = createSymbolType( $1 ); }
             ;
 
-stmt:         ID ASSIGNMENT expr                                              { $$ = createAssignment( $1 , $3 , &symbolTable ); }
+stmt:         ID ASSIGNMENT expr                                              { $$ = createAssignment( SCOPE( $1 ) , $3 , &context->symbolTable ); }
+            | ID LBRACKET expr RBRACKET ASSIGNMENT expr                       { $$ = createArrayAssignment( SCOPE( $1 ) , $3 , $6 , &context->symbolTable ); }
             | IF expresion THEN opt_stmts ENDIF                               { $$ = createIfStatement( $2 , $4 ); }
             | WHILE expresion DO opt_stmts ENDW                               { $$ = createWhileStatement( $2 , $4 ); }
-            | FOR ID ASSIGNMENT expr STEP expr UNTIL expr DO opt_stmts ENDFOR { $$ = createForStatement( $2 , $4 , $6 , $8 , $10 ); }
-            | READ ID                                                         { $$ = createReadStatement( $2 ); }
+            | FOR ID ASSIGNMENT expr STEP expr UNTIL expr DO opt_stmts ENDFOR { $$ = createForStatement( SCOPE( $2 ) , $4 , $6 , $8 , $10 , &context->symbolTable ); }
+            | READ ID                                                         { $$ = createReadStatement( SCOPE( $2 ) , &context->symbolTable ); }
             | PRINT expr                                                      { $$ = createPrintStatement( $2 ); }
+            | ID LPAREN opt_args RPAREN                                       { $$ = createCallStatement( $1 , $3 , &context->symbolTable ); }
+            | error                                                           { $$ = NULL; /*resynchronize at the next ; endif, endw, endfor or end*/ }
             ;
 
 opt_stmts:    stmt_lst                                                        {$$ = $1; }
             | /*empty*/                                                       { $$ = NULL; }
             ;
 
-stmt_lst:     stmt SEMICOLON stmt_lst                                         { $$ = createSemiColon( $1 , $3 ); }
+stmt_lst:     stmt SEMICOLON stmt_lst                                         { $$ = $1 == NULL ? $3 : createSemiColon( $1 , $3 ); }
             | stmt                                                            { $$ = $1; }
             ;
 
-expr:         expr SUM term                                                   { $$ = createOperation( oSUM , $1 , $3); }
-            | expr SUB term                                                   { $$ = createOperation( oSUB , $1 , $3); }
-            | SUB term                                                        { $$ = createOperation( oMULT , createMinus( $2 ) , $2 ); }
+expr:         expr SUM term                                                   { $$ = createOperation( oSUM , $1 , $3 , &context->operations ); }
+            | expr SUB term                                                   { $$ = createOperation( oSUB , $1 , $3 , &context->operations ); }
+            | SUB term                                                        { $$ = createOperation( oMULT , createMinus( $2 ) , $2 , &context->operations ); }
             | term                                                            { $$ = $1; }
             ;
 
-term:         term MULT factor                                                { $$ = createOperation( oMULT , $1 , $3); }
-            | term DIV factor                                                 { $$ = createOperation( oDIV , $1 , $3); }
+term:         term MULT factor                                                { $$ = createOperation( oMULT , $1 , $3 , &context->operations ); }
+            | term DIV factor                                                 { $$ = createOperation( oDIV , $1 , $3 , &context->operations ); }
             | factor                                                          { $$ = $1; }
             ;
 
 factor:       LPAREN expr RPAREN                                              { $$ = $2; }
-            | ID                                                              { $$ = createSymbol( $1 , &symbolTable); }
-            | NUM                                                             { $$ = createInteger( $1 ); }
+            | ID                                                              { $$ = createSymbol( SCOPE( $1 ) , &context->symbolTable); }
+            | ID LBRACKET expr RBRACKET                                       { $$ = createArrayElement( SCOPE( $1 ) , $3 , &context->symbolTable ); }
+            | NUM                                                             { $$ = $1 <= INT_MAX ? createInteger( (int) $1 ) : createLong( $1 ); }
             | NUMFLOAT                                                        { $$ = createFloat( $1 ); }
             ;
 
+opt_args:     args                                                            { $$ = $1; }
+            | /*empty*/                                                       { $$ = NULL; }
+            ;
+
+args:         expr COMMA args                                                 { $$ = createArgument( $1 , $3 ); }
+            | expr                                                            { $$ = createArgument( $1 , NULL ); }
+            ;
+
 expresion:    expr LESS_THAN expr                                             { $$ = createExpresion( eLESS_THAN , $1 , $3); }
             | expr GREATER_THAN expr                                          { $$ = createExpresion( eGREATER_THAN , $1 , $3); }
             | expr EQUAL_TO expr                                              { $$ = createExpresion( eEQUAL_TO , $1 , $3 ); }
@@ -157,21 +393,740 @@ expresion:    expr LESS_THAN expr                                             {
 
 %%
 
-int yyerror( char const * s ) 
+/**
+ * @brief makes a procedure the scope of the declarations and statements that follow. Its operations are hash-consed apart from those
+ * of the program, so the checks the range analysis removes from the program are not removed from the procedure
+ * @return the procedure
+ */
+static Node *enterProcedure( ParseContext *context , Node *procedure ) {
+
+    context->procedure         = procedure;
+    context->programOperations = context->operations;
+
+    memset( &context->operations , 0 , sizeof( OperationTable ) );
+
+    return procedure;
+
+}
+
+/**
+ * @brief returns to the scope of the program once the body of a procedure is parsed
+ */
+static void leaveProcedure( ParseContext *context ) {
+
+    context->programOperations.shared += context->operations.shared;
+
+    releaseOperationTable( &context->operations );
+
+    context->procedure  = NULL;
+    context->operations = context->programOperations;
+
+}
+
+int yyerror( YYLTYPE *location , ParseContext *context , char const *message ) 
 {
-  fprintf( stderr, "%s\n", s );
-  exit(1);
+  //the input ended by the memory limit is not a syntax error, the limit was already reported
+  if ( !memoryLimitExceeded ) {
+    reportDiagnostic( location->first_line, location->first_column, "%s", message );
+  }
+  return 0;
+}
+
+/**
+ * @brief returns the pending start token, then the tokens of the token list if the program was lexed before the parse,
+ * or the tokens of the scanner otherwise
+ */
+static int yylex( YYSTYPE *value , YYLTYPE *location , ParseContext *context ) {
+
+    Token *token;
+
+    //a pending start token selects what the parser reads: a complete program, only the header or only statements
+    if ( context->startToken != 0 ) {
+
+        int startToken      = context->startToken;
+        context->startToken = 0;
+
+        return startToken;
+
+    }
+
+    //the memory limit ends the input, the rest of the program is not compiled
+    if ( memoryLimitExceeded ) {
+
+        return 0;
+
+    }
+
+    if ( context->tokens == NULL ) {
+
+        return context->cursor != NULL ? scanFastToken( value , location , context ) : scanToken( value , location , context->scanner );
+
+    }
+
+    //the end of the input is returned again if the parser asks for more tokens
+    token = &context->tokens[context->nextToken];
+
+    if ( context->nextToken + 1 < context->tokenCount ) {
+
+        context->nextToken++;
+
+    }
+
+    *value     = token->value;
+    *location  = token->location;
+    lexerLine  = token->line;
+
+    return token->type;
+
+}
+
+/**
+ * @brief creates the scanner of a context reading a source from memory
+ */
+static void openScanner( ParseContext *context , const char *text , int length , int line , int column ) {
+
+    context->column = column;
+
+    if ( fastScannerEnabled ) {
+
+        openFastScanner( context , text , length , line );
+
+        return;
+
+    }
+
+    yylex_init_extra( context , &context->scanner );
+    yy_scan_bytes( text , length , context->scanner );
+    yyset_lineno( line , context->scanner );
+
+    lexerLine = line;
+
+}
+
+/**
+ * @brief destroys the scanner of a context and its buffer
+ */
+static void closeScanner( ParseContext *context ) {
+
+    if ( context->scanner != NULL ) {
+
+        yylex_destroy( context->scanner );
+
+    }
+
+    context->scanner = NULL;
+    context->cursor  = NULL;
+
+}
+
+Node *parseStatements( const char *text , int length , int line , int column , Symbol *table ) {
+
+    ParseContext context = { 0 };
+
+    context.startToken  = START_STATEMENTS;
+    context.symbolTable = table;
+
+    openScanner( &context , text , length , line , column );
+
+    yyparse( &context );
+
+    closeScanner( &context );
+    releaseOperationTable( &context.operations );
+
+    return context.syntaxTree;
+
+}
+
+Symbol *parseDeclarations( const char *text , int length ) {
+
+    ParseContext context = { 0 };
+
+    context.startToken = START_HEADER;
+
+    openScanner( &context , text , length , 1 , 1 );
+
+    yyparse( &context );
+
+    closeScanner( &context );
+    releaseOperationTable( &context.operations );
+
+    return context.symbolTable;
+
+}
+
+void lexProgram( ParseContext *context , const char *text , int length ) {
+
+    Token *token;
+
+    openScanner( context , text , length , 1 , 1 );
+
+    do {
+
+        if ( context->tokenCount == context->tokenCapacity ) {
+
+            context->tokenCapacity = context->tokenCapacity == 0 ? 256 : 2 * context->tokenCapacity;
+            context->tokens        = realloc( context->tokens , context->tokenCapacity * sizeof( Token ) );
+
+            if ( context->tokens == NULL ) {
+
+                printf( "Error: Memory allocation failed. Program will be terminated\n" );
+                exit(1);
+
+            }
+        }
+
+        token = &context->tokens[context->tokenCount++];
+
+        //the end of the input sets no location, so it keeps the location of the previous token as it does when the parser reads the scanner
+        token->location = context->tokenCount > 1 ? token[-1].location : (YYLTYPE) { 1 , 1 , 1 , 1 };
+
+        token->type = memoryLimitExceeded ? 0 : context->cursor != NULL ? scanFastToken( &token->value , &token->location , context )
+                                                                        : scanToken( &token->value , &token->location , context->scanner );
+        token->line = lexerLine;
+
+    } while ( token->type != 0 );
+
+    closeScanner( context );
+
+}
+
+void parseProgram( ParseContext *context ) {
+
+    context->nextToken = 0;
+    lexerLine          = 1;
+
+    yyparse( context );
+
+    releaseOperationTable( &context->operations );
+
+}
+
+void streamSource( ParseContext *context , const char *text , int length ) {
+
+    context->startToken = START_STREAM;
+
+    openScanner( context , text , length , 1 , 1 );
+
+    yyparse( context );
+
+    //also when the parse stopped at an error, the statements already queued are executed
+    closeStatementStream();
+    closeScanner( context );
+    releaseOperationTable( &context->operations );
+
+}
+
+/**
+ * @brief parses a program from its file with the statement stream, which executes every statement of the body as soon as it is
+ * parsed. The file is read by the flex scanner a buffer at a time, so the program starts before the rest of the file is read
+ * @param context context of the parse, whose arena is the arena of the current thread
+ * @param fileName file of the program
+ * @return 1 if the file was parsed, 0 if it cannot be opened
+ */
+static int streamProgram( ParseContext *context , const char *fileName ) {
+
+    FILE *file = fopen( fileName , "r" );
+
+    if ( file == NULL ) {
+
+        return 0;
+
+    }
+
+    context->startToken = START_STREAM;
+
+    yylex_init_extra( context , &context->scanner );
+    yyset_in( file , context->scanner );
+
+    yyparse( context );
+
+    //also when the parse stopped at an error, the statements already queued are executed
+    closeStatementStream();
+    releaseOperationTable( &context->operations );
+
+    yylex_destroy( context->scanner );
+    context->scanner = NULL;
+
+    fclose( file );
+
+    return 1;
+
+}
+
+/**
+ * @brief reads a source file with a single read when its size is known, followed by the two null characters that let the scanner
+ * scan it in place
+ * @return the source, NULL if the file cannot be read
+ */
+static char *readSource( const char *fileName , size_t *length ) {
+
+    int descriptor = open( fileName , O_RDONLY );
+    struct stat status;
+    size_t capacity;
+    ssize_t count;
+    char *source;
+
+    if ( descriptor < 0 ) {
+
+        return NULL;
+
+    }
+
+    //one byte more than the size, so the read that finds the end of the file does not need a larger buffer
+    capacity = fstat( descriptor , &status ) == 0 && status.st_size > 0 ? (size_t) status.st_size + 3 : 4096;
+    source   = malloc( capacity );
+    *length  = 0;
+
+    while ( source != NULL && ( count = read( descriptor , source + *length , capacity - 2 - *length ) ) > 0 ) {
+
+        *length += count;
+
+        if ( *length + 2 == capacity ) {
+
+            capacity *= 2;
+            source    = realloc( source , capacity );
+
+        }
+    }
+
+    close( descriptor );
+
+    if ( source == NULL ) {
+
+        printf( "Error: Memory allocation failed. Program will be terminated\n" );
+        exit(1);
+
+    }
+
+    source[*length]     = '\0';
+    source[*length + 1] = '\0';
+
+    return source;
+
+}
+
+static Arena programArena; //nodes, symbols and identifiers of the program executed by main
+
+static char *programSource = NULL; //source of the program executed by main
+
+static char **programFileNames = NULL; //files named by the arguments
+
+/**
+ * @brief releases the program executed by main, after the handlers that read it at exit, such as the one writing the profile
+ */
+static void releaseProgram() {
+
+    //a statement that failed on the thread of the stream exits while the parser may still read the symbols of the program
+    if ( isStatementStreamOpen() ) {
+
+        return;
+
+    }
+
+    currentArena = NULL;
+
+    releaseArena( &programArena );
+
+    free( programSource );
+    free( programFileNames );
+
 }
 
 int main( int argc, char **argv ) {
 
-    extern FILE * yyin;
+    static ParseContext context; //the profile written at exit keeps the address of its symbol table
+    char *source;
+    size_t length;
+    char **fileNames = programFileNames = calloc( argc , sizeof( char * ) );
+    char *fileName;
+    int fileCount = 0;
+    int jobs = 0;
+    int incrementalBench = 0;
+    int sessionBench = 0;
+    int unrollBench = 0;
+    int differentialCount = 0;
+    unsigned long long differentialSeed = 1;
+    int scannerDifferentialCount = 0;
+    unsigned long long scannerSeed = 1;
+    int startupBench = 0;
+    char *decodedTrace = NULL;
+    char *batchFile = NULL;
+    int batchFailures = 0;
+    char *nativeFile = NULL;
+    const char *wholeProgramOption = NULL; //option that needs the tree of the whole program, which the stream never builds
+    int traceSummary = 0;
+    int eliminated = 0;
+    int argument;
+
+    //registered first, so it runs after every handler registered by the options
+    atexit( releaseProgram );
+
+    for ( argument = 1 ; argument < argc ; argument++ ) {
+
+        if ( strcmp( argv[argument] , "--scalar" ) == 0 ) { //disables the vectorized execution of for loops
+
+            vectorLoopEnabled = 0;
+
+        } else if ( strcmp( argv[argument] , "--bounds-check" ) == 0 ) { //verifies array indexes at run time
+
+            boundsCheckEnabled = 1;
+
+        } else if ( strcmp( argv[argument] , "--trap-overflow" ) == 0 ) { //terminates the program on integer and long overflows
+
+            overflowTrapEnabled = 1;
+
+        } else if ( strcmp( argv[argument] , "--no-cse" ) == 0 ) { //evaluates every operation, even if its value was already computed
+
+            valueNumberingEnabled = 0;
+
+        } else if ( strcmp( argv[argument] , "--cse-report" ) == 0 ) { //reports the operations shared by the parse and eliminated by the value numbering
+
+            valueNumberingReportEnabled = 1;
+
+        } else if ( strcmp( argv[argument] , "--no-propagation" ) == 0 ) { //reads every symbol and tests every condition, even if their values are known
+
+            constantPropagationEnabled = 0;
+
+        } else if ( strcmp( argv[argument] , "--propagation-report" ) == 0 ) { //reports the constants propagated, the copies forwarded and the branches removed
+
+            constantPropagationReportEnabled = 1;
+
+        } else if ( strcmp( argv[argument] , "--no-inline" ) == 0 ) { //executes every call with a frame, even the calls of small procedures
+
+            inliningEnabled = 0;
+
+        } else if ( strcmp( argv[argument] , "--inline-report" ) == 0 ) { //reports the size of the procedures and the calls inlined and kept
+
+            inliningReportEnabled = 1;
+
+        } else if ( strcmp( argv[argument] , "--no-unroll" ) == 0 ) { //executes for loops one iteration per test and if statements with branches
+
+            unrollingEnabled = 0;
+
+        } else if ( strcmp( argv[argument] , "--unroll-report" ) == 0 ) { //reports the loops unrolled and the if statements converted to selects
+
+            unrollingReportEnabled = 1;
+
+        } else if ( strcmp( argv[argument] , "--fast-scanner" ) == 0 ) { //reads the sources with the hand-written scanner instead of the flex scanner
+
+            fastScannerEnabled = 1;
+
+        } else if ( strcmp( argv[argument] , "--stream" ) == 0 ) { //executes every statement of the program as soon as it is parsed and releases it
+
+            streamingEnabled = 1;
+
+        } else if ( strncmp( argv[argument] , "--stream-queue=" , 15 ) == 0 ) { //streams the program, executing the statements on a thread of their own up to count statements behind the parser
+
+            streamingEnabled    = 1;
+            streamQueueCapacity = atoi( argv[argument] + 15 );
+
+        } else if ( strcmp( argv[argument] , "--range-report" ) == 0 ) { //lists the run-time checks the range analysis could not remove
+
+            rangeReportEnabled = 1;
+
+        } else if ( strcmp( argv[argument] , "--metrics=prometheus" ) == 0 ) { //dumps the counters of the interpreter at exit and on SIGUSR1
+
+            exportMetrics( mPROMETHEUS );
+
+        } else if ( strcmp( argv[argument] , "--metrics=json" ) == 0 ) {
+
+            exportMetrics( mJSON );
+
+        } else if ( strncmp( argv[argument] , "--memory-limit=" , 15 ) == 0 ) { //stops the compilation when the memory in use goes over bytes[k|m|g]
+
+            char *unit;
+
+            memoryLimit = strtoull( argv[argument] + 15 , &unit , 10 );
+
+            switch ( *unit ) {
+
+                case 'g': case 'G': memoryLimit <<= 10; //fall through
+                case 'm': case 'M': memoryLimit <<= 10; //fall through
+                case 'k': case 'K': memoryLimit <<= 10; break;
+
+            }
+
+        } else if ( strncmp( argv[argument] , "--snapshot=" , 11 ) == 0 ) { //SIGTERM writes a snapshot and terminates, SIGUSR2 writes a snapshot and continues
+
+            enableSnapshots( argv[argument] + 11 );
+            wholeProgramOption = "--snapshot";
+
+        } else if ( strncmp( argv[argument] , "--resume=" , 9 ) == 0 ) { //continues the execution saved in a snapshot
+
+            enableResume( argv[argument] + 9 );
+            wholeProgramOption = "--resume";
+
+        } else if ( strncmp( argv[argument] , "--profile-generate=" , 19 ) == 0 ) { //records branch outcomes, loop iterations and symbol lookups and values
+
+            enableProfileRecording( argv[argument] + 19 );
+            wholeProgramOption = "--profile-generate";
+
+        } else if ( strncmp( argv[argument] , "--profile-use=" , 14 ) == 0 ) { //optimizes the program with a recorded profile
+
+            enableProfileUse( argv[argument] + 14 );
+            wholeProgramOption = "--profile-use";
+
+        } else if ( strncmp( argv[argument] , "--trace=" , 8 ) == 0 ) { //writes every assignment and condition of the execution to a binary log
+
+            enableTrace( argv[argument] + 8 );
+            wholeProgramOption = "--trace";
+
+        } else if ( strncmp( argv[argument] , "--trace-decode=" , 15 ) == 0 ) { //prints every record of a trace instead of executing a file
+
+            decodedTrace = argv[argument] + 15;
+            traceSummary = 0;
+
+        } else if ( strncmp( argv[argument] , "--trace-summary=" , 16 ) == 0 ) { //prints the records of a trace by statement and by symbol instead of executing a file
+
+            decodedTrace = argv[argument] + 16;
+            traceSummary = 1;
+
+        } else if ( strncmp( argv[argument] , "--batch=" , 8 ) == 0 ) { //executes the program once for every line of a file, all the records in one vectorized pass
+
+            batchFile          = argv[argument] + 8;
+            wholeProgramOption = "--batch";
+
+        } else if ( strncmp( argv[argument] , "--emit-native=" , 14 ) == 0 ) { //writes the program as a static x86-64 executable instead of executing it
+
+            nativeFile         = argv[argument] + 14;
+            wholeProgramOption = "--emit-native";
+
+        } else if ( strcmp( argv[argument] , "--incremental-bench" ) == 0 ) { //measures the recompilation of edited statements instead of executing
+
+            incrementalBench = 1;
+
+        } else if ( strncmp( argv[argument] , "--differential=" , 15 ) == 0 ) { //compares the engines on count[:seed] random programs instead of executing a file
+
+            char *seed = strchr( argv[argument] , ':' );
+
+            differentialCount = atoi( argv[argument] + 15 );
+
+            if ( seed != NULL ) {
+
+                differentialSeed = strtoull( seed + 1 , NULL , 10 );
+
+            }
+
+        } else if ( strncmp( argv[argument] , "--scanner-differential=" , 23 ) == 0 ) { //compares the scanners on count[:seed] random sources instead of executing a file
+
+            char *seed = strchr( argv[argument] , ':' );
+
+            scannerDifferentialCount = atoi( argv[argument] + 23 );
+
+            if ( seed != NULL ) {
+
+                scannerSeed = strtoull( seed + 1 , NULL , 10 );
+
+            }
+
+        } else if ( strncmp( argv[argument] , "--session-bench=" , 16 ) == 0 ) { //executes the program as many sessions in one thread instead of executing it once
+
+            sessionBench = atoi( argv[argument] + 16 );
+
+        } else if ( strncmp( argv[argument] , "--unroll-bench=" , 15 ) == 0 ) { //compares the branch misses of the program rolled and unrolled over as many runs instead of executing it
+
+            unrollBench = atoi( argv[argument] + 15 );
+
+        } else if ( strncmp( argv[argument] , "--startup-bench=" , 16 ) == 0 ) { //measures the time to the first print of a trivial program over as many runs
+
+            startupBench = atoi( argv[argument] + 16 );
+
+        } else if ( strncmp( argv[argument] , "--jobs=" , 7 ) == 0 ) { //lexes, parses and checks the files on as many threads instead of executing them
+
+            jobs = atoi( argv[argument] + 7 );
+
+        } else {
+
+            fileNames[fileCount++] = argv[argument];
+
+        }
+    }
+
+    if ( differentialCount > 0 ) {
+
+        return runDifferentialTests( differentialCount , differentialSeed ) > 0;
+
+    }
+
+    if ( scannerDifferentialCount > 0 ) {
+
+        return runScannerDifferential( scannerDifferentialCount , scannerSeed ) > 0;
+
+    }
+
+    if ( startupBench > 0 ) {
+
+        return benchmarkStartup( startupBench ) == 0;
+
+    }
+
+    if ( decodedTrace != NULL ) {
+
+        return decodeTrace( decodedTrace , traceSummary ) == 0;
+
+    }
+
+    if ( fileCount == 0 ) {
+
+        fprintf( stderr, "Usage: %s [--scalar] [--bounds-check] [--trap-overflow] [--no-cse] [--cse-report] [--no-propagation] [--propagation-report] [--no-inline] [--inline-report] [--no-unroll] [--unroll-report] [--fast-scanner] [--stream] [--stream-queue=count] [--range-report] [--metrics=prometheus|json] [--memory-limit=bytes[k|m|g]] [--snapshot=file] [--resume=file] [--profile-generate=file] [--profile-use=file] [--trace=file] [--trace-decode=file] [--trace-summary=file] [--batch=file] [--emit-native=file] [--incremental-bench] [--session-bench=count] [--unroll-bench=count] [--differential=count[:seed]] [--scanner-differential=count[:seed]] [--startup-bench=count] [--jobs=count] file...\n" , argv[0] );
+        return 1;
+
+    }
+
+    //many files are only compiled, in parallel
+    if ( fileCount > 1 || jobs > 0 ) {
+
+        return runFrontEnd( fileNames , fileCount , jobs ) > 0;
+
+    }
+
+    fileName = fileNames[0];
+
+    //the statements are executed while the file is parsed, the whole program is never read nor built
+    if ( streamingEnabled ) {
+
+        if ( wholeProgramOption != NULL ) {
+
+            fprintf( stderr, "Error: %s needs the whole program and cannot be combined with --stream\n" , wholeProgramOption );
+            return 1;
+
+        }
+
+        context.column = 1;
+        currentArena   = &programArena;
+
+        if ( !streamProgram( &context , fileName ) ) {
+
+            fprintf( stderr, "Error: cannot open %s\n" , fileName );
+            return 1;
+
+        }
+
+        return printDiagnostics( stderr ) > 0;
+
+    }
+
+    source   = programSource = readSource( fileName , &length );
+
+    if ( source == NULL ) {
+
+        fprintf( stderr, "Error: cannot open %s\n" , fileName );
+        return 1;
+
+    }
+
+    if ( incrementalBench ) {
+
+        benchmarkIncrementalProgram( source , length );
+
+        return printDiagnostics( stderr ) > 0;
+
+    }
+
+    if ( sessionBench > 0 ) {
+
+        benchmarkSessions( source , length , sessionBench );
+
+        return printDiagnostics( stderr ) > 0;
+
+    }
+
+    if ( unrollBench > 0 ) {
+
+        int same = benchmarkUnrolling( source , length , unrollBench );
+
+        return printDiagnostics( stderr ) > 0 || !same;
+
+    }
+
+    context.column = 1;
+    currentArena   = &programArena;
+
+    //the source is scanned in place, the scanner allocates no input buffer and never reads the file
+    if ( fastScannerEnabled ) {
+
+        openFastScanner( &context , source , length , 1 );
+
+    } else {
+
+        yylex_init_extra( &context , &context.scanner );
+        yy_scan_buffer( source , length + 2 , context.scanner );
+
+    }
+
+    //the program is executed only if it has no errors
+    if ( yyparse( &context ) == 0 && diagnosticCount == 0 ) {
+
+        if ( inliningEnabled ) {
+
+            inlineProcedures( context.syntaxTree , &context.symbolTable );
+
+        }
+
+        //after the inlining, which exposes the constant arguments of the calls
+        if ( constantPropagationEnabled ) {
+
+            propagateConstants( &context.syntaxTree , &context.symbolTable );
+
+        }
+
+        prepareProfile( context.syntaxTree , &context.symbolTable );
+        prepareTrace( context.syntaxTree , &context.symbolTable );
+        analyzeRanges( context.syntaxTree , &context.symbolTable );
+
+        if ( valueNumberingEnabled ) {
+
+            eliminated = eliminateCommonSubexpressions( context.syntaxTree , &context.symbolTable );
+
+        }
+
+        if ( valueNumberingReportEnabled ) {
+
+            fprintf( stderr , "%s: %d operations shared by the parse, %d operations eliminated by the value numbering\n" , fileName ,
+                     context.operations.shared , eliminated );
+
+        }
+
+        //after the range analysis, which proves the divisions the if-conversion may evaluate unconditionally
+        if ( unrollingEnabled ) {
+
+            unrollLoops( context.syntaxTree , &context.symbolTable );
+
+        }
+
+        releaseOperationTable( &context.operations );
+
+        //the optimizations may go over the memory limit too, the error is reported with the others
+        if ( !memoryLimitExceeded && nativeFile != NULL ) {
+
+            emitNativeExecutable( context.syntaxTree , &context.symbolTable , nativeFile );
+
+        } else if ( !memoryLimitExceeded && batchFile != NULL ) {
+
+            batchFailures = resolveBatch( context.syntaxTree , &context.symbolTable , batchFile , programOutput != NULL ? programOutput : stdout );
+
+            if ( batchFailures < 0 ) {
+
+                fprintf( stderr, "Error: cannot open %s\n" , batchFile );
+
+            }
+
+        } else if ( !memoryLimitExceeded ) {
+
+            resolveProgram( context.syntaxTree , &context.symbolTable );
+
+        }
+
+    }
+
+    if ( context.scanner != NULL ) {
+
+        yylex_destroy( context.scanner );
 
-    yyin = fopen( argv[1], "r" );
+    }
 
-    yyparse();
 
-    return 0;
+    return printDiagnostics( stderr ) > 0 || batchFailures != 0; //every error of the program is reported at once
 
     //end main
 }
@@ -0,0 +1,400 @@
+/**
+ * profile.c
+ * Implementation of the recording and use of execution profiles
+ *
+ * A profile is a text file with a header line "slcprofile <hash of the program>" followed by one line per record:
+ *   symbol <identifier> <lookups> <assignments> <lowest value> <highest value>
+ *   if <position> <executions> <times the condition was true>
+ *   while <position> <executions> <iterations>
+ *   for <position> <executions> <iterations>
+ * where the position is the pre-order number of the statement
+ *
+ * Using a profile:
+ *   reorders the symbol table so the symbols looked up most often are found first
+ *   marks the for and while loops that run fewer than PROFILE_COLD_LOOP_TRIPS iterations per execution. A cold for loop skips the
+ *   vectorized path, the unrolling and the hoisting of bounds checks, and the if statements of a cold loop are not converted to selects
+ *   marks the if statements whose condition has the same outcome in PROFILE_BIASED_PERCENT of their executions, which keep their branch
+ *   instead of being converted to selects: the branch is predicted well and the select would evaluate the value every time
+ *   gives the range analysis the range of values of every symbol, tried before the range of the type when an interval keeps growing
+ *   in a loop. The range is kept only if the loop never takes the symbol out of it, so the proofs hold for every input
+ * @author Jose Pablo Ortiz Lack
+ */
+#include "profile.h"
+#include "snapshot.h"
+#include "vectorLoop.h"
+#include "unrolling.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+
+static const char *recordFile = NULL; //file where the profile is recorded, NULL if no profile is recorded
+
+static const char *useFile = NULL; //file of the profile used to optimize the program, NULL if no profile is used
+
+static Node **profiledStatements = NULL; //statements of the program indexed by position
+
+static int profiledCount = 0; //number of statements of the program
+
+static Symbol **profiledSymbols = NULL; //symbol table of the program
+
+static uint64_t profiledHash; //hash of the program
+
+/**
+ * @brief the range of values a symbol was assigned in the run that recorded the profile being used
+ */
+typedef struct tagProfiledRange {
+
+    Symbol *symbol; //symbol of the slot, NULL if the profile recorded no value for it
+    double low; //lowest value assigned
+    double high; //highest value assigned
+
+} ProfiledRange;
+
+static ProfiledRange *profiledRanges = NULL; //ranges of the symbols of the program indexed by slot, NULL if no profile is used
+
+static int profiledRangeCount = 0; //number of entries of profiledRanges
+
+/**
+ * @brief symbol of the table and the lookups the profile recorded for it
+ */
+typedef struct tagSymbolLookups {
+
+    Symbol *symbol;
+    unsigned long long lookups;
+    int order; //position in the table before it was sorted
+
+} SymbolLookups;
+
+/**
+ * @brief allocates zeroed memory for the profile
+ */
+static void *allocateProfileMemory( size_t count , size_t size ) {
+
+    void *memory = calloc( count > 0 ? count : 1 , size );
+
+    if ( memory == NULL ) {
+
+        printf( "Error: Memory allocation failed. Program will be terminated\n" );
+        exit(1);
+
+    }
+
+    return memory;
+}
+
+/**
+ * @brief writes the recorded profile when the program exits
+ */
+static void writeProfile() {
+
+    FILE *file = fopen( recordFile , "w" );
+    Symbol *symbol;
+    int position;
+
+    if ( file == NULL ) {
+
+        fprintf( stderr , "Error: Cannot write profile %s\n" , recordFile );
+        return;
+
+    }
+
+    fprintf( file , "slcprofile %016llx\n" , (unsigned long long) profiledHash );
+
+    for ( symbol = *profiledSymbols ; symbol != NULL ; symbol = symbol->next ) {
+
+        fprintf( file , "symbol %s %llu %llu %.17g %.17g\n" , symbol->identifier , symbol->profile->lookups , symbol->profile->assignments ,
+                 symbol->profile->low , symbol->profile->high );
+
+    }
+
+    for ( position = 0 ; position < profiledCount ; position++ ) {
+
+        Node *statement = profiledStatements[position];
+
+        switch ( statement->type ) {
+
+            case nIF:
+
+                fprintf( file , "if %d %llu %llu\n" , position , statement->profile->executions , statement->profile->outcomes );
+
+            break;
+
+            case nWHILE:
+
+                fprintf( file , "while %d %llu %llu\n" , position , statement->profile->executions , statement->profile->outcomes );
+
+            break;
+
+            case nFOR: //the iterations are the executions of the body
+
+                fprintf( file , "for %d %llu %llu\n" , position , statement->profile->executions ,
+                         statement->doOptStmts != NULL ? statement->doOptStmts->profile->executions : 0 );
+
+            break;
+
+            default:
+
+            break;
+
+        }
+    }
+
+    fclose( file );
+
+}
+
+/**
+ * @brief orders symbols by lookups, most looked up first, keeping the order of the table between symbols with the same lookups
+ */
+static int compareLookups( const void *left , const void *right ) {
+
+    const SymbolLookups *leftSymbol  = left;
+    const SymbolLookups *rightSymbol = right;
+
+    if ( leftSymbol->lookups != rightSymbol->lookups ) {
+
+        return leftSymbol->lookups > rightSymbol->lookups ? -1 : 1;
+
+    }
+
+    return leftSymbol->order - rightSymbol->order;
+
+}
+
+/**
+ * @brief reads a profile and optimizes the program with it
+ */
+static void useProfile( Symbol **symbolTable ) {
+
+    FILE *file = fopen( useFile , "r" );
+    unsigned long long hash;
+    char kind[16];
+    SymbolLookups *lookups;
+    Symbol *symbol;
+    int symbolCount = 0;
+    int index;
+
+    if ( file == NULL ) {
+
+        fprintf( stderr , "Warning: Cannot open profile %s, the program is not optimized\n" , useFile );
+        return;
+
+    }
+
+    if ( fscanf( file , "slcprofile %llx" , &hash ) != 1 || hash != profiledHash ) {
+
+        fprintf( stderr , "Warning: Profile %s was not recorded from this program, the program is not optimized\n" , useFile );
+        fclose( file );
+        return;
+
+    }
+
+    for ( symbol = *symbolTable ; symbol != NULL ; symbol = symbol->next ) {
+
+        symbolCount++;
+
+    }
+
+    lookups            = allocateProfileMemory( symbolCount , sizeof( SymbolLookups ) );
+    profiledRanges     = allocateProfileMemory( symbolCount , sizeof( ProfiledRange ) );
+    profiledRangeCount = symbolCount;
+
+    for ( symbol = *symbolTable , index = 0 ; symbol != NULL ; symbol = symbol->next , index++ ) {
+
+        lookups[index].symbol = symbol;
+        lookups[index].order  = index;
+
+    }
+
+    while ( fscanf( file , "%15s" , kind ) == 1 ) {
+
+        if ( strcmp( kind , "symbol" ) == 0 ) {
+
+            char identifier[256];
+            unsigned long long symbolLookups;
+            unsigned long long assignments;
+            double low;
+            double high;
+
+            if ( fscanf( file , "%255s %llu %llu %lf %lf" , identifier , &symbolLookups , &assignments , &low , &high ) != 5 ) {
+
+                break;
+
+            }
+
+            for ( index = 0 ; index < symbolCount ; index++ ) {
+
+                Symbol *candidate = lookups[index].symbol;
+
+                if ( strcmp( candidate->identifier , identifier ) == 0 ) {
+
+                    lookups[index].lookups = symbolLookups;
+
+                    //the symbols start at 0, so the range of a symbol that was never assigned is 0
+                    if ( assignments == 0 ) {
+
+                        low  = 0;
+                        high = 0;
+
+                    }
+
+                    if ( candidate->length == 0 && isfinite( low ) && isfinite( high ) && candidate->slot < profiledRangeCount ) {
+
+                        profiledRanges[candidate->slot].symbol = candidate;
+                        profiledRanges[candidate->slot].low    = low;
+                        profiledRanges[candidate->slot].high   = high;
+
+                    }
+                }
+            }
+
+        } else {
+
+            int position;
+            unsigned long long executions;
+            unsigned long long outcomes;
+            Node *statement;
+
+            if ( fscanf( file , "%d %llu %llu" , &position , &executions , &outcomes ) != 3 ) {
+
+                break;
+
+            }
+
+            if ( position < 0 || position >= profiledCount || executions == 0 ) {
+
+                continue;
+
+            }
+
+            statement = profiledStatements[position];
+
+            if ( strcmp( kind , "if" ) == 0 && statement->type == nIF ) {
+
+                statement->biasedBranch = 100 * outcomes >= PROFILE_BIASED_PERCENT * executions ||
+                                          100 * ( executions - outcomes ) >= PROFILE_BIASED_PERCENT * executions;
+
+            } else if ( ( strcmp( kind , "for" ) == 0 && statement->type == nFOR ) || ( strcmp( kind , "while" ) == 0 && statement->type == nWHILE ) ) {
+
+                statement->coldLoop = outcomes < PROFILE_COLD_LOOP_TRIPS * executions;
+
+            }
+        }
+    }
+
+    fclose( file );
+
+    //the lookups walk the table from its head, so the symbols used most are placed first
+    qsort( lookups , symbolCount , sizeof( SymbolLookups ) , compareLookups );
+
+    for ( index = symbolCount - 1 ; index >= 0 ; index-- ) {
+
+        lookups[index].symbol->next = index + 1 < symbolCount ? lookups[index + 1].symbol : NULL;
+
+    }
+
+    if ( symbolCount > 0 ) {
+
+        *symbolTable = lookups[0].symbol;
+
+    }
+
+    free( lookups );
+
+}
+
+void enableProfileRecording( const char *fileName ) {
+
+    recordFile = fileName;
+
+    vectorLoopEnabled = 0;
+    unrollingEnabled  = 0;
+
+}
+
+void enableProfileUse( const char *fileName ) {
+
+    useFile = fileName;
+
+}
+
+void prepareProfile( Node *tree , Symbol **symbolTable ) {
+
+    Symbol *symbol;
+    int position;
+
+    if ( tree == NULL || ( recordFile == NULL && useFile == NULL ) ) {
+
+        return;
+
+    }
+
+    profiledCount      = numberStatements( tree , 0 );
+    profiledStatements = allocateProfileMemory( profiledCount , sizeof( Node * ) );
+    profiledSymbols    = symbolTable;
+    profiledHash       = hashProgram( tree , symbolTable );
+
+    collectStatements( tree , profiledStatements );
+
+    if ( useFile != NULL ) {
+
+        useProfile( symbolTable );
+
+    }
+
+    if ( recordFile != NULL ) {
+
+        for ( position = 0 ; position < profiledCount ; position++ ) {
+
+            profiledStatements[position]->profile = allocateProfileMemory( 1 , sizeof( NodeProfile ) );
+
+        }
+
+        for ( symbol = *symbolTable ; symbol != NULL ; symbol = symbol->next ) {
+
+            symbol->profile = allocateProfileMemory( 1 , sizeof( SymbolProfile ) );
+
+        }
+
+        atexit( writeProfile );
+
+    }
+}
+
+int getProfiledRange( Symbol *symbol , double *low , double *high ) {
+
+    if ( symbol->slot < 0 || symbol->slot >= profiledRangeCount || profiledRanges[symbol->slot].symbol != symbol ) {
+
+        return 0;
+
+    }
+
+    *low  = profiledRanges[symbol->slot].low;
+    *high = profiledRanges[symbol->slot].high;
+
+    return 1;
+
+}
+
+void recordSymbolValue( SymbolProfile *profile , double value ) {
+
+    if ( profile->assignments == 0 || value < profile->low ) {
+
+        profile->low = value;
+
+    }
+
+    if ( profile->assignments == 0 || value > profile->high ) {
+
+        profile->high = value;
+
+    }
+
+    profile->assignments++;
+
+}
+
+//end profile.c
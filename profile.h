@@ -0,0 +1,94 @@
+/**
+ * profile.h
+ * Definition of the execution profiles: branch outcomes, loop trip counts and symbol lookups and values recorded by one run of a program
+ * and used to optimize the following runs
+ * @author Jose Pablo Ortiz Lack
+ */
+#ifndef __PROFILE_H__
+#define __PROFILE_H__
+
+#include "symbolTable.h"
+#include "syntaxTree.h"
+
+/**
+ * @brief a for or while loop that runs fewer iterations than this per execution, on average, is not specialized
+ */
+#define PROFILE_COLD_LOOP_TRIPS 4
+
+/**
+ * @brief an if statement whose condition has the same outcome in at least this percentage of its executions keeps its branch
+ */
+#define PROFILE_BIASED_PERCENT 90
+
+/**
+ * @brief the counters of a statement
+ */
+typedef struct tagNodeProfile {
+
+    unsigned long long executions; //times the statement was resolved
+    unsigned long long outcomes; //times the condition of an if or while statement was true
+
+} NodeProfile;
+
+/**
+ * @brief the counters of a symbol
+ */
+typedef struct tagSymbolProfile {
+
+    unsigned long long lookups; //times the symbol was found in the symbol table
+    unsigned long long assignments; //values assigned to the symbol or to its elements
+
+    double low; //lowest value assigned
+    double high; //highest value assigned
+
+} SymbolProfile;
+
+/**
+ * @brief counts a lookup of a symbol that is being profiled
+ */
+#define PROFILE_LOOKUP( symbol ) ( ( symbol )->profile != NULL ? (void) ( symbol )->profile->lookups++ : (void) 0 )
+
+/**
+ * @brief records a value assigned to a symbol that is being profiled
+ */
+#define PROFILE_VALUE( symbol , newValue ) ( ( symbol )->profile != NULL ? recordSymbolValue( ( symbol )->profile , (double) ( newValue ) ) : (void) 0 )
+
+/**
+ * @brief records the profile of the program in a file when it exits. For loops are executed by the scalar path, so every iteration is counted
+ * @param fileName file of the profile
+ */
+void enableProfileRecording( const char *fileName );
+
+/**
+ * @brief makes the program be optimized with a profile recorded by a previous run
+ * @param fileName file of the profile
+ */
+void enableProfileUse( const char *fileName );
+
+/**
+ * @brief attaches the counters to the statements and symbols of a program if a profile is recorded, or optimizes the program if a profile is used.
+ * A profile recorded from a different program is ignored with a warning
+ * @param tree tree of the program
+ * @param symbolTable the symbolTable of the compiler
+ */
+void prepareProfile( Node *tree , Symbol **symbolTable );
+
+/**
+ * @brief obtains the range of values a symbol was assigned in the run that recorded the profile being used
+ * @param symbol symbol of the program the profile is used for, the symbols of other programs have no range
+ * @param low set to the lowest value assigned
+ * @param high set to the highest value assigned
+ * @return 1 if the profile has a range for the symbol, 0 otherwise
+ */
+int getProfiledRange( Symbol *symbol , double *low , double *high );
+
+/**
+ * @brief adds a value to the range of values of a symbol
+ * @param profile counters of the symbol
+ * @param value value assigned
+ */
+void recordSymbolValue( SymbolProfile *profile , double value );
+
+#endif //__PROFILE_H__
+
+//end profile.h
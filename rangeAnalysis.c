@@ -0,0 +1,876 @@
+/**
+ * rangeAnalysis.c
+ * Implementation of the interval analysis that proves run-time checks unnecessary
+ * @author Jose Pablo Ortiz Lack
+ */
+#include "rangeAnalysis.h"
+#include "syntaxTree.h"
+#include "symbolTable.h"
+#include "profile.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <math.h>
+#include <float.h>
+#include <limits.h>
+
+/**
+ * @brief number of loop iterations analyzed before the growing intervals are widened to the range of their type
+ */
+#define RANGE_WIDENING_ITERATIONS 3
+
+/**
+ * @brief largest integer a double represents exactly, long intervals beyond it are not trusted
+ */
+#define RANGE_EXACT_DOUBLE 9007199254740992.0
+
+int rangeReportEnabled = 0;
+
+/**
+ * @brief a check that could not be proven, kept to report why
+ */
+typedef struct tagRemainingCheck {
+
+    Node *node; //for statement or division
+    CheckType check; //check that remains
+    Interval interval; //interval of the value that made the proof fail
+
+} RemainingCheck;
+
+/**
+ * @brief the state shared by the analysis functions
+ */
+typedef struct tagRangeContext {
+
+    Symbol **symbolTable; //the symbolTable of the compiler
+
+    Symbol **symbols; //symbols of the table indexed by slot
+    int symbolCount; //number of symbols
+
+    RemainingCheck *remaining; //checks that could not be proven
+    int remainingCount; //number of checks that could not be proven
+    int remainingCapacity; //capacity of the remaining list
+
+    int profiledWidenings; //intervals widened to the range a profile recorded instead of the range of their type
+
+} RangeContext;
+
+/**
+ * @brief Allocates memory for the analysis
+ * @param size number of bytes
+ * @return the memory, the program will terminate if there is not enough memory
+ */
+static void *allocateRangeMemory( size_t size ) {
+
+    void *memory = calloc( 1 , size > 0 ? size : 1 );
+
+    if ( memory == NULL ) {
+
+        printf( "Error: Memory allocation failed. Program will be terminated\n" );
+        exit(1);
+
+    }
+
+    return memory;
+}
+
+/**
+ * @brief obtains the range of every value of a type
+ */
+static Interval typeRange( SymbolType symbolType ) {
+
+    Interval range = { 0 , 0 , 0 };
+
+    switch ( symbolType ) {
+
+        case sINTEGER:
+
+            range.low  = INT_MIN;
+            range.high = INT_MAX;
+
+        break;
+
+        case sLONG:
+
+            range.low  = (double) LLONG_MIN;
+            range.high = (double) LLONG_MAX;
+
+        break;
+
+        default:
+
+            range.low            = -INFINITY;
+            range.high           = INFINITY;
+            range.mayBeNonFinite = 1;
+
+        break;
+
+    }
+
+    return range;
+}
+
+/**
+ * @brief creates the interval of a single value
+ */
+static Interval singleValue( double value ) {
+
+    Interval interval = { value , value , 0 };
+
+    return interval;
+}
+
+/**
+ * @brief adjusts an interval computed with double arithmetic to the values the type can actually take.
+ * Integer results that leave the range of the type wrap around, so they take the whole range. Float results are widened by
+ * the rounding error and become possibly infinite when they leave the range of the type
+ */
+static Interval normalizeInterval( Interval interval , SymbolType symbolType ) {
+
+    switch ( symbolType ) {
+
+        case sINTEGER:
+
+            if ( isnan( interval.low ) || isnan( interval.high ) || interval.low < INT_MIN || interval.high > INT_MAX ) {
+
+                return typeRange( sINTEGER );
+
+            }
+
+            return interval;
+
+        case sLONG:
+
+            if ( isnan( interval.low ) || isnan( interval.high ) || interval.low < -RANGE_EXACT_DOUBLE || interval.high > RANGE_EXACT_DOUBLE ) {
+
+                return typeRange( sLONG );
+
+            }
+
+            return interval;
+
+        default: {
+
+            double epsilon  = symbolType == sFLOAT ? ldexp( 1.0 , -22 ) : ldexp( 1.0 , -51 );
+            double minimum  = symbolType == sFLOAT ? FLT_MIN : DBL_MIN;
+            double maximum  = symbolType == sFLOAT ? FLT_MAX : DBL_MAX;
+
+            if ( interval.mayBeNonFinite || isnan( interval.low ) || isnan( interval.high ) ) {
+
+                return typeRange( symbolType );
+
+            }
+
+            interval.low  -= fabs( interval.low ) * epsilon;
+            interval.high += fabs( interval.high ) * epsilon;
+
+            //values too small to be normal may be rounded to 0
+            if ( interval.low > 0 && interval.low < minimum ) {
+
+                interval.low = 0;
+
+            }
+
+            if ( interval.high < 0 && interval.high > -minimum ) {
+
+                interval.high = 0;
+
+            }
+
+            if ( interval.low < -maximum || interval.high > maximum ) {
+
+                return typeRange( symbolType );
+
+            }
+
+            return interval;
+        }
+
+    }
+}
+
+/**
+ * @brief joins two intervals into the smallest interval that contains both
+ */
+static Interval joinIntervals( Interval left , Interval right ) {
+
+    Interval joined;
+
+    joined.low            = left.low < right.low ? left.low : right.low;
+    joined.high           = left.high > right.high ? left.high : right.high;
+    joined.mayBeNonFinite = left.mayBeNonFinite || right.mayBeNonFinite;
+
+    return joined;
+}
+
+/**
+ * @brief verifies if an interval may contain a value
+ */
+static int containsValue( Interval interval , double value ) {
+
+    return interval.mayBeNonFinite || ( interval.low <= value && value <= interval.high );
+
+}
+
+/**
+ * @brief searches the check of a node in the remaining list, adding it if it is not there
+ */
+static void recordRemainingCheck( RangeContext *context , Node *node , CheckType check , Interval interval ) {
+
+    int index;
+
+    node->provenChecks &= ~check;
+
+    for ( index = 0 ; index < context->remainingCount ; index++ ) {
+
+        if ( context->remaining[index].node == node && context->remaining[index].check == check ) {
+
+            context->remaining[index].interval = joinIntervals( context->remaining[index].interval , interval );
+
+            return;
+
+        }
+    }
+
+    if ( context->remainingCount == context->remainingCapacity ) {
+
+        context->remainingCapacity = context->remainingCapacity == 0 ? 16 : 2 * context->remainingCapacity;
+        context->remaining = realloc( context->remaining , context->remainingCapacity * sizeof( RemainingCheck ) );
+
+        if ( context->remaining == NULL ) {
+
+            printf( "Error: Memory allocation failed. Program will be terminated\n" );
+            exit(1);
+
+        }
+    }
+
+    context->remaining[context->remainingCount].node     = node;
+    context->remaining[context->remainingCount].check    = check;
+    context->remaining[context->remainingCount].interval = interval;
+    context->remainingCount++;
+
+}
+
+/**
+ * @brief computes the interval of an expresion
+ * @param expr expresion to be analyzed
+ * @param state intervals of the symbols indexed by slot
+ * @param context the analysis context
+ * @return the interval of the expresion
+ */
+static Interval evaluateInterval( Node *expr , Interval *state , RangeContext *context ) {
+
+    Interval left;
+    Interval right;
+    Interval result;
+
+    if ( expr->type == nVALUE ) {
+
+        switch ( expr->operationType ) {
+
+            case oINTEGER: return singleValue( expr->value.iValue );
+            case oFLOAT:   return normalizeInterval( singleValue( expr->value.fValue ) , sFLOAT );
+            case oLONG:    return normalizeInterval( singleValue( (double) expr->value.lValue ) , sLONG );
+            case oDOUBLE:  return normalizeInterval( singleValue( expr->value.dValue ) , sDOUBLE );
+
+            case oINDEX:
+
+                evaluateInterval( expr->indexExpr , state , context ); //divisions inside the index are analyzed as well
+
+                return state[findSymbol( context->symbolTable , expr->value.idValue )->slot];
+
+            case oID:
+
+                return state[findSymbol( context->symbolTable , expr->value.idValue )->slot];
+
+            default:
+
+                return typeRange( expr->symbolType );
+
+        }
+    }
+
+    if ( expr->operationType == oKEEP || expr->operationType == oREUSE ) { //the value of the operation they keep
+
+        return evaluateInterval( expr->leftOperand , state , context );
+
+    }
+
+    left  = evaluateInterval( expr->leftOperand , state , context );
+    right = evaluateInterval( expr->rightOperand , state , context );
+
+    result.mayBeNonFinite = left.mayBeNonFinite || right.mayBeNonFinite;
+
+    switch ( expr->operationType ) {
+
+        case oSUM:
+
+            result.low  = left.low + right.low;
+            result.high = left.high + right.high;
+
+        break;
+
+        case oSUB:
+
+            result.low  = left.low - right.high;
+            result.high = left.high - right.low;
+
+        break;
+
+        case oMULT: {
+
+            double products[4] = { left.low * right.low , left.low * right.high , left.high * right.low , left.high * right.high };
+            int index;
+
+            result.low  = products[0];
+            result.high = products[0];
+
+            for ( index = 1 ; index < 4 ; index++ ) {
+
+                result.low  = products[index] < result.low ? products[index] : result.low;
+                result.high = products[index] > result.high ? products[index] : result.high;
+
+            }
+
+            break;
+        }
+
+        case oDIV: {
+
+            int isInteger = expr->symbolType == sINTEGER || expr->symbolType == sLONG;
+
+            if ( isInteger ) {
+
+                if ( containsValue( right , 0 ) ) {
+
+                    recordRemainingCheck( context , expr , cDIVISOR_NON_ZERO , right );
+
+                }
+
+                if ( containsValue( right , -1 ) ) {
+
+                    recordRemainingCheck( context , expr , cDIVISOR_NOT_MINUS_ONE , right );
+
+                }
+            }
+
+            if ( containsValue( right , 0 ) ) {
+
+                return typeRange( expr->symbolType );
+
+            } else {
+
+                double quotients[4] = { left.low / right.low , left.low / right.high , left.high / right.low , left.high / right.high };
+                int index;
+
+                result.low  = quotients[0];
+                result.high = quotients[0];
+
+                for ( index = 1 ; index < 4 ; index++ ) {
+
+                    result.low  = quotients[index] < result.low ? quotients[index] : result.low;
+                    result.high = quotients[index] > result.high ? quotients[index] : result.high;
+
+                }
+
+                if ( isInteger ) { //integer division truncates towards 0
+
+                    result.low  = trunc( result.low );
+                    result.high = trunc( result.high );
+
+                }
+            }
+
+            break;
+        }
+
+        default:
+
+            return typeRange( expr->symbolType );
+
+    }
+
+    return normalizeInterval( result , expr->symbolType );
+}
+
+/**
+ * @brief copies the intervals of every symbol
+ */
+static Interval *copyState( Interval *state , RangeContext *context ) {
+
+    Interval *copy = allocateRangeMemory( context->symbolCount * sizeof( Interval ) );
+
+    memcpy( copy , state , context->symbolCount * sizeof( Interval ) );
+
+    return copy;
+}
+
+/**
+ * @brief joins the intervals of a second state into the first one
+ * @return 1 if the first state changed, 0 otherwise
+ */
+static int joinStates( Interval *state , Interval *other , RangeContext *context ) {
+
+    int changed = 0;
+    int slot;
+
+    for ( slot = 0 ; slot < context->symbolCount ; slot++ ) {
+
+        Interval joined = joinIntervals( state[slot] , other[slot] );
+
+        if ( joined.low != state[slot].low || joined.high != state[slot].high || joined.mayBeNonFinite != state[slot].mayBeNonFinite ) {
+
+            state[slot] = joined;
+            changed     = 1;
+
+        }
+    }
+
+    return changed;
+}
+
+/**
+ * @brief widens the intervals that are still different from a previous state. The first time an interval of a loop is widened it
+ * takes in the range of values a profile recorded for its symbol, if there is one, and the range of its type otherwise. The loop is
+ * analyzed until its intervals stop changing, so a recorded range the loop does not keep the symbol in is widened again
+ * @param widenings times the interval of every slot was widened in the loop
+ */
+static void widenState( Interval *state , Interval *previous , int *widenings , RangeContext *context ) {
+
+    int slot;
+
+    for ( slot = 0 ; slot < context->symbolCount ; slot++ ) {
+
+        if ( state[slot].low != previous[slot].low || state[slot].high != previous[slot].high || state[slot].mayBeNonFinite != previous[slot].mayBeNonFinite ) {
+
+            Symbol *symbol = context->symbols[slot];
+            Interval recorded = { 0 , 0 , 0 };
+
+            if ( widenings[slot]++ == 0 && getProfiledRange( symbol , &recorded.low , &recorded.high ) ) {
+
+                state[slot] = joinIntervals( state[slot] , normalizeInterval( recorded , symbol->type ) );
+
+                context->profiledWidenings++;
+
+            } else {
+
+                state[slot] = typeRange( symbol->type );
+
+            }
+        }
+    }
+}
+
+static void analyzeStatement( Node *tree , Interval *state , RangeContext *context );
+
+/**
+ * @brief analyzes a loop body until the intervals at the beginning of the body stop changing
+ * @param body statements of the loop
+ * @param condition conditional expresion of a while loop or NULL
+ * @param iteratorSlot slot of the iterator of a for loop or -1
+ * @param iteratorRange interval of the iterator at the beginning of each iteration of a for loop
+ * @param state intervals before the loop, updated with the intervals after it
+ */
+static void analyzeLoop( Node *body , Node *condition , int iteratorSlot , Interval iteratorRange , Interval *state , RangeContext *context ) {
+
+    Interval *entry = copyState( state , context ); //intervals at the beginning of an iteration
+    int *widenings  = allocateRangeMemory( context->symbolCount * sizeof( int ) );
+    int iterations  = 0;
+    int changed     = 1;
+
+    while ( changed ) {
+
+        Interval *previous = copyState( entry , context );
+        Interval *exit;
+
+        if ( condition != NULL ) {
+
+            evaluateInterval( condition->leftOperand , entry , context );
+            evaluateInterval( condition->rightOperand , entry , context );
+
+        }
+
+        exit = copyState( entry , context );
+
+        if ( iteratorSlot >= 0 ) {
+
+            exit[iteratorSlot] = iteratorRange;
+
+        }
+
+        analyzeStatement( body , exit , context );
+
+        changed = joinStates( entry , exit , context );
+
+        if ( changed && ++iterations >= RANGE_WIDENING_ITERATIONS ) {
+
+            widenState( entry , previous , widenings , context );
+
+        }
+
+        joinStates( state , exit , context );
+
+        free( previous );
+        free( exit );
+
+    }
+
+    joinStates( state , entry , context );
+
+    free( widenings );
+    free( entry );
+
+}
+
+/**
+ * @brief updates the intervals of the symbols with the effect of a statement
+ * @param tree statement to be analyzed
+ * @param state intervals of the symbols indexed by slot
+ * @param context the analysis context
+ */
+static void analyzeStatement( Node *tree , Interval *state , RangeContext *context ) {
+
+    if ( tree == NULL ) {
+
+        return;
+
+    }
+
+    switch ( tree->type ) {
+
+        case nSEMICOLON:
+
+            analyzeStatement( tree->leftStatement , state , context );
+            analyzeStatement( tree->rightStatement , state , context );
+
+        break;
+
+        case nASSIGNMENT: {
+
+            Symbol *symbol = findSymbol( context->symbolTable , tree->value.idValue );
+            Interval value = evaluateInterval( tree->expr , state , context );
+
+            if ( tree->indexExpr != NULL ) { //only one element changes, the other ones keep their values
+
+                evaluateInterval( tree->indexExpr , state , context );
+
+                state[symbol->slot] = joinIntervals( state[symbol->slot] , value );
+
+            } else {
+
+                state[symbol->slot] = value;
+
+            }
+
+            break;
+        }
+
+        case nREAD: {
+
+            Symbol *symbol = findSymbol( context->symbolTable , tree->value.idValue );
+
+            state[symbol->slot] = typeRange( symbol->type );
+
+            break;
+        }
+
+        case nPRINT:
+
+            evaluateInterval( tree->expr , state , context );
+
+        break;
+
+        case nCALL: { //the procedure may assign any symbol
+
+            Node *argument;
+            int slot;
+
+            for ( argument = tree->arguments ; argument != NULL ; argument = argument->nextArgument ) {
+
+                evaluateInterval( argument->expr , state , context );
+
+            }
+
+            for ( slot = 0 ; slot < context->symbolCount ; slot++ ) {
+
+                state[slot] = typeRange( context->symbols[slot]->type );
+
+            }
+
+            break;
+        }
+
+        case nIF: {
+
+            Interval *thenState;
+
+            evaluateInterval( tree->expresion->leftOperand , state , context );
+            evaluateInterval( tree->expresion->rightOperand , state , context );
+
+            thenState = copyState( state , context );
+
+            analyzeStatement( tree->thenOptStmts , thenState , context );
+
+            joinStates( state , thenState , context );
+
+            free( thenState );
+
+            break;
+        }
+
+        case nWHILE: {
+
+            Interval none = { 0 , 0 , 0 };
+
+            analyzeLoop( tree->doOptStmts , tree->expresion , -1 , none , state , context );
+
+            break;
+        }
+
+        case nFOR: {
+
+            Symbol *iterator = findSymbol( context->symbolTable , tree->value.idValue );
+            Interval start   = evaluateInterval( tree->expr , state , context );
+            Interval step    = evaluateInterval( tree->stepExpr , state , context );
+            Interval until   = evaluateInterval( tree->untilExpr , state , context );
+            Interval iteratorRange;
+            Interval afterLoop;
+
+            if ( containsValue( step , 0 ) || step.mayBeNonFinite ) {
+
+                recordRemainingCheck( context , tree , cSTEP_NON_ZERO , step );
+
+            }
+
+            if ( start.mayBeNonFinite || step.mayBeNonFinite || until.mayBeNonFinite ) {
+
+                recordRemainingCheck( context , tree , cBOUNDS_FINITE , joinIntervals( joinIntervals( start , step ) , until ) );
+
+            }
+
+            //the iterator starts at start and never goes past until
+            if ( step.low > 0 && !step.mayBeNonFinite ) {
+
+                iteratorRange.low  = start.low;
+                iteratorRange.high = until.high > start.low ? until.high : start.low;
+
+            } else if ( step.high < 0 && !step.mayBeNonFinite ) {
+
+                iteratorRange.low  = until.low < start.high ? until.low : start.high;
+                iteratorRange.high = start.high;
+
+            } else {
+
+                iteratorRange = joinIntervals( start , until );
+
+            }
+
+            iteratorRange.mayBeNonFinite = start.mayBeNonFinite || until.mayBeNonFinite;
+            iteratorRange = normalizeInterval( iteratorRange , iterator->type );
+
+            analyzeLoop( tree->doOptStmts , NULL , iterator->slot , iteratorRange , state , context );
+
+            //after the loop the iterator keeps the last value that met the condition, or start - step if the body never ran
+            afterLoop.low            = start.low - step.high;
+            afterLoop.high           = start.high - step.low;
+            afterLoop.mayBeNonFinite = start.mayBeNonFinite || step.mayBeNonFinite;
+
+            state[iterator->slot] = joinIntervals( iteratorRange , normalizeInterval( afterLoop , iterator->type ) );
+
+            break;
+        }
+
+        default:
+
+        break;
+
+    }
+}
+
+/**
+ * @brief marks every check of the for statements and integer divisions of a tree as proven, before the analysis removes the ones that can fail
+ */
+static void resetProvenChecks( Node *tree ) {
+
+    if ( tree == NULL ) {
+
+        return;
+
+    }
+
+    if ( tree->type == nFOR ) {
+
+        tree->provenChecks = cSTEP_NON_ZERO | cBOUNDS_FINITE;
+
+    } else if ( tree->type == nOPERATION && tree->operationType == oDIV && ( tree->symbolType == sINTEGER || tree->symbolType == sLONG ) ) {
+
+        tree->provenChecks = cDIVISOR_NON_ZERO | cDIVISOR_NOT_MINUS_ONE;
+
+    }
+
+    resetProvenChecks( tree->leftOperand );
+    resetProvenChecks( tree->rightOperand );
+    resetProvenChecks( tree->indexExpr );
+    resetProvenChecks( tree->leftStatement );
+    resetProvenChecks( tree->rightStatement );
+    resetProvenChecks( tree->expr );
+    resetProvenChecks( tree->expresion );
+    resetProvenChecks( tree->thenOptStmts );
+    resetProvenChecks( tree->doOptStmts );
+    resetProvenChecks( tree->stepExpr );
+    resetProvenChecks( tree->untilExpr );
+
+}
+
+/**
+ * @brief counts the checks marked as proven in a tree
+ */
+static int countProvenChecks( Node *tree ) {
+
+    int count = 0;
+    int check;
+
+    if ( tree == NULL ) {
+
+        return 0;
+
+    }
+
+    for ( check = cSTEP_NON_ZERO ; check <= cDIVISOR_NOT_MINUS_ONE ; check <<= 1 ) {
+
+        count += ( tree->provenChecks & check ) != 0;
+
+    }
+
+    return count + countProvenChecks( tree->leftOperand ) + countProvenChecks( tree->rightOperand ) + countProvenChecks( tree->indexExpr ) +
+           countProvenChecks( tree->leftStatement ) + countProvenChecks( tree->rightStatement ) + countProvenChecks( tree->expr ) +
+           countProvenChecks( tree->expresion ) + countProvenChecks( tree->thenOptStmts ) + countProvenChecks( tree->doOptStmts ) +
+           countProvenChecks( tree->stepExpr ) + countProvenChecks( tree->untilExpr );
+}
+
+/**
+ * @brief converts a bound of an integer or long interval, LLONG_MAX as a double rounds up past the range of a long long
+ */
+static long long wholeBound( double bound ) {
+
+    if ( bound >= (double) LLONG_MAX ) return LLONG_MAX;
+    if ( bound <= (double) LLONG_MIN ) return LLONG_MIN;
+
+    return (long long) bound;
+}
+
+/**
+ * @brief writes the bounds of an interval, as whole numbers for integer and long values
+ * @param text where the bounds are written
+ * @param size size of the text
+ */
+static void formatInterval( char *text , size_t size , Interval interval , SymbolType symbolType ) {
+
+    if ( symbolType == sINTEGER || symbolType == sLONG ) {
+
+        snprintf( text , size , "[%lld, %lld]" , wholeBound( interval.low ) , wholeBound( interval.high ) );
+
+    } else {
+
+        snprintf( text , size , "[%g, %g]" , interval.low , interval.high );
+
+    }
+}
+
+/**
+ * @brief prints a remaining check and the reason it could not be proven
+ */
+static void reportRemainingCheck( RemainingCheck *remaining ) {
+
+    Interval interval = remaining->interval;
+    char bounds[96];
+
+    switch ( remaining->check ) {
+
+        case cSTEP_NON_ZERO:
+
+            formatInterval( bounds , sizeof( bounds ) , interval , remaining->node->stepExpr->symbolType );
+
+            fprintf( stderr , "line %d: for %s: step may be 0, step in %s%s\n" , remaining->node->line , remaining->node->value.idValue ,
+                     bounds , interval.mayBeNonFinite ? " or not finite" : "" );
+
+        break;
+
+        case cBOUNDS_FINITE:
+
+            fprintf( stderr , "line %d: for %s: start, step or until may be infinite or NaN\n" , remaining->node->line , remaining->node->value.idValue );
+
+        break;
+
+        case cDIVISOR_NON_ZERO:
+
+            formatInterval( bounds , sizeof( bounds ) , interval , remaining->node->symbolType );
+
+            fprintf( stderr , "line %d: division: divisor may be 0, divisor in %s\n" , remaining->node->line , bounds );
+
+        break;
+
+        case cDIVISOR_NOT_MINUS_ONE:
+
+            formatInterval( bounds , sizeof( bounds ) , interval , remaining->node->symbolType );
+
+            fprintf( stderr , "line %d: division: divisor may be -1 and overflow, divisor in %s\n" , remaining->node->line , bounds );
+
+        break;
+
+    }
+}
+
+void analyzeRanges( Node *tree , Symbol **symbolTable ) {
+
+    RangeContext context = { symbolTable , NULL , 0 , NULL , 0 , 0 , 0 };
+    Interval *state;
+    Symbol *symbol;
+    int index;
+
+    for ( symbol = *symbolTable ; symbol != NULL ; symbol = symbol->next ) {
+
+        context.symbolCount++;
+
+    }
+
+    context.symbols = allocateRangeMemory( context.symbolCount * sizeof( Symbol * ) );
+    state           = allocateRangeMemory( context.symbolCount * sizeof( Interval ) );
+
+    for ( symbol = *symbolTable ; symbol != NULL ; symbol = symbol->next ) {
+
+        context.symbols[symbol->slot] = symbol;
+        state[symbol->slot]           = singleValue( 0 ); //every symbol starts with the value 0
+
+    }
+
+    resetProvenChecks( tree );
+
+    analyzeStatement( tree , state , &context );
+
+    if ( rangeReportEnabled ) {
+
+        fprintf( stderr , "Range analysis: %d checks proven, %d checks remain\n" , countProvenChecks( tree ) , context.remainingCount );
+
+        if ( context.profiledWidenings > 0 ) {
+
+            fprintf( stderr , "%d loop intervals widened to the ranges of the profile first\n" , context.profiledWidenings );
+
+        }
+
+        for ( index = 0 ; index < context.remainingCount ; index++ ) {
+
+            reportRemainingCheck( &context.remaining[index] );
+
+        }
+    }
+
+    free( context.remaining );
+    free( context.symbols );
+    free( state );
+
+}
+
+//end rangeAnalysis.c
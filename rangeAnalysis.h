@@ -0,0 +1,39 @@
+/**
+ * rangeAnalysis.h
+ * Definition of the interval analysis that proves run-time checks unnecessary
+ * @author Jose Pablo Ortiz Lack
+ */
+#ifndef __RANGE_ANALYSIS_H__
+#define __RANGE_ANALYSIS_H__
+
+#include "symbolTable.h"
+#include "syntaxTree.h"
+
+/**
+ * @brief the range of values a symbol or expresion can take
+ */
+typedef struct tagInterval {
+
+    double low; //lowest value
+    double high; //highest value
+
+    int mayBeNonFinite; //1 if a float or double value can be infinite or NaN
+
+} Interval;
+
+/**
+ * @brief prints the run-time checks that remain after the analysis and the reason they could not be proven
+ */
+extern int rangeReportEnabled;
+
+/**
+ * @brief computes the intervals of every symbol through the statements of the tree and marks in provenChecks of each for statement
+ * and integer or long division the run-time checks that can never fail. Checks that cannot be proven keep being verified at run time
+ * @param tree tree to be analyzed
+ * @param symbolTable the symbolTable of the compiler
+ */
+void analyzeRanges( Node *tree , Symbol **symbolTable );
+
+#endif //__RANGE_ANALYSIS_H__
+
+//end rangeAnalysis.h
@@ -0,0 +1,540 @@
+/**
+ * session.c
+ * Implementation of the sessions, programs whose execution is suspended when a read statement has no input and resumed when input arrives
+ *
+ * A session is suspended with a longjmp from the read statement to resumeSession, discarding the C stack of resolveTree.
+ * Before that the position of the read and the frames of the enclosing for loops and calls are saved in a continuation, which is resumed
+ * the same way a snapshot is, so a waiting session only keeps its symbol table, its pending input and its continuation.
+ * A run-time error returns to resumeSession the same way, with the session failed instead of suspended
+ * @author Jose Pablo Ortiz Lack
+ */
+#include "session.h"
+#include "rangeAnalysis.h"
+#include "valueNumbering.h"
+#include "inlining.h"
+#include "constantPropagation.h"
+#include "unrolling.h"
+#include "diagnostics.h"
+
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <ctype.h>
+#include <time.h>
+
+#define SUSPENDED 1 //value of the longjmp to resumeSession when a read statement has no input
+
+#define FAILED 2 //value of the longjmp to resumeSession when a run-time error was found
+
+Session *activeSession = NULL;
+
+/**
+ * @brief obtains the current time in milliseconds
+ */
+static double currentMilliseconds() {
+
+    struct timespec now;
+
+    clock_gettime( CLOCK_MONOTONIC , &now );
+
+    return now.tv_sec * 1000.0 + now.tv_nsec / 1000000.0;
+}
+
+Session *createSession( const char *source , size_t length , FILE *output ) {
+
+    int errors = diagnosticCount;
+    IncrementalProgram *program = createIncrementalProgram( source , length );
+    Arena *outerArena = currentArena;
+    Session *session;
+
+    if ( diagnosticCount > errors ) {
+
+        destroyIncrementalProgram( program );
+
+        return NULL;
+
+    }
+
+    session = calloc( 1 , sizeof( Session ) );
+
+    if ( session == NULL ) {
+
+        printf( "Error: Memory allocation failed. Program will be terminated\n" );
+        exit(1);
+
+    }
+
+    session->program = program;
+    session->tree    = getIncrementalTree( program );
+    session->output  = output;
+    session->status  = pNEEDS_INPUT;
+
+    //the nodes and plans built by the optimizations belong to the program too
+    currentArena = &program->arena;
+
+    if ( session->tree != NULL ) {
+
+        if ( inliningEnabled ) {
+
+            inlineProcedures( session->tree , &program->symbolTable );
+
+        }
+
+        if ( constantPropagationEnabled ) {
+
+            propagateConstants( &session->tree , &program->symbolTable );
+
+        }
+
+        analyzeRanges( session->tree , &program->symbolTable );
+
+        if ( valueNumberingEnabled ) {
+
+            eliminateCommonSubexpressions( session->tree , &program->symbolTable );
+
+        }
+
+        if ( unrollingEnabled ) {
+
+            unrollLoops( session->tree , &program->symbolTable );
+
+        }
+
+        numberStatements( session->tree , 0 );
+
+    }
+
+    currentArena = outerArena;
+
+    //the optimizations may go over the memory limit too
+    if ( diagnosticCount > errors ) {
+
+        destroySession( session );
+
+        return NULL;
+
+    }
+
+    return session;
+}
+
+void feedSession( Session *session , const char *text , size_t length ) {
+
+    //the consumed input is dropped before the buffer grows
+    if ( session->inputStart > 0 ) {
+
+        memmove( session->input , session->input + session->inputStart , session->inputLength - session->inputStart );
+
+        session->inputLength -= session->inputStart;
+        session->inputStart   = 0;
+
+    }
+
+    if ( session->inputLength + length > session->inputCapacity ) {
+
+        LoopFrame *outerFrame = currentLoopFrame;
+
+        if ( session->status == pFAILED ) {
+
+            return;
+
+        }
+
+        //going over the memory limit fails the session, not the program that feeds it
+        activeSession    = session;
+        currentLoopFrame = NULL;
+
+        if ( setjmp( session->suspension ) != 0 ) {
+
+            activeSession    = NULL;
+            currentLoopFrame = outerFrame;
+            session->status  = pFAILED;
+
+            return;
+
+        }
+
+        accountRuntimeMemory( 2 * ( session->inputLength + length ) );
+        releaseRuntimeMemory( session->inputCapacity );
+
+        activeSession    = NULL;
+        currentLoopFrame = outerFrame;
+
+        session->inputCapacity = 2 * ( session->inputLength + length );
+        session->input         = realloc( session->input , session->inputCapacity );
+
+        if ( session->input == NULL ) {
+
+            printf( "Error: Memory allocation failed. Program will be terminated\n" );
+            exit(1);
+
+        }
+    }
+
+    memcpy( session->input + session->inputLength , text , length );
+
+    session->inputLength += length;
+
+}
+
+SessionStatus resumeSession( Session *session ) {
+
+    LoopFrame *outerFrame = currentLoopFrame;
+    CallFrame *outerCall  = currentCallFrame;
+    FILE *outerOutput     = programOutput;
+    int outerDepth        = callDepth;
+    int suspension;
+
+    if ( session->status != pNEEDS_INPUT ) {
+
+        return session->status;
+
+    }
+
+    activeSession    = session;
+    programOutput    = session->output;
+    currentLoopFrame = NULL;
+    currentCallFrame = NULL;
+    callDepth        = 0;
+
+    if ( ( suspension = setjmp( session->suspension ) ) == 0 ) {
+
+        if ( !session->started ) {
+
+            session->started = 1;
+
+            resolveTree( session->tree , &session->program->symbolTable );
+
+        } else {
+
+            resumeContinuation( session->tree , &session->program->symbolTable , &session->continuation );
+
+        }
+
+        session->status = pFINISHED;
+
+    } else if ( suspension == SUSPENDED ) {
+
+        session->status = pNEEDS_INPUT;
+
+    } else {
+
+        session->status = pFAILED;
+
+        releaseContinuation( &session->continuation );
+
+    }
+
+    activeSession    = NULL;
+    programOutput    = outerOutput;
+    currentLoopFrame = outerFrame;
+    currentCallFrame = outerCall;
+    callDepth        = outerDepth; //a suspension or an error abandons the calls being executed
+
+    return session->status;
+}
+
+void destroySession( Session *session ) {
+
+    releaseContinuation( &session->continuation );
+    releaseRuntimeMemory( session->inputCapacity );
+    destroyIncrementalProgram( session->program );
+
+    free( session->input );
+    free( session );
+
+}
+
+/**
+ * @brief unmarks the array accesses marked as within bounds by the loops being executed, which are abandoned by the longjmp
+ */
+static void abandonLoops( Symbol **symbolTable ) {
+
+    LoopFrame *frame;
+
+    for ( frame = currentLoopFrame ; frame != NULL ; frame = frame->outer ) {
+
+        if ( frame->boundsHoisted ) {
+
+            releaseArrayBounds( frame->loop , frame->boundsLow , frame->boundsHigh , symbolTable );
+
+        }
+    }
+}
+
+/**
+ * @brief saves where the active session stopped and returns to resumeSession
+ */
+static void suspendSession( Session *session , Node *read , Symbol **symbolTable ) {
+
+    //the frames of the continuation the session was resumed from were already restored
+    releaseContinuation( &session->continuation );
+    captureContinuation( &session->continuation , read );
+
+    abandonLoops( symbolTable );
+
+    longjmp( session->suspension , SUSPENDED );
+
+}
+
+_Noreturn void runtimeError( const char *format , ... ) {
+
+    va_list arguments;
+
+    va_start( arguments , format );
+
+    vfprintf( activeSession != NULL ? activeSession->output : stdout , format , arguments );
+
+    va_end( arguments );
+
+    if ( activeSession == NULL ) {
+
+        exit(1);
+
+    }
+
+    abandonLoops( &activeSession->program->symbolTable );
+
+    longjmp( activeSession->suspension , FAILED );
+
+}
+
+/**
+ * @brief converts a value of the input to the type of a symbol and assigns it
+ * @return 1 if the text is a number of the type of the symbol, 0 otherwise
+ */
+static int assignInputValue( const char *text , char *identifier , Symbol **symbolTable ) {
+
+    char *end;
+
+    switch ( getSymbolType( symbolTable , identifier ) ) {
+
+        case sINTEGER: {
+
+            long value = strtol( text , &end , 10 );
+
+            if ( *end == '\0' ) {
+
+                setIntegerSymbolValue( symbolTable , identifier , (int) value );
+
+            }
+
+            break;
+        }
+
+        case sFLOAT: {
+
+            float value = strtof( text , &end );
+
+            if ( *end == '\0' ) {
+
+                setFloatSymbolValue( symbolTable , identifier , value );
+
+            }
+
+            break;
+        }
+
+        case sLONG: {
+
+            long long value = strtoll( text , &end , 10 );
+
+            if ( *end == '\0' ) {
+
+                setLongSymbolValue( symbolTable , identifier , value );
+
+            }
+
+            break;
+        }
+
+        case sDOUBLE: {
+
+            double value = strtod( text , &end );
+
+            if ( *end == '\0' ) {
+
+                setDoubleSymbolValue( symbolTable , identifier , value );
+
+            }
+
+            break;
+        }
+
+        default:
+
+            return 0;
+
+    }
+
+    return *end == '\0' && end != text;
+
+}
+
+void readSessionValue( Node *read , Symbol **symbolTable ) {
+
+    Session *session = activeSession;
+
+    if ( !session->prompted ) {
+
+        fprintf( session->output , "read value for %s: " , read->value.idValue );
+
+        session->prompted = 1;
+
+    }
+
+    for ( ;; ) {
+
+        size_t start = session->inputStart;
+        size_t end;
+        char text[64];
+
+        while ( start < session->inputLength && isspace( (unsigned char) session->input[start] ) ) {
+
+            start++;
+
+        }
+
+        end = start;
+
+        while ( end < session->inputLength && !isspace( (unsigned char) session->input[end] ) ) {
+
+            end++;
+
+        }
+
+        //the value may continue in input that was not fed yet
+        if ( end == session->inputLength ) {
+
+            session->inputStart = start;
+
+            suspendSession( session , read , symbolTable );
+
+        }
+
+        session->inputStart = end;
+
+        if ( end - start < sizeof( text ) ) {
+
+            memcpy( text , session->input + start , end - start );
+            text[end - start] = '\0';
+
+            if ( assignInputValue( text , read->value.idValue , symbolTable ) ) {
+
+                break;
+
+            }
+        }
+    }
+
+    fprintf( session->output , "\n" );
+
+    session->prompted = 0;
+
+}
+
+void benchmarkSessions( const char *source , size_t length , int count ) {
+
+    Session **sessions = calloc( count > 0 ? count : 1 , sizeof( Session * ) );
+    FILE *output = fopen( "/dev/null" , "w" );
+    unsigned long long resumes = 0;
+    int waiting = 0;
+    int failed  = 0;
+    int maximumWaiting;
+    int index;
+    double start;
+    double elapsed;
+
+    if ( sessions == NULL || output == NULL ) {
+
+        printf( "Error: Memory allocation failed. Program will be terminated\n" );
+        exit(1);
+
+    }
+
+    start = currentMilliseconds();
+
+    for ( index = 0 ; index < count ; index++ ) {
+
+        if ( ( sessions[index] = createSession( source , length , output ) ) == NULL ) {
+
+            while ( index-- > 0 ) {
+
+                destroySession( sessions[index] );
+
+            }
+
+            free( sessions );
+            fclose( output );
+
+            return;
+
+        }
+    }
+
+    fprintf( stderr , "sessions: %d compiled in %.3f ms\n" , count , currentMilliseconds() - start );
+
+    start = currentMilliseconds();
+
+    for ( index = 0 ; index < count ; index++ ) {
+
+        resumes++;
+        waiting += resumeSession( sessions[index] ) == pNEEDS_INPUT;
+
+    }
+
+    maximumWaiting = waiting;
+
+    //every waiting session receives one value per turn, as an event loop would when their input arrives
+    while ( waiting > 0 ) {
+
+        for ( index = 0 ; index < count ; index++ ) {
+
+            char value[16];
+            int valueLength;
+
+            if ( sessions[index]->status != pNEEDS_INPUT ) {
+
+                continue;
+
+            }
+
+            valueLength = snprintf( value , sizeof( value ) , "%d\n" , index % 10 + 1 );
+
+            feedSession( sessions[index] , value , valueLength );
+
+            resumes++;
+            waiting -= resumeSession( sessions[index] ) != pNEEDS_INPUT;
+
+        }
+    }
+
+    elapsed = currentMilliseconds() - start;
+
+    fprintf( stderr , "waiting sessions: %d at once\n" , maximumWaiting );
+
+    for ( index = 0 ; index < count ; index++ ) {
+
+        failed += sessions[index]->status == pFAILED;
+
+    }
+
+    if ( failed > 0 ) {
+
+        fprintf( stderr , "failed sessions: %d\n" , failed );
+
+    }
+    fprintf( stderr , "resumes: %llu in %.3f ms, %.3f us per resume\n" , resumes , elapsed , resumes > 0 ? 1000.0 * elapsed / resumes : 0 );
+
+    for ( index = 0 ; index < count ; index++ ) {
+
+        destroySession( sessions[index] );
+
+    }
+
+    free( sessions );
+    fclose( output );
+
+}
+
+//end session.c
@@ -0,0 +1,121 @@
+/**
+ * session.h
+ * Definition of the sessions, programs whose execution is suspended when a read statement has no input and resumed when input arrives,
+ * so a single thread can serve many interactive programs
+ * @author Jose Pablo Ortiz Lack
+ */
+#ifndef __SESSION_H__
+#define __SESSION_H__
+
+#include <stdio.h>
+#include <stddef.h>
+#include <setjmp.h>
+
+#include "symbolTable.h"
+#include "syntaxTree.h"
+#include "incremental.h"
+#include "snapshot.h"
+#include "arena.h"
+
+/**
+ * @brief the state of a session after it was resumed
+ */
+typedef enum tagSessionStatus {
+
+    pNEEDS_INPUT, //suspended at a read statement until more input is fed
+    pFINISHED, //the program reached its end
+    pFAILED //the program stopped at a run-time error, whose message was written to the output of the session
+
+} SessionStatus;
+
+/**
+ * @brief a program being executed as a session. While it waits for input no C stack is kept: its position, the state of its
+ * for loops and the calls being executed are kept in a continuation and the values of its variables in its symbol table
+ */
+typedef struct tagSession {
+
+    IncrementalProgram *program; //tree and symbol table of the program
+    Node *tree; //tree of the statements, NULL if the program has no statements
+
+    FILE *output; //stream where print statements and read prompts are written
+
+    char *input; //input fed and not consumed yet
+    size_t inputStart; //offset of the first character not consumed
+    size_t inputLength; //offset after the last character fed
+    size_t inputCapacity; //capacity of the input buffer
+
+    int started; //1 once the execution started
+    int prompted; //1 if the prompt of the pending read was written
+
+    Continuation continuation; //where the execution continues, valid while the session needs input
+
+    SessionStatus status; //state of the session after it was last resumed
+
+    jmp_buf suspension; //where the execution returns to when the program is suspended
+
+} Session;
+
+/**
+ * @brief session being executed, NULL if the program is not executed as a session
+ */
+extern Session *activeSession;
+
+/**
+ * @brief compiles a program to be executed as a session. Errors are added to the diagnostics, including going over memoryLimit
+ * of arena.h, whose getMemoryUsage gives the memory of all the sessions by category
+ * @param source source of the program
+ * @param length length of the source
+ * @param output stream where print statements and read prompts are written
+ * @return the session, NULL if the program has errors. The memory of a program with errors is released
+ */
+Session *createSession( const char *source , size_t length , FILE *output );
+
+/**
+ * @brief appends input for the read statements of a session. A value is only taken once it is followed by white space.
+ * The session fails if its input goes over memoryLimit of arena.h
+ * @param session session that receives the input
+ * @param text input
+ * @param length length of the input
+ */
+void feedSession( Session *session , const char *text , size_t length );
+
+/**
+ * @brief executes a session from where it stopped until it finishes, fails or reaches a read statement without input
+ * @param session session to be executed
+ * @return the state of the session. A finished or failed session is not executed again
+ */
+SessionStatus resumeSession( Session *session );
+
+/**
+ * @brief releases a session with the tree and symbol table of its program
+ * @param session session to be released
+ */
+void destroySession( Session *session );
+
+/**
+ * @brief sets the value of a read statement of the active session from its input, suspending the session if no value is complete.
+ * Values that are not a number of the type of the symbol are skipped
+ * @param read read statement
+ * @param symbolTable the symbolTable of the compiler
+ */
+void readSessionValue( Node *read , Symbol **symbolTable );
+
+/**
+ * @brief reports an error found while executing a program. The active session fails with the message written to its output and
+ * the execution returns to resumeSession; without an active session the message is printed and the program is terminated
+ * @param format printf format of the message, followed by its arguments
+ */
+_Noreturn void runtimeError( const char *format , ... );
+
+/**
+ * @brief executes many copies of a program as sessions in a single thread, feeding one value to every waiting session in turns,
+ * and prints to stderr the time taken per resume
+ * @param source source of the program
+ * @param length length of the source
+ * @param count number of sessions
+ */
+void benchmarkSessions( const char *source , size_t length , int count );
+
+#endif //__SESSION_H__
+
+//end session.h
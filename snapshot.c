@@ -0,0 +1,958 @@
+/**
+ * snapshot.c
+ * Implementation of the snapshots of a running program and of the resume of a program from a snapshot or a continuation
+ *
+ * A snapshot has the following layout, in the byte order of the machine that wrote it:
+ *   "SLCSNAP1", hash of the program tree (8 bytes), position of the next statement (4 bytes),
+ *   number of symbols (4 bytes) and for each symbol: identifier length (4 bytes), identifier, type (4 bytes), length (4 bytes) and its values,
+ *   number of loop frames (4 bytes) and for each frame, from the outermost loop: loop position (4 bytes), iterator, step and until (8 bytes each)
+ * Snapshots are only taken outside procedure calls, so they have no call frames; the continuations of sessions keep them in memory
+ * @author Jose Pablo Ortiz Lack
+ */
+#include "snapshot.h"
+#include "metrics.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#define SNAPSHOT_MAGIC "SLCSNAP1"
+
+volatile sig_atomic_t snapshotRequested = 0;
+
+LoopFrame *currentLoopFrame = NULL;
+
+CallFrame *currentCallFrame = NULL;
+
+static const char *snapshotFile = NULL; //file where the snapshots are written, NULL if snapshots are disabled
+
+static const char *resumeFile = NULL; //file of the snapshot to resume from, NULL to start from the first statement
+
+static uint64_t programHash; //hash of the tree being executed, a snapshot can only be resumed by the same program
+
+/**
+ * @brief terminates the program after a problem with a snapshot file
+ */
+static void snapshotError( const char *message , const char *fileName ) {
+
+    printf( "Error: %s %s. Program will be terminated.\n" , message , fileName );
+    exit(1);
+
+}
+
+/**
+ * @brief records the signal that requested a snapshot
+ */
+static void requestSnapshot( int signalNumber ) {
+
+    snapshotRequested = signalNumber;
+
+}
+
+void enableSnapshots( const char *fileName ) {
+
+    struct sigaction action;
+
+    snapshotFile = fileName;
+
+    memset( &action , 0 , sizeof( action ) );
+    action.sa_handler = requestSnapshot;
+    sigemptyset( &action.sa_mask );
+    action.sa_flags = 0; //without SA_RESTART a read waiting for input is interrupted, so the snapshot is not delayed
+
+    sigaction( SIGTERM , &action , NULL );
+    sigaction( SIGUSR2 , &action , NULL );
+
+}
+
+void enableResume( const char *fileName ) {
+
+    resumeFile = fileName;
+
+}
+
+void enterLoopFrame( LoopFrame *frame , Node *loop ) {
+
+    frame->loop          = loop;
+    frame->boundsHoisted = 0;
+    frame->outer         = currentLoopFrame;
+    currentLoopFrame     = frame;
+
+}
+
+void leaveLoopFrame( LoopFrame *frame ) {
+
+    currentLoopFrame = frame->outer;
+
+}
+
+void enterCallFrame( CallFrame *frame , Node *call , FrameValue *savedLocals ) {
+
+    frame->call        = call;
+    frame->savedLocals = savedLocals;
+    frame->outer       = currentCallFrame;
+    currentCallFrame   = frame;
+
+}
+
+void leaveCallFrame( CallFrame *frame ) {
+
+    currentCallFrame = frame->outer;
+
+}
+
+int numberStatements( Node *tree , int index ) {
+
+    if ( tree == NULL ) {
+
+        return index;
+
+    }
+
+    tree->statementIndex = index++;
+
+    switch ( tree->type ) {
+
+        case nSEMICOLON:
+
+            index = numberStatements( tree->leftStatement , index );
+            index = numberStatements( tree->rightStatement , index );
+
+        break;
+
+        case nIF:
+
+            index = numberStatements( tree->thenOptStmts , index );
+
+        break;
+
+        case nWHILE:
+        case nFOR:
+
+            index = numberStatements( tree->doOptStmts , index );
+
+        break;
+
+        case nCALL: //the end of a body being numbered is -1, so its recursive calls do not number it again
+
+            if ( tree->procedure->body != NULL && tree->procedure->body->statementEnd == 0 ) {
+
+                tree->procedure->body->statementEnd = -1;
+
+                numberStatements( tree->procedure->body , 0 );
+
+            }
+
+        break;
+
+        default:
+
+        break;
+
+    }
+
+    tree->statementEnd = index;
+
+    return index;
+
+}
+
+void collectStatements( Node *tree , Node **statements ) {
+
+    if ( tree == NULL ) {
+
+        return;
+
+    }
+
+    statements[tree->statementIndex] = tree;
+
+    switch ( tree->type ) {
+
+        case nSEMICOLON:
+
+            collectStatements( tree->leftStatement , statements );
+            collectStatements( tree->rightStatement , statements );
+
+        break;
+
+        case nIF:
+
+            collectStatements( tree->thenOptStmts , statements );
+
+        break;
+
+        case nWHILE:
+        case nFOR:
+
+            collectStatements( tree->doOptStmts , statements );
+
+        break;
+
+        default:
+
+        break;
+
+    }
+}
+
+/**
+ * @brief adds bytes to a FNV-1a hash
+ */
+static uint64_t hashBytes( uint64_t hash , const void *bytes , size_t length ) {
+
+    const unsigned char *data = bytes;
+    size_t index;
+
+    for ( index = 0 ; index < length ; index++ ) {
+
+        hash = ( hash ^ data[index] ) * 1099511628211ULL;
+
+    }
+
+    return hash;
+
+}
+
+/**
+ * @brief hashes the shape, identifiers and literals of a tree
+ */
+static uint64_t hashTree( Node *tree , uint64_t hash ) {
+
+    int fields[4];
+
+    if ( tree == NULL ) {
+
+        return hashBytes( hash , "" , 1 );
+
+    }
+
+    if ( tree->type == nOPERATION && ( tree->operationType == oKEEP || tree->operationType == oREUSE ) ) {
+
+        return hashTree( tree->leftOperand , hash ); //the value numbering does not change the program a snapshot belongs to
+
+    }
+
+    fields[0] = tree->type;
+    fields[1] = tree->operationType;
+    fields[2] = tree->symbolType;
+    fields[3] = tree->expresionType;
+
+    hash = hashBytes( hash , fields , sizeof( fields ) );
+
+    if ( tree->type == nVALUE && tree->operationType != oID && tree->operationType != oINDEX ) {
+
+        hash = hashBytes( hash , &tree->value.lValue , sizeof( tree->value.lValue ) );
+
+    } else if ( tree->type == nVALUE || tree->type == nASSIGNMENT || tree->type == nFOR || tree->type == nREAD || tree->type == nCALL ) {
+
+        hash = hashBytes( hash , tree->value.idValue , strlen( tree->value.idValue ) + 1 );
+
+    }
+
+    hash = hashTree( tree->leftOperand , hash );
+    hash = hashTree( tree->rightOperand , hash );
+    hash = hashTree( tree->indexExpr , hash );
+    hash = hashTree( tree->leftStatement , hash );
+    hash = hashTree( tree->rightStatement , hash );
+    hash = hashTree( tree->expr , hash );
+    hash = hashTree( tree->expresion , hash );
+    hash = hashTree( tree->thenOptStmts , hash );
+    hash = hashTree( tree->doOptStmts , hash );
+    hash = hashTree( tree->stepExpr , hash );
+    hash = hashTree( tree->untilExpr , hash );
+    hash = hashTree( tree->arguments , hash );
+    hash = hashTree( tree->nextArgument , hash );
+
+    return hash;
+
+}
+
+/**
+ * @brief hashes the declarations of a symbol table. The order of the table is not hashed, since a profile may reorder it
+ */
+static uint64_t hashSymbols( Symbol **symbolTable , uint64_t hash ) {
+
+    Symbol *symbol;
+    uint64_t declarations = 0;
+
+    for ( symbol = *symbolTable ; symbol != NULL ; symbol = symbol->next ) {
+
+        int fields[2];
+        uint64_t declaration;
+
+        fields[0] = symbol->type;
+        fields[1] = symbol->length;
+
+        declaration = hashBytes( 14695981039346656037ULL , symbol->identifier , strlen( symbol->identifier ) + 1 );
+
+        if ( symbol->procedure != NULL ) { //the calls only hash the name of the procedure
+
+            declaration = hashTree( symbol->procedure->body , declaration );
+
+        }
+
+        declarations += hashBytes( declaration , fields , sizeof( fields ) );
+
+    }
+
+    return hashBytes( hash , &declarations , sizeof( declarations ) );
+
+}
+
+uint64_t hashProgram( Node *tree , Symbol **symbolTable ) {
+
+    return hashSymbols( symbolTable , hashTree( tree , 14695981039346656037ULL ) );
+
+}
+
+/**
+ * @brief writes bytes to a snapshot
+ */
+static void writeBytes( FILE *file , const void *bytes , size_t length , const char *fileName ) {
+
+    if ( length > 0 && fwrite( bytes , length , 1 , file ) != 1 ) {
+
+        snapshotError( "Cannot write snapshot" , fileName );
+
+    }
+}
+
+/**
+ * @brief writes a 4 byte number to a snapshot
+ */
+static void writeNumber( FILE *file , uint32_t number , const char *fileName ) {
+
+    writeBytes( file , &number , sizeof( number ) , fileName );
+
+}
+
+/**
+ * @brief reads bytes from a snapshot
+ */
+static void readBytes( FILE *file , void *bytes , size_t length , const char *fileName ) {
+
+    if ( length > 0 && fread( bytes , length , 1 , file ) != 1 ) {
+
+        snapshotError( "Snapshot is truncated:" , fileName );
+
+    }
+}
+
+/**
+ * @brief reads a 4 byte number from a snapshot
+ */
+static uint32_t readNumber( FILE *file , const char *fileName ) {
+
+    uint32_t number;
+
+    readBytes( file , &number , sizeof( number ) , fileName );
+
+    return number;
+
+}
+
+/**
+ * @brief obtains the size in bytes of the values of a symbol
+ */
+static size_t symbolBytes( Symbol *symbol ) {
+
+    size_t elementSize = ( symbol->type == sLONG || symbol->type == sDOUBLE ) ? sizeof( long long ) : sizeof( int );
+
+    return symbol->length == 0 ? sizeof( symbol->value ) : (size_t) symbol->length * elementSize;
+
+}
+
+/**
+ * @brief obtains the address of the values of a symbol
+ */
+static void *symbolValues( Symbol *symbol ) {
+
+    return symbol->length == 0 ? (void *) &symbol->value : (void *) symbol->value.iElements;
+
+}
+
+/**
+ * @brief allocates the frames of a continuation
+ */
+static void allocateFrames( Continuation *continuation , uint32_t frameCount ) {
+
+    continuation->frameCount  = frameCount;
+    continuation->nextFrame   = 0;
+    continuation->frameLoops  = malloc( ( frameCount > 0 ? frameCount : 1 ) * sizeof( uint32_t ) );
+    continuation->frameValues = malloc( ( frameCount > 0 ? frameCount : 1 ) * 3 * sizeof( LoopValue ) );
+
+    //the calls are allocated by captureContinuation if there are any
+    continuation->callCount     = 0;
+    continuation->nextCall      = 0;
+    continuation->nextCallValue = 0;
+    continuation->callPositions = NULL;
+    continuation->callValues    = NULL;
+
+    if ( continuation->frameLoops == NULL || continuation->frameValues == NULL ) {
+
+        printf( "Error: Memory allocation failed. Program will be terminated\n" );
+        exit(1);
+
+    }
+}
+
+/**
+ * @brief saves the calls being executed in a continuation, from the outermost call
+ */
+static void captureCalls( Continuation *continuation ) {
+
+    CallFrame *frame;
+    uint32_t count      = 0;
+    uint32_t valueCount = 0;
+    uint32_t index;
+
+    for ( frame = currentCallFrame ; frame != NULL ; frame = frame->outer ) {
+
+        count++;
+        valueCount += (uint32_t) frame->call->procedure->localCount;
+
+    }
+
+    if ( count == 0 ) {
+
+        return;
+
+    }
+
+    continuation->callCount     = count;
+    continuation->callPositions = malloc( count * sizeof( uint32_t ) );
+    continuation->callValues    = malloc( ( valueCount > 0 ? valueCount : 1 ) * sizeof( FrameValue ) );
+
+    if ( continuation->callPositions == NULL || continuation->callValues == NULL ) {
+
+        printf( "Error: Memory allocation failed. Program will be terminated\n" );
+        exit(1);
+
+    }
+
+    //frames are linked from the innermost call, they are kept from the outermost one
+    index = count;
+
+    for ( frame = currentCallFrame ; frame != NULL ; frame = frame->outer ) {
+
+        int localCount = frame->call->procedure->localCount;
+
+        index--;
+        valueCount -= (uint32_t) localCount;
+
+        continuation->callPositions[index] = (uint32_t) frame->call->statementIndex;
+
+        memcpy( &continuation->callValues[valueCount] , frame->savedLocals , localCount * sizeof( FrameValue ) );
+
+    }
+}
+
+void captureContinuation( Continuation *continuation , Node *position ) {
+
+    LoopFrame *frame;
+    uint32_t count = 0;
+    uint32_t index;
+
+    for ( frame = currentLoopFrame ; frame != NULL ; frame = frame->outer ) {
+
+        count++;
+
+    }
+
+    allocateFrames( continuation , count );
+
+    continuation->position = (uint32_t) position->statementIndex;
+
+    //frames are linked from the innermost loop, they are kept from the outermost one
+    index = count;
+
+    for ( frame = currentLoopFrame ; frame != NULL ; frame = frame->outer ) {
+
+        index--;
+
+        continuation->frameLoops[index]          = (uint32_t) frame->loop->statementIndex;
+        continuation->frameValues[3 * index]     = frame->iterator;
+        continuation->frameValues[3 * index + 1] = frame->step;
+        continuation->frameValues[3 * index + 2] = frame->until;
+
+    }
+
+    captureCalls( continuation );
+
+}
+
+void releaseContinuation( Continuation *continuation ) {
+
+    free( continuation->frameLoops );
+    free( continuation->frameValues );
+    free( continuation->callPositions );
+    free( continuation->callValues );
+
+    continuation->frameLoops    = NULL;
+    continuation->frameValues   = NULL;
+    continuation->frameCount    = 0;
+    continuation->callPositions = NULL;
+    continuation->callValues    = NULL;
+    continuation->callCount     = 0;
+
+}
+
+void takeSnapshot( Node *position , Symbol **symbolTable ) {
+
+    int requested = snapshotRequested;
+    size_t nameLength;
+    char *temporaryName;
+    FILE *file;
+    Symbol *symbol;
+    Continuation continuation;
+    uint32_t count = 0;
+    uint32_t index;
+
+    snapshotRequested = 0;
+
+    if ( snapshotFile == NULL ) {
+
+        return;
+
+    }
+
+    //the snapshot is written to a temporary file and renamed, so a previous snapshot is never left half written
+    nameLength    = strlen( snapshotFile );
+    temporaryName = malloc( nameLength + 5 );
+
+    if ( temporaryName == NULL ) {
+
+        printf( "Error: Memory allocation failed. Program will be terminated\n" );
+        exit(1);
+
+    }
+
+    memcpy( temporaryName , snapshotFile , nameLength );
+    memcpy( temporaryName + nameLength , ".tmp" , 5 );
+
+    file = fopen( temporaryName , "wb" );
+
+    if ( file == NULL ) {
+
+        snapshotError( "Cannot create snapshot" , temporaryName );
+
+    }
+
+    writeBytes( file , SNAPSHOT_MAGIC , 8 , snapshotFile );
+    writeBytes( file , &programHash , sizeof( programHash ) , snapshotFile );
+    writeNumber( file , (uint32_t) position->statementIndex , snapshotFile );
+
+    for ( symbol = *symbolTable ; symbol != NULL ; symbol = symbol->next ) {
+
+        count++;
+
+    }
+
+    writeNumber( file , count , snapshotFile );
+
+    for ( symbol = *symbolTable ; symbol != NULL ; symbol = symbol->next ) {
+
+        writeNumber( file , (uint32_t) strlen( symbol->identifier ) , snapshotFile );
+        writeBytes( file , symbol->identifier , strlen( symbol->identifier ) , snapshotFile );
+        writeNumber( file , (uint32_t) symbol->type , snapshotFile );
+        writeNumber( file , (uint32_t) symbol->length , snapshotFile );
+        writeBytes( file , symbolValues( symbol ) , symbolBytes( symbol ) , snapshotFile );
+
+    }
+
+    captureContinuation( &continuation , position );
+
+    writeNumber( file , continuation.frameCount , snapshotFile );
+
+    for ( index = 0 ; index < continuation.frameCount ; index++ ) {
+
+        writeNumber( file , continuation.frameLoops[index] , snapshotFile );
+        writeBytes( file , &continuation.frameValues[3 * index] , 3 * sizeof( LoopValue ) , snapshotFile );
+
+    }
+
+    releaseContinuation( &continuation );
+
+    if ( fclose( file ) != 0 || rename( temporaryName , snapshotFile ) != 0 ) {
+
+        snapshotError( "Cannot write snapshot" , snapshotFile );
+
+    }
+
+    free( temporaryName );
+
+    if ( requested == SIGTERM ) {
+
+        fflush( stdout );
+        exit( SNAPSHOT_EXIT_STATUS );
+
+    }
+}
+
+/**
+ * @brief reads a snapshot, restores the values of its symbols and keeps the position and loop frames to be restored
+ */
+static void readSnapshot( Continuation *resume , Node *tree , Symbol **symbolTable ) {
+
+    FILE *file = fopen( resumeFile , "rb" );
+    char magic[8];
+    uint64_t hash;
+    uint32_t count;
+    uint32_t index;
+
+    if ( file == NULL ) {
+
+        snapshotError( "Cannot open snapshot" , resumeFile );
+
+    }
+
+    readBytes( file , magic , sizeof( magic ) , resumeFile );
+    readBytes( file , &hash , sizeof( hash ) , resumeFile );
+
+    if ( memcmp( magic , SNAPSHOT_MAGIC , sizeof( magic ) ) != 0 ) {
+
+        snapshotError( "Not a snapshot:" , resumeFile );
+
+    }
+
+    if ( hash != programHash ) {
+
+        snapshotError( "Snapshot was taken from a different program:" , resumeFile );
+
+    }
+
+    resume->position = readNumber( file , resumeFile );
+
+    if ( resume->position >= (uint32_t) tree->statementEnd ) {
+
+        snapshotError( "Snapshot position is not part of the program:" , resumeFile );
+
+    }
+
+    count = readNumber( file , resumeFile );
+
+    for ( index = 0 ; index < count ; index++ ) {
+
+        uint32_t identifierLength = readNumber( file , resumeFile );
+        char *identifier = malloc( identifierLength + 1 );
+        Symbol *symbol;
+
+        if ( identifier == NULL ) {
+
+            printf( "Error: Memory allocation failed. Program will be terminated\n" );
+            exit(1);
+
+        }
+
+        readBytes( file , identifier , identifierLength , resumeFile );
+        identifier[identifierLength] = '\0';
+
+        symbol = findSymbol( symbolTable , identifier );
+
+        if ( symbol == NULL || readNumber( file , resumeFile ) != (uint32_t) symbol->type || readNumber( file , resumeFile ) != (uint32_t) symbol->length ) {
+
+            snapshotError( "Snapshot declarations do not match the program:" , resumeFile );
+
+        }
+
+        readBytes( file , symbolValues( symbol ) , symbolBytes( symbol ) , resumeFile );
+
+        free( identifier );
+
+    }
+
+    allocateFrames( resume , readNumber( file , resumeFile ) );
+
+    for ( index = 0 ; index < resume->frameCount ; index++ ) {
+
+        resume->frameLoops[index] = readNumber( file , resumeFile );
+        readBytes( file , &resume->frameValues[3 * index] , 3 * sizeof( LoopValue ) , resumeFile );
+
+    }
+
+    fclose( file );
+
+}
+
+/**
+ * @brief verifies if the statement of a position is nested in a tree
+ */
+static int containsPosition( Node *tree , uint32_t position ) {
+
+    return tree != NULL && position >= (uint32_t) tree->statementIndex && position < (uint32_t) tree->statementEnd;
+
+}
+
+/**
+ * @brief obtains the position to go back to in the tree being resumed: the next call to be restored, or the saved statement
+ * once every call was restored
+ */
+static uint32_t resumePosition( Continuation *continuation ) {
+
+    return continuation->nextCall < continuation->callCount ? continuation->callPositions[continuation->nextCall] : continuation->position;
+
+}
+
+static void resumeTree( Node *tree , Symbol **symbolTable , Continuation *continuation );
+
+/**
+ * @brief enters again a call that was being executed and continues its body from the saved position. The locals keep the values
+ * they had in the call, and the values they had before it are restored when it returns
+ */
+static void resumeCall( Node *call , Symbol **symbolTable , Continuation *continuation ) {
+
+    Node *procedure = call->procedure;
+    FrameValue frame[procedure->localCount > 0 ? procedure->localCount : 1];
+    CallFrame callFrame;
+    int index;
+
+    memcpy( frame , &continuation->callValues[continuation->nextCallValue] , procedure->localCount * sizeof( FrameValue ) );
+
+    continuation->nextCallValue += (uint32_t) procedure->localCount;
+    continuation->nextCall++;
+
+    enterCallFrame( &callFrame , call , frame );
+    callDepth++;
+
+    resumeTree( procedure->body , symbolTable , continuation );
+
+    callDepth--;
+    leaveCallFrame( &callFrame );
+
+    for ( index = 0 ; index < procedure->localCount ; index++ ) {
+
+        memcpy( &procedure->locals[index]->value , &frame[index] , sizeof( FrameValue ) );
+
+    }
+}
+
+/**
+ * @brief continues a for loop from the iteration saved in its frame
+ */
+static void resumeForLoop( Node *tree , Symbol **symbolTable , Continuation *continuation ) {
+
+    LoopFrame frame;
+    LoopValue *saved;
+
+    if ( continuation->nextFrame >= continuation->frameCount || continuation->frameLoops[continuation->nextFrame] != (uint32_t) tree->statementIndex ) {
+
+        snapshotError( "Snapshot loops do not match the program:" , resumeFile );
+
+    }
+
+    saved = &continuation->frameValues[3 * continuation->nextFrame++];
+
+    enterLoopFrame( &frame , tree );
+
+    frame.iterator = saved[0];
+    frame.step     = saved[1];
+    frame.until    = saved[2];
+
+    //the rest of the current iteration
+    resumeTree( tree->doOptStmts , symbolTable , continuation );
+
+    //the following iterations, with the step and until values evaluated when the loop started
+    switch ( tree->symbolType ) {
+
+        case sINTEGER: {
+
+            int integerIterator;
+
+            for ( integerIterator = frame.iterator.iValue + frame.step.iValue ;
+                  frame.step.iValue < 0 ? integerIterator >= frame.until.iValue : integerIterator <= frame.until.iValue ;
+                  integerIterator += frame.step.iValue ) {
+
+                METRIC_ADD( loopIterations , 1 );
+
+                frame.iterator.iValue = integerIterator;
+                setIntegerSymbolValue( symbolTable , tree->value.idValue , integerIterator );
+                resolveTree( tree->doOptStmts , symbolTable );
+
+            }
+
+            setIntegerSymbolValue( symbolTable , tree->value.idValue , integerIterator - frame.step.iValue );
+
+            break;
+        }
+
+        case sFLOAT: {
+
+            float floatIterator;
+
+            for ( floatIterator = frame.iterator.fValue + frame.step.fValue ;
+                  frame.step.fValue < 0 ? floatIterator >= frame.until.fValue : floatIterator <= frame.until.fValue ;
+                  floatIterator += frame.step.fValue ) {
+
+                METRIC_ADD( loopIterations , 1 );
+
+                frame.iterator.fValue = floatIterator;
+                setFloatSymbolValue( symbolTable , tree->value.idValue , floatIterator );
+                resolveTree( tree->doOptStmts , symbolTable );
+
+            }
+
+            setFloatSymbolValue( symbolTable , tree->value.idValue , floatIterator - frame.step.fValue );
+
+            break;
+        }
+
+        case sLONG: {
+
+            long long longIterator;
+
+            for ( longIterator = frame.iterator.lValue + frame.step.lValue ;
+                  frame.step.lValue < 0 ? longIterator >= frame.until.lValue : longIterator <= frame.until.lValue ;
+                  longIterator += frame.step.lValue ) {
+
+                METRIC_ADD( loopIterations , 1 );
+
+                frame.iterator.lValue = longIterator;
+                setLongSymbolValue( symbolTable , tree->value.idValue , longIterator );
+                resolveTree( tree->doOptStmts , symbolTable );
+
+            }
+
+            setLongSymbolValue( symbolTable , tree->value.idValue , longIterator - frame.step.lValue );
+
+            break;
+        }
+
+        case sDOUBLE: {
+
+            double doubleIterator;
+
+            for ( doubleIterator = frame.iterator.dValue + frame.step.dValue ;
+                  frame.step.dValue < 0 ? doubleIterator >= frame.until.dValue : doubleIterator <= frame.until.dValue ;
+                  doubleIterator += frame.step.dValue ) {
+
+                METRIC_ADD( loopIterations , 1 );
+
+                frame.iterator.dValue = doubleIterator;
+                setDoubleSymbolValue( symbolTable , tree->value.idValue , doubleIterator );
+                resolveTree( tree->doOptStmts , symbolTable );
+
+            }
+
+            setDoubleSymbolValue( symbolTable , tree->value.idValue , doubleIterator - frame.step.dValue );
+
+            break;
+        }
+    }
+
+    leaveLoopFrame( &frame );
+
+}
+
+/**
+ * @brief goes back to the saved position through the statements that contain it, without executing the statements before it,
+ * and continues the execution from there
+ */
+static void resumeTree( Node *tree , Symbol **symbolTable , Continuation *continuation ) {
+
+    if ( (uint32_t) tree->statementIndex == resumePosition( continuation ) ) {
+
+        if ( continuation->nextCall < continuation->callCount ) {
+
+            resumeCall( tree , symbolTable , continuation );
+
+        } else {
+
+            resolveTree( tree , symbolTable );
+
+        }
+
+        return;
+
+    }
+
+    switch ( tree->type ) {
+
+        case nSEMICOLON:
+
+            if ( containsPosition( tree->leftStatement , resumePosition( continuation ) ) ) {
+
+                resumeTree( tree->leftStatement , symbolTable , continuation );
+                resolveTree( tree->rightStatement , symbolTable );
+
+            } else {
+
+                resumeTree( tree->rightStatement , symbolTable , continuation );
+
+            }
+
+        break;
+
+        case nIF: //the condition was true when the snapshot was taken
+
+            resumeTree( tree->thenOptStmts , symbolTable , continuation );
+
+        break;
+
+        case nWHILE:
+
+            resumeTree( tree->doOptStmts , symbolTable , continuation );
+
+            while ( evaluateExpresion( tree->expresion , symbolTable ) ) {
+
+                METRIC_ADD( loopIterations , 1 );
+
+                resolveTree( tree->doOptStmts , symbolTable );
+
+            }
+
+        break;
+
+        case nFOR:
+
+            resumeForLoop( tree , symbolTable , continuation );
+
+        break;
+
+        default: //statements without nested statements are only reached as the saved position
+
+        break;
+
+    }
+}
+
+void resumeContinuation( Node *tree , Symbol **symbolTable , Continuation *continuation ) {
+
+    executionGeneration++; //the values kept before the continuation was taken are not reused
+
+    resumeTree( tree , symbolTable , continuation );
+
+    releaseContinuation( continuation );
+
+}
+
+int resolveProgram( Node *tree , Symbol **symbolTable ) {
+
+    Continuation resume;
+
+    if ( tree == NULL || ( snapshotFile == NULL && resumeFile == NULL ) ) {
+
+        return resolveTree( tree , symbolTable );
+
+    }
+
+    numberStatements( tree , 0 );
+
+    programHash = hashProgram( tree , symbolTable );
+
+    if ( resumeFile == NULL ) {
+
+        return resolveTree( tree , symbolTable );
+
+    }
+
+    readSnapshot( &resume , tree , symbolTable );
+
+    resumeContinuation( tree , symbolTable , &resume );
+
+    return 1;
+
+}
+
+//end snapshot.c
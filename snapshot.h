@@ -0,0 +1,216 @@
+/**
+ * snapshot.h
+ * Definition of the snapshots of a running program and of the resume of a program from a snapshot or a continuation
+ * @author Jose Pablo Ortiz Lack
+ */
+#ifndef __SNAPSHOT_H__
+#define __SNAPSHOT_H__
+
+#include <signal.h>
+#include <stdint.h>
+
+#include "symbolTable.h"
+#include "syntaxTree.h"
+
+/**
+ * @brief exit status of a program that was terminated after writing a snapshot
+ */
+#define SNAPSHOT_EXIT_STATUS 3
+
+/**
+ * @brief a value of the iterator, step or until expresions of a for loop, depending on the type of the loop
+ */
+typedef union tagLoopValue {
+
+    int       iValue; //integer value
+    float     fValue; //float value
+    long long lValue; //long value
+    double    dValue; //double value
+
+} LoopValue;
+
+/**
+ * @brief the state of a for loop being executed. The frames live in the stack of the interpreter and are linked from the innermost loop outwards
+ */
+typedef struct tagLoopFrame {
+
+    Node *loop; //for statement being executed
+
+    LoopValue iterator; //value of the iterator in the current iteration
+    LoopValue step; //step evaluated when the loop started
+    LoopValue until; //until value evaluated when the loop started
+
+    int boundsHoisted; //1 if the array accesses of the body were marked as within bounds before the loop
+    long long boundsLow; //lowest value of the iterator used to mark the array accesses
+    long long boundsHigh; //highest value of the iterator used to mark the array accesses
+
+    struct tagLoopFrame *outer; //frame of the enclosing for loop, NULL if there is none
+
+} LoopFrame;
+
+/**
+ * @brief the value of a parameter or local symbol saved by a call frame
+ */
+typedef union tagFrameValue {
+
+    int       iValue; //integer value
+    float     fValue; //float value
+    long long lValue; //long value
+    double    dValue; //double value
+
+} FrameValue;
+
+/**
+ * @brief a procedure call being executed. The frames live in the stack of the interpreter and are linked from the innermost call outwards
+ */
+typedef struct tagCallFrame {
+
+    Node *call; //call statement being executed
+    FrameValue *savedLocals; //values the locals of the procedure had before the call, one per local
+
+    struct tagCallFrame *outer; //frame of the call that made this one, NULL if the statements of the program made it
+
+} CallFrame;
+
+/**
+ * @brief the point where the execution of a program stopped: the statement about to be executed, the calls being executed and the state
+ * of the enclosing for loops. The values of the symbols are kept in the symbol table
+ */
+typedef struct tagContinuation {
+
+    uint32_t position; //position of the statement to resume at, in the body of the innermost call if there are calls
+
+    uint32_t frameCount; //number of loop frames
+    uint32_t nextFrame; //next frame to be restored
+
+    uint32_t *frameLoops; //position of the for statement of each frame, from the outermost loop
+    LoopValue *frameValues; //iterator, step and until of each frame
+
+    uint32_t callCount; //number of calls being executed
+    uint32_t nextCall; //next call to be restored
+    uint32_t nextCallValue; //first saved local of the next call to be restored
+
+    uint32_t *callPositions; //position of each call statement in the tree that contains it, from the outermost call
+    FrameValue *callValues; //saved locals of each call, as many as the called procedure has locals, from the outermost call
+
+} Continuation;
+
+/**
+ * @brief signal that requested a snapshot, 0 if there is none. Snapshots are taken before the next statement is executed
+ */
+extern volatile sig_atomic_t snapshotRequested;
+
+/**
+ * @brief frame of the innermost for loop being executed, NULL if there is none
+ */
+extern LoopFrame *currentLoopFrame;
+
+/**
+ * @brief frame of the innermost procedure call being executed, NULL if there is none
+ */
+extern CallFrame *currentCallFrame;
+
+/**
+ * @brief makes SIGTERM write a snapshot and terminate the program with SNAPSHOT_EXIT_STATUS, and SIGUSR2 write a snapshot and continue
+ * @param fileName file where the snapshots are written
+ */
+void enableSnapshots( const char *fileName );
+
+/**
+ * @brief makes the program resume from a snapshot instead of starting from its first statement
+ * @param fileName file of the snapshot
+ */
+void enableResume( const char *fileName );
+
+/**
+ * @brief links the frame of a for loop that starts its execution
+ * @param frame frame of the loop
+ * @param loop for statement
+ */
+void enterLoopFrame( LoopFrame *frame , Node *loop );
+
+/**
+ * @brief unlinks the frame of a for loop that ended its execution
+ * @param frame frame of the loop
+ */
+void leaveLoopFrame( LoopFrame *frame );
+
+/**
+ * @brief links the frame of a procedure call whose body starts its execution
+ * @param frame frame of the call
+ * @param call call statement
+ * @param savedLocals values the locals of the procedure had before the call
+ */
+void enterCallFrame( CallFrame *frame , Node *call , FrameValue *savedLocals );
+
+/**
+ * @brief unlinks the frame of a procedure call whose body ended its execution
+ * @param frame frame of the call
+ */
+void leaveCallFrame( CallFrame *frame );
+
+/**
+ * @brief numbers the statements of a tree in pre-order, the numbers are the positions kept by snapshots and continuations.
+ * The body of every procedure called from the tree is numbered on its own from 0 the first time one of its calls is found
+ * @param tree tree to be numbered
+ * @param index position of the first statement
+ * @return the position after the last statement of the tree
+ */
+int numberStatements( Node *tree , int index );
+
+/**
+ * @brief indexes the statements of a numbered tree by position
+ * @param tree tree numbered with numberStatements
+ * @param statements where the statements are stored, one per position of the tree
+ */
+void collectStatements( Node *tree , Node **statements );
+
+/**
+ * @brief hashes the statements and declarations of a program, so files written by a run can be verified to belong to the same program
+ * @param tree tree of the program
+ * @param symbolTable the symbolTable of the compiler
+ * @return the hash of the program
+ */
+uint64_t hashProgram( Node *tree , Symbol **symbolTable );
+
+/**
+ * @brief saves the position of a statement, the frames of the for loops that enclose it and the frames of the calls being executed
+ * @param continuation where the position and frames are saved, its frames must be released with releaseContinuation
+ * @param position statement that is about to be executed
+ */
+void captureContinuation( Continuation *continuation , Node *position );
+
+/**
+ * @brief continues the execution of a program from a continuation, going back to its position through the statements that contain it
+ * without executing the statements before it. The frames of the continuation are released
+ * @param tree tree of the program, numbered with numberStatements
+ * @param symbolTable the symbolTable of the compiler, with the values the symbols had when the continuation was captured
+ * @param continuation continuation of the program
+ */
+void resumeContinuation( Node *tree , Symbol **symbolTable , Continuation *continuation );
+
+/**
+ * @brief releases the frames of a continuation that will not be resumed
+ * @param continuation continuation to be released
+ */
+void releaseContinuation( Continuation *continuation );
+
+/**
+ * @brief writes the values of the symbols, the position of the statement and the state of the enclosing for loops.
+ * If the snapshot was requested by SIGTERM the program is terminated
+ * @param position statement that is about to be executed
+ * @param symbolTable the symbolTable of the compiler
+ */
+void takeSnapshot( Node *position , Symbol **symbolTable );
+
+/**
+ * @brief executes a program from its first statement, or from the snapshot given to enableResume
+ * @param tree tree of the program
+ * @param symbolTable the symbolTable of the compiler
+ * @return 1 if the resolution concluded successfully
+ */
+int resolveProgram( Node *tree , Symbol **symbolTable );
+
+#endif //__SNAPSHOT_H__
+
+//end snapshot.h
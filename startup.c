@@ -0,0 +1,194 @@
+/**
+ * startup.c
+ * Implementation of the startup benchmark
+ *
+ * Every run starts the executable of the running compiler with posix_spawn and its standard output connected to a pipe.
+ * The time of a run ends when the first byte arrives through the pipe, which is what a caller of a short script waits for
+ * @author Jose Pablo Ortiz Lack
+ */
+#include "startup.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <spawn.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+extern char **environ;
+
+/**
+ * @brief the program whose first print is measured
+ */
+static const char *trivialProgram = "program p begin print 1 end\n";
+
+/**
+ * @brief obtains the current time in microseconds
+ */
+static double currentMicroseconds() {
+
+    struct timespec now;
+
+    clock_gettime( CLOCK_MONOTONIC , &now );
+
+    return now.tv_sec * 1000000.0 + now.tv_nsec / 1000.0;
+}
+
+/**
+ * @brief orders two times from the shortest to the longest
+ */
+static int compareTimes( const void *left , const void *right ) {
+
+    double leftTime  = *(const double *) left;
+    double rightTime = *(const double *) right;
+
+    return ( leftTime > rightTime ) - ( leftTime < rightTime );
+
+}
+
+/**
+ * @brief starts the compiler on the program once
+ * @return the microseconds until its first byte was read, a negative value if the run did not print "1" or did not exit successfully
+ */
+static double measureRun( const char *executable , char *fileName ) {
+
+    char *arguments[] = { (char *) executable , fileName , NULL };
+    posix_spawn_file_actions_t actions;
+    char output[16];
+    size_t length = 0;
+    ssize_t count;
+    double start;
+    double firstPrint = -1;
+    int status;
+    int channel[2];
+    pid_t child;
+
+    if ( pipe( channel ) != 0 ) {
+
+        return -1;
+
+    }
+
+    posix_spawn_file_actions_init( &actions );
+    posix_spawn_file_actions_adddup2( &actions , channel[1] , STDOUT_FILENO );
+    posix_spawn_file_actions_addclose( &actions , channel[0] );
+    posix_spawn_file_actions_addclose( &actions , channel[1] );
+    posix_spawn_file_actions_addopen( &actions , STDIN_FILENO , "/dev/null" , O_RDONLY , 0 );
+
+    start = currentMicroseconds();
+
+    if ( posix_spawn( &child , executable , &actions , NULL , arguments , environ ) != 0 ) {
+
+        posix_spawn_file_actions_destroy( &actions );
+        close( channel[0] );
+        close( channel[1] );
+
+        return -1;
+
+    }
+
+    posix_spawn_file_actions_destroy( &actions );
+    close( channel[1] );
+
+    while ( ( count = read( channel[0] , output + length , sizeof( output ) - 1 - length ) ) > 0 ) {
+
+        if ( length == 0 ) {
+
+            firstPrint = currentMicroseconds() - start;
+
+        }
+
+        length += count;
+
+        if ( length == sizeof( output ) - 1 ) {
+
+            break;
+
+        }
+    }
+
+    close( channel[0] );
+    waitpid( child , &status , 0 );
+
+    output[length] = '\0';
+
+    if ( !WIFEXITED( status ) || WEXITSTATUS( status ) != 0 || strcmp( output , "1\n" ) != 0 ) {
+
+        return -1;
+
+    }
+
+    return firstPrint;
+}
+
+int benchmarkStartup( int count ) {
+
+    char executable[PATH_MAX];
+    char fileName[] = "/tmp/slcstartupXXXXXX";
+    double *times = malloc( count * sizeof( double ) );
+    ssize_t executableLength = readlink( "/proc/self/exe" , executable , sizeof( executable ) - 1 );
+    int descriptor = mkstemp( fileName );
+    int run;
+
+    if ( times == NULL ) {
+
+        printf( "Error: Memory allocation failed. Program will be terminated\n" );
+        exit(1);
+
+    }
+
+    if ( executableLength < 0 || descriptor < 0 ) {
+
+        fprintf( stderr , "Error: cannot prepare the startup benchmark\n" );
+        free( times );
+
+        return 0;
+
+    }
+
+    executable[executableLength] = '\0';
+
+    if ( write( descriptor , trivialProgram , strlen( trivialProgram ) ) != (ssize_t) strlen( trivialProgram ) ) {
+
+        fprintf( stderr , "Error: cannot write %s\n" , fileName );
+        close( descriptor );
+        unlink( fileName );
+        free( times );
+
+        return 0;
+
+    }
+
+    close( descriptor );
+
+    for ( run = 0 ; run < count ; run++ ) {
+
+        if ( ( times[run] = measureRun( executable , fileName ) ) < 0 ) {
+
+            fprintf( stderr , "Error: run %d of %s did not print the output of the program\n" , run + 1 , executable );
+            unlink( fileName );
+            free( times );
+
+            return 0;
+
+        }
+    }
+
+    unlink( fileName );
+
+    qsort( times , count , sizeof( double ) , compareTimes );
+
+    fprintf( stderr , "startup: %d runs of %s\n" , count , executable );
+    fprintf( stderr , "time to first print: minimum %.1f us, median %.1f us, 90th percentile %.1f us\n" , times[0] , times[count / 2] ,
+             times[count * 9 / 10] );
+
+    free( times );
+
+    return 1;
+
+}
+
+//end startup.c
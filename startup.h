@@ -0,0 +1,19 @@
+/**
+ * startup.h
+ * Definition of the startup benchmark, which measures how long the compiler takes to start and print the output of a trivial program
+ * @author Jose Pablo Ortiz Lack
+ */
+#ifndef __STARTUP_H__
+#define __STARTUP_H__
+
+/**
+ * @brief runs the executable of the compiler on "program p begin print 1 end" as many times as requested, measuring the time from
+ * starting the process to reading the first byte it prints, and prints the minimum, median and 90th percentile to stderr
+ * @param count number of runs
+ * @return 1 if every run printed the expected output, 0 otherwise
+ */
+int benchmarkStartup( int count );
+
+#endif //__STARTUP_H__
+
+//end startup.h
@@ -0,0 +1,286 @@
+/**
+ * streaming.c
+ * Implementation of the streaming execution
+ *
+ * The parser allocates the nodes of every statement from the arena of the stream. When a top-level statement is reduced the
+ * lookahead is the semicolon or the end that follows it, which allocate nothing, so the arena holds that statement and nothing else.
+ * Without a queue the statement is executed right away and the arena is emptied for the next one. With a queue the arena moves
+ * into a slot of a ring that the executing thread consumes in order; the parser empties the arena of a slot when it takes the slot
+ * again, once the statement in it was executed, so the arenas are always released by the thread that accounted their memory
+ * @author Jose Pablo Ortiz Lack
+ */
+#include "streaming.h"
+#include "arena.h"
+#include "diagnostics.h"
+#include "metrics.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <pthread.h>
+
+int streamingEnabled = 0;
+
+int streamQueueCapacity = 0;
+
+/**
+ * @brief a statement waiting to be executed by the executing thread
+ */
+typedef struct tagQueuedStatement {
+
+    Node *statement; //statement tree
+    Arena arena; //nodes of the statement, released when the slot is taken again
+
+} QueuedStatement;
+
+static Symbol **streamSymbolTable = NULL; //the symbolTable of the program being streamed, NULL if the stream is not open
+
+static Arena statementArena; //nodes of the statement being parsed
+
+static Arena *outerArena = NULL; //arena of the thread before the stream was opened
+
+static QueuedStatement *queue = NULL; //ring of the statements parsed ahead, NULL if they are executed by the parser
+
+static unsigned long long queuedCount = 0; //statements queued by the parser
+
+static unsigned long long executedCount = 0; //statements executed by the executing thread
+
+static int queueClosed = 0; //set once the parser has queued the last statement
+
+static int executorWaiting = 0; //set while the executing thread waits for a statement
+
+static int parserWaiting = 0; //set while the parser waits for room in the queue
+
+static pthread_mutex_t queueLock = PTHREAD_MUTEX_INITIALIZER;
+
+static pthread_cond_t queueFilled = PTHREAD_COND_INITIALIZER; //signaled when a statement is queued or the queue is closed
+
+static pthread_cond_t queueDrained = PTHREAD_COND_INITIALIZER; //signaled when a statement was executed
+
+static pthread_t executor; //thread that executes the queued statements
+
+static Metrics executorMetrics; //counters of the executing thread once it finished
+
+/**
+ * @brief executes the queued statements in order until the queue is closed and empty
+ */
+static void *executeStatements( void *argument ) {
+
+    while ( 1 ) {
+
+        Node *statement;
+
+        pthread_mutex_lock( &queueLock );
+
+        //the output of the statements executed so far is written while the parser is behind, not when the program ends
+        if ( executedCount == queuedCount && !queueClosed ) {
+
+            pthread_mutex_unlock( &queueLock );
+
+            fflush( programOutput != NULL ? programOutput : stdout );
+
+            pthread_mutex_lock( &queueLock );
+
+        }
+
+        while ( executedCount == queuedCount && !queueClosed ) {
+
+            executorWaiting = 1;
+
+            pthread_cond_wait( &queueFilled , &queueLock );
+
+        }
+
+        executorWaiting = 0;
+
+        if ( executedCount == queuedCount ) {
+
+            pthread_mutex_unlock( &queueLock );
+
+            break;
+
+        }
+
+        statement = queue[executedCount % streamQueueCapacity].statement;
+
+        pthread_mutex_unlock( &queueLock );
+
+        resolveTree( statement , streamSymbolTable );
+
+        pthread_mutex_lock( &queueLock );
+
+        executedCount++;
+
+        //the parser is woken once half of the queue is free, not for every statement, so the threads do not switch for each one
+        if ( parserWaiting && queuedCount - executedCount <= (unsigned long long) streamQueueCapacity / 2 ) {
+
+            pthread_cond_signal( &queueDrained );
+
+        }
+
+        pthread_mutex_unlock( &queueLock );
+
+    }
+
+    executorMetrics = metrics;
+
+    return NULL;
+}
+
+void openStatementStream( Symbol **symbolTable ) {
+
+    sigset_t blocked;
+    sigset_t previous;
+
+    streamSymbolTable = symbolTable;
+    outerArena        = currentArena;
+    currentArena      = &statementArena;
+
+    if ( streamQueueCapacity <= 0 ) {
+
+        return;
+
+    }
+
+    queue         = calloc( streamQueueCapacity , sizeof( QueuedStatement ) );
+    queuedCount   = 0;
+    executedCount = 0;
+    queueClosed   = 0;
+
+    if ( queue == NULL ) {
+
+        printf( "Error: Memory allocation failed. Program will be terminated\n" );
+        exit(1);
+
+    }
+
+    //the executing thread is created with every signal blocked, so the signals keep being handled by the parser
+    sigfillset( &blocked );
+    pthread_sigmask( SIG_SETMASK , &blocked , &previous );
+
+    if ( pthread_create( &executor , NULL , executeStatements , NULL ) != 0 ) {
+
+        printf( "Error: Cannot create the thread of the statement stream. Program will be terminated\n" );
+        exit(1);
+
+    }
+
+    pthread_sigmask( SIG_SETMASK , &previous , NULL );
+
+}
+
+void streamStatement( Node *statement ) {
+
+    QueuedStatement *slot;
+
+    //after an error the lookahead may be any token, so the arena is kept until the stream is closed
+    if ( statement == NULL || diagnosticCount > 0 || memoryLimitExceeded ) {
+
+        return;
+
+    }
+
+    if ( queue == NULL ) {
+
+        resolveTree( statement , streamSymbolTable );
+
+        releaseArena( &statementArena );
+
+        return;
+
+    }
+
+    pthread_mutex_lock( &queueLock );
+
+    if ( queuedCount - executedCount == (unsigned long long) streamQueueCapacity ) {
+
+        parserWaiting = 1;
+
+        while ( queuedCount - executedCount > (unsigned long long) streamQueueCapacity / 2 ) {
+
+            pthread_cond_wait( &queueDrained , &queueLock );
+
+        }
+
+        parserWaiting = 0;
+
+    }
+
+    slot = &queue[queuedCount % streamQueueCapacity];
+
+    pthread_mutex_unlock( &queueLock );
+
+    //the statement that was in the slot has been executed
+    releaseArena( &slot->arena );
+
+    slot->statement = statement;
+    slot->arena     = statementArena;
+
+    memset( &statementArena , 0 , sizeof( Arena ) );
+
+    pthread_mutex_lock( &queueLock );
+
+    queuedCount++;
+
+    //the executing thread is also woken once half of the queue is filled
+    if ( executorWaiting && queuedCount - executedCount >= (unsigned long long) ( streamQueueCapacity + 1 ) / 2 ) {
+
+        pthread_cond_signal( &queueFilled );
+
+    }
+
+    pthread_mutex_unlock( &queueLock );
+
+}
+
+void closeStatementStream() {
+
+    int index;
+
+    if ( streamSymbolTable == NULL ) {
+
+        return;
+
+    }
+
+    if ( queue != NULL ) {
+
+        pthread_mutex_lock( &queueLock );
+
+        queueClosed = 1;
+
+        pthread_cond_signal( &queueFilled );
+        pthread_mutex_unlock( &queueLock );
+
+        pthread_join( executor , NULL );
+
+        addMetrics( &executorMetrics );
+
+        for ( index = 0 ; index < streamQueueCapacity ; index++ ) {
+
+            releaseArena( &queue[index].arena );
+
+        }
+
+        free( queue );
+
+        queue = NULL;
+
+    }
+
+    currentArena = outerArena;
+
+    releaseArena( &statementArena );
+
+    streamSymbolTable = NULL;
+
+}
+
+int isStatementStreamOpen() {
+
+    return streamSymbolTable != NULL;
+
+}
+
+//end streaming.c
@@ -0,0 +1,59 @@
+/**
+ * streaming.h
+ * Definition of the streaming execution, which executes every statement of the body of a program as soon as it is parsed and
+ * releases it, so neither the time to the first output nor the memory of the compiler grow with the length of the program
+ * @author Jose Pablo Ortiz Lack
+ */
+#ifndef __STREAMING_H__
+#define __STREAMING_H__
+
+#include "symbolTable.h"
+#include "syntaxTree.h"
+
+/**
+ * @brief executes the programs with the statement stream instead of parsing them completely first, 0 by default
+ */
+extern int streamingEnabled;
+
+/**
+ * @brief statements parsed ahead of the execution when the statements are executed by a thread of their own, 0 to execute every
+ * statement on the thread of the parser before the next one is parsed. The executing thread writes the output every time it waits
+ * for the parser
+ */
+extern int streamQueueCapacity;
+
+/**
+ * @brief starts the stream once the declarations and the procedures of a program are parsed. The nodes of the statements that
+ * follow are allocated from an arena of the stream, which becomes the arena of the current thread, and the executing thread is
+ * started if streamQueueCapacity is set
+ * @param symbolTable the symbolTable of the compiler, which is not modified while the stream is open
+ */
+void openStatementStream( Symbol **symbolTable );
+
+/**
+ * @brief executes a top-level statement whose nested blocks are completely parsed, or queues it for the executing thread, and
+ * releases every node allocated since the previous statement once it is executed. The queue waits for the executing thread when
+ * it is full. The statements that follow an error are parsed and checked but not executed, and their nodes are kept until the
+ * stream is closed.
+ * The whole-program optimizations are not applied: the statements are executed as they were parsed, with their vectorized loops,
+ * and the operations are shared only inside a statement
+ * @param statement statement tree, NULL if the statement had errors
+ */
+void streamStatement( Node *statement );
+
+/**
+ * @brief waits for the queued statements to be executed, stops the executing thread and adds its metrics to the metrics of the
+ * current thread. Every node of the stream is released and the arena of the current thread is restored. Nothing is done if the
+ * stream was not opened
+ */
+void closeStatementStream();
+
+/**
+ * @brief verifies if the stream is open, when the parser may still read the symbols while a statement is executed
+ * @return 1 if the stream was opened and not closed yet
+ */
+int isStatementStreamOpen();
+
+#endif //__STREAMING_H__
+
+//end streaming.h
@@ -4,26 +4,24 @@
  * @author Jose Pablo Ortiz Lack
  */
 #include "symbolTable.h"
+#include "diagnostics.h"
+#include "metrics.h"
+#include "profile.h"
+#include "trace.h"
+#include "arena.h"
+#include "session.h"
 
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
 
 /**
- * @brief Allocates space for the Symbol
- * @return The Symbol or NULL if there is not enough memory
+ * @brief Allocates space for the Symbol, from the arena of the thread if it has one
+ * @return The Symbol. The program is terminated if there is not enough memory
  */
 static Symbol *allocateSymbol() {
 
-    Symbol *symbol = malloc( sizeof( Symbol ) );
-
-    //if there was not enough memory, malloc returns null
-    if ( symbol == NULL ) {
-
-        return NULL;
-    }
-
-    return symbol;
+    return allocateCompilerMemory( sizeof( Symbol ) , _Alignof( Symbol ) , aSYMBOLS );
 
 }
 
@@ -49,10 +47,13 @@ int insertSymbol( Symbol **head, char *identifier , SymbolType type) {
             }
 
             new->type       = type;
+            new->length     = 0;
+            new->profile    = NULL;
+            new->procedure  = NULL;
+            new->slot       = new->next == NULL ? 0 : new->next->slot + 1;
             
             //reserve memory for the identifier and copy the identifier to the new symbol
-            new->identifier = malloc( ( strlen( identifier ) + 1 ) * sizeof( char ) );
-            strcpy( new->identifier , identifier );
+            new->identifier = copyCompilerString( identifier , strlen( identifier ) );
 
             if ( type == sINTEGER ) {
 
@@ -62,6 +63,14 @@ int insertSymbol( Symbol **head, char *identifier , SymbolType type) {
 
                 new->value.fValue = 0.0;
 
+            } else if ( type == sLONG ) {
+
+                new->value.lValue = 0;
+
+            } else if ( type == sDOUBLE ) {
+
+                new->value.dValue = 0.0;
+
             }
 
             return 1;
@@ -76,20 +85,62 @@ int insertSymbol( Symbol **head, char *identifier , SymbolType type) {
 
     } else {
 
-        printf( "Error: Symbol to be inserted already exists. Program will be terminated\n" );
-        exit(1);
+        reportError( "Symbol %s is already declared" , identifier );
+
+        return 0;
 
     }
 
 }
 
+int insertArraySymbol( Symbol **head , char *identifier , SymbolType type , int length ) {
+
+    void *elements = NULL;
+    size_t elementSize = ( type == sLONG || type == sDOUBLE ) ? sizeof( long long ) : sizeof( int );
+
+    if ( length <= 0 ) {
+
+        reportError( "Length of array %s must be greater than 0" , identifier );
+
+        return 0;
+
+    }
+
+    if ( findSymbol( head , identifier ) != NULL ) {
+
+        reportError( "Symbol %s is already declared" , identifier );
+
+        return 0;
+
+    }
+
+    //reserve an aligned contiguous buffer for the elements
+    elements = allocateCompilerMemory( (size_t) length * elementSize , SYMBOL_ARRAY_ALIGNMENT , aRUNTIME );
+
+    insertSymbol( head , identifier , type ); //the new symbol becomes the head of the table
+
+    ( *head )->length = length;
+
+    //all the element pointers share the same storage in the value union
+    ( *head )->value.iElements = elements;
+
+    return 1;
+
+}
+
 Symbol *findSymbol( Symbol **head , char *identifier ) {
 
     Symbol *result =  *head; //We start searching at the beginning of the table
+
+    METRIC_ADD( symbolLookups , 1 );
     
     while ( result != NULL ) { //Traverse the complete table
+
+        METRIC_ADD( symbolsTraversed , 1 );
     
         if ( strcmp( result->identifier , identifier ) == 0 ) { //If the identifier of the current node matches the search criteria
+
+            PROFILE_LOOKUP( result );
             
             return result;
 
@@ -106,8 +157,7 @@ int setIntegerSymbolValue( Symbol **head , char *identifier , int newValue ) {
     //verify the table is not empty
     if ( *head == NULL ) {
         
-        printf( "Error: Cannot assign value to undeclared symbol. Program will be terminated\n" );
-        exit(1);
+        runtimeError( "Error: Cannot assign value to undeclared symbol. Program will be terminated\n" );
 
     }
 
@@ -115,11 +165,27 @@ int setIntegerSymbolValue( Symbol **head , char *identifier , int newValue ) {
 
     if ( updateSymbol == NULL ) { //The symbol was not found
         
-        printf( "Error: Cannot assign value to undeclared symbol. Program will be terminated\n" );
-        exit(1);
+        runtimeError( "Error: Cannot assign value to undeclared symbol. Program will be terminated\n" );
         
     }
 
+    PROFILE_VALUE( updateSymbol , newValue );
+    TRACE_VALUE( updateSymbol , TRACE_NO_INDEX , newValue );
+
+    if ( updateSymbol->length > 0 ) { //assigning an array updates every element
+
+        int index;
+
+        for ( index = 0 ; index < updateSymbol->length ; index++ ) {
+
+            updateSymbol->value.iElements[index] = newValue;
+
+        }
+
+        return 1;
+
+    }
+
     updateSymbol->value.iValue = newValue;
 
     return 1;
@@ -131,8 +197,7 @@ int setFloatSymbolValue( Symbol **head, char *identifier, float newValue ) {
     //verify the table is not empty
     if ( *head == NULL ) {
         
-        printf( "Error: Cannot assign value to undeclared symbol. Program will be terminated\n" );
-        exit(1);
+        runtimeError( "Error: Cannot assign value to undeclared symbol. Program will be terminated\n" );
         
     }
 
@@ -140,24 +205,119 @@ int setFloatSymbolValue( Symbol **head, char *identifier, float newValue ) {
 
     if ( updateSymbol == NULL ) { //The symbol was not found
         
-        printf( "Error: Cannot assign value to undeclared symbol. Program will be terminated\n" );
-        exit(1);
+        runtimeError( "Error: Cannot assign value to undeclared symbol. Program will be terminated\n" );
         
     }
 
+    PROFILE_VALUE( updateSymbol , newValue );
+    TRACE_VALUE( updateSymbol , TRACE_NO_INDEX , newValue );
+
+    if ( updateSymbol->length > 0 ) { //assigning an array updates every element
+
+        int index;
+
+        for ( index = 0 ; index < updateSymbol->length ; index++ ) {
+
+            updateSymbol->value.fElements[index] = newValue;
+
+        }
+
+        return 1;
+
+    }
+
     updateSymbol->value.fValue = newValue;
 
     return 1;
 
 }
 
+int setLongSymbolValue( Symbol **head , char *identifier , long long newValue ) {
+
+    //verify the table is not empty
+    if ( *head == NULL ) {
+        
+        runtimeError( "Error: Cannot assign value to undeclared symbol. Program will be terminated\n" );
+        
+    }
+
+    Symbol *updateSymbol = findSymbol( head, identifier ); //Search the symbol to be updated
+
+    if ( updateSymbol == NULL ) { //The symbol was not found
+        
+        runtimeError( "Error: Cannot assign value to undeclared symbol. Program will be terminated\n" );
+        
+    }
+
+    PROFILE_VALUE( updateSymbol , newValue );
+    TRACE_VALUE( updateSymbol , TRACE_NO_INDEX , newValue );
+
+    if ( updateSymbol->length > 0 ) { //assigning an array updates every element
+
+        int index;
+
+        for ( index = 0 ; index < updateSymbol->length ; index++ ) {
+
+            updateSymbol->value.lElements[index] = newValue;
+
+        }
+
+        return 1;
+
+    }
+
+    updateSymbol->value.lValue = newValue;
+
+    return 1;
+
+}
+
+int setDoubleSymbolValue( Symbol **head , char *identifier , double newValue ) {
+
+    //verify the table is not empty
+    if ( *head == NULL ) {
+        
+        runtimeError( "Error: Cannot assign value to undeclared symbol. Program will be terminated\n" );
+        
+    }
+
+    Symbol *updateSymbol = findSymbol( head, identifier ); //Search the symbol to be updated
+
+    if ( updateSymbol == NULL ) { //The symbol was not found
+        
+        runtimeError( "Error: Cannot assign value to undeclared symbol. Program will be terminated\n" );
+        
+    }
+
+    PROFILE_VALUE( updateSymbol , newValue );
+    TRACE_VALUE( updateSymbol , TRACE_NO_INDEX , newValue );
+
+    if ( updateSymbol->length > 0 ) { //assigning an array updates every element
+
+        int index;
+
+        for ( index = 0 ; index < updateSymbol->length ; index++ ) {
+
+            updateSymbol->value.dElements[index] = newValue;
+
+        }
+
+        return 1;
+
+    }
+
+    updateSymbol->value.dValue = newValue;
+
+    return 1;
+
+}
+
 int getIntegerSymbolValue( Symbol **head, char *identifier ) {
 
     //verify the table is not empty
     if ( *head == NULL ) {
         
-        printf( "Error: Cannot obtain value from undeclared symbol. Program will be terminated\n" );
-        exit(1);
+        runtimeError( "Error: Cannot obtain value from undeclared symbol. Program will be terminated\n" );
         
     }
 
@@ -165,8 +325,7 @@ int getIntegerSymbolValue( Symbol **head, char *identifier ) {
 
     if ( symbol == NULL ) { //The symbol was not found
         
-        printf( "Error: Cannot obtain value from undeclared symbol. Program will be terminated\n" );
-        exit(1);
+        runtimeError( "Error: Cannot obtain value from undeclared symbol. Program will be terminated\n" );
         
     }
 
@@ -179,8 +338,7 @@ float getFloatSymbolValue( Symbol **head , char *identifier ) {
     //verify the table is not empty
     if ( *head == NULL ) {
         
-        printf( "Error: Cannot obtain value from undeclared symbol. Program will be terminated\n" );
-        exit(1);
+        runtimeError( "Error: Cannot obtain value from undeclared symbol. Program will be terminated\n" );
         
     }
 
@@ -188,8 +346,7 @@ float getFloatSymbolValue( Symbol **head , char *identifier ) {
 
     if ( symbol == NULL ) { //The symbol was not found
         
-        printf( "Error: Cannot obtain value from undeclared symbol. Program will be terminated\n" );
-        exit(1);
+        runtimeError( "Error: Cannot obtain value from undeclared symbol. Program will be terminated\n" );
         
     }
 
@@ -197,13 +354,54 @@ float getFloatSymbolValue( Symbol **head , char *identifier ) {
 
 }
 
+long long getLongSymbolValue( Symbol **head , char *identifier ) {
+
+    //verify the table is not empty
+    if ( *head == NULL ) {
+        
+        runtimeError( "Error: Cannot obtain value from undeclared symbol. Program will be terminated\n" );
+        
+    }
+
+    Symbol *symbol = findSymbol( head , identifier ); //Search the symbol to get the value from
+
+    if ( symbol == NULL ) { //The symbol was not found
+        
+        runtimeError( "Error: Cannot obtain value from undeclared symbol. Program will be terminated\n" );
+        
+    }
+
+    return symbol->value.lValue;
+
+}
+
+double getDoubleSymbolValue( Symbol **head , char *identifier ) {
+
+    //verify the table is not empty
+    if ( *head == NULL ) {
+        
+        runtimeError( "Error: Cannot obtain value from undeclared symbol. Program will be terminated\n" );
+        
+    }
+
+    Symbol *symbol = findSymbol( head , identifier ); //Search the symbol to get the value from
+
+    if ( symbol == NULL ) { //The symbol was not found
+        
+        runtimeError( "Error: Cannot obtain value from undeclared symbol. Program will be terminated\n" );
+        
+    }
+
+    return symbol->value.dValue;
+
+}
+
 SymbolType getSymbolType( Symbol **head , char * identifier ) {
 
     //verify the table is not empty
     if ( *head == NULL ) {
         
-        printf("Error: Cannot obtain symbol type from undeclared symbol. Program will be terminated\n");
-        exit(1);
+        runtimeError("Error: Cannot obtain symbol type from undeclared symbol. Program will be terminated\n");
         
     }
 
@@ -211,8 +409,7 @@ SymbolType getSymbolType( Symbol **head , char * identifier ) {
 
     if ( symbol == NULL ) { //The symbol was not found
         
-        printf( "Error: Cannot obtain symbol type from undeclared symbol. Program will be terminated\n" );
-        exit(1);
+        runtimeError( "Error: Cannot obtain symbol type from undeclared symbol. Program will be terminated\n" );
         
     }
 
@@ -220,4 +417,139 @@ SymbolType getSymbolType( Symbol **head , char * identifier ) {
 
 }
 
+int getSymbolLength( Symbol **head , char *identifier ) {
+
+    Symbol *symbol = findSymbol( head , identifier ); //Search the symbol to get the length from
+
+    if ( symbol == NULL ) { //The symbol was not found
+        
+        runtimeError( "Error: Cannot obtain length from undeclared symbol. Program will be terminated\n" );
+        
+    }
+
+    return symbol->length;
+
+}
+
+int getSlotCount( Symbol **head ) {
+
+    Symbol *symbol;
+    int slotCount = 0;
+
+    for ( symbol = *head ; symbol != NULL ; symbol = symbol->next ) {
+
+        if ( symbol->slot >= slotCount ) {
+
+            slotCount = symbol->slot + 1;
+
+        }
+    }
+
+    return slotCount;
+
+}
+
+/**
+ * @brief searches an array symbol by identifier
+ * If the symbol has not been declared or is not an array, an error will be printed and the program will terminate.
+ * @param head reference to the head of the table
+ * @param identifier identifier of the array
+ * @return the array symbol
+ */
+static Symbol *findArraySymbol( Symbol **head , char *identifier ) {
+
+    Symbol *symbol = findSymbol( head , identifier );
+
+    if ( symbol == NULL ) { //The symbol was not found
+        
+        runtimeError( "Error: Cannot access element of undeclared symbol. Program will be terminated\n" );
+        
+    }
+
+    if ( symbol->length == 0 ) { //The symbol is a scalar
+
+        runtimeError( "Error: Cannot access element of a symbol that is not an array. Program will be terminated\n" );
+
+    }
+
+    return symbol;
+
+}
+
+int setIntegerElementValue( Symbol **head , char *identifier , int index , int newValue ) {
+
+    Symbol *symbol = findArraySymbol( head , identifier );
+
+    PROFILE_VALUE( symbol , newValue );
+    TRACE_VALUE( symbol , (uint32_t) index , newValue );
+
+    symbol->value.iElements[index] = newValue;
+
+    return 1;
+
+}
+
+int setFloatElementValue( Symbol **head , char *identifier , int index , float newValue ) {
+
+    Symbol *symbol = findArraySymbol( head , identifier );
+
+    PROFILE_VALUE( symbol , newValue );
+    TRACE_VALUE( symbol , (uint32_t) index , newValue );
+
+    symbol->value.fElements[index] = newValue;
+
+    return 1;
+
+}
+
+int getIntegerElementValue( Symbol **head , char *identifier , int index ) {
+
+    return findArraySymbol( head , identifier )->value.iElements[index];
+
+}
+
+float getFloatElementValue( Symbol **head , char *identifier , int index ) {
+
+    return findArraySymbol( head , identifier )->value.fElements[index];
+
+}
+
+int setLongElementValue( Symbol **head , char *identifier , int index , long long newValue ) {
+
+    Symbol *symbol = findArraySymbol( head , identifier );
+
+    PROFILE_VALUE( symbol , newValue );
+    TRACE_VALUE( symbol , (uint32_t) index , newValue );
+
+    symbol->value.lElements[index] = newValue;
+
+    return 1;
+
+}
+
+int setDoubleElementValue( Symbol **head , char *identifier , int index , double newValue ) {
+
+    Symbol *symbol = findArraySymbol( head , identifier );
+
+    PROFILE_VALUE( symbol , newValue );
+    TRACE_VALUE( symbol , (uint32_t) index , newValue );
+
+    symbol->value.dElements[index] = newValue;
+
+    return 1;
+
+}
+
+long long getLongElementValue( Symbol **head , char *identifier , int index ) {
+
+    return findArraySymbol( head , identifier )->value.lElements[index];
+
+}
+
+double getDoubleElementValue( Symbol **head , char *identifier , int index ) {
+
+    return findArraySymbol( head , identifier )->value.dElements[index];
+
+}
+
 //end symbolTable.c
\ No newline at end of file
@@ -7,13 +7,20 @@
 #ifndef __SYMBOL_TABLE_H__
 #define __SYMBOL_TABLE_H__
 
+/**
+ * @brief alignment in bytes of the array buffers, wide enough for any vector register
+ */
+#define SYMBOL_ARRAY_ALIGNMENT 64
+
 /**
  * @brief The symbol type
  */
 typedef enum tagSymbolType {
 
     sINTEGER,
-    sFLOAT
+    sFLOAT,
+    sLONG,
+    sDOUBLE
 
 } SymbolType;
 
@@ -25,28 +32,53 @@ typedef struct tagSymbol {
     SymbolType  type; //type of symbol
     
     char* identifier; //name of the symbol
+
+    int length; //number of elements if the symbol is an array, 0 if the symbol is a scalar
+
+    int slot; //position of the symbol in declaration order, starting at 0
     
     union {
 
-        int   iValue; //integer value
-        float fValue; //float value
+        int       iValue; //integer value
+        float     fValue; //float value
+        long long lValue; //long value
+        double    dValue; //double value
+        int       *iElements; //elements of an integer array, aligned to SYMBOL_ARRAY_ALIGNMENT bytes
+        float     *fElements; //elements of a float array, aligned to SYMBOL_ARRAY_ALIGNMENT bytes
+        long long *lElements; //elements of a long array, aligned to SYMBOL_ARRAY_ALIGNMENT bytes
+        double    *dElements; //elements of a double array, aligned to SYMBOL_ARRAY_ALIGNMENT bytes
 
     } value; //value of the symbol
 
+    struct tagSymbolProfile *profile; //counters of the symbol while a profile is recorded, NULL otherwise
+
+    struct tagNode *procedure; //definition of the procedure if the symbol is a procedure, NULL otherwise
+
     struct tagSymbol *next; //next element of the symbol table
 
 } Symbol;
 
 /**
  * @brief inserts a new symbol at the beggining of the list and initializes it with the value of 0.
- * If the symbol already exists or there is a memory error, the program will terminate.
+ * If the symbol already exists an error is added to the diagnostics. If there is a memory error, the program will terminate.
  * @param head reference to the head of the table
  * @param type type of symbol to be added
  * @param identifier identifier of the symbol to be added
-  * @return  1 if the symbol was added successfully
+  * @return  1 if the symbol was added successfully, 0 if it already existed
  */
 int insertSymbol( Symbol **head , char *identifier , SymbolType type );
 
+/**
+ * @brief inserts a new array symbol at the beggining of the list. Its elements are stored in a contiguous aligned buffer initialized with 0.
+ * If the symbol already exists or the length is not positive, an error is added to the diagnostics. If there is a memory error, the program will terminate.
+ * @param head reference to the head of the table
+ * @param identifier identifier of the symbol to be added
+ * @param type type of the elements of the array
+ * @param length number of elements of the array
+ * @return 1 if the symbol was added successfully, 0 if it was not added
+ */
+int insertArraySymbol( Symbol **head , char *identifier , SymbolType type , int length );
+
 /**
  * @brief searches a symbol by identifier
  * @param head reference to the head of the table
@@ -57,7 +89,7 @@ Symbol *findSymbol( Symbol **head , char *identifier );
 
 
 /**
- * @brief updates the value of an integer symbol.
+ * @brief updates the value of an integer symbol. If the symbol is an array every element is updated.
  * If the symbol has not been declared, an error will be printed and the program will terminate.
  * @param head reference to the head of the table
  * @param identifier identifier of the symbol
@@ -67,7 +99,7 @@ Symbol *findSymbol( Symbol **head , char *identifier );
 int setIntegerSymbolValue( Symbol **head , char *identifier , int newValue );
 
 /**
- * @brief updates the value of an integer symbol
+ * @brief updates the value of a float symbol. If the symbol is an array every element is updated.
  * If the symbol has not been initialized, an error will be printed and the program will terminate.
  * @param head reference to the head of the table
  * @param identifier identifier of the symbol
@@ -76,6 +108,26 @@ int setIntegerSymbolValue( Symbol **head , char *identifier , int newValue );
  */
 int setFloatSymbolValue( Symbol **head , char *identifier , float newValue );
 
+/**
+ * @brief updates the value of a long symbol. If the symbol is an array every element is updated.
+ * If the symbol has not been initialized, an error will be printed and the program will terminate.
+ * @param head reference to the head of the table
+ * @param identifier identifier of the symbol
+ * @param newValue updated value of the symbol
+ * @return 1 if the update was sucessful
+ */
+int setLongSymbolValue( Symbol **head , char *identifier , long long newValue );
+
+/**
+ * @brief updates the value of a double symbol. If the symbol is an array every element is updated.
+ * If the symbol has not been initialized, an error will be printed and the program will terminate.
+ * @param head reference to the head of the table
+ * @param identifier identifier of the symbol
+ * @param newValue updated value of the symbol
+ * @return 1 if the update was sucessful
+ */
+int setDoubleSymbolValue( Symbol **head , char *identifier , double newValue );
+
 /**
  * @brief obtains the value of an integer symbol
  * If the symbol has not been initialized, an error will be printed and the program will terminate.
@@ -94,6 +146,24 @@ int getIntegerSymbolValue( Symbol **head , char *identifier );
  */
 float getFloatSymbolValue( Symbol **head , char *identifier );
 
+/**
+ * @brief obtains the value of a long symbol
+ * If the symbol has not been initialized, an error will be printed and the program will terminate.
+ * @param head reference to the head of the table
+ * @param identifier identifier of the symbol
+ * @return the long value of the symbol
+ */
+long long getLongSymbolValue( Symbol **head , char *identifier );
+
+/**
+ * @brief obtains the value of a double symbol
+ * If the symbol has not been initialized, an error will be printed and the program will terminate.
+ * @param head reference to the head of the table
+ * @param identifier identifier of the symbol
+ * @return the double value of the symbol
+ */
+double getDoubleSymbolValue( Symbol **head , char *identifier );
+
 /**
  * @brief obtains the symbol type of a symbol
  * If the symbol has not been initialized, an error will be printed and the program will terminate.
@@ -103,6 +173,107 @@ float getFloatSymbolValue( Symbol **head , char *identifier );
  */
 SymbolType getSymbolType( Symbol **head , char * identifier);
 
+/**
+ * @brief obtains the number of elements of a symbol
+ * If the symbol has not been initialized, an error will be printed and the program will terminate.
+ * @param head reference to the head of the table
+ * @param identifier identifier of the symbol
+ * @return the number of elements of the array or 0 if the symbol is a scalar
+ */
+int getSymbolLength( Symbol **head , char *identifier );
+
+/**
+ * @brief obtains the number of slots of the table, one more than its highest slot. The head may not have the highest slot once
+ * a profile reordered the table
+ * @param head reference to the head of the table
+ * @return the number of slots
+ */
+int getSlotCount( Symbol **head );
+
+/**
+ * @brief updates an element of an integer array. The index is not verified against the length of the array.
+ * If the symbol has not been initialized or is not an array, an error will be printed and the program will terminate.
+ * @param head reference to the head of the table
+ * @param identifier identifier of the array
+ * @param index index of the element
+ * @param newValue updated value of the element
+ * @return 1 if the update was sucessful
+ */
+int setIntegerElementValue( Symbol **head , char *identifier , int index , int newValue );
+
+/**
+ * @brief updates an element of a float array. The index is not verified against the length of the array.
+ * If the symbol has not been initialized or is not an array, an error will be printed and the program will terminate.
+ * @param head reference to the head of the table
+ * @param identifier identifier of the array
+ * @param index index of the element
+ * @param newValue updated value of the element
+ * @return 1 if the update was sucessful
+ */
+int setFloatElementValue( Symbol **head , char *identifier , int index , float newValue );
+
+/**
+ * @brief obtains an element of an integer array. The index is not verified against the length of the array.
+ * If the symbol has not been initialized or is not an array, an error will be printed and the program will terminate.
+ * @param head reference to the head of the table
+ * @param identifier identifier of the array
+ * @param index index of the element
+ * @return the integer value of the element
+ */
+int getIntegerElementValue( Symbol **head , char *identifier , int index );
+
+/**
+ * @brief obtains an element of a float array. The index is not verified against the length of the array.
+ * If the symbol has not been initialized or is not an array, an error will be printed and the program will terminate.
+ * @param head reference to the head of the table
+ * @param identifier identifier of the array
+ * @param index index of the element
+ * @return the float value of the element
+ */
+float getFloatElementValue( Symbol **head , char *identifier , int index );
+
+/**
+ * @brief updates an element of a long array. The index is not verified against the length of the array.
+ * If the symbol has not been initialized or is not an array, an error will be printed and the program will terminate.
+ * @param head reference to the head of the table
+ * @param identifier identifier of the array
+ * @param index index of the element
+ * @param newValue updated value of the element
+ * @return 1 if the update was sucessful
+ */
+int setLongElementValue( Symbol **head , char *identifier , int index , long long newValue );
+
+/**
+ * @brief updates an element of a double array. The index is not verified against the length of the array.
+ * If the symbol has not been initialized or is not an array, an error will be printed and the program will terminate.
+ * @param head reference to the head of the table
+ * @param identifier identifier of the array
+ * @param index index of the element
+ * @param newValue updated value of the element
+ * @return 1 if the update was sucessful
+ */
+int setDoubleElementValue( Symbol **head , char *identifier , int index , double newValue );
+
+/**
+ * @brief obtains an element of a long array. The index is not verified against the length of the array.
+ * If the symbol has not been initialized or is not an array, an error will be printed and the program will terminate.
+ * @param head reference to the head of the table
+ * @param identifier identifier of the array
+ * @param index index of the element
+ * @return the long value of the element
+ */
+long long getLongElementValue( Symbol **head , char *identifier , int index );
+
+/**
+ * @brief obtains an element of a double array. The index is not verified against the length of the array.
+ * If the symbol has not been initialized or is not an array, an error will be printed and the program will terminate.
+ * @param head reference to the head of the table
+ * @param identifier identifier of the array
+ * @param index index of the element
+ * @return the double value of the element
+ */
+double getDoubleElementValue( Symbol **head , char *identifier , int index );
+
 #endif //__SYMBOL_TABLE_H__
 
 //end symbolTable.h
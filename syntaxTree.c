@@ -5,25 +5,47 @@
  */
 #include "syntaxTree.h"
 #include "symbolTable.h"
+#include "vectorLoop.h"
+#include "unrolling.h"
+#include "diagnostics.h"
+#include "metrics.h"
+#include "snapshot.h"
+#include "session.h"
+#include "profile.h"
+#include "trace.h"
+#include "arena.h"
 
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
+#include <math.h>
+
+extern _Thread_local int lexerLine; //current line of the lexer
+
+int boundsCheckEnabled = 0;
+
+int overflowTrapEnabled = 0;
+
+FILE *programOutput = NULL;
+
+FILE *programInput = NULL;
+
+unsigned int executionGeneration = 1;
+
+_Thread_local int callDepth = 0;
 
 /**
- * @brief Allocates space for the Node
- * @return The Node or NULL if there is not enough memory
+ * @brief Allocates space for the Node, from the arena of the thread if it has one
+ * @return The Node. The program is terminated if there is not enough memory
  */
 static Node *allocateNode() {
 
-    Node *node = malloc( sizeof( Node ) );
-
-    if ( node == NULL ) {
+    Node *node = allocateCompilerMemory( sizeof( Node ) , _Alignof( Node ) , aNODES ); //components that are not used by the node type stay NULL
 
-        printf( "Error: Memory allocation failed. Program will be terminated\n" );
-        exit(1);
+    node->line = lexerLine;
 
-    }
+    METRIC_ADD( nodesAllocated , 1 );
+    METRIC_ADD( nodeBytes , sizeof( Node ) );
 
     return node;
 }
@@ -42,7 +64,7 @@ Node * createInteger( int value ) {
 
 }
 
-Node * createFloat( float value ) {
+Node * createFloat( double value ) {
 
     Node *nFloat = allocateNode();
 
@@ -51,11 +73,40 @@ Node * createFloat( float value ) {
     nFloat->operationType = oFLOAT;
     nFloat->symbolType    = sFLOAT;
     nFloat->value.fValue  = value;
+    nFloat->floatLiteral  = value;
     
     return nFloat;
 
 }
 
+Node * createLong( long long value ) {
+
+    Node *nLong = allocateNode();
+
+    nLong->type          = nVALUE;
+
+    nLong->operationType = oLONG;
+    nLong->symbolType    = sLONG;
+    nLong->value.lValue  = value;
+    
+    return nLong;
+
+}
+
+Node * createDouble( double value ) {
+
+    Node *nDouble = allocateNode();
+
+    nDouble->type          = nVALUE;
+
+    nDouble->operationType = oDOUBLE;
+    nDouble->symbolType    = sDOUBLE;
+    nDouble->value.dValue  = value;
+    
+    return nDouble;
+
+}
+
 Node *createMinus( Node *rightOperand ) {
 
     Node *nMinus = allocateNode();
@@ -77,6 +128,23 @@ Node *createMinus( Node *rightOperand ) {
             nMinus->symbolType    = sFLOAT;
             nMinus->operationType = oFLOAT;
             nMinus->value.fValue  = -1.0;
+            nMinus->floatLiteral  = -1.0;
+
+        break;
+
+        case sLONG:
+
+            nMinus->symbolType    = sLONG;
+            nMinus->operationType = oLONG;
+            nMinus->value.lValue  = -1;
+
+        break;
+
+        case sDOUBLE:
+
+            nMinus->symbolType    = sDOUBLE;
+            nMinus->operationType = oDOUBLE;
+            nMinus->value.dValue  = -1.0;
 
         break;
 
@@ -86,8 +154,47 @@ Node *createMinus( Node *rightOperand ) {
 
 }
 
+/**
+ * @brief verifies that a symbol is declared. If not, an error is added to the diagnostics and the symbol is declared as an integer,
+ * so later uses are not reported again
+ * @param identifier identifier of the symbol
+ * @param symbolTable symbol table of the compiler
+ * @return 1 if the symbol was declared, 0 otherwise
+ */
+static int assertDeclared( char *identifier , Symbol **symbolTable ) {
+
+    Symbol *symbol = findSymbol( symbolTable , identifier );
+
+    if ( symbol != NULL && symbol->procedure != NULL ) {
+
+        reportError( "Procedure %s cannot be used as a symbol" , identifier );
+
+        return 0;
+
+    }
+
+    if ( symbol != NULL ) {
+
+        return 1;
+
+    }
+
+    reportError( "Symbol %s is not declared" , identifier );
+
+    insertSymbol( symbolTable , identifier , sINTEGER );
+
+    return 0;
+
+}
+
 Node * createSymbol( char  *value , Symbol **symbolTable) {
 
+    if ( assertDeclared( value , symbolTable ) && getSymbolLength( symbolTable , value ) > 0 ) {
+
+        reportError( "Array %s must be accessed with an index" , value );
+
+    }
+
     Node *nSymbol = allocateNode();
 
     nSymbol->type          = nVALUE;
@@ -100,6 +207,44 @@ Node * createSymbol( char  *value , Symbol **symbolTable) {
 
 }
 
+/**
+ * @brief verifies that a symbol is an array and that its index is an integer expresion. If not, an error is added to the diagnostics
+ * @param identifier identifier of the array
+ * @param indexExpr index expresion
+ * @param symbolTable symbol table of the compiler
+ */
+static void assertArrayElement( char *identifier , Node *indexExpr , Symbol **symbolTable ) {
+
+    if ( assertDeclared( identifier , symbolTable ) && getSymbolLength( symbolTable , identifier ) == 0 ) {
+
+        reportError( "Symbol %s is not an array" , identifier );
+
+    }
+
+    if ( indexExpr->symbolType != sINTEGER ) {
+
+        reportError( "Index of array %s must be an integer" , identifier );
+
+    }
+}
+
+Node *createArrayElement( char *identifier , Node *indexExpr , Symbol **symbolTable ) {
+
+    assertArrayElement( identifier , indexExpr , symbolTable ); //if assert fails the error is reported
+
+    Node *nElement = allocateNode();
+
+    nElement->type          = nVALUE;
+
+    nElement->operationType = oINDEX;
+    nElement->symbolType    = getSymbolType( symbolTable , identifier );
+    nElement->value.idValue = identifier;
+    nElement->indexExpr     = indexExpr;
+
+    return nElement;
+
+}
+
 Node *createSymbolType( SymbolType symbolType ) {
 
     Node *nSymbolType = allocateNode();
@@ -111,280 +256,1355 @@ Node *createSymbolType( SymbolType symbolType ) {
     return nSymbolType;
 }
 
+/**
+ * @brief verifies if an expresion is made only of literals
+ * @param expr expresion to be verified
+ * @return 1 if every operand of the expresion is a literal, 0 otherwise
+ */
+static int isLiteral( Node *expr ) {
+
+    if ( expr->type == nOPERATION ) {
+
+        return isLiteral( expr->leftOperand ) && isLiteral( expr->rightOperand );
+
+    }
+
+    return expr->type == nVALUE && expr->operationType != oID && expr->operationType != oINDEX;
+
+}
+
+/**
+ * @brief changes the type of a literal expresion, converting the values of its literals
+ * @param expr literal expresion
+ * @param symbolType new type of the expresion, sLONG or sDOUBLE
+ */
+static void widenLiteral( Node *expr , SymbolType symbolType ) {
+
+    expr->symbolType = symbolType;
+
+    if ( expr->type == nOPERATION ) {
+
+        widenLiteral( expr->leftOperand , symbolType );
+        widenLiteral( expr->rightOperand , symbolType );
+
+    } else if ( symbolType == sLONG ) {
+
+        expr->operationType = oLONG;
+        expr->value.lValue  = expr->value.iValue;
+
+    } else {
+
+        expr->operationType = oDOUBLE;
+        expr->value.dValue  = expr->floatLiteral; //the exact value, not the one rounded to float
+
+    }
+}
+
+SymbolType promoteLiteral( Node *expr , SymbolType symbolType ) {
+
+    if ( ( ( expr->symbolType == sINTEGER && symbolType == sLONG ) || ( expr->symbolType == sFLOAT && symbolType == sDOUBLE ) ) && isLiteral( expr ) ) {
+
+        widenLiteral( expr , symbolType );
+
+    }
+
+    return expr->symbolType;
+
+}
+
+/**
+ * @brief promotes the literal operand, if any, to the type of the other operand and verifies that both types match
+ * @param leftOperand the left operand
+ * @param rightOperand the right operand
+ * @return the type of symbol of both operands if they match
+ */
+static SymbolType unifySymbolTypes( Node *leftOperand , Node *rightOperand ) {
+
+    promoteLiteral( leftOperand , rightOperand->symbolType );
+    promoteLiteral( rightOperand , leftOperand->symbolType );
+
+    return assertSymbolType( leftOperand->symbolType , rightOperand->symbolType ); //if assert fails the error is reported
+
+}
+
 SymbolType assertSymbolType( SymbolType leftOperand , SymbolType rightOperand ) {
 
     if ( leftOperand == rightOperand ) { //both operand symbol types match
 
         return leftOperand;
 
-    } else { //operands do not match, print error and exit program
+    } else { //operands do not match, report the error and continue with the type of the left operand
 
-        printf( "Error: Types do not match. Program will be terminated.\n" );
+        reportError( "Types do not match" );
 
-        exit(1); //We exit the program as there was an error
+        return leftOperand;
     }
 }
 
-Node *createOperation( OperationType operationType , Node *leftOperand , Node *rightOperand) {
+/**
+ * @brief combines a value into a hash
+ */
+static unsigned int combineHash( unsigned int hash , unsigned int value ) {
 
-    Node *nOperation = allocateNode();
+    return ( hash ^ value ) * 16777619u;
 
-    nOperation->type          = nOPERATION;
+}
 
-    nOperation->symbolType    = assertSymbolType( leftOperand->symbolType , rightOperand->symbolType ); //if assert fails compiler will terminate
-    nOperation->operationType = operationType;
-    nOperation->leftOperand   = leftOperand;
-    nOperation->rightOperand  = rightOperand;
+/**
+ * @brief hashes an identifier
+ */
+static unsigned int hashIdentifier( const char *identifier ) {
 
-    return nOperation;
+    unsigned int hash = 2166136261u;
+
+    while ( *identifier != '\0' ) {
+
+        hash = combineHash( hash , (unsigned char) *identifier++ );
+
+    }
+
+    return hash;
 
 }
 
-Node *createExpresion( ExpresionType expresionType , Node *leftOperand , Node *rightOperand) {
+unsigned int hashExpresion( Node *expr ) {
 
-    Node *nExpresion = allocateNode();
+    unsigned int hash = combineHash( 2166136261u , expr->operationType );
 
-    nExpresion->type          = nEXPRESION;
+    if ( expr->type == nOPERATION ) {
 
-    nExpresion->symbolType    = assertSymbolType( leftOperand->symbolType , rightOperand->symbolType ); //if assert fails compiler will terminate
-    nExpresion->expresionType = expresionType;
-    nExpresion->leftOperand   = leftOperand;
-    nExpresion->rightOperand  = rightOperand;
+        return expr->valueHash;
 
-    return nExpresion;
+    }
 
-}
+    switch ( expr->operationType ) {
 
-Node *createSemiColon( Node *leftStatement , Node *rightStatement ) {
+        case oID:
 
-    Node *nSemicolon = allocateNode();
+            return combineHash( hash , hashIdentifier( expr->value.idValue ) );
 
-    nSemicolon->type           = nSEMICOLON;
+        case oINDEX:
 
-    nSemicolon->leftStatement  = leftStatement;
-    nSemicolon->rightStatement = rightStatement;
+            return combineHash( combineHash( hash , hashIdentifier( expr->value.idValue ) ) , hashExpresion( expr->indexExpr ) );
 
-    return nSemicolon;
+        default: //the bits of a literal, the unused bits of the value stay 0
+
+            hash = combineHash( hash , (unsigned int) expr->value.lValue );
 
+            return combineHash( hash , (unsigned int) ( (unsigned long long) expr->value.lValue >> 32 ) );
+
+    }
 }
 
-Node *createAssignment( char *identifier , Node *expr , Symbol **symbolTable ) {
+int sameExpresion( Node *left , Node *right ) {
 
-    Node *nAssignment = allocateNode();
+    if ( left == right ) {
 
-    nAssignment->type          = nASSIGNMENT;
+        return 1;
 
-    nAssignment->symbolType    = assertSymbolType( expr->symbolType , getSymbolType( symbolTable , identifier ) );
-    nAssignment->expr          = expr;
-    nAssignment->value.idValue = identifier;
+    }
 
-    return nAssignment;
+    if ( left->type != right->type || left->operationType != right->operationType || left->symbolType != right->symbolType ) {
 
-}
+        return 0;
 
-Node *createIfStatement( Node *expresion , Node *thenOptStmts ) {
+    }
 
-    Node *nIfStatement = allocateNode();
+    if ( left->type == nOPERATION ) {
 
-    nIfStatement->type         = nIF;
+        return left->valueHash == right->valueHash && sameExpresion( left->leftOperand , right->leftOperand ) &&
+               sameExpresion( left->rightOperand , right->rightOperand );
 
-    nIfStatement->expresion    = expresion;
-    nIfStatement->thenOptStmts = thenOptStmts;
+    }
 
-    return nIfStatement;
+    switch ( left->operationType ) {
 
-}
+        case oID:
 
-Node *createWhileStatement( Node *expresion , Node *doOptStmts ) {
+            return strcmp( left->value.idValue , right->value.idValue ) == 0;
 
-    Node *nWhileStatement = allocateNode();
+        case oINDEX:
 
-    nWhileStatement->type       = nWHILE;
+            return strcmp( left->value.idValue , right->value.idValue ) == 0 && sameExpresion( left->indexExpr , right->indexExpr );
 
-    nWhileStatement->expresion  = expresion;
-    nWhileStatement->doOptStmts = doOptStmts;
+        default:
 
-    return nWhileStatement;
+            return left->value.lValue == right->value.lValue;
 
+    }
 }
 
-Node *createForStatement( char *identifier , Node *expr , Node *stepExpr , Node *untilExpr , Node *doOptStmts ) {
+/**
+ * @brief finds the entry of the table that holds an operation identical to the given one
+ * @return the entry of the identical operation, or the free entry where the operation would be stored
+ */
+static Node **findOperation( OperationTable *operations , Node *operation ) {
 
-    Node *nForStatement = allocateNode();
+    unsigned int mask  = operations->capacity - 1;
+    unsigned int entry = operation->valueHash & mask;
 
-    nForStatement->type          = nFOR;
+    while ( operations->operations[entry] != NULL && !sameExpresion( operations->operations[entry] , operation ) ) {
 
-    nForStatement->value.idValue = identifier;
-    nForStatement->expr          = expr;
-    nForStatement->stepExpr      = stepExpr;
-    nForStatement->untilExpr     = untilExpr;
-    nForStatement->doOptStmts    = doOptStmts;
+        entry = ( entry + 1 ) & mask;
 
-    return nForStatement;
+    }
+
+    return &operations->operations[entry];
 
 }
 
-Node *createReadStatement( char *identifier ) {
+/**
+ * @brief doubles the entries of the table when it is half full, the table is created by the first operation stored
+ */
+static void growOperationTable( OperationTable *operations ) {
 
-    Node *nReadStatement = allocateNode();
+    Node **previous   = operations->operations;
+    int previousCount = operations->capacity;
+    int index;
 
-    nReadStatement->type          = nREAD;
+    if ( operations->count * 2 < operations->capacity ) {
 
-    nReadStatement->value.idValue = identifier;
+        return;
 
-    return nReadStatement;
-}
+    }
 
-Node *createPrintStatement( Node *expr ) {
+    operations->capacity   = previous == NULL ? 256 : operations->capacity * 2;
+    operations->operations = calloc( operations->capacity , sizeof( Node * ) );
 
-    Node *nPrintStatement = allocateNode();
+    if ( operations->operations == NULL ) {
 
-    nPrintStatement->type = nPRINT;
+        printf( "Error: Memory allocation failed. Program will be terminated\n" );
+        exit(1);
 
-    nPrintStatement->expr = expr;
+    }
 
-    return nPrintStatement;
+    for ( index = 0 ; index < previousCount ; index++ ) {
+
+        if ( previous[index] != NULL ) {
+
+            *findOperation( operations , previous[index] ) = previous[index];
+
+        }
+    }
+
+    free( previous );
 
 }
 
-int evaluateIntegerOperation( Node *operation , Symbol **symbolTable) {
+/**
+ * @brief verifies if an operand can be part of a shared operation. Literals and symbols can, operations only if they are shared
+ * themselves. Array elements cannot, since the bounds proven for an element belong to the loop that contains it
+ */
+static int isShareable( Node *operand , OperationTable *operations ) {
 
-    switch ( operation->operationType ) {
-        
-        case oINTEGER:
+    if ( operand->type == nOPERATION ) {
 
-            return operation->value.iValue;
+        return operations->operations != NULL && *findOperation( operations , operand ) == operand;
 
-        case oID:
+    }
 
-            return getIntegerSymbolValue( symbolTable , operation->value.idValue);
-        
-        case oSUM:
+    return operand->operationType != oINDEX;
 
-            return evaluateIntegerOperation( operation->leftOperand , symbolTable ) + evaluateIntegerOperation( operation->rightOperand , symbolTable );
-        
-        case oSUB:
+}
 
-            return evaluateIntegerOperation( operation->leftOperand , symbolTable ) - evaluateIntegerOperation( operation->rightOperand , symbolTable );
-        
-        case oMULT:
+void releaseOperationTable( OperationTable *operations ) {
 
-            return evaluateIntegerOperation( operation->leftOperand , symbolTable ) * evaluateIntegerOperation( operation->rightOperand , symbolTable );
-        
-        case oDIV:
+    free( operations->operations );
 
-            return evaluateIntegerOperation( operation->leftOperand , symbolTable ) / evaluateIntegerOperation( operation->rightOperand , symbolTable );
-        
-        default:
-            // should not be here
-            return 0;
-    
-    }
+    operations->operations = NULL;
+    operations->capacity   = 0;
+    operations->count      = 0;
 
 }
 
-float evaluateFloatOperation( Node *operation , Symbol **symbolTable) {
+Node *createOperation( OperationType operationType , Node *leftOperand , Node *rightOperand , OperationTable *operations ) {
 
-    switch (operation->operationType) {
-        
-        case oFLOAT:
+    Node operation = { 0 }; //the operation is only allocated if it is not found in the table
+    Node *nOperation;
+    Node **entry = NULL;
 
-            return operation->value.fValue;
+    operation.type          = nOPERATION;
 
-        case oID:
+    operation.symbolType    = unifySymbolTypes( leftOperand , rightOperand ); //if assert fails the error is reported
+    operation.operationType = operationType;
+    operation.leftOperand   = leftOperand;
+    operation.rightOperand  = rightOperand;
+    operation.valueHash     = combineHash( combineHash( combineHash( hashExpresion( leftOperand ) , operationType ) , operation.symbolType ) ,
+                                           hashExpresion( rightOperand ) );
 
-            return getFloatSymbolValue( symbolTable , operation->value.idValue);
-        
-        case oSUM:
+    //operations of two literals are not shared, the literals are widened in place when the operation is promoted. An operand that
+    //is an operation is only shareable if it reads a symbol
+    if ( operations != NULL && isShareable( leftOperand , operations ) && isShareable( rightOperand , operations ) &&
+         ( leftOperand->type == nOPERATION || rightOperand->type == nOPERATION || !isLiteral( leftOperand ) || !isLiteral( rightOperand ) ) ) {
 
-            return evaluateFloatOperation( operation->leftOperand , symbolTable ) + evaluateFloatOperation( operation->rightOperand , symbolTable );
-        
-        case oSUB:
+        growOperationTable( operations );
 
-            return evaluateFloatOperation( operation->leftOperand , symbolTable ) - evaluateFloatOperation( operation->rightOperand , symbolTable );
-        
-        case oMULT:
+        entry = findOperation( operations , &operation );
 
-            return evaluateFloatOperation( operation->leftOperand , symbolTable ) * evaluateFloatOperation( operation->rightOperand , symbolTable );
-        
-        case oDIV:
+        if ( *entry != NULL ) {
+
+            operations->shared++;
+
+            return *entry;
+
+        }
+    }
+
+    nOperation  = allocateNode();
+    operation.line = nOperation->line;
+    *nOperation = operation;
+
+    if ( entry != NULL ) {
+
+        *entry = nOperation;
+        operations->count++;
+
+    }
+
+    return nOperation;
+
+}
+
+Node *copyNode( Node *node ) {
+
+    Node *copy = allocateNode();
+
+    *copy = *node;
+
+    return copy;
+
+}
+
+Node *createKeptOperation( Node *operation ) {
+
+    Node *nKept = allocateNode();
+
+    nKept->type          = nOPERATION;
+    nKept->symbolType    = operation->symbolType;
+    nKept->operationType = oKEEP;
+    nKept->leftOperand   = operation;
+    nKept->valueHash     = operation->valueHash;
+    nKept->line          = operation->line;
+
+    return nKept;
+
+}
+
+Node *createReusedOperation( Node *kept , int operationCount ) {
+
+    Node *nReused = allocateNode();
+
+    nReused->type          = nOPERATION;
+    nReused->symbolType    = kept->symbolType;
+    nReused->operationType = oREUSE;
+    nReused->leftOperand   = kept;
+    nReused->value.iValue  = operationCount;
+    nReused->valueHash     = kept->valueHash;
+    nReused->line          = kept->line;
+
+    return nReused;
+
+}
+
+Node *createExpresion( ExpresionType expresionType , Node *leftOperand , Node *rightOperand) {
+
+    Node *nExpresion = allocateNode();
+
+    nExpresion->type          = nEXPRESION;
+
+    nExpresion->symbolType    = unifySymbolTypes( leftOperand , rightOperand ); //if assert fails the error is reported
+    nExpresion->expresionType = expresionType;
+    nExpresion->leftOperand   = leftOperand;
+    nExpresion->rightOperand  = rightOperand;
+
+    return nExpresion;
+
+}
+
+Node *createSemiColon( Node *leftStatement , Node *rightStatement ) {
+
+    Node *nSemicolon = allocateNode();
+
+    nSemicolon->type           = nSEMICOLON;
+
+    nSemicolon->leftStatement  = leftStatement;
+    nSemicolon->rightStatement = rightStatement;
+
+    return nSemicolon;
+
+}
+
+Node *createAssignment( char *identifier , Node *expr , Symbol **symbolTable ) {
+
+    Node *nAssignment = allocateNode();
+
+    assertDeclared( identifier , symbolTable );
+
+    nAssignment->type          = nASSIGNMENT;
+
+    nAssignment->symbolType    = assertSymbolType( promoteLiteral( expr , getSymbolType( symbolTable , identifier ) ) , getSymbolType( symbolTable , identifier ) );
+    nAssignment->expr          = expr;
+    nAssignment->value.idValue = identifier;
+
+    return nAssignment;
+
+}
+
+Node *createArrayAssignment( char *identifier , Node *indexExpr , Node *expr , Symbol **symbolTable ) {
+
+    assertArrayElement( identifier , indexExpr , symbolTable ); //if assert fails the error is reported
+
+    Node *nAssignment = createAssignment( identifier , expr , symbolTable );
+
+    nAssignment->indexExpr = indexExpr;
+
+    return nAssignment;
+
+}
+
+Node *createIfStatement( Node *expresion , Node *thenOptStmts ) {
+
+    Node *nIfStatement = allocateNode();
+
+    nIfStatement->type         = nIF;
+
+    nIfStatement->expresion    = expresion;
+    nIfStatement->thenOptStmts = thenOptStmts;
+
+    return nIfStatement;
+
+}
+
+Node *createWhileStatement( Node *expresion , Node *doOptStmts ) {
+
+    Node *nWhileStatement = allocateNode();
+
+    nWhileStatement->type       = nWHILE;
+
+    nWhileStatement->expresion  = expresion;
+    nWhileStatement->doOptStmts = doOptStmts;
+
+    return nWhileStatement;
+
+}
+
+Node *createForStatement( char *identifier , Node *expr , Node *stepExpr , Node *untilExpr , Node *doOptStmts , Symbol **symbolTable ) {
+
+    Node *nForStatement = allocateNode();
+
+    assertDeclared( identifier , symbolTable );
+
+    //literal start, step and until expresions take the type of the iterator
+    promoteLiteral( expr , getSymbolType( symbolTable , identifier ) );
+    promoteLiteral( stepExpr , getSymbolType( symbolTable , identifier ) );
+    promoteLiteral( untilExpr , getSymbolType( symbolTable , identifier ) );
+
+    //Check that the symbol and the expresions have the same type, if assert fails the error is reported
+    nForStatement->symbolType = assertSymbolType( getSymbolType( symbolTable , identifier ) , expr->symbolType );
+    assertSymbolType( nForStatement->symbolType , stepExpr->symbolType );
+    assertSymbolType( nForStatement->symbolType , untilExpr->symbolType );
+
+    nForStatement->type          = nFOR;
+
+    nForStatement->value.idValue = identifier;
+    nForStatement->expr          = expr;
+    nForStatement->stepExpr      = stepExpr;
+    nForStatement->untilExpr     = untilExpr;
+    nForStatement->doOptStmts    = doOptStmts;
+    nForStatement->vectorLoop    = createVectorLoop( nForStatement );
+
+    return nForStatement;
+
+}
+
+Node *createReadStatement( char *identifier , Symbol **symbolTable ) {
+
+    Node *nReadStatement = allocateNode();
+
+    assertDeclared( identifier , symbolTable );
+
+    nReadStatement->type          = nREAD;
+
+    nReadStatement->value.idValue = identifier;
+
+    return nReadStatement;
+}
+
+Node *createPrintStatement( Node *expr ) {
+
+    Node *nPrintStatement = allocateNode();
+
+    nPrintStatement->type = nPRINT;
+
+    nPrintStatement->expr = expr;
+
+    return nPrintStatement;
+
+}
+
+Node *createProcedure( char *identifier , Symbol **symbolTable ) {
+
+    Node *nProcedure = allocateNode();
+
+    nProcedure->type          = nPROCEDURE;
+
+    nProcedure->value.idValue = identifier;
+
+    if ( insertSymbol( symbolTable , identifier , sINTEGER ) ) {
+
+        ( *symbolTable )->procedure = nProcedure;
+
+    }
+
+    nProcedure->outerSymbols = *symbolTable;
+
+    return nProcedure;
+
+}
+
+/**
+ * @brief writes the qualified identifier of a local symbol of a procedure
+ * @return the qualified identifier, in memory of the program being compiled
+ */
+static char *qualifyIdentifier( Node *procedure , char *identifier ) {
+
+    size_t procedureLength  = strlen( procedure->value.idValue );
+    size_t identifierLength = strlen( identifier );
+    char *qualified         = allocateCompilerMemory( procedureLength + identifierLength + 2 , 1 , aSTRINGS );
+
+    memcpy( qualified , procedure->value.idValue , procedureLength );
+    qualified[procedureLength] = LOCAL_SEPARATOR;
+    memcpy( qualified + procedureLength + 1 , identifier , identifierLength + 1 );
+
+    return qualified;
+
+}
+
+void declareLocalSymbol( Node *procedure , char *identifier , SymbolType symbolType , int isParameter , Symbol **symbolTable ) {
+
+    if ( insertSymbol( symbolTable , qualifyIdentifier( procedure , identifier ) , symbolType ) && isParameter ) {
+
+        procedure->parameterCount++;
+
+    }
+}
+
+char *scopeIdentifier( Node *procedure , char *identifier , Symbol **symbolTable ) {
+
+    size_t procedureLength  = procedure == NULL ? 0 : strlen( procedure->value.idValue );
+    size_t identifierLength = strlen( identifier );
+    char qualified[procedureLength + identifierLength + 2];
+    Symbol *local;
+
+    if ( procedure == NULL ) {
+
+        return identifier;
+
+    }
+
+    memcpy( qualified , procedure->value.idValue , procedureLength );
+    qualified[procedureLength] = LOCAL_SEPARATOR;
+    memcpy( qualified + procedureLength + 1 , identifier , identifierLength + 1 );
+
+    local = findSymbol( symbolTable , qualified );
+
+    return local != NULL ? local->identifier : identifier;
+
+}
+
+void closeProcedure( Node *procedure , Node *body , Symbol **symbolTable ) {
+
+    Symbol *symbol;
+    int index;
+
+    procedure->body = body;
+
+    //the symbols declared after the procedure are its locals, the newest first
+    for ( symbol = *symbolTable ; symbol != procedure->outerSymbols ; symbol = symbol->next ) {
+
+        procedure->localCount++;
+
+    }
+
+    procedure->locals = allocateCompilerMemory( ( procedure->localCount > 0 ? procedure->localCount : 1 ) * sizeof( Symbol * ) , _Alignof( Symbol * ) , aSYMBOLS );
+
+    for ( symbol = *symbolTable , index = procedure->localCount - 1 ; index >= 0 ; symbol = symbol->next , index-- ) {
+
+        procedure->locals[index] = symbol;
+
+    }
+}
+
+Node *createArgument( Node *expr , Node *nextArgument ) {
+
+    Node *nArgument = allocateNode();
+
+    nArgument->type         = nARGUMENT;
+
+    nArgument->symbolType   = expr->symbolType;
+    nArgument->expr         = expr;
+    nArgument->nextArgument = nextArgument;
+
+    return nArgument;
+
+}
+
+/**
+ * @brief finds a parameter of a procedure, also while its body is parsed, when its locals are not collected yet
+ * @param procedure procedure tree
+ * @param index position of the parameter
+ * @param symbolTable symbol table of the compiler
+ * @return the parameter
+ */
+static Symbol *findParameter( Node *procedure , int index , Symbol **symbolTable ) {
+
+    Symbol *symbol;
+
+    if ( procedure->locals != NULL ) {
+
+        return procedure->locals[index];
+
+    }
+
+    //the parameters are the symbols declared right after the procedure
+    for ( symbol = *symbolTable ; symbol->slot != procedure->outerSymbols->slot + 1 + index ; symbol = symbol->next );
+
+    return symbol;
+
+}
+
+Node *createCallStatement( char *identifier , Node *arguments , Symbol **symbolTable ) {
+
+    Node *nCall       = allocateNode();
+    Symbol *symbol    = findSymbol( symbolTable , identifier );
+    Node *procedure   = symbol != NULL ? symbol->procedure : NULL;
+    Node *argument    = arguments;
+    int argumentCount = 0;
+
+    nCall->type          = nCALL;
+
+    nCall->value.idValue = identifier;
+    nCall->procedure     = procedure;
+    nCall->arguments     = arguments;
+
+    if ( procedure == NULL ) {
+
+        reportError( "Procedure %s is not declared" , identifier );
+
+        return nCall;
+
+    }
+
+    for ( ; argument != NULL ; argument = argument->nextArgument , argumentCount++ ) {
+
+        //the parameters are the first locals, their types are known even while the body of a recursive procedure is parsed
+        if ( argumentCount < procedure->parameterCount ) {
+
+            Symbol *parameter = findParameter( procedure , argumentCount , symbolTable );
+
+            argument->symbolType = assertSymbolType( promoteLiteral( argument->expr , parameter->type ) , parameter->type );
+
+        }
+    }
+
+    if ( argumentCount != procedure->parameterCount ) {
+
+        reportError( "Procedure %s expects %d arguments, %d given" , identifier , procedure->parameterCount , argumentCount );
+
+    }
+
+    return nCall;
+
+}
+
+/**
+ * @brief resolves the index of an array element node, verifying it against the length of the array when bounds checking is enabled
+ * @param node array element or array assignment node
+ * @param symbolTable the symbolTable of the compiler
+ * @return the index of the element
+ */
+static int resolveArrayIndex( Node *node , Symbol **symbolTable ) {
+
+    int index = evaluateIntegerOperation( node->indexExpr , symbolTable );
+
+    if ( boundsCheckEnabled && node->boundsProven == 0 && ( index < 0 || index >= getSymbolLength( symbolTable , node->value.idValue ) ) ) {
+
+        runtimeError( "Error: Index %d out of bounds for array %s. Program will be terminated.\n" , index , node->value.idValue );
+
+    }
+
+    return index;
+
+}
+
+/**
+ * @brief verifies if a tree contains a statement that modifies a symbol
+ * @param tree tree to be searched
+ * @param identifier identifier of the symbol
+ * @return 1 if the symbol is assigned, read or used as a for iterator inside the tree, 0 otherwise
+ */
+static int assignsSymbol( Node *tree , char *identifier ) {
+
+    if ( tree == NULL ) {
+
+        return 0;
+
+    }
+
+    switch ( tree->type ) {
+
+        case nSEMICOLON:
+
+            return assignsSymbol( tree->leftStatement , identifier ) || assignsSymbol( tree->rightStatement , identifier );
+
+        case nASSIGNMENT:
+        case nREAD:
+
+            return strcmp( tree->value.idValue , identifier ) == 0;
+
+        case nIF:
+
+            return assignsSymbol( tree->thenOptStmts , identifier );
+
+        case nWHILE:
+
+            return assignsSymbol( tree->doOptStmts , identifier );
+
+        case nFOR:
+
+            return strcmp( tree->value.idValue , identifier ) == 0 || assignsSymbol( tree->doOptStmts , identifier );
+
+        case nCALL: //the procedure may assign any global symbol
+
+            return 1;
+
+        default:
+
+            return 0;
+
+    }
+}
+
+/**
+ * @brief marks the array accesses of a for loop body whose index is within bounds for every iteration.
+ * Only indexes of the form c, i, i + c, c + i and i - c, where i is the iterator and c a literal, are proven
+ * @param tree tree to be marked
+ * @param induction identifier of the iterator, which must not be modified inside the tree
+ * @param low lowest value taken by the iterator
+ * @param high highest value taken by the iterator
+ * @param delta 1 to mark the proven accesses before the loop, -1 to unmark them after the loop
+ * @param symbolTable the symbolTable of the compiler
+ */
+static void proveArrayBounds( Node *tree , char *induction , long long low , long long high , int delta , Symbol **symbolTable ) {
+
+    if ( tree == NULL || ( tree->type == nOPERATION && tree->operationType == oREUSE ) ) { //the kept operation is marked where it is evaluated
+
+        return;
+
+    }
+
+    if ( tree->indexExpr != NULL ) {
+
+        Node *index   = tree->indexExpr;
+        int isAffine  = 0;
+        long long min = 0;
+        long long max = 0;
+
+        if ( index->type == nVALUE && index->operationType == oINTEGER ) {
+
+            isAffine = 1;
+            min = max = index->value.iValue;
+
+        } else if ( index->type == nVALUE && index->operationType == oID && strcmp( index->value.idValue , induction ) == 0 ) {
+
+            isAffine = 1;
+            min = low;
+            max = high;
+
+        } else if ( index->type == nOPERATION && ( index->operationType == oSUM || index->operationType == oSUB ) ) {
+
+            Node *variable = index->leftOperand;
+            Node *constant = index->rightOperand;
+
+            if ( index->operationType == oSUM && variable->operationType == oINTEGER ) { //c + i
+
+                variable = index->rightOperand;
+                constant = index->leftOperand;
+
+            }
+
+            if ( variable->type == nVALUE && variable->operationType == oID && strcmp( variable->value.idValue , induction ) == 0 &&
+                 constant->type == nVALUE && constant->operationType == oINTEGER ) {
+
+                long long offset = index->operationType == oSUM ? constant->value.iValue : -(long long) constant->value.iValue;
+
+                isAffine = 1;
+                min = low + offset;
+                max = high + offset;
+
+            }
+        }
+
+        if ( isAffine && min >= 0 && max < getSymbolLength( symbolTable , tree->value.idValue ) ) {
+
+            tree->boundsProven += delta;
+
+        }
+    }
+
+    proveArrayBounds( tree->leftOperand , induction , low , high , delta , symbolTable );
+    proveArrayBounds( tree->rightOperand , induction , low , high , delta , symbolTable );
+    proveArrayBounds( tree->indexExpr , induction , low , high , delta , symbolTable );
+    proveArrayBounds( tree->leftStatement , induction , low , high , delta , symbolTable );
+    proveArrayBounds( tree->rightStatement , induction , low , high , delta , symbolTable );
+    proveArrayBounds( tree->expr , induction , low , high , delta , symbolTable );
+    proveArrayBounds( tree->expresion , induction , low , high , delta , symbolTable );
+    proveArrayBounds( tree->thenOptStmts , induction , low , high , delta , symbolTable );
+    proveArrayBounds( tree->doOptStmts , induction , low , high , delta , symbolTable );
+    proveArrayBounds( tree->stepExpr , induction , low , high , delta , symbolTable );
+    proveArrayBounds( tree->untilExpr , induction , low , high , delta , symbolTable );
+
+}
+
+void releaseArrayBounds( Node *loop , long long low , long long high , Symbol **symbolTable ) {
+
+    proveArrayBounds( loop->doOptStmts , loop->value.idValue , low , high , -1 , symbolTable );
+
+}
+
+/**
+ * @brief reports a for loop with a step of 0, which terminates the program or fails the active session
+ */
+static void stepError() {
+
+    runtimeError( "Error: Step cannot be 0.0 . Program will be terminated.\n" );
+
+}
+
+/**
+ * @brief reports a division by 0, which terminates the program or fails the active session
+ */
+static void divisionError() {
+
+    runtimeError( "Error: Division by zero. Program will be terminated.\n" );
+
+}
+
+/**
+ * @brief reports an integer or long overflow, which terminates the program or fails the active session
+ */
+static void overflowError() {
+
+    runtimeError( "Error: Integer overflow. Program will be terminated.\n" );
+
+}
+
+int evaluateIntegerOperation( Node *operation , Symbol **symbolTable) {
+
+    int result;
+    int left;
+    int right;
+
+    //binary operations evaluate their left operand first, so a value it keeps can be reused by the right one
+    //the overflow builtins wrap around like the hardware does, the overflow flag is only acted upon in trapping mode
+    switch ( operation->operationType ) {
+        
+        case oINTEGER:
+
+            return operation->value.iValue;
+
+        case oID:
+
+            return getIntegerSymbolValue( symbolTable , operation->value.idValue);
+
+        case oINDEX:
+
+            return getIntegerElementValue( symbolTable , operation->value.idValue , resolveArrayIndex( operation , symbolTable ) );
+        
+        case oSUM:
+
+            left  = evaluateIntegerOperation( operation->leftOperand , symbolTable );
+            right = evaluateIntegerOperation( operation->rightOperand , symbolTable );
+
+            if ( __builtin_add_overflow( left , right , &result ) && overflowTrapEnabled ) {
+
+                overflowError();
+
+            }
+
+            return result;
+        
+        case oSUB:
+
+            left  = evaluateIntegerOperation( operation->leftOperand , symbolTable );
+            right = evaluateIntegerOperation( operation->rightOperand , symbolTable );
+
+            if ( __builtin_sub_overflow( left , right , &result ) && overflowTrapEnabled ) {
+
+                overflowError();
+
+            }
+
+            return result;
+        
+        case oMULT:
+
+            left  = evaluateIntegerOperation( operation->leftOperand , symbolTable );
+            right = evaluateIntegerOperation( operation->rightOperand , symbolTable );
+
+            if ( __builtin_mul_overflow( left , right , &result ) && overflowTrapEnabled ) {
+
+                overflowError();
+
+            }
+
+            return result;
+        
+        case oDIV:
+
+            left  = evaluateIntegerOperation( operation->leftOperand , symbolTable );
+            right = evaluateIntegerOperation( operation->rightOperand , symbolTable );
+
+            if ( !( operation->provenChecks & cDIVISOR_NON_ZERO ) && right == 0 ) {
+
+                divisionError();
+
+            }
+
+            if ( !( operation->provenChecks & cDIVISOR_NOT_MINUS_ONE ) && right == -1 ) { //the smallest integer divided by -1 overflows
+
+                if ( __builtin_sub_overflow( 0 , left , &result ) && overflowTrapEnabled ) {
+
+                    overflowError();
+
+                }
+
+                return result;
+
+            }
+
+            return left / right;
+
+        case oKEEP:
+
+            operation->value.iValue   = evaluateIntegerOperation( operation->leftOperand , symbolTable );
+            operation->keptGeneration = executionGeneration;
+
+            return operation->value.iValue;
+
+        case oREUSE:
+
+            if ( operation->leftOperand->keptGeneration == executionGeneration ) {
+
+                METRIC_ADD( operationsReused , operation->value.iValue );
+
+                return operation->leftOperand->value.iValue;
+
+            }
+
+            return evaluateIntegerOperation( operation->leftOperand , symbolTable );
+        
+        default:
+            // should not be here
+            return 0;
+    
+    }
+
+}
+
+long long evaluateLongOperation( Node *operation , Symbol **symbolTable) {
+
+    long long result;
+    long long left;
+    long long right;
+
+    //binary operations evaluate their left operand first, so a value it keeps can be reused by the right one
+    //the overflow builtins wrap around like the hardware does, the overflow flag is only acted upon in trapping mode
+    switch ( operation->operationType ) {
+        
+        case oLONG:
+
+            return operation->value.lValue;
+
+        case oID:
+
+            return getLongSymbolValue( symbolTable , operation->value.idValue);
+
+        case oINDEX:
+
+            return getLongElementValue( symbolTable , operation->value.idValue , resolveArrayIndex( operation , symbolTable ) );
+        
+        case oSUM:
+
+            left  = evaluateLongOperation( operation->leftOperand , symbolTable );
+            right = evaluateLongOperation( operation->rightOperand , symbolTable );
+
+            if ( __builtin_add_overflow( left , right , &result ) && overflowTrapEnabled ) {
+
+                overflowError();
+
+            }
+
+            return result;
+        
+        case oSUB:
+
+            left  = evaluateLongOperation( operation->leftOperand , symbolTable );
+            right = evaluateLongOperation( operation->rightOperand , symbolTable );
+
+            if ( __builtin_sub_overflow( left , right , &result ) && overflowTrapEnabled ) {
+
+                overflowError();
+
+            }
+
+            return result;
+        
+        case oMULT:
+
+            left  = evaluateLongOperation( operation->leftOperand , symbolTable );
+            right = evaluateLongOperation( operation->rightOperand , symbolTable );
+
+            if ( __builtin_mul_overflow( left , right , &result ) && overflowTrapEnabled ) {
+
+                overflowError();
+
+            }
+
+            return result;
+        
+        case oDIV:
+
+            left  = evaluateLongOperation( operation->leftOperand , symbolTable );
+            right = evaluateLongOperation( operation->rightOperand , symbolTable );
+
+            if ( !( operation->provenChecks & cDIVISOR_NON_ZERO ) && right == 0 ) {
+
+                divisionError();
+
+            }
+
+            if ( !( operation->provenChecks & cDIVISOR_NOT_MINUS_ONE ) && right == -1 ) { //the smallest long divided by -1 overflows
+
+                if ( __builtin_sub_overflow( 0 , left , &result ) && overflowTrapEnabled ) {
+
+                    overflowError();
+
+                }
+
+                return result;
+
+            }
+
+            return left / right;
+
+        case oKEEP:
+
+            operation->value.lValue   = evaluateLongOperation( operation->leftOperand , symbolTable );
+            operation->keptGeneration = executionGeneration;
+
+            return operation->value.lValue;
+
+        case oREUSE:
+
+            if ( operation->leftOperand->keptGeneration == executionGeneration ) {
+
+                METRIC_ADD( operationsReused , operation->value.iValue );
+
+                return operation->leftOperand->value.lValue;
+
+            }
+
+            return evaluateLongOperation( operation->leftOperand , symbolTable );
+        
+        default:
+            // should not be here
+            return 0;
+    
+    }
+
+}
+
+float evaluateFloatOperation( Node *operation , Symbol **symbolTable) {
+
+    float left;
+    float right;
+
+    //binary operations evaluate their left operand first, so a value it keeps can be reused by the right one
+    switch (operation->operationType) {
+        
+        case oFLOAT:
+
+            return operation->value.fValue;
+
+        case oID:
+
+            return getFloatSymbolValue( symbolTable , operation->value.idValue);
+
+        case oINDEX:
+
+            return getFloatElementValue( symbolTable , operation->value.idValue , resolveArrayIndex( operation , symbolTable ) );
+        
+        case oSUM:
+
+            left  = evaluateFloatOperation( operation->leftOperand , symbolTable );
+            right = evaluateFloatOperation( operation->rightOperand , symbolTable );
+
+            return left + right;
+        
+        case oSUB:
+
+            left  = evaluateFloatOperation( operation->leftOperand , symbolTable );
+            right = evaluateFloatOperation( operation->rightOperand , symbolTable );
+
+            return left - right;
+        
+        case oMULT:
+
+            left  = evaluateFloatOperation( operation->leftOperand , symbolTable );
+            right = evaluateFloatOperation( operation->rightOperand , symbolTable );
+
+            return left * right;
+        
+        case oDIV:
+
+            left  = evaluateFloatOperation( operation->leftOperand , symbolTable );
+            right = evaluateFloatOperation( operation->rightOperand , symbolTable );
+
+            return left / right;
+
+        case oKEEP:
+
+            operation->value.fValue   = evaluateFloatOperation( operation->leftOperand , symbolTable );
+            operation->keptGeneration = executionGeneration;
+
+            return operation->value.fValue;
+
+        case oREUSE:
+
+            if ( operation->leftOperand->keptGeneration == executionGeneration ) {
+
+                METRIC_ADD( operationsReused , operation->value.iValue );
+
+                return operation->leftOperand->value.fValue;
+
+            }
+
+            return evaluateFloatOperation( operation->leftOperand , symbolTable );
+        
+        default:
+            // should not be here
+            return 0;
+    
+    }
+
+}
+
+double evaluateDoubleOperation( Node *operation , Symbol **symbolTable) {
+
+    double left;
+    double right;
+
+    //binary operations evaluate their left operand first, so a value it keeps can be reused by the right one
+    switch (operation->operationType) {
+        
+        case oDOUBLE:
+
+            return operation->value.dValue;
+
+        case oID:
+
+            return getDoubleSymbolValue( symbolTable , operation->value.idValue);
+
+        case oINDEX:
+
+            return getDoubleElementValue( symbolTable , operation->value.idValue , resolveArrayIndex( operation , symbolTable ) );
+        
+        case oSUM:
+
+            left  = evaluateDoubleOperation( operation->leftOperand , symbolTable );
+            right = evaluateDoubleOperation( operation->rightOperand , symbolTable );
+
+            return left + right;
+        
+        case oSUB:
+
+            left  = evaluateDoubleOperation( operation->leftOperand , symbolTable );
+            right = evaluateDoubleOperation( operation->rightOperand , symbolTable );
+
+            return left - right;
+        
+        case oMULT:
+
+            left  = evaluateDoubleOperation( operation->leftOperand , symbolTable );
+            right = evaluateDoubleOperation( operation->rightOperand , symbolTable );
+
+            return left * right;
+        
+        case oDIV:
+
+            left  = evaluateDoubleOperation( operation->leftOperand , symbolTable );
+            right = evaluateDoubleOperation( operation->rightOperand , symbolTable );
+
+            return left / right;
+
+        case oKEEP:
+
+            operation->value.dValue   = evaluateDoubleOperation( operation->leftOperand , symbolTable );
+            operation->keptGeneration = executionGeneration;
+
+            return operation->value.dValue;
+
+        case oREUSE:
+
+            if ( operation->leftOperand->keptGeneration == executionGeneration ) {
+
+                METRIC_ADD( operationsReused , operation->value.iValue );
+
+                return operation->leftOperand->value.dValue;
+
+            }
+
+            return evaluateDoubleOperation( operation->leftOperand , symbolTable );
+        
+        default:
+            // should not be here
+            return 0;
+    
+    }
+
+}
+
+/**
+ * @brief compares two values with the comparison of an expresion
+ */
+#define COMPARE_VALUES( expresionType , left , right ) \
+    ( ( expresionType ) == eGREATER_THAN ? ( left ) > ( right ) : ( ( expresionType ) == eLESS_THAN ? ( left ) < ( right ) : ( left ) == ( right ) ) )
+
+int evaluateExpresion(Node *expresion , Symbol **symbolTable ) {
+
+    //the left side is evaluated before the right side, as in the operations
+    switch ( expresion->symbolType ) {
+
+        case sINTEGER: {
+
+            int left  = evaluateIntegerOperation( expresion->leftOperand , symbolTable );
+            int right = evaluateIntegerOperation( expresion->rightOperand , symbolTable );
+
+            return COMPARE_VALUES( expresion->expresionType , left , right );
+        }
+
+        case sFLOAT: {
+
+            float left  = evaluateFloatOperation( expresion->leftOperand , symbolTable );
+            float right = evaluateFloatOperation( expresion->rightOperand , symbolTable );
+
+            return COMPARE_VALUES( expresion->expresionType , left , right );
+        }
+
+        case sLONG: {
+
+            long long left  = evaluateLongOperation( expresion->leftOperand , symbolTable );
+            long long right = evaluateLongOperation( expresion->rightOperand , symbolTable );
+
+            return COMPARE_VALUES( expresion->expresionType , left , right );
+        }
+
+        case sDOUBLE: {
+
+            double left  = evaluateDoubleOperation( expresion->leftOperand , symbolTable );
+            double right = evaluateDoubleOperation( expresion->rightOperand , symbolTable );
+
+            return COMPARE_VALUES( expresion->expresionType , left , right );
+        }
 
-            return evaluateFloatOperation( operation->leftOperand , symbolTable ) / evaluateFloatOperation( operation->rightOperand , symbolTable );
-        
         default:
             // should not be here
             return 0;
-    
-    }
 
+    }
 }
 
-int evaluateExpresion(Node *expresion , Symbol **symbolTable ) {
+/**
+ * @brief executes a call. The frame of the call keeps the values the locals of the procedure had before it, so a recursive call
+ * does not overwrite the locals of the call that made it. The arguments are evaluated before the frame is entered
+ * @param call call statement
+ * @param symbolTable the symbolTable of the compiler
+ */
+static void callProcedure( Node *call , Symbol **symbolTable ) {
 
-    switch ( expresion->expresionType ) {
+    Node *procedure = call->procedure;
+    Node *argument  = call->arguments;
+    FrameValue arguments[procedure->parameterCount > 0 ? procedure->parameterCount : 1];
+    FrameValue frame[procedure->localCount > 0 ? procedure->localCount : 1];
+    CallFrame callFrame;
+    int index;
 
-        case eGREATER_THAN:
+    for ( index = 0 ; index < procedure->parameterCount ; index++ , argument = argument->nextArgument ) {
 
-            switch ( expresion->symbolType ) {
+        switch ( procedure->locals[index]->type ) {
 
-                case sINTEGER:
+            case sINTEGER: arguments[index].iValue = evaluateIntegerOperation( argument->expr , symbolTable ); break;
+            case sFLOAT:   arguments[index].fValue = evaluateFloatOperation( argument->expr , symbolTable ); break;
+            case sLONG:    arguments[index].lValue = evaluateLongOperation( argument->expr , symbolTable ); break;
+            case sDOUBLE:  arguments[index].dValue = evaluateDoubleOperation( argument->expr , symbolTable ); break;
 
-                    return evaluateIntegerOperation( expresion->leftOperand , symbolTable ) > evaluateIntegerOperation( expresion->rightOperand  , symbolTable );
+        }
+    }
 
-                case sFLOAT:
+    //the parameters start with the arguments and the other locals with 0
+    for ( index = 0 ; index < procedure->localCount ; index++ ) {
 
-                    return evaluateFloatOperation( expresion->leftOperand , symbolTable ) > evaluateFloatOperation( expresion->rightOperand  , symbolTable );
+        Symbol *local = procedure->locals[index];
 
-                default:
-                    // should not be here
-                    return 0;
+        memcpy( &frame[index] , &local->value , sizeof( FrameValue ) );
+        memset( &local->value , 0 , sizeof( local->value ) );
 
-            }
+        if ( index < procedure->parameterCount ) {
 
-        case eLESS_THAN:
+            memcpy( &local->value , &arguments[index] , sizeof( FrameValue ) );
 
-            switch ( expresion->symbolType ) {
+        }
+    }
 
-                case sINTEGER:
+    enterCallFrame( &callFrame , call , frame );
+    callDepth++;
 
-                    return evaluateIntegerOperation( expresion->leftOperand , symbolTable ) < evaluateIntegerOperation( expresion->rightOperand  , symbolTable );
+    resolveTree( procedure->body , symbolTable );
 
-                case sFLOAT:
+    callDepth--;
+    leaveCallFrame( &callFrame );
 
-                    return evaluateFloatOperation( expresion->leftOperand , symbolTable ) < evaluateFloatOperation( expresion->rightOperand  , symbolTable );
+    for ( index = 0 ; index < procedure->localCount ; index++ ) {
 
-                default:
-                    // should not be here
-                    return 0;
+        memcpy( &procedure->locals[index]->value , &frame[index] , sizeof( FrameValue ) );
 
-            }
+    }
+}
 
-        case eEQUAL_TO:
+int resolveTree( Node *tree , Symbol **symbolTable) {
 
-            switch ( expresion->symbolType ) {
+    if ( tree == NULL ) { //empty statement
 
-                case sINTEGER:
+        return 1;
 
-                    return evaluateIntegerOperation( expresion->leftOperand , symbolTable ) == evaluateIntegerOperation( expresion->rightOperand  , symbolTable );
+    }
 
-                case sFLOAT:
+    METRIC_ADD( statements[tree->type] , 1 );
+    TRACE_STATEMENT( tree );
 
-                    return evaluateFloatOperation( expresion->leftOperand , symbolTable ) == evaluateFloatOperation( expresion->rightOperand  , symbolTable );
+    if ( tree->profile != NULL ) {
 
-                default:
-                    // should not be here
-                    return 0;
+        tree->profile->executions++;
 
-            }
+    }
 
-        default:
-            // should not be here
-            return 0;
+    //the snapshot is taken before the statement is executed, so resuming executes it. Inside a call it waits for the call to return
+    if ( snapshotRequested && callDepth == 0 ) {
 
-    }
-}
+        takeSnapshot( tree , symbolTable );
 
-int resolveTree( Node *tree , Symbol **symbolTable) {
+    }
     
     switch ( tree->type ) {
 
@@ -401,17 +1621,69 @@ int resolveTree( Node *tree , Symbol **symbolTable) {
             switch ( tree->symbolType ) {
 
                 case sINTEGER:
+
+                    if ( tree->indexExpr != NULL ) { //array element assignment
+
+                        int index = resolveArrayIndex( tree , symbolTable );
+
+                        setIntegerElementValue( symbolTable , tree->value.idValue , index , evaluateIntegerOperation( tree->expr , symbolTable ) );
+
+                        break;
+
+                    }
                     
                     setIntegerSymbolValue( symbolTable , tree->value.idValue , evaluateIntegerOperation( tree->expr , symbolTable ) );
                 
                 break;
                 
                 case sFLOAT:
+
+                    if ( tree->indexExpr != NULL ) { //array element assignment
+
+                        int index = resolveArrayIndex( tree , symbolTable );
+
+                        setFloatElementValue( symbolTable , tree->value.idValue , index , evaluateFloatOperation( tree->expr , symbolTable ) );
+
+                        break;
+
+                    }
                     
                     setFloatSymbolValue( symbolTable , tree->value.idValue , evaluateFloatOperation( tree->expr , symbolTable ) );
                 
                 break;
 
+                case sLONG:
+
+                    if ( tree->indexExpr != NULL ) { //array element assignment
+
+                        int index = resolveArrayIndex( tree , symbolTable );
+
+                        setLongElementValue( symbolTable , tree->value.idValue , index , evaluateLongOperation( tree->expr , symbolTable ) );
+
+                        break;
+
+                    }
+                    
+                    setLongSymbolValue( symbolTable , tree->value.idValue , evaluateLongOperation( tree->expr , symbolTable ) );
+                
+                break;
+                
+                case sDOUBLE:
+
+                    if ( tree->indexExpr != NULL ) { //array element assignment
+
+                        int index = resolveArrayIndex( tree , symbolTable );
+
+                        setDoubleElementValue( symbolTable , tree->value.idValue , index , evaluateDoubleOperation( tree->expr , symbolTable ) );
+
+                        break;
+
+                    }
+                    
+                    setDoubleSymbolValue( symbolTable , tree->value.idValue , evaluateDoubleOperation( tree->expr , symbolTable ) );
+                
+                break;
+
                 default:
 
                     //should not be here
@@ -424,8 +1696,22 @@ int resolveTree( Node *tree , Symbol **symbolTable) {
         break;
 
         case nIF:
+
+            if ( tree->conditionalSelect ) {
+
+                resolveConditionalSelect( tree , symbolTable );
+
+                break;
+
+            }
             
-            if ( evaluateExpresion( tree->expresion , symbolTable ) ) {
+            if ( TRACE_CONDITION( tree , tIF , evaluateExpresion( tree->expresion , symbolTable ) ) ) {
+
+                if ( tree->profile != NULL ) {
+
+                    tree->profile->outcomes++;
+
+                }
 
                 resolveTree( tree->thenOptStmts , symbolTable );
 
@@ -435,7 +1721,15 @@ int resolveTree( Node *tree , Symbol **symbolTable) {
 
         case nWHILE:
             
-            while ( evaluateExpresion( tree->expresion , symbolTable ) ) {
+            while ( TRACE_CONDITION( tree , tWHILE , evaluateExpresion( tree->expresion , symbolTable ) ) ) {
+
+                METRIC_ADD( loopIterations , 1 );
+
+                if ( tree->profile != NULL ) {
+
+                    tree->profile->outcomes++;
+
+                }
 
                 resolveTree( tree->doOptStmts , symbolTable );
 
@@ -444,15 +1738,11 @@ int resolveTree( Node *tree , Symbol **symbolTable) {
         break;
 
         case nFOR: {
-            
-            //Check that the symbol and the expr have the same type
-            SymbolType symbolType = assertSymbolType( getSymbolType( symbolTable , tree->value.idValue) , tree->expr->symbolType );
-            
-            //assert that the stepExpr and unitlExpr have the same symbol type as the symbol
-            assertSymbolType( symbolType , tree->stepExpr->symbolType );
-            assertSymbolType( symbolType , tree->untilExpr->symbolType );
 
-            switch (symbolType) {
+            LoopFrame frame; //state of the loop kept for snapshots
+            
+            //the types of the iterator and the expresions were verified when the tree was built
+            switch ( tree->symbolType ) {
 
                 case sINTEGER: {
 
@@ -461,37 +1751,105 @@ int resolveTree( Node *tree , Symbol **symbolTable) {
                     int integerStep  = evaluateIntegerOperation( tree->stepExpr , symbolTable );
                     int integerUntil = evaluateIntegerOperation( tree->untilExpr , symbolTable );
                     int integerIterator;
+                    int boundsHoisted = 0;
+                    long long boundsLow;
+                    long long boundsHigh;
                     setIntegerSymbolValue( symbolTable , tree->value.idValue , integerStart );
 
-                    if ( integerStep < 0 ) {
+                    if ( !( tree->provenChecks & cSTEP_NON_ZERO ) && integerStep == 0 ) {
+
+                        stepError();
+
+                    }
+
+                    //bodies made only of accumulations are executed several iterations at a time, unless the profile showed the loop is too short
+                    if ( tree->vectorLoop != NULL && vectorLoopEnabled && !overflowTrapEnabled && !tree->coldLoop &&
+                         resolveVectorLoop( tree->vectorLoop , integerStart , integerStep , integerUntil , symbolTable ) ) {
+
+                        break;
+
+                    }
+
+                    enterLoopFrame( &frame , tree );
+
+                    frame.step.iValue  = integerStep;
+                    frame.until.iValue = integerUntil;
+
+                    //array indexes that stay within bounds for every iteration are verified once, before the loop
+                    if ( boundsCheckEnabled && !tree->coldLoop && !assignsSymbol( tree->doOptStmts , tree->value.idValue ) ) {
+
+                        if ( integerStep > 0 && integerStart <= integerUntil ) {
+
+                            boundsHoisted = 1;
+                            boundsLow     = integerStart;
+                            boundsHigh    = integerUntil - ( ( (long long) integerUntil - integerStart ) % integerStep ); //last value of the iterator
+
+                        } else if ( integerStep < 0 && integerStart >= integerUntil ) {
+
+                            boundsHoisted = 1;
+                            boundsLow     = integerUntil + ( ( (long long) integerStart - integerUntil ) % -(long long) integerStep ); //last value of the iterator
+                            boundsHigh    = integerStart;
+
+                        }
+
+                        if ( boundsHoisted ) {
+
+                            proveArrayBounds( tree->doOptStmts , tree->value.idValue , boundsLow , boundsHigh , 1 , symbolTable );
+
+                            frame.boundsHoisted = 1;
+                            frame.boundsLow     = boundsLow;
+                            frame.boundsHigh    = boundsHigh;
+
+                        }
+                    }
+
+                    //small bodies are executed several iterations per test of the loop, unless the profile showed the loop is too short
+                    if ( tree->unrolledLoop != NULL && !tree->coldLoop &&
+                         resolveUnrolledLoop( tree , integerStart , integerStep , integerUntil , &frame , symbolTable ) ) {
+
+                        //the iterator already has its final value
+
+                    } else if ( integerStep < 0 ) {
                         
                         for ( integerIterator = integerStart ; integerIterator >= integerUntil ; integerIterator += integerStep ) {
 
+                            METRIC_ADD( loopIterations , 1 );
+                            frame.iterator.iValue = integerIterator;
+
                             setIntegerSymbolValue( symbolTable , tree->value.idValue , integerIterator); //updates the symbol value with the step value
                             
                             resolveTree( tree-> doOptStmts , symbolTable );
+                            TRACE_STATEMENT( tree );
 
                         }
 
                         setIntegerSymbolValue( symbolTable, tree->value.idValue , integerIterator - integerStep); //updates the symbol value with the step value
 
-                    } else if ( integerStep > 0 ) {
+                    } else {
                         
                         for ( integerIterator = integerStart ; integerIterator <= integerUntil ; integerIterator += integerStep ) {
 
+                            METRIC_ADD( loopIterations , 1 );
+                            frame.iterator.iValue = integerIterator;
+
                             setIntegerSymbolValue( symbolTable , tree->value.idValue , integerIterator); //updates the symbol value with the step value
                             
                             resolveTree( tree-> doOptStmts , symbolTable );
+                            TRACE_STATEMENT( tree );
                         }
 
                          setIntegerSymbolValue( symbolTable , tree->value.idValue , integerIterator - integerStep); //updates the symbol value with the step value
 
-                    } else {
+                    }
+
+                    if ( boundsHoisted ) {
+
+                        proveArrayBounds( tree->doOptStmts , tree->value.idValue , boundsLow , boundsHigh , -1 , symbolTable );
 
-                        printf( "Error: Step cannot be 0.0 . Program will be terminated.\n" );
-                        exit(1);
                     }
 
+                    leaveLoopFrame( &frame );
+
                     break;
                 }
 
@@ -504,34 +1862,182 @@ int resolveTree( Node *tree , Symbol **symbolTable) {
                     float floatIterator;
                     
                     setFloatSymbolValue( symbolTable, tree->value.idValue , floatStart );
+
+                    if ( !( tree->provenChecks & cBOUNDS_FINITE ) && ( !isfinite( floatStart ) || !isfinite( floatStep ) || !isfinite( floatUntil ) ) ) {
+
+                        runtimeError( "Error: For loop bounds must be finite. Program will be terminated.\n" );
+
+                    }
+
+                    if ( !( tree->provenChecks & cSTEP_NON_ZERO ) && floatStep == 0 ) {
+
+                        stepError();
+
+                    }
+
+                    enterLoopFrame( &frame , tree );
+
+                    frame.step.fValue  = floatStep;
+                    frame.until.fValue = floatUntil;
+
                     if ( floatStep < 0 ) {
                         
                         for ( floatIterator = floatStart ; floatIterator >= floatUntil ; floatIterator += floatStep ) {
 
+                            METRIC_ADD( loopIterations , 1 );
+                            frame.iterator.fValue = floatIterator;
+
                             setFloatSymbolValue( symbolTable, tree->value.idValue , floatIterator); //updates the symbol value with the step value
                             
                             resolveTree( tree-> doOptStmts , symbolTable );
+                            TRACE_STATEMENT( tree );
 
                         }
 
                         setFloatSymbolValue( symbolTable, tree->value.idValue , floatIterator - floatStep); //updates the symbol value by removing the excess step
 
-                    } else if ( floatStep > 0 ) {
+                    } else {
                         
                         for (floatIterator = floatStart ; floatIterator <= floatUntil ; floatIterator += floatStep ) {
   
+                            METRIC_ADD( loopIterations , 1 );
+                            frame.iterator.fValue = floatIterator;
+
                             setFloatSymbolValue( symbolTable, tree->value.idValue , floatIterator ); //updates the symbol value with the step value
                             
                             resolveTree( tree-> doOptStmts , symbolTable );
+                            TRACE_STATEMENT( tree );
                         }
 
                         setFloatSymbolValue( symbolTable, tree->value.idValue , floatIterator - floatStep ); //updates the symbol by removing the excess step
 
+                    }
+
+                    leaveLoopFrame( &frame );
+
+                    break;
+                }
+
+                case sLONG: {
+
+                    //resolve expr and assign to symbol
+                    long long longStart = evaluateLongOperation( tree->expr , symbolTable );
+                    long long longStep  = evaluateLongOperation( tree->stepExpr , symbolTable );
+                    long long longUntil = evaluateLongOperation( tree->untilExpr , symbolTable );
+                    long long longIterator;
+                    
+                    setLongSymbolValue( symbolTable, tree->value.idValue , longStart );
+
+                    if ( !( tree->provenChecks & cSTEP_NON_ZERO ) && longStep == 0 ) {
+
+                        stepError();
+
+                    }
+
+                    enterLoopFrame( &frame , tree );
+
+                    frame.step.lValue  = longStep;
+                    frame.until.lValue = longUntil;
+
+                    if ( longStep < 0 ) {
+                        
+                        for ( longIterator = longStart ; longIterator >= longUntil ; longIterator += longStep ) {
+
+                            METRIC_ADD( loopIterations , 1 );
+                            frame.iterator.lValue = longIterator;
+
+                            setLongSymbolValue( symbolTable, tree->value.idValue , longIterator); //updates the symbol value with the step value
+                            
+                            resolveTree( tree-> doOptStmts , symbolTable );
+                            TRACE_STATEMENT( tree );
+
+                        }
+
+                        setLongSymbolValue( symbolTable, tree->value.idValue , longIterator - longStep); //updates the symbol value by removing the excess step
+
+                    } else {
+                        
+                        for (longIterator = longStart ; longIterator <= longUntil ; longIterator += longStep ) {
+  
+                            METRIC_ADD( loopIterations , 1 );
+                            frame.iterator.lValue = longIterator;
+
+                            setLongSymbolValue( symbolTable, tree->value.idValue , longIterator ); //updates the symbol value with the step value
+                            
+                            resolveTree( tree-> doOptStmts , symbolTable );
+                            TRACE_STATEMENT( tree );
+                        }
+
+                        setLongSymbolValue( symbolTable, tree->value.idValue , longIterator - longStep ); //updates the symbol by removing the excess step
+
+                    }
+
+                    leaveLoopFrame( &frame );
+
+                    break;
+                }
+
+                case sDOUBLE: {
+
+                    //resolve expr and assign to symbol
+                    double doubleStart = evaluateDoubleOperation( tree->expr , symbolTable );
+                    double doubleStep  = evaluateDoubleOperation( tree->stepExpr , symbolTable );
+                    double doubleUntil = evaluateDoubleOperation( tree->untilExpr , symbolTable );
+                    double doubleIterator;
+                    
+                    setDoubleSymbolValue( symbolTable, tree->value.idValue , doubleStart );
+
+                    if ( !( tree->provenChecks & cBOUNDS_FINITE ) && ( !isfinite( doubleStart ) || !isfinite( doubleStep ) || !isfinite( doubleUntil ) ) ) {
+
+                        runtimeError( "Error: For loop bounds must be finite. Program will be terminated.\n" );
+
+                    }
+
+                    if ( !( tree->provenChecks & cSTEP_NON_ZERO ) && doubleStep == 0 ) {
+
+                        stepError();
+
+                    }
+
+                    enterLoopFrame( &frame , tree );
+
+                    frame.step.dValue  = doubleStep;
+                    frame.until.dValue = doubleUntil;
+
+                    if ( doubleStep < 0 ) {
+                        
+                        for ( doubleIterator = doubleStart ; doubleIterator >= doubleUntil ; doubleIterator += doubleStep ) {
+
+                            METRIC_ADD( loopIterations , 1 );
+                            frame.iterator.dValue = doubleIterator;
+
+                            setDoubleSymbolValue( symbolTable, tree->value.idValue , doubleIterator); //updates the symbol value with the step value
+                            
+                            resolveTree( tree-> doOptStmts , symbolTable );
+                            TRACE_STATEMENT( tree );
+
+                        }
+
+                        setDoubleSymbolValue( symbolTable, tree->value.idValue , doubleIterator - doubleStep); //updates the symbol value by removing the excess step
+
                     } else {
+                        
+                        for (doubleIterator = doubleStart ; doubleIterator <= doubleUntil ; doubleIterator += doubleStep ) {
+  
+                            METRIC_ADD( loopIterations , 1 );
+                            frame.iterator.dValue = doubleIterator;
+
+                            setDoubleSymbolValue( symbolTable, tree->value.idValue , doubleIterator ); //updates the symbol value with the step value
+                            
+                            resolveTree( tree-> doOptStmts , symbolTable );
+                            TRACE_STATEMENT( tree );
+                        }
+
+                        setDoubleSymbolValue( symbolTable, tree->value.idValue , doubleIterator - doubleStep ); //updates the symbol by removing the excess step
 
-                        printf( "Error: Step cannot be 0.0 . Program will be terminated.\n" );
-                        exit(1);
-                    } 
+                    }
+
+                    leaveLoopFrame( &frame );
 
                     break;
                 }
@@ -543,17 +2049,32 @@ int resolveTree( Node *tree , Symbol **symbolTable) {
 
         case nREAD:
 
+            //a program executed as a session takes its values from the input of the session, and is suspended if there is none
+            if ( activeSession != NULL ) {
+
+                readSessionValue( tree , symbolTable );
+
+                break;
+
+            }
+
             switch ( getSymbolType( symbolTable , tree->value.idValue ) ) {
 
                 case sINTEGER: {
                     
-                    printf( "read value for %s: ", tree->value.idValue );
+                    fprintf( programOutput != NULL ? programOutput : stdout , "read value for %s: " , tree->value.idValue );
                     
                     int value;
                     
-                    scanf( "%d" , &value );
+                    //a read interrupted by a snapshot signal is repeated, after the snapshot if the program was not terminated
+                    while ( fscanf( programInput != NULL ? programInput : stdin , "%d" , &value ) != 1 && snapshotRequested && callDepth == 0 ) {
+
+                        clearerr( programInput != NULL ? programInput : stdin );
+                        takeSnapshot( tree , symbolTable );
+
+                    }
                     
-                    printf( "\n" );
+                    fprintf( programOutput != NULL ? programOutput : stdout , "\n" );
 
                     setIntegerSymbolValue( symbolTable, tree->value.idValue , value );
 
@@ -564,32 +2085,93 @@ int resolveTree( Node *tree , Symbol **symbolTable) {
 
                     float value;
 
-                    printf( "read value for %s: ", tree->value.idValue );
-                    scanf( "%f" , &value );
+                    fprintf( programOutput != NULL ? programOutput : stdout , "read value for %s: " , tree->value.idValue );
+                    while ( fscanf( programInput != NULL ? programInput : stdin , "%f" , &value ) != 1 && snapshotRequested && callDepth == 0 ) {
+
+                        clearerr( programInput != NULL ? programInput : stdin );
+                        takeSnapshot( tree , symbolTable );
+
+                    }
                     
-                    printf( "\n" );
+                    fprintf( programOutput != NULL ? programOutput : stdout , "\n" );
                     
                     setFloatSymbolValue( symbolTable, tree->value.idValue , value );
 
                     break;
                 }
+
+                case sLONG: {
+
+                    long long value;
+
+                    fprintf( programOutput != NULL ? programOutput : stdout , "read value for %s: " , tree->value.idValue );
+                    while ( fscanf( programInput != NULL ? programInput : stdin , "%lld" , &value ) != 1 && snapshotRequested && callDepth == 0 ) {
+
+                        clearerr( programInput != NULL ? programInput : stdin );
+                        takeSnapshot( tree , symbolTable );
+
+                    }
+                    
+                    fprintf( programOutput != NULL ? programOutput : stdout , "\n" );
+                    
+                    setLongSymbolValue( symbolTable, tree->value.idValue , value );
+
+                    break;
+                }
+
+                case sDOUBLE: {
+
+                    double value;
+
+                    fprintf( programOutput != NULL ? programOutput : stdout , "read value for %s: " , tree->value.idValue );
+                    while ( fscanf( programInput != NULL ? programInput : stdin , "%lf" , &value ) != 1 && snapshotRequested && callDepth == 0 ) {
+
+                        clearerr( programInput != NULL ? programInput : stdin );
+                        takeSnapshot( tree , symbolTable );
+
+                    }
+                    
+                    fprintf( programOutput != NULL ? programOutput : stdout , "\n" );
+                    
+                    setDoubleSymbolValue( symbolTable, tree->value.idValue , value );
+
+                    break;
+                }
             }
 
         break;
 
+        case nCALL:
+
+            callProcedure( tree , symbolTable );
+
+        break;
+
         case nPRINT:
 
             switch ( tree->expr->symbolType ) {
 
                 case sINTEGER:
                 
-                    printf ( "%d\n" , evaluateIntegerOperation( tree->expr , symbolTable ) );
+                    fprintf( programOutput != NULL ? programOutput : stdout , "%d\n" , evaluateIntegerOperation( tree->expr , symbolTable ) );
 
                 break;
 
                 case sFLOAT:
 
-                    printf ( "%f\n" , evaluateFloatOperation( tree->expr , symbolTable ) );
+                    fprintf( programOutput != NULL ? programOutput : stdout , "%f\n" , evaluateFloatOperation( tree->expr , symbolTable ) );
+
+                break;
+
+                case sLONG:
+                
+                    fprintf( programOutput != NULL ? programOutput : stdout , "%lld\n" , evaluateLongOperation( tree->expr , symbolTable ) );
+
+                break;
+
+                case sDOUBLE:
+
+                    fprintf( programOutput != NULL ? programOutput : stdout , "%f\n" , evaluateDoubleOperation( tree->expr , symbolTable ) );
 
                 break;
             }
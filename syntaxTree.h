@@ -6,7 +6,12 @@
 #ifndef __SYNTAX_TREE_H__
 #define __SYNTAX_TREE_H__
 
+#include <stdio.h>
+
 #include "symbolTable.h"
+
+struct tagVectorLoop;
+
 /**
  * @brief The node type
  */
@@ -23,7 +28,10 @@ typedef enum tagNodeType {
     nWHILE,
     nFOR,
     nREAD,
-    nPRINT
+    nPRINT,
+    nCALL,
+    nPROCEDURE,
+    nARGUMENT
     
 } NodeType;
 
@@ -34,11 +42,16 @@ typedef enum tagOperationType {
 
     oINTEGER,
     oFLOAT,
+    oLONG,
+    oDOUBLE,
     oID,
+    oINDEX,
     oSUM,
     oSUB,
     oDIV,
-    oMULT
+    oMULT,
+    oKEEP, //evaluates its left operand and keeps the value for the operations that reuse it
+    oREUSE //the value kept by the oKEEP node in its left operand, evaluated again if it was not kept by this execution
 
 } OperationType;
 
@@ -53,6 +66,18 @@ typedef enum tagExpresionType {
 
 } ExpresionType;
 
+/**
+ * @brief The run-time checks that can be proven unnecessary by the range analysis
+ */
+typedef enum tagCheckType {
+
+    cSTEP_NON_ZERO         = 1, //the step of a for loop is never 0
+    cBOUNDS_FINITE         = 2, //the start, step and until values of a for loop are never infinite or NaN
+    cDIVISOR_NON_ZERO      = 4, //the divisor of an integer or long division is never 0
+    cDIVISOR_NOT_MINUS_ONE = 8  //the divisor of an integer or long division is never -1, so the division cannot overflow
+
+} CheckType;
+
 /**
  * @brief The syntax tree structure
  */
@@ -60,6 +85,17 @@ typedef struct tagNode {
   
     NodeType type; //Type of node (see NodeType ENUM)
 
+    int line; //line of the source where the node was parsed
+
+    int provenChecks; //run-time checks proven unnecessary by the range analysis (see CheckType ENUM), 0 if nothing was proven
+
+    int statementIndex; //pre-order position of the statement in the program, assigned when snapshots or profiles are enabled
+    int statementEnd; //position after the last statement nested in this one, assigned when snapshots or profiles are enabled
+
+    struct tagNodeProfile *profile; //counters of the statement while a profile is recorded, NULL otherwise
+    int coldLoop; //1 if the profile showed the for or while loop runs too few iterations per execution to be worth specializing
+    int biasedBranch; //1 if the profile showed the condition of the if statement almost always has the same outcome
+
     /********** EXPR | TERM | FACTOR components **********/
     OperationType operationType; //Type of operation (see OperationType ENUM)
     SymbolType valueType; //type of value (see SymbolType ENUM) of the expresion or value
@@ -68,13 +104,25 @@ typedef struct tagNode {
 
         int iValue; //integer value
         float fValue; //float value
+        long long lValue; //long value
+        double dValue; //double value
         char *idValue; //symbol value
 
     } value; //value (if Operand)
+
+    double floatLiteral; //exact value of a float literal, used if the literal is promoted to double
+
+    unsigned int valueHash; //hash of the shape, identifiers and literals of an operation, assigned when the operation is built
+    unsigned int keptGeneration; //execution in which an oKEEP node stored its value (see executionGeneration)
     
     struct tagNode *leftOperand; //left operand of the operation
     struct tagNode *rightOperand; //right operand of the operation
 
+    /********** ARRAY ELEMENT components **********/
+    //identifier of the array reused from EXPR | TERM | FACTOR component value.idValue
+    struct tagNode *indexExpr; //index of the element, NULL if the node does not access an array element
+    int boundsProven; //number of enclosing for loops that proved the index is within bounds
+
     /********** EXPRESION components **********/
     ExpresionType expresionType;
     //valueType, leftOperand and rightOperand reused from EXPR | TERM | FACTOR components
@@ -90,10 +138,12 @@ typedef struct tagNode {
     /********** ASSIGNMENT STMT Components **********/
     //identifier reused from DEC Components
     struct tagNode *expr; //operation to assign
+    //indexExpr and boundsProven reused from ARRAY ELEMENT components when an array element is assigned
 
     /********** IF STMT Components **********/
     struct tagNode *expresion; //conditional expresion to be evaluated
     struct tagNode *thenOptStmts; //optional statements to be executed if expresion is true
+    int conditionalSelect; //1 if the only assignment of the body is executed as a select, without branches (see unrolling.h)
 
     /********** WHILE STMT Components **********/
     //expresion reused from IF STMT components
@@ -104,6 +154,8 @@ typedef struct tagNode {
     struct tagNode *stepExpr; //Step expresion to be executed in each loop (view EXPR components)
     struct tagNode *untilExpr; //Stop expr to be met (e.g 7, 14.5, x where x := 10) (view EXPR components)
     //do_opt_stmts reused from WHILE STMT components
+    struct tagVectorLoop *vectorLoop; //vectorization plan of the loop body, NULL if it can only be executed by the scalar path
+    struct tagUnrolledLoop *unrolledLoop; //unrolling plan of the loop body, NULL if it is executed one iteration per test
 
     /********** READ STMT Components **********/
     //identifier reused from EXPR | TERM | FACTOR component value.idValue
@@ -111,8 +163,72 @@ typedef struct tagNode {
     /********** WRITE STMT Components **********/
     //expr reused from ASSIGNMENT STMT components
 
+    /********** PROCEDURE Components **********/
+    //identifier of the procedure reused from EXPR | TERM | FACTOR component value.idValue
+    Symbol **locals; //parameters and local symbols of the procedure in declaration order, the parameters first
+    int parameterCount; //number of parameters
+    int localCount; //number of parameters and local symbols
+    Symbol *outerSymbols; //newest symbol declared before the parameters, the procedure itself if it was declared
+    struct tagNode *body; //statements of the procedure
+    int callSites; //calls to the procedure in the program, counted by the inlining
+    int recursive; //1 if the body of the procedure calls it
+
+    /********** CALL STMT Components **********/
+    //identifier of the procedure reused from EXPR | TERM | FACTOR component value.idValue
+    struct tagNode *procedure; //procedure called
+    struct tagNode *arguments; //first argument, NULL if the procedure has no parameters
+
+    /********** ARGUMENT Components **********/
+    //expr reused from ASSIGNMENT STMT components
+    struct tagNode *nextArgument; //argument after this one, NULL for the last one
+
 } Node;
 
+/**
+ * @brief the operations built by one parse, so an operation identical to one already built is shared instead of built again
+ */
+typedef struct tagOperationTable {
+
+    Node **operations; //open addressing table of the operations, NULL in the free entries
+    int capacity; //entries of the table, a power of 2
+    int count; //operations in the table
+
+    int shared; //operations returned from the table instead of being built
+
+} OperationTable;
+
+/**
+ * @brief enables the verification of array indexes at run time. Indexes proven to be within bounds by an enclosing for loop are not verified
+ */
+extern int boundsCheckEnabled;
+
+/**
+ * @brief enables trapping of integer and long overflows in sums, substractions, multiplications and divisions.
+ * When disabled the operations wrap around
+ */
+extern int overflowTrapEnabled;
+
+/**
+ * @brief stream where print statements write their values and read statements their prompts, stdout if NULL
+ */
+extern FILE *programOutput;
+
+/**
+ * @brief stream where read statements take their values when the program is not executed as a session, stdin if NULL
+ */
+extern FILE *programInput;
+
+/**
+ * @brief generation of the current execution. A value kept by an oKEEP node is only reused by the generation that stored it, so
+ * an execution resumed in the middle of a statement sequence evaluates the operations whose values it did not keep
+ */
+extern unsigned int executionGeneration;
+
+/**
+ * @brief number of procedure calls being executed by the current thread. Snapshots are deferred until it is 0
+ */
+extern _Thread_local int callDepth;
+
 /**
  * @brief creates integer Node
  * @param value value of the integer
@@ -122,10 +238,24 @@ Node *createInteger( int value );
 
 /**
  * @brief creates float Node
- * @param value value of the float
+ * @param value value of the float, kept with double precision in case the literal is promoted to double
  * @return float node
  */
-Node *createFloat( float value );
+Node *createFloat( double value );
+
+/**
+ * @brief creates long Node
+ * @param value value of the long
+ * @return long node
+ */
+Node *createLong( long long value );
+
+/**
+ * @brief creates double Node
+ * @param value value of the double
+ * @return double node
+ */
+Node *createDouble( double value );
 
 /**
  * @brief creates a minus one node to multiply against a right operand, of either integer or float type
@@ -142,6 +272,15 @@ Node *createMinus( Node *rightOperand );
  */
 Node *createSymbol( char *value , Symbol **symbolTable );
 
+/**
+ * @brief creates array element Node
+ * @param identifier identifier of the array
+ * @param indexExpr integer expresion that resolves to the index of the element
+ * @param symbolTable symbol table of the compiler
+ * @return array element node
+ */
+Node *createArrayElement( char *identifier , Node *indexExpr , Symbol **symbolTable );
+
 /**
  * @brief creates a symbol type Node
  * param symbolType type of symbol
@@ -150,21 +289,74 @@ Node *createSymbol( char *value , Symbol **symbolTable );
 Node *createSymbolType( SymbolType symbolType );
 
 /**
- * @brief verifies that the symbol types of two operands match. If they don't match an error message is sent and the program is closed
+ * @brief promotes an expresion made only of literals to a wider type: integer literals to long and float literals to double
+ * @param expr expresion to be promoted
+ * @param symbolType type the expresion is expected to have
+ * @return the symbol type of the expresion after the promotion
+ */
+SymbolType promoteLiteral( Node *expr , SymbolType symbolType );
+
+/**
+ * @brief verifies that the symbol types of two operands match. If they don't match an error is added to the diagnostics
  * @param leftOperand tye symbol type of the left operand
  * @param rightOperand tye symbol type of the right operand
- * @return the type of symbol of both expresions if they match
+ * @return the type of symbol of both expresions if they match, the type of the left operand otherwise
  */
 SymbolType assertSymbolType( SymbolType leftOperand , SymbolType rightOperand );
 
 /**
- * @brief creates operation tree
+ * @brief creates operation tree. An operation that reads symbols is hash-consed: if an identical operation was already built by the
+ * same parse, that node is returned and shared by both expresions
  * @param operationType type of operation from the tree
  * @param leftOperand the left operand of the operation
  * @param rightOperand the right operand of the operation
+ * @param operations operations built by the parse, NULL to build the operation without sharing it
  * @return operation tree
  */
-Node *createOperation( OperationType operationType , Node *leftOperand , Node *rightOperand);
+Node *createOperation( OperationType operationType , Node *leftOperand , Node *rightOperand , OperationTable *operations );
+
+/**
+ * @brief releases the table of the operations built by a parse. The operations stay in the tree
+ * @param operations table to be released
+ */
+void releaseOperationTable( OperationTable *operations );
+
+/**
+ * @brief hashes the shape, identifiers and literals of an expresion
+ * @param expr expresion to be hashed
+ * @return the valueHash of an operation, the hash of the identifier or literal of an operand
+ */
+unsigned int hashExpresion( Node *expr );
+
+/**
+ * @brief verifies if two expresions have the same shape, identifiers and literals
+ * @param left first expresion
+ * @param right second expresion
+ * @return 1 if the expresions always evaluate to the same value for the same symbol values, 0 otherwise
+ */
+int sameExpresion( Node *left , Node *right );
+
+/**
+ * @brief copies a node, so one of its operands can be replaced without changing the other expresions that share it
+ * @param node node to be copied
+ * @return the copy
+ */
+Node *copyNode( Node *node );
+
+/**
+ * @brief creates a node that evaluates an operation and keeps its value
+ * @param operation operation whose value is kept
+ * @return oKEEP node
+ */
+Node *createKeptOperation( Node *operation );
+
+/**
+ * @brief creates a node that reuses the value kept by an oKEEP node
+ * @param kept oKEEP node
+ * @param operationCount number of operations of the kept operation, which are not evaluated when its value is reused
+ * @return oREUSE node
+ */
+Node *createReusedOperation( Node *kept , int operationCount );
 
 /**
  * @brief creates expresion tree
@@ -192,6 +384,16 @@ Node *createSemiColon( Node *leftStatement , Node *rightStatement );
  */
 Node *createAssignment( char *identifier , Node *expr , Symbol **symbolTable );
 
+/**
+ * @brief creates array element assignment statement tree
+ * @param identifier identifier of the array
+ * @param indexExpr integer expresion that resolves to the index of the element
+ * @param expr operation to be assigned to the element
+ * @param symbolTable symbol table of the compiler
+ * @return assignment statement tree
+ */
+Node *createArrayAssignment( char *identifier , Node *indexExpr , Node *expr , Symbol **symbolTable );
+
 /**
  * @brief creates if statement tree
  * @param expresion conditional expresion to be resolved
@@ -215,16 +417,18 @@ Node *createWhileStatement( Node *expresion , Node *doOptStmts );
  * @param stepExpr expresion to be resolved for the for loop steps
  * @param untilExpr expresion to be resolved as the stop expresion of the for loop
  * @param doOptStmts optional statements to be executed inside the for loop
+ * @param symbolTable symbol table of the compiler
  * @return for statement tree
  */
-Node *createForStatement( char *identifier , Node *expr , Node *stepExpr , Node *untilExpr , Node *doOptStmts );
+Node *createForStatement( char *identifier , Node *expr , Node *stepExpr , Node *untilExpr , Node *doOptStmts , Symbol **symbolTable );
 
 /**
  * @brief creates read statement tree
  * @param identifier identifier for the assignment statement
+ * @param symbolTable symbol table of the compiler
  * @return read statement tree
  */
-Node *createReadStatement( char *identifier );
+Node *createReadStatement( char *identifier , Symbol **symbolTable );
 
 /**
  * @brief creates print statement tree
@@ -233,6 +437,68 @@ Node *createReadStatement( char *identifier );
  */
 Node *createPrintStatement( Node *expr );
 
+/**
+ * @brief creates procedure tree and declares the procedure, before its parameters and body are parsed so the body can call it.
+ * If the identifier is already declared an error is added to the diagnostics
+ * @param identifier identifier of the procedure
+ * @param symbolTable symbol table of the compiler
+ * @return procedure tree
+ */
+Node *createProcedure( char *identifier , Symbol **symbolTable );
+
+/**
+ * @brief separates the name of a procedure from the names of its local symbols, it cannot appear in an identifier of the source
+ */
+#define LOCAL_SEPARATOR '.'
+
+/**
+ * @brief declares a parameter or a local symbol of a procedure. Its identifier is qualified with the name of the procedure, so it
+ * may shadow a global symbol. Procedures have no local arrays
+ * @param procedure procedure being parsed
+ * @param identifier identifier of the symbol
+ * @param symbolType type of the symbol
+ * @param isParameter 1 for a parameter, 0 for a local symbol
+ * @param symbolTable symbol table of the compiler
+ */
+void declareLocalSymbol( Node *procedure , char *identifier , SymbolType symbolType , int isParameter , Symbol **symbolTable );
+
+/**
+ * @brief obtains the identifier an identifier of the source refers to: the local symbol of the procedure if it has one with that
+ * name, the global one otherwise
+ * @param procedure procedure being parsed, NULL outside procedures
+ * @param identifier identifier of the source
+ * @param symbolTable symbol table of the compiler
+ * @return the identifier of the symbol
+ */
+char *scopeIdentifier( Node *procedure , char *identifier , Symbol **symbolTable );
+
+/**
+ * @brief completes a procedure tree once its body is parsed, collecting the parameters and local symbols declared since
+ * createProcedure
+ * @param procedure procedure tree
+ * @param body statements of the procedure
+ * @param symbolTable symbol table of the compiler
+ */
+void closeProcedure( Node *procedure , Node *body , Symbol **symbolTable );
+
+/**
+ * @brief creates argument list node
+ * @param expr expresion passed to the parameter
+ * @param nextArgument arguments that follow, NULL for the last one
+ * @return argument node
+ */
+Node *createArgument( Node *expr , Node *nextArgument );
+
+/**
+ * @brief creates call statement tree. The procedure must be declared and the arguments must match the number and types of its
+ * parameters, otherwise an error is added to the diagnostics
+ * @param identifier identifier of the procedure
+ * @param arguments first argument, NULL if there are none
+ * @param symbolTable symbol table of the compiler
+ * @return call statement tree
+ */
+Node *createCallStatement( char *identifier , Node *arguments , Symbol **symbolTable );
+
 /**
  * @brief calculates the result of of an integer Operation
  * @param operation operation to be calculated
@@ -249,6 +515,22 @@ int evaluateIntegerOperation( Node *operation , Symbol **symbolTable );
  */
 float evaluateFloatOperation( Node *operation , Symbol **symbolTable );
 
+/**
+ * @brief calculates the result of a long operation
+ * @param operation operation to be calculated
+ * @param symbolTable the symbolTable of the compiler
+ * @return long value result of the operation
+ */
+long long evaluateLongOperation( Node *operation , Symbol **symbolTable );
+
+/**
+ * @brief calculates the result of a double operation
+ * @param operation operation to be calculated
+ * @param symbolTable the symbolTable of the compiler
+ * @return double value result of the operation
+ */
+double evaluateDoubleOperation( Node *operation , Symbol **symbolTable );
+
 /**
  * @brief evaluates an Expresion
  * @param expresion expresion to be evaluated
@@ -264,6 +546,15 @@ int evaluateExpresion(Node *expresion , Symbol **symbolTable );
  */
 void assignSymbol( char *identifier , Node *expr , Symbol **symbolTable , SymbolType symbolType);
 
+/**
+ * @brief unmarks the array accesses of a for loop body that were marked as within bounds by a loop whose execution was abandoned before it ended
+ * @param loop for statement
+ * @param low lowest value of the iterator used to mark the accesses
+ * @param high highest value of the iterator used to mark the accesses
+ * @param symbolTable the symbolTable of the compiler
+ */
+void releaseArrayBounds( Node *loop , long long low , long long high , Symbol **symbolTable );
+
 /**
  * @brief resolves the syntactic tree
  * @param tree tree to be resolved
@@ -0,0 +1,749 @@
+/**
+ * trace.c
+ * Implementation of the execution trace and of its decoder
+ *
+ * A trace has the following layout, in the byte order of the machine that wrote it:
+ *   "SLCTRAC1", number of symbols (4 bytes) and for each symbol, by slot: identifier length (4 bytes), identifier, type (4 bytes), length (4 bytes),
+ *   number of statements (4 bytes) and for each statement, by position: node type (4 bytes), line (4 bytes),
+ *   followed by the records, 32 bytes each, until the end of the file
+ *
+ * The interpreter appends the records to a ring buffer shared with a thread that writes them to the file. The interpreter is the only
+ * thread that moves the head and the flusher the only one that moves the tail, so neither takes a lock: a record is published by the
+ * release store of the head and freed by the release store of the tail. When the ring is full the interpreter yields until the flusher
+ * catches up, so no record is ever dropped
+ * @author Jose Pablo Ortiz Lack
+ */
+#include "trace.h"
+#include "snapshot.h"
+#include "vectorLoop.h"
+#include "unrolling.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <time.h>
+#include <unistd.h>
+
+#define TRACE_MAGIC "SLCTRAC1"
+
+/**
+ * @brief number of records of the ring buffer, a power of 2
+ */
+#define TRACE_RING_RECORDS 65536
+
+/**
+ * @brief records read at once by the decoder
+ */
+#define TRACE_DECODE_RECORDS 4096
+
+int traceEnabled = 0;
+
+uint32_t traceStatement = 0;
+
+static const char *traceFile = NULL; //file where the trace is written, NULL if the execution is not traced
+
+static FILE *traceStream = NULL; //stream of the trace file
+
+static TraceRecord *ring = NULL; //records waiting to be written
+
+static atomic_ullong ringHead; //records appended by the interpreter
+
+static atomic_ullong ringTail; //records written by the flusher
+
+static unsigned long long producerHead = 0; //copy of the head kept by the interpreter
+
+static unsigned long long producerTail = 0; //last tail seen by the interpreter
+
+static unsigned long long stalls = 0; //times the interpreter found the ring full
+
+static atomic_int flusherStopping; //set when the program exits, the flusher writes what is left and stops
+
+static int writeFailed = 0; //set by the flusher if the file cannot be written
+
+static pthread_t flusher; //thread that writes the records
+
+static struct timespec traceStart; //time the trace was started
+
+/**
+ * @brief terminates the program after a problem with a trace file
+ */
+static void traceError( const char *message , const char *fileName ) {
+
+    printf( "Error: %s %s. Program will be terminated.\n" , message , fileName );
+    exit(1);
+
+}
+
+/**
+ * @brief writes bytes to the header of a trace
+ */
+static void writeBytes( FILE *file , const void *bytes , size_t length ) {
+
+    if ( length > 0 && fwrite( bytes , length , 1 , file ) != 1 ) {
+
+        traceError( "Cannot write trace" , traceFile );
+
+    }
+}
+
+/**
+ * @brief writes a 4 byte number to the header of a trace
+ */
+static void writeNumber( FILE *file , uint32_t number ) {
+
+    writeBytes( file , &number , sizeof( number ) );
+
+}
+
+/**
+ * @brief reads bytes from a trace
+ * @return 1 if every byte was read, 0 if the trace is truncated
+ */
+static int readBytes( FILE *file , void *bytes , size_t length ) {
+
+    return length == 0 || fread( bytes , length , 1 , file ) == 1;
+
+}
+
+/**
+ * @brief reads a 4 byte number from a trace
+ * @return 1 if the number was read, 0 if the trace is truncated
+ */
+static int readNumber( FILE *file , uint32_t *number ) {
+
+    return readBytes( file , number , sizeof( *number ) );
+
+}
+
+/**
+ * @brief obtains the nanoseconds since the trace was started
+ */
+static uint64_t traceNanoseconds() {
+
+    struct timespec now;
+
+    clock_gettime( CLOCK_MONOTONIC , &now );
+
+    return (uint64_t) ( now.tv_sec - traceStart.tv_sec ) * 1000000000u + (uint64_t) now.tv_nsec - (uint64_t) traceStart.tv_nsec;
+}
+
+/**
+ * @brief writes the records of the ring to the file until the program exits
+ */
+static void *flushRecords( void *argument ) {
+
+    int descriptor = fileno( traceStream );
+    unsigned long long tail = 0;
+
+    while ( 1 ) {
+
+        //the flag is read before the head, so once it is set the head includes the last record
+        int stopping = atomic_load_explicit( &flusherStopping , memory_order_acquire );
+        unsigned long long head = atomic_load_explicit( &ringHead , memory_order_acquire );
+        struct timespec pause = { 0 , 1000000 };
+        size_t first = (size_t) ( tail & ( TRACE_RING_RECORDS - 1 ) );
+        size_t count = (size_t) ( head - tail );
+        size_t written = 0;
+
+        if ( head == tail ) {
+
+            if ( stopping ) {
+
+                break;
+
+            }
+
+            nanosleep( &pause , NULL );
+
+            continue;
+
+        }
+
+        //records are written up to the end of the ring, the ones that wrapped around are written by the next pass
+        if ( first + count > TRACE_RING_RECORDS ) {
+
+            count = TRACE_RING_RECORDS - first;
+
+        }
+
+        while ( !writeFailed && written < count * sizeof( TraceRecord ) ) {
+
+            ssize_t bytes = write( descriptor , (char *) ( ring + first ) + written , count * sizeof( TraceRecord ) - written );
+
+            if ( bytes <= 0 ) {
+
+                writeFailed = 1;
+
+            } else {
+
+                written += (size_t) bytes;
+
+            }
+        }
+
+        tail += count;
+
+        atomic_store_explicit( &ringTail , tail , memory_order_release );
+
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief writes the last records and closes the trace when the program exits
+ */
+static void finishTrace() {
+
+    traceEnabled = 0;
+
+    atomic_store_explicit( &flusherStopping , 1 , memory_order_release );
+    pthread_join( flusher , NULL );
+
+    if ( fclose( traceStream ) != 0 || writeFailed ) {
+
+        fprintf( stderr , "Error: Cannot write trace %s\n" , traceFile );
+
+    }
+
+    if ( stalls > 0 ) {
+
+        fprintf( stderr , "trace: %llu records, the interpreter waited %llu times for the file\n" , producerHead , stalls );
+
+    }
+
+    free( ring );
+
+}
+
+/**
+ * @brief appends a record to the ring, waiting for the flusher if the ring is full
+ */
+static void appendRecord( const TraceRecord *record ) {
+
+    if ( producerHead - producerTail == TRACE_RING_RECORDS ) {
+
+        producerTail = atomic_load_explicit( &ringTail , memory_order_acquire );
+
+        while ( producerHead - producerTail == TRACE_RING_RECORDS ) {
+
+            stalls++;
+
+            sched_yield();
+
+            producerTail = atomic_load_explicit( &ringTail , memory_order_acquire );
+
+        }
+    }
+
+    ring[producerHead & ( TRACE_RING_RECORDS - 1 )] = *record;
+
+    producerHead++;
+
+    atomic_store_explicit( &ringHead , producerHead , memory_order_release );
+
+}
+
+void enableTrace( const char *fileName ) {
+
+    traceFile = fileName;
+
+    vectorLoopEnabled = 0;
+    unrollingEnabled  = 0;
+
+}
+
+void prepareTrace( Node *tree , Symbol **symbolTable ) {
+
+    Symbol *symbol;
+    Symbol **symbols;
+    Node **statements;
+    sigset_t blocked;
+    sigset_t previous;
+    uint32_t symbolCount = 0;
+    uint32_t statementCount;
+    uint32_t index;
+
+    if ( traceFile == NULL || tree == NULL ) {
+
+        return;
+
+    }
+
+    statementCount = (uint32_t) numberStatements( tree , 0 );
+
+    for ( symbol = *symbolTable ; symbol != NULL ; symbol = symbol->next ) {
+
+        symbolCount++;
+
+    }
+
+    symbols    = calloc( symbolCount > 0 ? symbolCount : 1 , sizeof( Symbol * ) );
+    statements = calloc( statementCount , sizeof( Node * ) );
+    ring       = malloc( TRACE_RING_RECORDS * sizeof( TraceRecord ) );
+
+    if ( symbols == NULL || statements == NULL || ring == NULL ) {
+
+        printf( "Error: Memory allocation failed. Program will be terminated\n" );
+        exit(1);
+
+    }
+
+    for ( symbol = *symbolTable ; symbol != NULL ; symbol = symbol->next ) {
+
+        symbols[symbol->slot] = symbol;
+
+    }
+
+    collectStatements( tree , statements );
+
+    traceStream = fopen( traceFile , "wb" );
+
+    if ( traceStream == NULL ) {
+
+        traceError( "Cannot create trace" , traceFile );
+
+    }
+
+    writeBytes( traceStream , TRACE_MAGIC , 8 );
+    writeNumber( traceStream , symbolCount );
+
+    for ( index = 0 ; index < symbolCount ; index++ ) {
+
+        writeNumber( traceStream , (uint32_t) strlen( symbols[index]->identifier ) );
+        writeBytes( traceStream , symbols[index]->identifier , strlen( symbols[index]->identifier ) );
+        writeNumber( traceStream , (uint32_t) symbols[index]->type );
+        writeNumber( traceStream , (uint32_t) symbols[index]->length );
+
+    }
+
+    writeNumber( traceStream , statementCount );
+
+    for ( index = 0 ; index < statementCount ; index++ ) {
+
+        writeNumber( traceStream , (uint32_t) statements[index]->type );
+        writeNumber( traceStream , (uint32_t) statements[index]->line );
+
+    }
+
+    //the records are written with the descriptor of the stream, after the header
+    if ( fflush( traceStream ) != 0 ) {
+
+        traceError( "Cannot write trace" , traceFile );
+
+    }
+
+    free( symbols );
+    free( statements );
+
+    atomic_init( &ringHead , 0 );
+    atomic_init( &ringTail , 0 );
+    atomic_init( &flusherStopping , 0 );
+
+    clock_gettime( CLOCK_MONOTONIC , &traceStart );
+
+    //the flusher is created with every signal blocked, so the signals keep being handled by the interpreter
+    sigfillset( &blocked );
+    pthread_sigmask( SIG_SETMASK , &blocked , &previous );
+
+    if ( pthread_create( &flusher , NULL , flushRecords , NULL ) != 0 ) {
+
+        printf( "Error: Cannot create the thread of the trace. Program will be terminated\n" );
+        exit(1);
+
+    }
+
+    pthread_sigmask( SIG_SETMASK , &previous , NULL );
+
+    atexit( finishTrace );
+
+    traceEnabled = 1;
+
+}
+
+void recordTraceInteger( Symbol *symbol , uint32_t index , long long value ) {
+
+    TraceRecord record;
+
+    record.timestamp = traceNanoseconds();
+    record.value     = (uint64_t) value;
+    record.statement = traceStatement;
+    record.index     = index;
+    record.slot      = (uint16_t) symbol->slot;
+    record.kind      = tASSIGNMENT;
+    record.type      = (uint8_t) symbol->type;
+    record.reserved  = 0;
+
+    appendRecord( &record );
+
+}
+
+void recordTraceReal( Symbol *symbol , uint32_t index , double value ) {
+
+    TraceRecord record;
+
+    record.timestamp = traceNanoseconds();
+    record.statement = traceStatement;
+    record.index     = index;
+    record.slot      = (uint16_t) symbol->slot;
+    record.kind      = tASSIGNMENT;
+    record.type      = (uint8_t) symbol->type;
+    record.reserved  = 0;
+
+    memcpy( &record.value , &value , sizeof( value ) );
+
+    appendRecord( &record );
+
+}
+
+int recordTraceCondition( Node *tree , TraceKind kind , int outcome ) {
+
+    TraceRecord record;
+
+    record.timestamp = traceNanoseconds();
+    record.value     = outcome != 0;
+    record.statement = callDepth > 0 ? traceStatement : (uint32_t) tree->statementIndex; //the conditions of a procedure body belong to its call
+    record.index     = TRACE_NO_INDEX;
+    record.slot      = 0;
+    record.kind      = (uint8_t) kind;
+    record.type      = sINTEGER;
+    record.reserved  = 0;
+
+    appendRecord( &record );
+
+    return outcome;
+
+}
+
+/**
+ * @brief a symbol of a decoded trace
+ */
+typedef struct tagTraceSymbol {
+
+    char *identifier;
+    uint32_t type;
+    uint32_t length;
+
+    unsigned long long assignments; //values assigned to the symbol
+    unsigned long long elementAssignments; //values assigned to single elements of the symbol
+    double low; //lowest value assigned
+    double high; //highest value assigned
+    double last; //last value assigned
+
+} TraceSymbol;
+
+/**
+ * @brief a statement of a decoded trace
+ */
+typedef struct tagTraceStatement {
+
+    uint32_t type; //NodeType of the statement
+    uint32_t line; //line of the statement
+
+    unsigned long long assignments; //values assigned by the statement
+    unsigned long long conditions; //times the condition of the statement was evaluated
+    unsigned long long outcomes; //times the condition of the statement was true
+
+} TraceStatement;
+
+/**
+ * @brief obtains the name of the node type of a statement
+ */
+static const char *statementName( uint32_t type ) {
+
+    switch ( type ) {
+
+        case nSEMICOLON:  return "sequence";
+        case nASSIGNMENT: return "assignment";
+        case nIF:         return "if";
+        case nWHILE:      return "while";
+        case nFOR:        return "for";
+        case nREAD:       return "read";
+        case nPRINT:      return "print";
+        case nCALL:       return "call";
+        default:          return "statement";
+
+    }
+}
+
+/**
+ * @brief obtains the value of a record as a double
+ */
+static double recordValue( const TraceRecord *record ) {
+
+    double value;
+
+    if ( record->type == sFLOAT || record->type == sDOUBLE ) {
+
+        memcpy( &value , &record->value , sizeof( value ) );
+
+        return value;
+
+    }
+
+    return (double) (int64_t) record->value;
+}
+
+/**
+ * @brief prints the value of a record in the precision of its type
+ */
+static void printRecordValue( FILE *stream , const TraceRecord *record ) {
+
+    switch ( record->type ) {
+
+        case sFLOAT:
+
+            fprintf( stream , "%.9g" , recordValue( record ) );
+
+        break;
+
+        case sDOUBLE:
+
+            fprintf( stream , "%.17g" , recordValue( record ) );
+
+        break;
+
+        default:
+
+            fprintf( stream , "%lld" , (long long) (int64_t) record->value );
+
+        break;
+
+    }
+}
+
+/**
+ * @brief frees the symbols and statements of a decoded trace
+ */
+static void releaseTraceTables( TraceSymbol *symbols , uint32_t symbolCount , TraceStatement *statements ) {
+
+    uint32_t index;
+
+    for ( index = 0 ; symbols != NULL && index < symbolCount ; index++ ) {
+
+        free( symbols[index].identifier );
+
+    }
+
+    free( symbols );
+    free( statements );
+
+}
+
+int decodeTrace( const char *fileName , int summary ) {
+
+    FILE *file = fopen( fileName , "rb" );
+    TraceSymbol *symbols = NULL;
+    TraceStatement *statements = NULL;
+    TraceRecord *records;
+    char magic[8];
+    uint32_t symbolCount = 0;
+    uint32_t statementCount = 0;
+    uint32_t index;
+    unsigned long long recordCount = 0;
+    unsigned long long lastTimestamp = 0;
+    unsigned long long invalidRecords = 0;
+    size_t count;
+
+    if ( file == NULL ) {
+
+        fprintf( stderr , "Error: cannot open %s\n" , fileName );
+        return 0;
+
+    }
+
+    if ( !readBytes( file , magic , sizeof( magic ) ) || memcmp( magic , TRACE_MAGIC , sizeof( magic ) ) != 0 || !readNumber( file , &symbolCount ) ) {
+
+        fprintf( stderr , "Error: %s is not a trace\n" , fileName );
+        fclose( file );
+        return 0;
+
+    }
+
+    symbols = calloc( symbolCount > 0 ? symbolCount : 1 , sizeof( TraceSymbol ) );
+
+    if ( symbols == NULL ) {
+
+        printf( "Error: Memory allocation failed. Program will be terminated\n" );
+        exit(1);
+
+    }
+
+    for ( index = 0 ; index < symbolCount ; index++ ) {
+
+        uint32_t length;
+
+        if ( !readNumber( file , &length ) || length > 4096 || ( symbols[index].identifier = calloc( length + 1 , 1 ) ) == NULL ||
+             !readBytes( file , symbols[index].identifier , length ) || !readNumber( file , &symbols[index].type ) ||
+             !readNumber( file , &symbols[index].length ) ) {
+
+            fprintf( stderr , "Error: the header of trace %s is truncated\n" , fileName );
+            releaseTraceTables( symbols , symbolCount , statements );
+            fclose( file );
+            return 0;
+
+        }
+    }
+
+    if ( !readNumber( file , &statementCount ) || ( statements = calloc( statementCount > 0 ? statementCount : 1 , sizeof( TraceStatement ) ) ) == NULL ) {
+
+        fprintf( stderr , "Error: the header of trace %s is truncated\n" , fileName );
+        releaseTraceTables( symbols , symbolCount , statements );
+        fclose( file );
+        return 0;
+
+    }
+
+    for ( index = 0 ; index < statementCount ; index++ ) {
+
+        if ( !readNumber( file , &statements[index].type ) || !readNumber( file , &statements[index].line ) ) {
+
+            fprintf( stderr , "Error: the header of trace %s is truncated\n" , fileName );
+            releaseTraceTables( symbols , symbolCount , statements );
+            fclose( file );
+            return 0;
+
+        }
+    }
+
+    records = malloc( TRACE_DECODE_RECORDS * sizeof( TraceRecord ) );
+
+    if ( records == NULL ) {
+
+        printf( "Error: Memory allocation failed. Program will be terminated\n" );
+        exit(1);
+
+    }
+
+    while ( ( count = fread( records , sizeof( TraceRecord ) , TRACE_DECODE_RECORDS , file ) ) > 0 ) {
+
+        size_t position;
+
+        for ( position = 0 ; position < count ; position++ ) {
+
+            TraceRecord *record = &records[position];
+            TraceStatement *statement;
+
+            //a record that names a statement or a symbol missing from the header is counted but not decoded
+            if ( record->statement >= statementCount || ( record->kind == tASSIGNMENT && record->slot >= symbolCount ) || record->kind > tWHILE ) {
+
+                invalidRecords++;
+                continue;
+
+            }
+
+            statement = &statements[record->statement];
+
+            recordCount++;
+            lastTimestamp = record->timestamp;
+
+            if ( record->kind == tASSIGNMENT ) {
+
+                TraceSymbol *symbol = &symbols[record->slot];
+                double value = recordValue( record );
+
+                if ( symbol->assignments == 0 || value < symbol->low ) {
+
+                    symbol->low = value;
+
+                }
+
+                if ( symbol->assignments == 0 || value > symbol->high ) {
+
+                    symbol->high = value;
+
+                }
+
+                symbol->last = value;
+                symbol->assignments++;
+                symbol->elementAssignments += record->index != TRACE_NO_INDEX;
+                statement->assignments++;
+
+                if ( !summary ) {
+
+                    printf( "%14.3f us  %-10s line %-5u %s" , record->timestamp / 1000.0 , statementName( statement->type ) , statement->line ,
+                            symbol->identifier );
+
+                    if ( record->index != TRACE_NO_INDEX ) {
+
+                        printf( "[%u]" , record->index );
+
+                    }
+
+                    printf( " = " );
+                    printRecordValue( stdout , record );
+                    printf( "\n" );
+
+                }
+
+            } else {
+
+                statement->conditions++;
+                statement->outcomes += record->value != 0;
+
+                if ( !summary ) {
+
+                    printf( "%14.3f us  %-10s line %-5u %s\n" , record->timestamp / 1000.0 , statementName( statement->type ) , statement->line ,
+                            record->value != 0 ? "true" : "false" );
+
+                }
+            }
+        }
+    }
+
+    if ( summary ) {
+
+        printf( "trace %s: %llu records over %.3f ms\n" , fileName , recordCount , lastTimestamp / 1000000.0 );
+
+        printf( "statements:\n" );
+
+        for ( index = 0 ; index < statementCount ; index++ ) {
+
+            TraceStatement *statement = &statements[index];
+
+            if ( statement->conditions > 0 ) {
+
+                printf( "  %u %s line %u: condition true %llu of %llu times (%.1f%%)\n" , index , statementName( statement->type ) , statement->line ,
+                        statement->outcomes , statement->conditions , 100.0 * statement->outcomes / statement->conditions );
+
+            } else if ( statement->assignments > 0 ) {
+
+                printf( "  %u %s line %u: %llu assignments\n" , index , statementName( statement->type ) , statement->line , statement->assignments );
+
+            }
+        }
+
+        printf( "symbols:\n" );
+
+        for ( index = 0 ; index < symbolCount ; index++ ) {
+
+            TraceSymbol *symbol = &symbols[index];
+
+            if ( symbol->assignments > 0 ) {
+
+                printf( "  %s: %llu assignments, %llu to elements, lowest %.17g, highest %.17g, last %.17g\n" , symbol->identifier ,
+                        symbol->assignments , symbol->elementAssignments , symbol->low , symbol->high , symbol->last );
+
+            }
+        }
+    }
+
+    if ( invalidRecords > 0 ) {
+
+        fprintf( stderr , "Warning: %llu records of trace %s do not match its header\n" , invalidRecords , fileName );
+
+    }
+
+    free( records );
+    releaseTraceTables( symbols , symbolCount , statements );
+    fclose( file );
+
+    return 1;
+
+}
+
+//end trace.c
@@ -0,0 +1,135 @@
+/**
+ * trace.h
+ * Definition of the execution trace, a binary log with one fixed-size record for every value assigned and every condition evaluated
+ * while a program runs, and of its decoder
+ * Compiling with -DNO_TRACE removes every record from the hot paths
+ * @author Jose Pablo Ortiz Lack
+ */
+#ifndef __TRACE_H__
+#define __TRACE_H__
+
+#include <stdint.h>
+
+#include "symbolTable.h"
+#include "syntaxTree.h"
+
+/**
+ * @brief index of a record that is not the assignment of an array element
+ */
+#define TRACE_NO_INDEX UINT32_MAX
+
+/**
+ * @brief the events of the trace
+ */
+typedef enum tagTraceKind {
+
+    tASSIGNMENT, //a value was assigned to a symbol or to an element of an array
+    tIF, //the condition of an if statement was evaluated, the value is 1 if it was true
+    tWHILE //the condition of a while statement was evaluated, the value is 1 if it was true
+
+} TraceKind;
+
+/**
+ * @brief a record of the trace, 32 bytes
+ */
+typedef struct tagTraceRecord {
+
+    uint64_t timestamp; //nanoseconds since the trace was started
+    uint64_t value; //integers and longs as a signed 64 bit integer, floats and doubles as the bits of a double
+    uint32_t statement; //pre-order position of the statement that produced the event
+    uint32_t index; //element of the array assigned, TRACE_NO_INDEX otherwise
+    uint16_t slot; //slot of the symbol assigned
+    uint8_t kind; //TraceKind of the event
+    uint8_t type; //SymbolType of the value
+    uint32_t reserved; //keeps the records aligned to 32 bytes
+
+} TraceRecord;
+
+/**
+ * @brief 1 while the execution is traced
+ */
+extern int traceEnabled;
+
+/**
+ * @brief position of the statement being resolved, stamped on the records
+ */
+extern uint32_t traceStatement;
+
+#ifdef NO_TRACE
+
+#define TRACE_STATEMENT( tree ) ( (void) 0 )
+#define TRACE_VALUE( symbol , index , newValue ) ( (void) 0 )
+#define TRACE_CONDITION( tree , kind , outcome ) ( outcome )
+
+#else
+
+/**
+ * @brief makes the statement the one that produces the following records. The records of a procedure body belong to its call
+ */
+#define TRACE_STATEMENT( tree ) ( traceEnabled && callDepth == 0 ? (void) ( traceStatement = (uint32_t) ( tree )->statementIndex ) : (void) 0 )
+
+/**
+ * @brief records a value assigned to a symbol, or to one of its elements if the index is not TRACE_NO_INDEX
+ */
+#define TRACE_VALUE( symbol , index , newValue ) ( traceEnabled ? _Generic( ( newValue ) , \
+                                                       float: recordTraceReal , \
+                                                       double: recordTraceReal , \
+                                                       default: recordTraceInteger )( symbol , index , newValue ) : (void) 0 )
+
+/**
+ * @brief records the outcome of the condition of an if or while statement, and evaluates to the outcome
+ */
+#define TRACE_CONDITION( tree , kind , outcome ) ( traceEnabled ? recordTraceCondition( tree , kind , outcome ) : ( outcome ) )
+
+#endif
+
+/**
+ * @brief traces the execution of the program into a file. For loops are executed by the scalar path, so every iteration is recorded
+ * @param fileName file of the trace
+ */
+void enableTrace( const char *fileName );
+
+/**
+ * @brief numbers the statements of the program, writes the header of the trace and starts the thread that flushes the records.
+ * The last records are flushed and the file is closed when the program exits
+ * @param tree tree of the program
+ * @param symbolTable the symbolTable of the compiler
+ */
+void prepareTrace( Node *tree , Symbol **symbolTable );
+
+/**
+ * @brief appends the assignment of an integer or long value to the trace
+ * @param symbol symbol assigned
+ * @param index element assigned, TRACE_NO_INDEX for the whole symbol
+ * @param value value assigned
+ */
+void recordTraceInteger( Symbol *symbol , uint32_t index , long long value );
+
+/**
+ * @brief appends the assignment of a float or double value to the trace
+ * @param symbol symbol assigned
+ * @param index element assigned, TRACE_NO_INDEX for the whole symbol
+ * @param value value assigned
+ */
+void recordTraceReal( Symbol *symbol , uint32_t index , double value );
+
+/**
+ * @brief appends the outcome of a condition to the trace
+ * @param tree the if or while statement
+ * @param kind tIF or tWHILE
+ * @param outcome value of the condition
+ * @return the outcome
+ */
+int recordTraceCondition( Node *tree , TraceKind kind , int outcome );
+
+/**
+ * @brief prints a trace as text, one line per record, or as a summary of the records by statement and by symbol
+ * @param fileName file of the trace
+ * @param summary 1 to print the summary, 0 to print every record
+ * @return 1 if the trace was decoded, 0 if it cannot be read
+ */
+int decodeTrace( const char *fileName , int summary );
+
+#endif //__TRACE_H__
+
+//end trace.h
@@ -0,0 +1,732 @@
+/**
+ * unrolling.c
+ * Implementation of the loop unrolling and the if-conversion
+ *
+ * An unrolled loop computes its number of iterations before it starts, so a group of factor iterations needs a single test.
+ * Its body is executed from the list of its statements, without the dispatch of the semicolons that join them, and the iterator
+ * symbol is found once per loop instead of once per iteration
+ * @author Jose Pablo Ortiz Lack
+ */
+#include "unrolling.h"
+#include "syntaxTree.h"
+#include "symbolTable.h"
+#include "metrics.h"
+#include "session.h"
+#include "arena.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <limits.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+int unrollingEnabled = 1;
+
+int unrollingReportEnabled = 0;
+
+/**
+ * @brief the state shared by the unrolling functions
+ */
+typedef struct tagUnrollingContext {
+
+    Symbol **symbolTable; //the symbolTable of the compiler
+
+    int unrolled; //loops with an unrolling plan
+    int converted; //if statements executed as conditional selects
+
+} UnrollingContext;
+
+/**
+ * @brief counts the nodes of a tree, the statements and expresions
+ */
+static int countNodes( Node *tree ) {
+
+    if ( tree == NULL ) {
+
+        return 0;
+
+    }
+
+    return 1 + countNodes( tree->leftOperand ) + countNodes( tree->rightOperand ) + countNodes( tree->indexExpr ) +
+           countNodes( tree->leftStatement ) + countNodes( tree->rightStatement ) + countNodes( tree->expr ) +
+           countNodes( tree->expresion ) + countNodes( tree->thenOptStmts ) + countNodes( tree->doOptStmts ) +
+           countNodes( tree->stepExpr ) + countNodes( tree->untilExpr ) + countNodes( tree->arguments ) + countNodes( tree->nextArgument );
+}
+
+/**
+ * @brief copies the statements joined by semicolons into a list, in execution order
+ * @param statements list to be filled, NULL to only count the statements
+ * @return the number of statements after the ones already in the list
+ */
+static int flattenStatements( Node *tree , Node **statements , int count ) {
+
+    if ( tree == NULL ) {
+
+        return count;
+
+    }
+
+    if ( tree->type == nSEMICOLON ) {
+
+        count = flattenStatements( tree->leftStatement , statements , count );
+
+        return flattenStatements( tree->rightStatement , statements , count );
+
+    }
+
+    if ( statements != NULL ) {
+
+        statements[count] = tree;
+
+    }
+
+    return count + 1;
+
+}
+
+/**
+ * @brief chooses how many iterations of a body are executed per test of the loop
+ * @return 8, 4 or 2, 1 if the body is large enough not to be unrolled
+ */
+static int chooseFactor( int bodyNodes ) {
+
+    if ( bodyNodes <= UNROLL_SMALL_BODY ) {
+
+        return 8;
+
+    }
+
+    if ( bodyNodes <= UNROLL_MEDIUM_BODY ) {
+
+        return 4;
+
+    }
+
+    return bodyNodes <= UNROLL_LARGE_BODY ? 2 : 1;
+
+}
+
+/**
+ * @brief builds the unrolling plan of an integer for loop
+ * @return the plan, NULL if the loop is not unrolled
+ */
+static UnrolledLoop *createUnrolledLoop( Node *loop , int bodyNodes ) {
+
+    int factor = chooseFactor( bodyNodes );
+    UnrolledLoop *unrolledLoop;
+
+    if ( loop->symbolType != sINTEGER || factor == 1 || loop->doOptStmts == NULL ) {
+
+        return NULL;
+
+    }
+
+    unrolledLoop                 = allocateCompilerMemory( sizeof( UnrolledLoop ) , _Alignof( UnrolledLoop ) , aNODES );
+    unrolledLoop->factor         = factor;
+    unrolledLoop->statementCount = flattenStatements( loop->doOptStmts , NULL , 0 );
+    unrolledLoop->statements     = allocateCompilerMemory( unrolledLoop->statementCount * sizeof( Node * ) , _Alignof( Node * ) , aNODES );
+
+    flattenStatements( loop->doOptStmts , unrolledLoop->statements , 0 );
+
+    return unrolledLoop;
+
+}
+
+/**
+ * @brief tells if an operation can be evaluated when its value is not needed: it has no array elements, which may be out of
+ * bounds, and no integer or long divisions that may divide by 0 or overflow. It must also read no symbol but the assigned one,
+ * since the symbol lookups of a value computed for nothing cost more than the branch misses the select avoids
+ */
+static int isCheapValue( Node *operation , char *target ) {
+
+    switch ( operation->operationType ) {
+
+        case oINTEGER:
+        case oFLOAT:
+        case oLONG:
+        case oDOUBLE:
+
+            return 1;
+
+        case oID:
+
+            return strcmp( operation->value.idValue , target ) == 0;
+
+        case oDIV:
+
+            if ( ( operation->symbolType == sINTEGER || operation->symbolType == sLONG ) &&
+                 ( operation->provenChecks & ( cDIVISOR_NON_ZERO | cDIVISOR_NOT_MINUS_ONE ) ) != ( cDIVISOR_NON_ZERO | cDIVISOR_NOT_MINUS_ONE ) ) {
+
+                return 0;
+
+            }
+
+            return isCheapValue( operation->leftOperand , target ) && isCheapValue( operation->rightOperand , target );
+
+        case oSUM:
+        case oSUB:
+        case oMULT:
+
+            return isCheapValue( operation->leftOperand , target ) && isCheapValue( operation->rightOperand , target );
+
+        case oKEEP:
+        case oREUSE:
+
+            return isCheapValue( operation->leftOperand , target );
+
+        default:
+
+            return 0;
+
+    }
+}
+
+/**
+ * @brief tells if an if statement can be executed as a conditional select: its body is a single assignment of a scalar with a
+ * cheap value
+ */
+static int canSelect( Node *ifStatement , UnrollingContext *context ) {
+
+    Node *assignment = ifStatement->thenOptStmts;
+    Symbol *target;
+
+    if ( assignment == NULL || assignment->type != nASSIGNMENT || assignment->indexExpr != NULL || overflowTrapEnabled ) {
+
+        return 0;
+
+    }
+
+    target = findSymbol( context->symbolTable , assignment->value.idValue );
+
+    //assigning an array without an index assigns every element
+    return target != NULL && target->length == 0 && isCheapValue( assignment->expr , assignment->value.idValue );
+
+}
+
+/**
+ * @brief plans the loops and converts the if statements of the statements of a tree
+ * @param tree statements to be planned
+ * @param loopDepth number of loops around the statements, without the ones a profile showed to be cold
+ */
+static void planStatements( Node *tree , int loopDepth , UnrollingContext *context ) {
+
+    if ( tree == NULL ) {
+
+        return;
+
+    }
+
+    switch ( tree->type ) {
+
+        case nSEMICOLON:
+
+            planStatements( tree->leftStatement , loopDepth , context );
+            planStatements( tree->rightStatement , loopDepth , context );
+
+        break;
+
+        case nIF:
+
+            //outside of loops, or of the loops a profile showed to be cold, the branch is taken a few times and converting it gains nothing.
+            //A branch that a profile showed almost always goes the same way is predicted well, the select would only add work
+            if ( loopDepth > 0 && tree->biasedBranch && unrollingReportEnabled && canSelect( tree , context ) ) {
+
+                fprintf( stderr , "line %d: if kept as a branch, the profile shows its condition is biased\n" , tree->line );
+
+            }
+
+            if ( loopDepth > 0 && !tree->biasedBranch && canSelect( tree , context ) ) {
+
+                tree->conditionalSelect = 1;
+                context->converted++;
+
+                if ( unrollingReportEnabled ) {
+
+                    fprintf( stderr , "line %d: if converted to a select of %s\n" , tree->line , tree->thenOptStmts->value.idValue );
+
+                }
+
+                break;
+
+            }
+
+            planStatements( tree->thenOptStmts , loopDepth , context );
+
+        break;
+
+        case nWHILE:
+
+            planStatements( tree->doOptStmts , loopDepth + !tree->coldLoop , context );
+
+        break;
+
+        case nFOR: {
+
+            int bodyNodes;
+
+            planStatements( tree->doOptStmts , loopDepth + !tree->coldLoop , context );
+
+            bodyNodes          = countNodes( tree->doOptStmts );
+            tree->unrolledLoop = createUnrolledLoop( tree , bodyNodes );
+
+            if ( tree->unrolledLoop != NULL ) {
+
+                context->unrolled++;
+
+                if ( unrollingReportEnabled ) {
+
+                    fprintf( stderr , "line %d: for %s: %d nodes, unrolled %d times\n" , tree->line , tree->value.idValue , bodyNodes ,
+                             tree->unrolledLoop->factor );
+
+                }
+            }
+
+        break;
+        }
+
+        default:
+
+        break;
+
+    }
+}
+
+int unrollLoops( Node *tree , Symbol **symbolTable ) {
+
+    UnrollingContext context = { symbolTable , 0 , 0 };
+    Symbol *symbol;
+
+    planStatements( tree , 0 , &context );
+
+    for ( symbol = *symbolTable ; symbol != NULL ; symbol = symbol->next ) {
+
+        if ( symbol->procedure != NULL ) {
+
+            planStatements( symbol->procedure->body , 0 , &context );
+
+        }
+    }
+
+    if ( unrollingReportEnabled ) {
+
+        fprintf( stderr , "Unrolling: %d loops unrolled, %d if statements converted to selects\n" , context.unrolled , context.converted );
+
+    }
+
+    return context.unrolled + context.converted;
+
+}
+
+/**
+ * @brief executes one iteration of an unrolled loop and advances the iterator
+ */
+#define UNROLLED_ITERATION() do { \
+    frame->iterator.iValue = (int) value; \
+    iterator->value.iValue = (int) value; \
+    for ( index = 0 ; index < unrolledLoop->statementCount ; index++ ) { \
+        resolveTree( unrolledLoop->statements[index] , symbolTable ); \
+    } \
+    value += step; \
+} while ( 0 )
+
+int resolveUnrolledLoop( Node *loop , int start , int step , int until , LoopFrame *frame , Symbol **symbolTable ) {
+
+    UnrolledLoop *unrolledLoop = loop->unrolledLoop;
+    Symbol *iterator;
+    long long count;
+    long long groups;
+    long long last;
+    long long value = start;
+    int remainder;
+    int index;
+
+    //number of iterations executed by the scalar path
+    if ( step > 0 ) {
+
+        count = start <= until ? ( (long long) until - start ) / step + 1 : 0;
+
+    } else {
+
+        count = start >= until ? ( (long long) start - until ) / -(long long) step + 1 : 0;
+
+    }
+
+    //the iterator value that ends the scalar loop must be representable, otherwise the scalar path is kept
+    last = (long long) start + count * step;
+
+    if ( last > INT_MAX || last < INT_MIN ) {
+
+        return 0;
+
+    }
+
+    iterator  = findSymbol( symbolTable , loop->value.idValue );
+    groups    = count / unrolledLoop->factor;
+    remainder = (int) ( count % unrolledLoop->factor );
+
+    METRIC_ADD( loopIterations , count );
+
+    for ( ; groups > 0 ; groups-- ) {
+
+        switch ( unrolledLoop->factor ) {
+
+            case 8:
+
+                UNROLLED_ITERATION();
+                UNROLLED_ITERATION();
+                UNROLLED_ITERATION();
+                UNROLLED_ITERATION();
+                //falls through
+
+            case 4:
+
+                UNROLLED_ITERATION();
+                UNROLLED_ITERATION();
+                //falls through
+
+            default:
+
+                UNROLLED_ITERATION();
+                UNROLLED_ITERATION();
+
+        }
+    }
+
+    for ( ; remainder > 0 ; remainder-- ) {
+
+        UNROLLED_ITERATION();
+
+    }
+
+    setIntegerSymbolValue( symbolTable , loop->value.idValue , (int) ( last - step ) ); //the last value of the iterator
+
+    return 1;
+
+}
+
+void resolveConditionalSelect( Node *ifStatement , Symbol **symbolTable ) {
+
+    Node *assignment = ifStatement->thenOptStmts;
+    uint64_t mask    = -(uint64_t) ( evaluateExpresion( ifStatement->expresion , symbolTable ) != 0 ); //all ones if the condition holds
+    Symbol *target;
+
+    switch ( assignment->symbolType ) {
+
+        case sINTEGER: {
+
+            uint32_t taken = (uint32_t) evaluateIntegerOperation( assignment->expr , symbolTable );
+
+            target = findSymbol( symbolTable , assignment->value.idValue );
+            target->value.iValue = (int) ( ( taken & (uint32_t) mask ) | ( (uint32_t) target->value.iValue & ~(uint32_t) mask ) );
+
+        break;
+        }
+
+        case sFLOAT: {
+
+            float value = evaluateFloatOperation( assignment->expr , symbolTable );
+            uint32_t taken;
+            uint32_t kept;
+
+            target = findSymbol( symbolTable , assignment->value.idValue );
+
+            memcpy( &taken , &value , sizeof( taken ) );
+            memcpy( &kept , &target->value.fValue , sizeof( kept ) );
+
+            kept = ( taken & (uint32_t) mask ) | ( kept & ~(uint32_t) mask );
+
+            memcpy( &target->value.fValue , &kept , sizeof( kept ) );
+
+        break;
+        }
+
+        case sLONG: {
+
+            uint64_t taken = (uint64_t) evaluateLongOperation( assignment->expr , symbolTable );
+
+            target = findSymbol( symbolTable , assignment->value.idValue );
+            target->value.lValue = (long long) ( ( taken & mask ) | ( (uint64_t) target->value.lValue & ~mask ) );
+
+        break;
+        }
+
+        case sDOUBLE: {
+
+            double value = evaluateDoubleOperation( assignment->expr , symbolTable );
+            uint64_t taken;
+            uint64_t kept;
+
+            target = findSymbol( symbolTable , assignment->value.idValue );
+
+            memcpy( &taken , &value , sizeof( taken ) );
+            memcpy( &kept , &target->value.dValue , sizeof( kept ) );
+
+            kept = ( taken & mask ) | ( kept & ~mask );
+
+            memcpy( &target->value.dValue , &kept , sizeof( kept ) );
+
+        break;
+        }
+
+        default:
+
+        break;
+
+    }
+}
+
+/**
+ * @brief obtains the current time in milliseconds
+ */
+static double currentMilliseconds() {
+
+    struct timespec now;
+
+    clock_gettime( CLOCK_MONOTONIC , &now );
+
+    return now.tv_sec * 1000.0 + now.tv_nsec / 1000000.0;
+}
+
+/**
+ * @brief opens a hardware counter of the current thread, stopped and counting only user space
+ * @return the descriptor of the counter, -1 if it is not available
+ */
+static int openCounter( uint64_t config ) {
+
+    struct perf_event_attr attributes;
+
+    memset( &attributes , 0 , sizeof( attributes ) );
+
+    attributes.size           = sizeof( attributes );
+    attributes.type           = PERF_TYPE_HARDWARE;
+    attributes.config         = config;
+    attributes.disabled       = 1;
+    attributes.exclude_kernel = 1;
+    attributes.exclude_hv     = 1;
+
+    return (int) syscall( SYS_perf_event_open , &attributes , 0 , -1 , -1 , 0 );
+
+}
+
+/**
+ * @brief resets, enables or disables the counters that are available
+ */
+static void controlCounters( int branches , int branchMisses , unsigned long request ) {
+
+    if ( branches >= 0 ) {
+
+        ioctl( branches , request , 0 );
+
+    }
+
+    if ( branchMisses >= 0 ) {
+
+        ioctl( branchMisses , request , 0 );
+
+    }
+}
+
+/**
+ * @brief reads a counter, 0 if it is not available
+ */
+static long long readCounter( int counter ) {
+
+    long long value = 0;
+
+    if ( counter >= 0 && read( counter , &value , sizeof( value ) ) != sizeof( value ) ) {
+
+        value = 0;
+
+    }
+
+    return value;
+}
+
+/**
+ * @brief orders two measures from the smallest to the largest
+ */
+static int compareMeasures( const void *left , const void *right ) {
+
+    double leftMeasure  = *(const double *) left;
+    double rightMeasure = *(const double *) right;
+
+    return ( leftMeasure > rightMeasure ) - ( leftMeasure < rightMeasure );
+
+}
+
+/**
+ * @brief the medians of the runs of a configuration
+ */
+typedef struct tagUnrollingMeasure {
+
+    double milliseconds;
+    double branches;
+    double branchMisses;
+
+    char *output; //output of the first run
+    size_t outputLength;
+
+} UnrollingMeasure;
+
+/**
+ * @brief runs a program as many times with a configuration
+ * @return 1 if every run was executed, 0 if the program has errors
+ */
+static int measureConfiguration( const char *source , size_t length , int count , int branches , int branchMisses ,
+                                 UnrollingMeasure *measure ) {
+
+    double *samples = malloc( 3 * count * sizeof( double ) );
+    int run;
+
+    if ( samples == NULL ) {
+
+        printf( "Error: Memory allocation failed. Program will be terminated\n" );
+        exit(1);
+
+    }
+
+    measure->output = NULL;
+
+    for ( run = 0 ; run < count ; run++ ) {
+
+        char *output;
+        size_t outputLength;
+        FILE *stream = open_memstream( &output , &outputLength );
+        Session *session = createSession( source , length , stream );
+        double start;
+
+        if ( session == NULL ) {
+
+            fclose( stream );
+            free( output );
+            free( samples );
+
+            return 0;
+
+        }
+
+        controlCounters( branches , branchMisses , PERF_EVENT_IOC_RESET );
+        controlCounters( branches , branchMisses , PERF_EVENT_IOC_ENABLE );
+
+        start = currentMilliseconds();
+
+        resumeSession( session );
+
+        samples[run] = currentMilliseconds() - start;
+
+        controlCounters( branches , branchMisses , PERF_EVENT_IOC_DISABLE );
+
+        samples[count + run]     = (double) readCounter( branches );
+        samples[2 * count + run] = (double) readCounter( branchMisses );
+
+        destroySession( session );
+        fclose( stream );
+
+        if ( measure->output == NULL ) {
+
+            measure->output       = output;
+            measure->outputLength = outputLength;
+
+        } else {
+
+            free( output );
+
+        }
+    }
+
+    qsort( samples , count , sizeof( double ) , compareMeasures );
+    qsort( samples + count , count , sizeof( double ) , compareMeasures );
+    qsort( samples + 2 * count , count , sizeof( double ) , compareMeasures );
+
+    measure->milliseconds = samples[count / 2];
+    measure->branches     = samples[count + count / 2];
+    measure->branchMisses = samples[2 * count + count / 2];
+
+    free( samples );
+
+    return 1;
+
+}
+
+int benchmarkUnrolling( const char *source , size_t length , int count ) {
+
+    int enabled      = unrollingEnabled;
+    int branches     = openCounter( PERF_COUNT_HW_BRANCH_INSTRUCTIONS );
+    int branchMisses = openCounter( PERF_COUNT_HW_BRANCH_MISSES );
+    int counterError = errno;
+    UnrollingMeasure rolled;
+    UnrollingMeasure unrolled;
+    int same;
+
+    unrollingEnabled = 0;
+
+    if ( !measureConfiguration( source , length , count , branches , branchMisses , &rolled ) ) {
+
+        unrollingEnabled = enabled;
+
+        return 0;
+
+    }
+
+    unrollingEnabled = 1;
+
+    measureConfiguration( source , length , count , branches , branchMisses , &unrolled );
+
+    unrollingEnabled = enabled;
+
+    same = rolled.outputLength == unrolled.outputLength && memcmp( rolled.output , unrolled.output , rolled.outputLength ) == 0;
+
+    fprintf( stderr , "unrolling: %d runs of each configuration\n" , count );
+
+    if ( branches < 0 || branchMisses < 0 ) {
+
+        fprintf( stderr , "branch counters are not available: %s\n" , strerror( counterError ) );
+        fprintf( stderr , "rolled:   median %.3f ms\n" , rolled.milliseconds );
+        fprintf( stderr , "unrolled: median %.3f ms\n" , unrolled.milliseconds );
+
+    } else {
+
+        fprintf( stderr , "rolled:   median %.3f ms, %.0f branches, %.0f branch misses\n" , rolled.milliseconds , rolled.branches ,
+                 rolled.branchMisses );
+        fprintf( stderr , "unrolled: median %.3f ms, %.0f branches, %.0f branch misses\n" , unrolled.milliseconds , unrolled.branches ,
+                 unrolled.branchMisses );
+
+        if ( rolled.branchMisses > 0 ) {
+
+            fprintf( stderr , "branch misses reduced by %.1f%%\n" , 100.0 * ( 1 - unrolled.branchMisses / rolled.branchMisses ) );
+
+        }
+    }
+
+    if ( !same ) {
+
+        fprintf( stderr , "Error: the unrolled program printed a different output\n" );
+
+    }
+
+    free( rolled.output );
+    free( unrolled.output );
+
+    if ( branches >= 0 ) {
+
+        close( branches );
+
+    }
+
+    if ( branchMisses >= 0 ) {
+
+        close( branchMisses );
+
+    }
+
+    return same;
+
+}
+
+//end unrolling.c
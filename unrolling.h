@@ -0,0 +1,100 @@
+/**
+ * unrolling.h
+ * Definition of the loop unrolling, which executes several iterations of a counted for loop per test of the loop, and of the
+ * if-conversion, which executes the small if statements of loop bodies as conditional selects without branches
+ * @author Jose Pablo Ortiz Lack
+ */
+#ifndef __UNROLLING_H__
+#define __UNROLLING_H__
+
+#include "symbolTable.h"
+#include "syntaxTree.h"
+#include "snapshot.h"
+
+/**
+ * @brief nodes of the largest body unrolled 8 times
+ */
+#define UNROLL_SMALL_BODY 16
+
+/**
+ * @brief nodes of the largest body unrolled 4 times
+ */
+#define UNROLL_MEDIUM_BODY 48
+
+/**
+ * @brief nodes of the largest body unrolled 2 times, larger bodies already pay for the loop test over enough work
+ */
+#define UNROLL_LARGE_BODY 128
+
+/**
+ * @brief the unrolling plan of an integer for loop
+ */
+typedef struct tagUnrolledLoop {
+
+    Node **statements; //statements of the body in execution order, without the semicolons that join them
+    int statementCount; //number of statements
+
+    int factor; //iterations executed per test of the loop, 2, 4 or 8
+
+} UnrolledLoop;
+
+/**
+ * @brief unrolls the for loops and converts the small if statements of their bodies before the programs are executed, 1 by default.
+ * Recording a profile or a trace disables it, since both count every iteration and every branch
+ */
+extern int unrollingEnabled;
+
+/**
+ * @brief prints the loops unrolled and the if statements converted to conditional selects
+ */
+extern int unrollingReportEnabled;
+
+/**
+ * @brief plans the unrolling of the integer for loops of a tree, with a factor chosen from the number of nodes of their bodies,
+ * and converts the if statements of loop bodies whose only statement is the assignment of a scalar, if c then x := e endif, into
+ * x := c ? e : x. An if is converted only if e cannot fail, so evaluating it when c is false is harmless: e has no array
+ * elements and its integer and long divisions were proven by the range analysis to have a divisor other than 0 and -1.
+ * e must also read no symbol but x, as in clamps, flags and counters. Nothing is converted in trapping mode, where any integer
+ * operation may fail. The bodies of the procedures are planned too
+ * @param tree tree of the program
+ * @param symbolTable the symbolTable of the compiler
+ * @return the number of loops unrolled plus the number of if statements converted
+ */
+int unrollLoops( Node *tree , Symbol **symbolTable );
+
+/**
+ * @brief executes an integer for loop with its unrolling plan. The remainder of the iterations that do not fill a group of factor
+ * iterations is executed after the groups, for positive and negative steps. The final value of the iterator is the one produced by
+ * the scalar path
+ * @param loop for statement
+ * @param start start value of the iterator
+ * @param step step of the iterator, must not be 0
+ * @param until stop value of the iterator
+ * @param frame frame of the loop, whose iterator is kept up to date for snapshots and suspended sessions
+ * @param symbolTable the symbolTable of the compiler
+ * @return 1 if the loop was executed, 0 if the scalar path must be used instead
+ */
+int resolveUnrolledLoop( Node *loop , int start , int step , int until , LoopFrame *frame , Symbol **symbolTable );
+
+/**
+ * @brief executes an if statement converted by unrollLoops: the condition and the assigned value are both evaluated and the value
+ * kept by the symbol is selected with a mask
+ * @param ifStatement if statement
+ * @param symbolTable the symbolTable of the compiler
+ */
+void resolveConditionalSelect( Node *ifStatement , Symbol **symbolTable );
+
+/**
+ * @brief executes a program as a session as many times with unrolling disabled and enabled, and prints to stderr the median time,
+ * branches and branch misses of each, read from the hardware counters through perf_event_open. Only the time is printed if the
+ * counters are not available. The program should not read values
+ * @param source source of the program
+ * @param length length of the source
+ * @param count number of runs of each configuration
+ * @return 1 if both configurations printed the same output, 0 otherwise
+ */
+int benchmarkUnrolling( const char *source , size_t length , int count );
+
+#endif //__UNROLLING_H__
+
+//end unrolling.h
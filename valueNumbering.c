@@ -0,0 +1,467 @@
+/**
+ * valueNumbering.c
+ * Implementation of the value numbering that eliminates the common subexpressions of straight-line statement sequences
+ *
+ * The tree is visited twice in the order it is executed. The first visit numbers every operation and finds the ones whose value
+ * is still available from an identical operation of the same sequence. The second visit, which numbers the operations the same
+ * way, wraps the operations whose value is reused in oKEEP nodes and replaces the repeated ones by oREUSE nodes
+ * @author Jose Pablo Ortiz Lack
+ */
+#include "valueNumbering.h"
+#include "syntaxTree.h"
+#include "symbolTable.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+int valueNumberingEnabled = 1;
+
+int valueNumberingReportEnabled = 0;
+
+/**
+ * @brief an operation whose value was computed by the current sequence
+ */
+typedef struct tagAvailableValue {
+
+    Node *operation; //operation as built by the parse
+    int producer; //number of the operation
+    int computedAt; //clock of the sequence when the value was computed
+    int next; //next value in the same bucket, -1 at the end
+
+} AvailableValue;
+
+/**
+ * @brief the state shared by the value numbering functions
+ */
+typedef struct tagValueContext {
+
+    Symbol **symbolTable; //the symbolTable of the compiler
+    int *assignedAt; //clock of the last assignment of each symbol, indexed by slot
+    int clock; //advances with every assignment
+
+    AvailableValue *values; //values available in the current sequence
+    int valueCount; //number of available values
+    int valueCapacity; //capacity of the value list
+    int *buckets; //first value of each hash bucket, -1 if the bucket is empty
+    int bucketCount; //number of buckets, a power of 2
+
+    int rewriting; //0 while the reused values are found, 1 while the tree is rewritten
+    int operationCount; //operations numbered by the visit
+    int *producers; //number of the operation whose value is reused by each operation, -1 if it is computed
+    char *reused; //1 for the operations whose value is reused by a later operation
+    Node **kept; //oKEEP node of each reused operation
+    int operationCapacity; //capacity of the operation lists
+
+    int eliminated; //operations that are no longer evaluated
+
+} ValueContext;
+
+/**
+ * @brief Allocates or resizes memory for the value numbering
+ * @param memory memory to be resized, NULL to allocate it
+ * @param size number of bytes
+ * @return the memory, the program will terminate if there is not enough memory
+ */
+static void *resizeValueMemory( void *memory , size_t size ) {
+
+    memory = realloc( memory , size > 0 ? size : 1 );
+
+    if ( memory == NULL ) {
+
+        printf( "Error: Memory allocation failed. Program will be terminated\n" );
+        exit(1);
+
+    }
+
+    return memory;
+}
+
+/**
+ * @brief counts the operations of an expresion, including those of its array indexes
+ */
+static int countOperations( Node *expr ) {
+
+    if ( expr->type != nOPERATION ) {
+
+        return expr->operationType == oINDEX ? countOperations( expr->indexExpr ) : 0;
+
+    }
+
+    return 1 + countOperations( expr->leftOperand ) + countOperations( expr->rightOperand );
+
+}
+
+/**
+ * @brief verifies if an expresion reads a symbol assigned after a clock
+ * @param expr expresion to be verified
+ * @param clock clock of the sequence, -1 to verify if the expresion reads any symbol
+ * @return 1 if a symbol read by the expresion was assigned after the clock
+ */
+static int readsAssignedSymbol( Node *expr , int clock , ValueContext *context ) {
+
+    if ( expr->type == nOPERATION ) {
+
+        return readsAssignedSymbol( expr->leftOperand , clock , context ) || readsAssignedSymbol( expr->rightOperand , clock , context );
+
+    }
+
+    if ( expr->operationType != oID && expr->operationType != oINDEX ) {
+
+        return 0;
+
+    }
+
+    if ( context->assignedAt[findSymbol( context->symbolTable , expr->value.idValue )->slot] > clock ) {
+
+        return 1;
+
+    }
+
+    return expr->operationType == oINDEX && readsAssignedSymbol( expr->indexExpr , clock , context );
+
+}
+
+/**
+ * @brief starts a new sequence, no value computed before it is reused after it
+ */
+static void startSequence( ValueContext *context ) {
+
+    int index;
+
+    for ( index = 0 ; index < context->valueCount ; index++ ) {
+
+        context->buckets[context->values[index].operation->valueHash & ( context->bucketCount - 1 )] = -1;
+
+    }
+
+    context->valueCount = 0;
+
+}
+
+/**
+ * @brief finds the value of an identical operation computed by the current sequence
+ * @return the value, NULL if no identical operation was computed or one of its symbols was assigned since
+ */
+static AvailableValue *findAvailableValue( Node *operation , ValueContext *context ) {
+
+    int index;
+
+    if ( context->bucketCount == 0 ) {
+
+        return NULL;
+
+    }
+
+    //the newest identical operation decides, the older ones were computed before any assignment that invalidates it
+    for ( index = context->buckets[operation->valueHash & ( context->bucketCount - 1 )] ; index >= 0 ; index = context->values[index].next ) {
+
+        AvailableValue *value = &context->values[index];
+
+        if ( sameExpresion( value->operation , operation ) ) {
+
+            return readsAssignedSymbol( operation , value->computedAt , context ) ? NULL : value;
+
+        }
+    }
+
+    return NULL;
+
+}
+
+/**
+ * @brief makes the value of an operation available to the rest of the sequence
+ */
+static void addAvailableValue( Node *operation , int producer , ValueContext *context ) {
+
+    int bucket;
+
+    if ( context->valueCount == context->valueCapacity ) {
+
+        context->valueCapacity = context->valueCapacity == 0 ? 64 : 2 * context->valueCapacity;
+        context->values        = resizeValueMemory( context->values , context->valueCapacity * sizeof( AvailableValue ) );
+
+    }
+
+    //the buckets are kept at twice the capacity of the value list
+    if ( context->bucketCount < 2 * context->valueCapacity ) {
+
+        int index;
+
+        context->bucketCount = 2 * context->valueCapacity;
+        context->buckets     = resizeValueMemory( context->buckets , context->bucketCount * sizeof( int ) );
+
+        memset( context->buckets , -1 , context->bucketCount * sizeof( int ) );
+
+        for ( index = 0 ; index < context->valueCount ; index++ ) {
+
+            bucket = context->values[index].operation->valueHash & ( context->bucketCount - 1 );
+
+            context->values[index].next = context->buckets[bucket];
+            context->buckets[bucket]    = index;
+
+        }
+    }
+
+    bucket = operation->valueHash & ( context->bucketCount - 1 );
+
+    context->values[context->valueCount].operation  = operation;
+    context->values[context->valueCount].producer   = producer;
+    context->values[context->valueCount].computedAt = context->clock;
+    context->values[context->valueCount].next       = context->buckets[bucket];
+
+    context->buckets[bucket] = context->valueCount++;
+
+}
+
+/**
+ * @brief numbers the operations of an expresion in the order they are evaluated. The first visit finds the values that are
+ * reused, the second one returns the expresion rewritten, copying the operations whose operands change
+ * @param expr expresion to be numbered, NULL if the statement has none
+ * @return the expresion to be evaluated instead
+ */
+static Node *numberValues( Node *expr , ValueContext *context ) {
+
+    Node *value = expr;
+    Node *leftOperand;
+    Node *rightOperand;
+    int operation;
+
+    if ( expr == NULL ) {
+
+        return NULL;
+
+    }
+
+    if ( expr->type != nOPERATION ) {
+
+        if ( expr->operationType == oINDEX ) {
+
+            Node *index = numberValues( expr->indexExpr , context );
+
+            if ( index != expr->indexExpr ) {
+
+                value = copyNode( expr );
+                value->indexExpr = index;
+
+            }
+        }
+
+        return value;
+
+    }
+
+    operation = context->operationCount++;
+
+    if ( !context->rewriting ) {
+
+        AvailableValue *available;
+
+        if ( operation == context->operationCapacity ) {
+
+            context->operationCapacity = context->operationCapacity == 0 ? 256 : 2 * context->operationCapacity;
+            context->producers         = resizeValueMemory( context->producers , context->operationCapacity * sizeof( int ) );
+            context->reused            = resizeValueMemory( context->reused , context->operationCapacity );
+
+        }
+
+        context->producers[operation] = -1;
+        context->reused[operation]    = 0;
+
+        if ( ( available = findAvailableValue( expr , context ) ) != NULL ) {
+
+            context->producers[operation]          = available->producer;
+            context->reused[available->producer] = 1;
+            context->eliminated                   += countOperations( expr );
+
+            return expr;
+
+        }
+
+    } else if ( context->producers[operation] >= 0 ) {
+
+        return createReusedOperation( context->kept[context->producers[operation]] , countOperations( expr ) );
+
+    }
+
+    leftOperand  = numberValues( expr->leftOperand , context );
+    rightOperand = numberValues( expr->rightOperand , context );
+
+    if ( leftOperand != expr->leftOperand || rightOperand != expr->rightOperand ) {
+
+        value = copyNode( expr );
+        value->leftOperand  = leftOperand;
+        value->rightOperand = rightOperand;
+
+    }
+
+    if ( !context->rewriting ) {
+
+        //operations made only of literals are as cheap to evaluate as to reuse
+        if ( readsAssignedSymbol( expr , -1 , context ) ) {
+
+            addAvailableValue( expr , operation , context );
+
+        }
+
+    } else if ( context->reused[operation] ) {
+
+        value = createKeptOperation( value );
+
+        context->kept[operation] = value;
+
+    }
+
+    return value;
+
+}
+
+/**
+ * @brief numbers the operations of a condition, evaluated left side first
+ */
+static void numberCondition( Node *expresion , ValueContext *context ) {
+
+    expresion->leftOperand  = numberValues( expresion->leftOperand , context );
+    expresion->rightOperand = numberValues( expresion->rightOperand , context );
+
+}
+
+/**
+ * @brief records the assignment of a symbol, the values that read it are no longer available
+ */
+static void recordAssignment( char *identifier , ValueContext *context ) {
+
+    context->assignedAt[findSymbol( context->symbolTable , identifier )->slot] = ++context->clock;
+
+}
+
+/**
+ * @brief numbers the operations of the statements of a tree in the order they are executed
+ */
+static void numberStatementValues( Node *tree , ValueContext *context ) {
+
+    if ( tree == NULL ) {
+
+        return;
+
+    }
+
+    switch ( tree->type ) {
+
+        case nSEMICOLON:
+
+            numberStatementValues( tree->leftStatement , context );
+            numberStatementValues( tree->rightStatement , context );
+
+        break;
+
+        case nASSIGNMENT: //the index of an element is evaluated before the value assigned
+
+            tree->indexExpr = numberValues( tree->indexExpr , context );
+            tree->expr      = numberValues( tree->expr , context );
+
+            recordAssignment( tree->value.idValue , context );
+
+        break;
+
+        case nPRINT:
+
+            tree->expr = numberValues( tree->expr , context );
+
+        break;
+
+        case nCALL: //the procedure may assign any symbol
+
+            startSequence( context );
+
+        break;
+
+        case nREAD: //a session is suspended by a read and may be resumed by another execution
+
+            recordAssignment( tree->value.idValue , context );
+            startSequence( context );
+
+        break;
+
+        case nIF:
+
+            numberCondition( tree->expresion , context );
+
+            startSequence( context );
+            numberStatementValues( tree->thenOptStmts , context );
+            startSequence( context );
+
+        break;
+
+        case nWHILE: //the condition is evaluated again after every iteration
+
+            startSequence( context );
+            numberCondition( tree->expresion , context );
+
+            startSequence( context );
+            numberStatementValues( tree->doOptStmts , context );
+            startSequence( context );
+
+        break;
+
+        case nFOR: //start, step and until are evaluated once, before the iterator is assigned
+
+            tree->expr      = numberValues( tree->expr , context );
+            tree->stepExpr  = numberValues( tree->stepExpr , context );
+            tree->untilExpr = numberValues( tree->untilExpr , context );
+
+            recordAssignment( tree->value.idValue , context );
+
+            startSequence( context );
+            numberStatementValues( tree->doOptStmts , context );
+            startSequence( context );
+
+        break;
+
+        default:
+
+        break;
+
+    }
+}
+
+int eliminateCommonSubexpressions( Node *tree , Symbol **symbolTable ) {
+
+    ValueContext context = { 0 };
+    int symbolCount = getSlotCount( symbolTable );
+
+    if ( tree == NULL ) {
+
+        return 0;
+
+    }
+
+    context.symbolTable = symbolTable;
+    context.assignedAt  = resizeValueMemory( NULL , symbolCount * sizeof( int ) );
+
+    memset( context.assignedAt , 0 , symbolCount * sizeof( int ) );
+
+    numberStatementValues( tree , &context );
+
+    if ( context.eliminated > 0 ) {
+
+        context.rewriting      = 1;
+        context.operationCount = 0;
+        context.kept           = resizeValueMemory( NULL , context.operationCapacity * sizeof( Node * ) );
+
+        numberStatementValues( tree , &context );
+
+    }
+
+    free( context.assignedAt );
+    free( context.values );
+    free( context.buckets );
+    free( context.producers );
+    free( context.reused );
+    free( context.kept );
+
+    return context.eliminated;
+
+}
+
+//end valueNumbering.c
@@ -0,0 +1,37 @@
+/**
+ * valueNumbering.h
+ * Definition of the value numbering that eliminates the common subexpressions of straight-line statement sequences
+ * @author Jose Pablo Ortiz Lack
+ */
+#ifndef __VALUE_NUMBERING_H__
+#define __VALUE_NUMBERING_H__
+
+#include "symbolTable.h"
+#include "syntaxTree.h"
+
+/**
+ * @brief eliminates the common subexpressions of the programs before they are executed, 1 by default
+ */
+extern int valueNumberingEnabled;
+
+/**
+ * @brief prints the number of operations shared by the parse and eliminated by the value numbering
+ */
+extern int valueNumberingReportEnabled;
+
+/**
+ * @brief finds the operations computed again by a statement sequence without any of their symbols being assigned in between. The
+ * first operation keeps its value in an oKEEP node and the repeated ones are replaced by oREUSE nodes that return it.
+ * Values are only reused within a straight-line sequence: the bodies and conditions of loops and the bodies of ifs start new
+ * sequences, and so do every call, which may assign any symbol, and every read, so a session suspended by a read never resumes in
+ * the middle of a sequence.
+ * Operations shared by the parse are never modified, the operations that contain a replaced one are copied
+ * @param tree tree to be optimized
+ * @param symbolTable the symbolTable of the compiler
+ * @return the number of operations eliminated from the tree
+ */
+int eliminateCommonSubexpressions( Node *tree , Symbol **symbolTable );
+
+#endif //__VALUE_NUMBERING_H__
+
+//end valueNumbering.h
@@ -0,0 +1,528 @@
+/**
+ * vectorLoop.c
+ * Implementation of the vectorized execution path of counted for loops
+ * @author Jose Pablo Ortiz Lack
+ */
+#include "vectorLoop.h"
+#include "metrics.h"
+#include "syntaxTree.h"
+#include "symbolTable.h"
+#include "arena.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <limits.h>
+
+/**
+ * @brief number of iterations executed by each vector block
+ */
+#define VECTOR_LANES 16
+
+/**
+ * @brief 16 unsigned integer lanes. Unsigned lanes wrap around exactly like the scalar integer operations
+ */
+typedef unsigned int VectorLane __attribute__(( vector_size( VECTOR_LANES * sizeof( unsigned int ) ) ));
+
+int vectorLoopEnabled = 1;
+
+/**
+ * @brief Allocates zeroed memory for the lists used while the vectorization plan is built
+ * @param size number of bytes
+ * @return the memory, the program will terminate if there is not enough memory
+ */
+static void *allocateVectorMemory( size_t size ) {
+
+    void *memory = calloc( 1 , size > 0 ? size : 1 );
+
+    if ( memory == NULL ) {
+
+        printf( "Error: Memory allocation failed. Program will be terminated\n" );
+        exit(1);
+
+    }
+
+    return memory;
+}
+
+/**
+ * @brief searches an identifier in a list of identifiers
+ * @return the index of the identifier or -1 if it is not in the list
+ */
+static int findIdentifier( char **identifiers , int count , char *identifier ) {
+
+    int index;
+
+    for ( index = 0 ; index < count ; index++ ) {
+
+        if ( strcmp( identifiers[index] , identifier ) == 0 ) {
+
+            return index;
+
+        }
+    }
+
+    return -1;
+}
+
+/**
+ * @brief collects the identifiers assigned by the loop body
+ * @return 1 if every statement of the body is an integer assignment, 0 otherwise
+ */
+static int collectAccumulators( Node *body , VectorLoop *vectorLoop , char **assigned , int *assignedCount ) {
+
+    if ( body == NULL ) {
+
+        return 1;
+
+    }
+
+    switch ( body->type ) {
+
+        case nSEMICOLON:
+
+            return collectAccumulators( body->leftStatement , vectorLoop , assigned , assignedCount ) &&
+                   collectAccumulators( body->rightStatement , vectorLoop , assigned , assignedCount );
+
+        case nASSIGNMENT:
+
+            if ( body->symbolType != sINTEGER || body->indexExpr != NULL ||
+                 strcmp( body->value.idValue , vectorLoop->induction ) == 0 ||
+                 findIdentifier( assigned , *assignedCount , body->value.idValue ) != -1 ) {
+
+                return 0;
+
+            }
+
+            assigned[(*assignedCount)++] = body->value.idValue;
+
+            return 1;
+
+        default:
+
+            return 0;
+
+    }
+}
+
+/**
+ * @brief counts the statements of the loop body
+ */
+static int countStatements( Node *body ) {
+
+    if ( body == NULL ) {
+
+        return 0;
+
+    }
+
+    if ( body->type == nSEMICOLON ) {
+
+        return countStatements( body->leftStatement ) + countStatements( body->rightStatement );
+
+    }
+
+    return 1;
+}
+
+/**
+ * @brief counts the nodes of an expresion
+ */
+static int countOperations( Node *expr ) {
+
+    if ( expr->type == nOPERATION ) {
+
+        return 1 + countOperations( expr->leftOperand ) + countOperations( expr->rightOperand );
+
+    }
+
+    return 1;
+}
+
+/**
+ * @brief flattens an expresion that does not reference any accumulator to postfix form
+ * @return the stack depth needed to evaluate the expresion or 0 if it cannot be vectorized
+ */
+static int flattenExpresion( Node *expr , VectorLoop *vectorLoop , char **assigned , int assignedCount , VectorAccumulator *accumulator ) {
+
+    VectorOperation *operation;
+
+    if ( expr->symbolType != sINTEGER ) {
+
+        return 0;
+
+    }
+
+    if ( expr->type == nOPERATION ) {
+
+        int leftDepth;
+        int rightDepth;
+
+        if ( expr->operationType != oSUM && expr->operationType != oSUB && expr->operationType != oMULT ) {
+
+            return 0; //integer division has no vector instruction and is left to the scalar path
+
+        }
+
+        leftDepth  = flattenExpresion( expr->leftOperand , vectorLoop , assigned , assignedCount , accumulator );
+        rightDepth = flattenExpresion( expr->rightOperand , vectorLoop , assigned , assignedCount , accumulator );
+
+        if ( leftDepth == 0 || rightDepth == 0 ) {
+
+            return 0;
+
+        }
+
+        operation       = &accumulator->operations[accumulator->operationCount++];
+        operation->type = expr->operationType == oSUM ? vSUM : ( expr->operationType == oSUB ? vSUB : vMULT );
+
+        return leftDepth > rightDepth + 1 ? leftDepth : rightDepth + 1;
+
+    }
+
+    operation = &accumulator->operations[accumulator->operationCount++];
+
+    switch ( expr->operationType ) {
+
+        case oINTEGER:
+
+            operation->type  = vCONSTANT;
+            operation->value = expr->value.iValue;
+
+        break;
+
+        case oID:
+
+            if ( strcmp( expr->value.idValue , vectorLoop->induction ) == 0 ) {
+
+                operation->type = vINDUCTION;
+
+            } else if ( findIdentifier( assigned , assignedCount , expr->value.idValue ) == -1 ) {
+
+                operation->type  = vINVARIANT;
+                operation->value = findIdentifier( vectorLoop->invariants , vectorLoop->invariantCount , expr->value.idValue );
+
+                if ( operation->value == -1 ) {
+
+                    operation->value = vectorLoop->invariantCount;
+                    vectorLoop->invariants[vectorLoop->invariantCount++] = expr->value.idValue;
+
+                }
+
+            } else {
+
+                return 0; //accumulators depend on the previous iteration
+
+            }
+
+        break;
+
+        default:
+
+            return 0;
+
+    }
+
+    return 1;
+}
+
+/**
+ * @brief flattens the terms of acc := acc +/- expr +/- expr ... that are not the accumulator itself
+ * @param sign 1 if the terms are added, -1 if they are substracted
+ * @param accumulatorTerms number of times the accumulator was found with a positive sign
+ * @return the stack depth needed or 0 if the terms cannot be vectorized
+ */
+static int flattenTerms( Node *expr , int sign , VectorLoop *vectorLoop , char **assigned , int assignedCount , VectorAccumulator *accumulator , int *accumulatorTerms ) {
+
+    int depth;
+
+    if ( expr->type == nOPERATION && ( expr->operationType == oSUM || expr->operationType == oSUB ) ) {
+
+        int leftDepth  = flattenTerms( expr->leftOperand , sign , vectorLoop , assigned , assignedCount , accumulator , accumulatorTerms );
+        int rightDepth = flattenTerms( expr->rightOperand , expr->operationType == oSUM ? sign : -sign , vectorLoop , assigned , assignedCount , accumulator , accumulatorTerms );
+
+        if ( leftDepth == 0 || rightDepth == 0 ) {
+
+            return 0;
+
+        }
+
+        return leftDepth > rightDepth ? leftDepth : rightDepth;
+
+    }
+
+    if ( expr->type == nVALUE && expr->operationType == oID && strcmp( expr->value.idValue , accumulator->identifier ) == 0 ) {
+
+        if ( sign < 0 ) {
+
+            return 0;
+
+        }
+
+        ( *accumulatorTerms )++;
+
+        return 1;
+
+    }
+
+    //the running total is on the stack, the term is pushed on top of it and then combined
+    depth = flattenExpresion( expr , vectorLoop , assigned , assignedCount , accumulator );
+
+    if ( depth == 0 ) {
+
+        return 0;
+
+    }
+
+    accumulator->operations[accumulator->operationCount++].type = sign > 0 ? vSUM : vSUB;
+
+    return depth + 1;
+}
+
+VectorLoop *createVectorLoop( Node *forStatement ) {
+
+    Node *body = forStatement->doOptStmts;
+    int statementCount = countStatements( body );
+    char **assigned;
+    int assignedCount = 0;
+    int invariantCapacity = 0;
+    Node **statements;
+    int statementIndex = 0;
+    int index;
+
+    //the plan belongs to the program, a plan that is discarded is released with it
+    VectorLoop *vectorLoop = allocateCompilerMemory( sizeof( VectorLoop ) , _Alignof( VectorLoop ) , aNODES );
+
+    vectorLoop->induction = forStatement->value.idValue;
+
+    assigned = allocateVectorMemory( statementCount * sizeof( char * ) );
+
+    if ( forStatement->expr->symbolType != sINTEGER || !collectAccumulators( body , vectorLoop , assigned , &assignedCount ) ) {
+
+        free( assigned );
+
+        return NULL;
+
+    }
+
+    //gather the assignments in program order
+    statements = allocateVectorMemory( statementCount * sizeof( Node * ) );
+
+    while ( body != NULL ) {
+
+        if ( body->type == nSEMICOLON ) {
+
+            statements[statementIndex++] = body->leftStatement;
+            body = body->rightStatement;
+
+        } else {
+
+            statements[statementIndex++] = body;
+            body = NULL;
+
+        }
+    }
+
+    for ( index = 0 ; index < statementCount ; index++ ) {
+
+        invariantCapacity += countOperations( statements[index]->expr );
+
+    }
+
+    vectorLoop->accumulators      = allocateCompilerMemory( statementCount * sizeof( VectorAccumulator ) , _Alignof( VectorAccumulator ) , aNODES );
+    vectorLoop->accumulatorCount  = statementCount;
+    vectorLoop->invariants        = allocateCompilerMemory( invariantCapacity * sizeof( char * ) , _Alignof( char * ) , aNODES );
+    vectorLoop->accumulatorValues = allocateCompilerMemory( statementCount * sizeof( unsigned int ) , _Alignof( unsigned int ) , aNODES );
+    vectorLoop->invariantValues   = allocateCompilerMemory( invariantCapacity * sizeof( unsigned int ) , _Alignof( unsigned int ) , aNODES );
+
+    for ( index = 0 ; index < statementCount ; index++ ) {
+
+        VectorAccumulator *accumulator = &vectorLoop->accumulators[index];
+        int accumulatorTerms = 0;
+        int depth;
+
+        accumulator->identifier = statements[index]->value.idValue;
+
+        //each term needs at most one extra sum or substraction, plus the initial constant 0
+        accumulator->operations = allocateCompilerMemory( ( 2 * countOperations( statements[index]->expr ) + 1 ) * sizeof( VectorOperation ) ,
+                                                          _Alignof( VectorOperation ) , aNODES );
+
+        accumulator->operations[0].type  = vCONSTANT;
+        accumulator->operations[0].value = 0;
+        accumulator->operationCount      = 1;
+
+        depth = flattenTerms( statements[index]->expr , 1 , vectorLoop , assigned , assignedCount , accumulator , &accumulatorTerms );
+
+        if ( depth == 0 || depth > VECTOR_STACK_DEPTH || accumulatorTerms != 1 ) {
+
+            vectorLoop = NULL; //the plan is discarded, the scalar path is used for this loop
+            break;
+
+        }
+    }
+
+    free( assigned );
+    free( statements );
+
+    return vectorLoop;
+}
+
+/**
+ * @brief evaluates a postfix expresion for a single iteration
+ * @return the value added to the accumulator
+ */
+static unsigned int evaluateScalarOperations( VectorAccumulator *accumulator , unsigned int induction , const unsigned int *invariants ) {
+
+    unsigned int stack[VECTOR_STACK_DEPTH];
+    int top = -1;
+    int index;
+
+    for ( index = 0 ; index < accumulator->operationCount ; index++ ) {
+
+        VectorOperation *operation = &accumulator->operations[index];
+
+        switch ( operation->type ) {
+
+            case vCONSTANT:  stack[++top] = (unsigned int) operation->value; break;
+            case vINDUCTION: stack[++top] = induction; break;
+            case vINVARIANT: stack[++top] = invariants[operation->value]; break;
+            case vSUM:       top--; stack[top] += stack[top + 1]; break;
+            case vSUB:       top--; stack[top] -= stack[top + 1]; break;
+            case vMULT:      top--; stack[top] *= stack[top + 1]; break;
+
+        }
+    }
+
+    return stack[0];
+}
+
+/**
+ * @brief executes complete blocks of VECTOR_LANES iterations for one accumulator.
+ * The function is cloned for AVX-512, AVX2 and the SSE2 baseline, the clone is selected at load time through CPUID
+ * @return the sum of the values added to the accumulator by the executed iterations
+ */
+#if defined( __GNUC__ ) && defined( __x86_64__ ) && !defined( __clang__ )
+__attribute__(( target_clones( "avx512f" , "avx2" , "default" ) ))
+#endif
+static unsigned int resolveVectorBlocks( VectorAccumulator *accumulator , unsigned int start , unsigned int step , long long blocks , const unsigned int *invariants ) {
+
+    VectorLane stack[VECTOR_STACK_DEPTH];
+    VectorLane induction;
+    VectorLane advance;
+    const VectorLane zero = { 0 };
+    VectorLane sum = { 0 };
+    unsigned int total = 0;
+    long long block;
+    int lane;
+
+    for ( lane = 0 ; lane < VECTOR_LANES ; lane++ ) {
+
+        induction[lane] = start + step * lane;
+        advance[lane]   = step * VECTOR_LANES;
+
+    }
+
+    for ( block = 0 ; block < blocks ; block++ ) {
+
+        int top = -1;
+        int index;
+
+        for ( index = 0 ; index < accumulator->operationCount ; index++ ) {
+
+            VectorOperation *operation = &accumulator->operations[index];
+
+            switch ( operation->type ) {
+
+                case vCONSTANT:  stack[++top] = zero + (unsigned int) operation->value; break;
+                case vINDUCTION: stack[++top] = induction; break;
+                case vINVARIANT: stack[++top] = zero + invariants[operation->value]; break;
+                case vSUM:       top--; stack[top] += stack[top + 1]; break;
+                case vSUB:       top--; stack[top] -= stack[top + 1]; break;
+                case vMULT:      top--; stack[top] *= stack[top + 1]; break;
+
+            }
+        }
+
+        sum       += stack[0];
+        induction += advance;
+
+    }
+
+    for ( lane = 0 ; lane < VECTOR_LANES ; lane++ ) {
+
+        total += sum[lane];
+
+    }
+
+    return total;
+}
+
+int resolveVectorLoop( VectorLoop *vectorLoop , int start , int step , int until , Symbol **symbolTable ) {
+
+    long long count;
+    long long last;
+    long long blocks;
+    long long iteration;
+    int index;
+
+    //number of iterations executed by the scalar path
+    if ( step > 0 ) {
+
+        count = start <= until ? ( (long long) until - start ) / step + 1 : 0;
+
+    } else {
+
+        count = start >= until ? ( (long long) start - until ) / -(long long) step + 1 : 0;
+
+    }
+
+    //the iterator value that ends the scalar loop must be representable, otherwise the scalar path is kept
+    last = (long long) start + count * step;
+
+    if ( last > INT_MAX || last < INT_MIN ) {
+
+        return 0;
+
+    }
+
+    for ( index = 0 ; index < vectorLoop->invariantCount ; index++ ) {
+
+        vectorLoop->invariantValues[index] = (unsigned int) getIntegerSymbolValue( symbolTable , vectorLoop->invariants[index] );
+
+    }
+
+    blocks = count / VECTOR_LANES;
+
+    METRIC_ADD( loopIterations , count );
+
+    for ( index = 0 ; index < vectorLoop->accumulatorCount ; index++ ) {
+
+        VectorAccumulator *accumulator = &vectorLoop->accumulators[index];
+        unsigned int value = (unsigned int) getIntegerSymbolValue( symbolTable , accumulator->identifier );
+
+        value += resolveVectorBlocks( accumulator , (unsigned int) start , (unsigned int) step , blocks , vectorLoop->invariantValues );
+
+        //tail iterations that do not fill a complete block
+        for ( iteration = blocks * VECTOR_LANES ; iteration < count ; iteration++ ) {
+
+            value += evaluateScalarOperations( accumulator , (unsigned int) start + (unsigned int) step * (unsigned int) iteration , vectorLoop->invariantValues );
+
+        }
+
+        vectorLoop->accumulatorValues[index] = value;
+
+    }
+
+    for ( index = 0 ; index < vectorLoop->accumulatorCount ; index++ ) {
+
+        setIntegerSymbolValue( symbolTable , vectorLoop->accumulators[index].identifier , (int) vectorLoop->accumulatorValues[index] );
+
+    }
+
+    //same adjustment as the scalar path: the iterator keeps the last value that met the condition
+    setIntegerSymbolValue( symbolTable , vectorLoop->induction , (int) ( (unsigned int) last - (unsigned int) step ) );
+
+    return 1;
+}
+
+//end vectorLoop.c
@@ -0,0 +1,101 @@
+/**
+ * vectorLoop.h
+ * Definition of the structures used to execute counted for loops several iterations at a time
+ * @author Jose Pablo Ortiz Lack
+ */
+#ifndef __VECTOR_LOOP_H__
+#define __VECTOR_LOOP_H__
+
+#include "symbolTable.h"
+#include "syntaxTree.h"
+
+/**
+ * @brief maximum depth of the operand stack used to evaluate a vectorized expression
+ */
+#define VECTOR_STACK_DEPTH 16
+
+/**
+ * @brief The vector operation type
+ */
+typedef enum tagVectorOperationType {
+
+    vCONSTANT,
+    vINDUCTION,
+    vINVARIANT,
+    vSUM,
+    vSUB,
+    vMULT
+
+} VectorOperationType;
+
+/**
+ * @brief a single instruction of a flattened (postfix) expression
+ */
+typedef struct tagVectorOperation {
+
+    VectorOperationType type; //type of instruction (see VectorOperationType ENUM)
+
+    int value; //constant value (vCONSTANT) or index of the invariant (vINVARIANT)
+
+} VectorOperation;
+
+/**
+ * @brief an accumulator updated in the loop body with acc := acc + expr or acc := acc - expr
+ */
+typedef struct tagVectorAccumulator {
+
+    char *identifier; //identifier of the accumulator symbol
+
+    VectorOperation *operations; //postfix form of the value added to the accumulator in each iteration
+    int operationCount; //number of operations
+
+} VectorAccumulator;
+
+/**
+ * @brief the vectorization plan of a counted for loop
+ */
+typedef struct tagVectorLoop {
+
+    char *induction; //identifier of the loop iterator
+
+    VectorAccumulator *accumulators; //accumulators updated by the loop body
+    int accumulatorCount; //number of accumulators
+
+    char **invariants; //identifiers read but never assigned by the loop body
+    int invariantCount; //number of invariants
+
+    unsigned int *accumulatorValues; //scratch values of the accumulators while the loop is executed
+    unsigned int *invariantValues; //scratch values of the invariants while the loop is executed
+
+} VectorLoop;
+
+/**
+ * @brief enables or disables the vectorized path. When disabled every loop runs through the scalar path of resolveTree
+ */
+extern int vectorLoopEnabled;
+
+/**
+ * @brief analyzes an integer for statement and builds its vectorization plan.
+ * Only bodies made of integer assignments of the form acc := acc + expr or acc := acc - expr are accepted,
+ * where expr uses +, - and * over literals, the loop iterator and symbols not assigned inside the body.
+ * The plan is allocated with the nodes of the program and released with them
+ * @param forStatement for statement to be analyzed
+ * @return the vectorization plan or NULL if the body cannot be vectorized
+ */
+VectorLoop *createVectorLoop( Node *forStatement );
+
+/**
+ * @brief executes an integer for loop with the vectorized path, selecting SSE2, AVX2 or AVX-512 lanes through CPUID.
+ * The final values of the accumulators and the iterator are the same as the ones produced by the scalar path
+ * @param vectorLoop vectorization plan of the loop
+ * @param start start value of the iterator
+ * @param step step of the iterator, must not be 0
+ * @param until stop value of the iterator
+ * @param symbolTable the symbolTable of the compiler
+ * @return 1 if the loop was executed, 0 if the scalar path must be used instead
+ */
+int resolveVectorLoop( VectorLoop *vectorLoop , int start , int step , int until , Symbol **symbolTable );
+
+#endif //__VECTOR_LOOP_H__
+
+//end vectorLoop.h